@@ -0,0 +1,314 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#include "BinaryLog.h"
+
+/* STL Headers */
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+const char BinaryLog::MAGIC[8] = {'U', 'D', 'L', 'O', 'G', '0', '0', '1'};
+
+namespace
+{
+const char EXTENSION[] = ".udlog";
+
+template<typename T>
+void appendValue(const uint8_t* value, int precision, std::string& out)
+{
+    T converted;
+    memcpy(&converted, value, sizeof(T));
+    NumberFormat::append(out, converted, precision);
+    out += '\t';
+}
+
+/// the length of the layout after a TYPE_RECORD header
+size_t layoutLength(uint16_t count)
+{
+    return 2 * sizeof(uint16_t) + count * (1 + sizeof(uint16_t));
+}
+
+/// appends value, a type in the machine's order, and a tab
+void appendValue(BinaryLog::Type type, const uint8_t* value, int precision, std::string& out)
+{
+    switch(type)
+    {
+    case BinaryLog::TYPE_INT8:
+        appendValue<int8_t>(value, precision, out);
+        break;
+    case BinaryLog::TYPE_UINT8:
+        appendValue<uint8_t>(value, precision, out);
+        break;
+    case BinaryLog::TYPE_INT16:
+        appendValue<int16_t>(value, precision, out);
+        break;
+    case BinaryLog::TYPE_UINT16:
+        appendValue<uint16_t>(value, precision, out);
+        break;
+    case BinaryLog::TYPE_INT32:
+        appendValue<int32_t>(value, precision, out);
+        break;
+    case BinaryLog::TYPE_UINT32:
+        appendValue<uint32_t>(value, precision, out);
+        break;
+    case BinaryLog::TYPE_INT64:
+        appendValue<int64_t>(value, precision, out);
+        break;
+    case BinaryLog::TYPE_UINT64:
+        appendValue<uint64_t>(value, precision, out);
+        break;
+    case BinaryLog::TYPE_FLOAT32:
+        appendValue<float>(value, precision, out);
+        break;
+    case BinaryLog::TYPE_FLOAT64:
+        appendValue<double>(value, precision, out);
+        break;
+    default:
+        break;
+    }
+}
+}
+
+size_t BinaryLog::width(Type type)
+{
+    switch(type)
+    {
+    case TYPE_INT8:
+    case TYPE_UINT8:
+        return 1;
+    case TYPE_INT16:
+    case TYPE_UINT16:
+        return 2;
+    case TYPE_INT32:
+    case TYPE_UINT32:
+    case TYPE_FLOAT32:
+        return 4;
+    case TYPE_INT64:
+    case TYPE_UINT64:
+    case TYPE_FLOAT64:
+        return 8;
+    default:
+        return 0;
+    }
+}
+
+std::string BinaryLog::fileHeader(Type type, const std::string& header)
+{
+    std::string out(MAGIC, MAGIC_LENGTH);
+    out.push_back(static_cast<char>(type));
+
+    uint32_t length = header.size();
+    out.append(reinterpret_cast<const char*>(&length), sizeof(length));
+    out.append(header);
+    return out;
+}
+
+std::string BinaryLog::fileHeader(const Layout& layout)
+{
+    std::string out = fileHeader(TYPE_RECORD, columnNames(layout));
+    out.append(reinterpret_cast<const char*>(&layout.count), sizeof(layout.count));
+    out.append(reinterpret_cast<const char*>(&layout.size), sizeof(layout.size));
+    for(uint16_t i = 0; i < layout.count; i++)
+    {
+        out.push_back(static_cast<char>(layout.columns[i].type));
+        out.append(reinterpret_cast<const char*>(&layout.columns[i].offset), sizeof(uint16_t));
+    }
+    return out;
+}
+
+std::string BinaryLog::columnNames(const Layout& layout)
+{
+    std::string names;
+    for(uint16_t i = 0; i < layout.count; i++)
+    {
+        if(i > 0)
+        {
+            names += ' ';
+        }
+        names += layout.columns[i].name;
+    }
+    return names;
+}
+
+bool BinaryLog::recordText(const Layout& layout, const uint8_t* record, size_t length, std::string& out,
+                           int precision)
+{
+    uint16_t count;
+    if(length < RECORD_HEADER_LENGTH)
+    {
+        return false;
+    }
+    memcpy(&count, record + sizeof(int64_t), sizeof(count));
+    if(count != layout.size || length != RECORD_HEADER_LENGTH + count)
+    {
+        return false;
+    }
+
+    int64_t time_micros;
+    memcpy(&time_micros, record, sizeof(time_micros));
+    NumberFormat::append(out, time_micros, 0);
+    out += '\t';
+
+    const uint8_t* values = record + RECORD_HEADER_LENGTH;
+    for(uint16_t i = 0; i < layout.count; i++)
+    {
+        if(layout.columns[i].offset + width(layout.columns[i].type) > count)
+        {
+            continue;
+        }
+
+        appendValue(layout.columns[i].type, values + layout.columns[i].offset, precision, out);
+    }
+    out += '\n';
+    return true;
+}
+
+bool BinaryLog::readHeader(const uint8_t* data, size_t size, FileHeader& header)
+{
+    size_t offset = MAGIC_LENGTH + 1 + sizeof(uint32_t);
+    if(size < offset || memcmp(data, MAGIC, MAGIC_LENGTH) != 0)
+    {
+        return false;
+    }
+
+    header.type = static_cast<Type>(data[MAGIC_LENGTH]);
+    uint32_t header_length;
+    memcpy(&header_length, data + MAGIC_LENGTH + 1, sizeof(header_length));
+    if((width(header.type) == 0 && header.type != TYPE_RECORD) || offset + header_length > size)
+    {
+        return false;
+    }
+
+    header.columns.assign(reinterpret_cast<const char*>(data + offset), header_length);
+    offset += header_length;
+    header.recordColumns.clear();
+    header.recordSize = 0;
+
+    if(header.type == TYPE_RECORD)
+    {
+        uint16_t count;
+        if(size < offset + layoutLength(0))
+        {
+            return false;
+        }
+        memcpy(&count, data + offset, sizeof(count));
+        memcpy(&header.recordSize, data + offset + sizeof(count), sizeof(header.recordSize));
+        if(size < offset + layoutLength(count))
+        {
+            return false;
+        }
+
+        header.recordColumns.resize(count);
+        for(uint16_t i = 0; i < count; i++)
+        {
+            const uint8_t* column = data + offset + layoutLength(0) + i * (1 + sizeof(uint16_t));
+            header.recordColumns[i].name = "";
+            header.recordColumns[i].type = static_cast<Type>(column[0]);
+            memcpy(&header.recordColumns[i].offset, column + 1, sizeof(uint16_t));
+        }
+        offset += layoutLength(count);
+    }
+
+    header.length = offset;
+    return true;
+}
+
+size_t BinaryLog::recordToText(const FileHeader& header, const uint8_t* data, size_t size, std::string& out)
+{
+    if(size < RECORD_HEADER_LENGTH)
+    {
+        return 0;
+    }
+
+    uint16_t count;
+    memcpy(&count, data + sizeof(int64_t), sizeof(count));
+    size_t length = RECORD_HEADER_LENGTH + count * (header.type == TYPE_RECORD ? 1 : width(header.type));
+    if(length > size)
+    {
+        return 0;
+    }
+
+    if(header.type == TYPE_RECORD)
+    {
+        Layout layout = {header.recordColumns.data(), static_cast<uint16_t>(header.recordColumns.size()),
+                         header.recordSize};
+        recordText(layout, data, length, out);
+        return length;
+    }
+
+    NumberFormat::append(out, recordTime(data), 0);
+    out += '\t';
+    size_t value_width = width(header.type);
+    for(uint16_t i = 0; i < count; i++)
+    {
+        appendValue(header.type, data + RECORD_HEADER_LENGTH + i * value_width, NumberFormat::DEFAULT_PRECISION, out);
+    }
+    out += '\n';
+    return length;
+}
+
+bool BinaryLog::toText(const uint8_t* data, size_t size, std::ostream& out)
+{
+    FileHeader header;
+    if(! readHeader(data, size, header))
+    {
+        return false;
+    }
+
+    // the same header line LogfileWriter writes
+    out << "Time(micros)\t" << header.columns << '\n';
+
+    size_t offset = header.length;
+    std::string line;
+    while(true)
+    {
+        line.clear();
+        size_t length = recordToText(header, data + offset, size - offset, line);
+        if(length == 0)
+        {
+            break;
+        }
+        out << line;
+        offset += length;
+    }
+
+    return true;
+}
+
+std::string BinaryLog::convertFile(const std::string& path)
+{
+    size_t extension_length = sizeof(EXTENSION) - 1;
+    if(path.size() <= extension_length ||
+       path.compare(path.size() - extension_length, extension_length, EXTENSION) != 0)
+    {
+        return "";
+    }
+
+    std::ifstream input(path.c_str(), std::ios::binary);
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    if(! input.good() && ! input.eof())
+    {
+        return "";
+    }
+
+    // channel names with their own extension keep it, like LogfileWriter::getLogPath
+    std::string text_path = path.substr(0, path.size() - extension_length);
+    size_t name_start = text_path.rfind('/');
+    if(text_path.find('.', name_start == std::string::npos ? 0 : name_start) == std::string::npos)
+    {
+        text_path += ".dat";
+    }
+
+    std::ofstream output(text_path.c_str());
+    if(! toText(data.data(), data.size(), output) || ! output.good())
+    {
+        return "";
+    }
+
+    return text_path;
+}
@@ -0,0 +1,259 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#ifndef BINARY_LOG_H_
+#define BINARY_LOG_H_
+
+/* STL Headers */
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/* C Headers */
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+/* Project Headers */
+#include "NumberFormat.h"
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "BinaryLog writes values in machine order and assumes it is little endian"
+#endif
+
+/**
+ * @brief The opt-in binary format for LogFile::logData channels.
+ *
+ * With log.binary set in config.xml each channel is written to NAME.udlog
+ * rather than NAME.dat. Every value in a channel has the type of the first
+ * container logged to it, so a sample of nine floats is 46 bytes rather than
+ * the hundred or so it takes as text, and nothing is formatted in flight.
+ *
+ * A file is MAGIC, then a header of
+ *
+ *     uint8_t  type           one of Type
+ *     uint32_t header_length
+ *     char     header[header_length]  the logHeader() columns, verbatim
+ *
+ * and then one record per logData() call of
+ *
+ *     int64_t  time_micros    the same time the text log writes
+ *     uint16_t count
+ *     type     values[count]
+ *
+ * all little endian. toText() turns a file back in to exactly the .dat text
+ * the channel would have produced, `autopilot logconvert` does it for files.
+ *
+ * Channels of a LOG_RECORD struct (see LogRecord.h) are TYPE_RECORD. Their
+ * header is followed by the struct's Layout,
+ *
+ *     uint16_t column_count
+ *     uint16_t record_size
+ *     uint8_t  type, uint16_t offset     for each column
+ *
+ * and each record's count is record_size, the bytes of the struct as it was
+ * in memory.
+ */
+class BinaryLog
+{
+public:
+    static const char MAGIC[8];
+    static const size_t MAGIC_LENGTH = sizeof(MAGIC);
+    static const size_t RECORD_HEADER_LENGTH = 10;
+    /// the most values a record can hold
+    static const size_t MAX_COUNT = 0xFFFF;
+
+    enum Type
+    {
+        TYPE_UNKNOWN = 0,
+        TYPE_INT8,
+        TYPE_UINT8,
+        TYPE_INT16,
+        TYPE_UINT16,
+        TYPE_INT32,
+        TYPE_UINT32,
+        TYPE_INT64,
+        TYPE_UINT64,
+        TYPE_FLOAT32,
+        TYPE_FLOAT64,
+        TYPE_RECORD
+    };
+
+    /// one field of a LOG_RECORD struct
+    struct Column
+    {
+        const char* name;
+        Type type;
+        uint16_t offset;
+    };
+
+    /// where each field of a LOG_RECORD struct is, generated by the macro
+    struct Layout
+    {
+        const Column* columns;
+        uint16_t count;
+        uint16_t size;
+    };
+
+    /// the Type values of T are stored as
+    template<typename T>
+    static constexpr Type typeOf()
+    {
+        static_assert(std::is_arithmetic<T>::value, "binary logs only hold numbers");
+
+        return std::is_floating_point<T>::value ? (sizeof(T) == 4 ? TYPE_FLOAT32 : TYPE_FLOAT64)
+             : sizeof(T) == 1 ? (std::is_signed<T>::value ? TYPE_INT8 : TYPE_UINT8)
+             : sizeof(T) == 2 ? (std::is_signed<T>::value ? TYPE_INT16 : TYPE_UINT16)
+             : sizeof(T) == 4 ? (std::is_signed<T>::value ? TYPE_INT32 : TYPE_UINT32)
+             : (std::is_signed<T>::value ? TYPE_INT64 : TYPE_UINT64);
+    }
+
+    /// bytes per value of type, 0 if it isn't one
+    static size_t width(Type type);
+
+    /// the bytes a file of type and header starts with
+    static std::string fileHeader(Type type, const std::string& header);
+
+    /// the bytes a TYPE_RECORD file of layout starts with
+    static std::string fileHeader(const Layout& layout);
+
+    /// the column names of layout as a logHeader() line
+    static std::string columnNames(const Layout& layout);
+
+    /// the bytes a record of count values takes
+    static size_t recordLength(Type type, size_t count)
+    {
+        return RECORD_HEADER_LENGTH + count * width(type);
+    }
+
+    /**
+     * Encodes a record of the values in data as type in to out, which must
+     * hold recordLength(type, data.size()). Values of another type are
+     * converted. Returns the bytes used.
+     */
+    template<typename DataContainer>
+    static size_t encodeRecord(uint8_t* out, Type type, int64_t time_micros, const DataContainer& data);
+
+    /**
+     * Encodes a LOG_RECORD struct in to out, which must hold
+     * RECORD_HEADER_LENGTH + sizeof(Record). Returns the bytes used.
+     */
+    template<typename Record>
+    static size_t encodeRecord(uint8_t* out, int64_t time_micros, const Record& record)
+    {
+        uint16_t count = sizeof(Record);
+        memcpy(out, &time_micros, sizeof(time_micros));
+        memcpy(out + sizeof(time_micros), &count, sizeof(count));
+        memcpy(out + RECORD_HEADER_LENGTH, &record, sizeof(Record));
+        return RECORD_HEADER_LENGTH + sizeof(Record);
+    }
+
+    /**
+     * Appends the .dat line for a record from encodeRecord() of a struct
+     * with layout to out, floating point fields with precision digits after
+     * the point. Returns false, appending nothing, if the record isn't one.
+     */
+    static bool recordText(const Layout& layout, const uint8_t* record, size_t length, std::string& out,
+                           int precision = NumberFormat::DEFAULT_PRECISION);
+
+    /// what readHeader() finds at the start of a .udlog file
+    struct FileHeader
+    {
+        Type type;
+        /// the logHeader() columns, or the names of a LOG_RECORD struct's fields
+        std::string columns;
+        /// a TYPE_RECORD file's layout, the names aren't stored
+        std::vector<Column> recordColumns;
+        uint16_t recordSize;
+        /// where the first record starts
+        size_t length;
+    };
+
+    /// parses the header data starts with, false if it isn't a binary log or is cut short
+    static bool readHeader(const uint8_t* data, size_t size, FileHeader& header);
+
+    /// the time a record was logged at
+    static int64_t recordTime(const uint8_t* record)
+    {
+        int64_t time_micros;
+        memcpy(&time_micros, record, sizeof(time_micros));
+        return time_micros;
+    }
+
+    /**
+     * Appends the .dat line for the record data starts with, in a file
+     * with header, to out. Returns the record's length, or 0 if it is cut
+     * short in the size bytes available.
+     */
+    static size_t recordToText(const FileHeader& header, const uint8_t* data, size_t size, std::string& out);
+
+    /**
+     * Writes the .dat text for a whole .udlog file to out. Returns false if
+     * data isn't a binary log, a record cut short at the end is left out.
+     */
+    static bool toText(const uint8_t* data, size_t size, std::ostream& out);
+
+    /**
+     * Converts the .udlog file at path to text beside it, the name it would
+     * have had as a text log. Returns the path written or "" on failure.
+     */
+    static std::string convertFile(const std::string& path);
+
+private:
+    template<typename T>
+    static void put(uint8_t* out, Type type, T value);
+};
+
+template<typename T>
+void BinaryLog::put(uint8_t* out, Type type, T value)
+{
+    switch(type)
+    {
+#define BINARY_LOG_PUT(TYPE, CTYPE) \
+    case TYPE: \
+    { \
+        CTYPE converted = static_cast<CTYPE>(value); \
+        memcpy(out, &converted, sizeof(converted)); \
+        break; \
+    }
+    BINARY_LOG_PUT(TYPE_INT8, int8_t)
+    BINARY_LOG_PUT(TYPE_UINT8, uint8_t)
+    BINARY_LOG_PUT(TYPE_INT16, int16_t)
+    BINARY_LOG_PUT(TYPE_UINT16, uint16_t)
+    BINARY_LOG_PUT(TYPE_INT32, int32_t)
+    BINARY_LOG_PUT(TYPE_UINT32, uint32_t)
+    BINARY_LOG_PUT(TYPE_INT64, int64_t)
+    BINARY_LOG_PUT(TYPE_UINT64, uint64_t)
+    BINARY_LOG_PUT(TYPE_FLOAT32, float)
+    BINARY_LOG_PUT(TYPE_FLOAT64, double)
+#undef BINARY_LOG_PUT
+    default:
+        break;
+    }
+}
+
+template<typename DataContainer>
+size_t BinaryLog::encodeRecord(uint8_t* out, Type type, int64_t time_micros, const DataContainer& data)
+{
+    size_t value_width = width(type);
+    uint8_t* values = out + RECORD_HEADER_LENGTH;
+    uint16_t count = 0;
+
+    for (typename DataContainer::const_iterator it = data.begin(); it != data.end() && count < MAX_COUNT; ++it)
+    {
+        put(values, type, *it);
+        values += value_width;
+        count++;
+    }
+
+    memcpy(out, &time_micros, sizeof(time_micros));
+    memcpy(out + sizeof(time_micros), &count, sizeof(count));
+    return values - out;
+}
+
+#endif /* BINARY_LOG_H_ */
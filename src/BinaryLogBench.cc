@@ -0,0 +1,157 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "BinaryLog.h"
+#include "NumberFormat.h"
+#include "AllocationCounter.h"
+#include "Benchmark.h"
+
+#include <sstream>
+#include <vector>
+
+namespace
+{
+const int SAMPLES = 100000;
+
+/// nine doubles like the attitude PID error states, a bit different every sample
+std::vector<double> sample(int i)
+{
+    std::vector<double> data(9);
+    for(size_t j = 0; j < data.size(); j++)
+    {
+        data[j] = (i % 1000) * 0.001234 - j * 0.5 + 1e-5 * i;
+    }
+    return data;
+}
+
+void report(Benchmark& bench, uint64_t elapsed, uint64_t bytes, uint64_t allocations)
+{
+    bench.report("ns_per_sample", elapsed / static_cast<double>(SAMPLES), "ns/sample");
+    bench.report("lines_per_second", SAMPLES / (elapsed / 1e9), "lines/s");
+    bench.report("bytes_per_sample", bytes / static_cast<double>(SAMPLES), "B/sample");
+    bench.report("allocations_per_sample", allocations / static_cast<double>(SAMPLES), "allocations/sample");
+}
+}
+
+// LogFile::logData then LogFile::logMessage as text, the way they were before NumberFormat
+BENCHMARK(LogFormat, Text)
+{
+    std::vector<std::vector<double> > samples;
+    for(int i = 0; i < SAMPLES; i++)
+    {
+        samples.push_back(sample(i));
+    }
+
+    uint64_t bytes = 0;
+    uint64_t allocations = AllocationCounter::allocations();
+    uint64_t start = Benchmark::nowNanos();
+    for(int i = 0; i < SAMPLES; i++)
+    {
+        std::stringstream output;
+        for(double value : samples[i])
+        {
+            output << std::to_string(value);
+            output << '\t';
+        }
+
+        std::stringstream dataStr;
+        dataStr << static_cast<long>(i * 10000) << '\t';
+        dataStr << output.str();
+        dataStr << std::endl;
+        bytes += dataStr.str().size();
+    }
+    uint64_t elapsed = Benchmark::nowNanos() - start;
+
+    report(bench, elapsed, bytes, AllocationCounter::allocations() - allocations);
+}
+
+namespace
+{
+/// the text LogChannel::log builds now, digits after the point
+void textLines(Benchmark& bench, int precision)
+{
+    std::vector<std::vector<double> > samples;
+    for(int i = 0; i < SAMPLES; i++)
+    {
+        samples.push_back(sample(i));
+    }
+
+    uint64_t bytes = 0;
+    uint64_t allocations = AllocationCounter::allocations();
+    uint64_t start = Benchmark::nowNanos();
+    for(int i = 0; i < SAMPLES; i++)
+    {
+        TextLine line;
+        line.appendNumber(static_cast<int64_t>(i * 10000), 0);
+        line.append('\t');
+        for(double value : samples[i])
+        {
+            line.appendNumber(value, precision);
+            line.append('\t');
+        }
+        line.append('\n');
+        bytes += line.size();
+    }
+    uint64_t elapsed = Benchmark::nowNanos() - start;
+
+    report(bench, elapsed, bytes, AllocationCounter::allocations() - allocations);
+}
+}
+
+// the same line as Text, written straight in to a buffer
+BENCHMARK(LogFormat, TextNumberFormat)
+{
+    textLines(bench, NumberFormat::DEFAULT_PRECISION);
+}
+
+// a channel that only needs millimetres or milliradians
+BENCHMARK(LogFormat, TextNumberFormat3Digits)
+{
+    textLines(bench, 3);
+}
+
+BENCHMARK(LogFormat, Binary)
+{
+    std::vector<std::vector<double> > samples;
+    for(int i = 0; i < SAMPLES; i++)
+    {
+        samples.push_back(sample(i));
+    }
+
+    uint8_t record[BinaryLog::RECORD_HEADER_LENGTH + 32 * sizeof(double)];
+    uint64_t bytes = 0;
+    uint64_t allocations = AllocationCounter::allocations();
+    uint64_t start = Benchmark::nowNanos();
+    for(int i = 0; i < SAMPLES; i++)
+    {
+        bytes += BinaryLog::encodeRecord(record, BinaryLog::TYPE_FLOAT64, i * 10000, samples[i]);
+    }
+    uint64_t elapsed = Benchmark::nowNanos() - start;
+
+    report(bench, elapsed, bytes, AllocationCounter::allocations() - allocations);
+}
+
+// the same samples logged as float, what most control channels could use
+BENCHMARK(LogFormat, BinaryFloat)
+{
+    std::vector<std::vector<double> > samples;
+    for(int i = 0; i < SAMPLES; i++)
+    {
+        samples.push_back(sample(i));
+    }
+
+    uint8_t record[BinaryLog::RECORD_HEADER_LENGTH + 32 * sizeof(double)];
+    uint64_t bytes = 0;
+    uint64_t allocations = AllocationCounter::allocations();
+    uint64_t start = Benchmark::nowNanos();
+    for(int i = 0; i < SAMPLES; i++)
+    {
+        bytes += BinaryLog::encodeRecord(record, BinaryLog::TYPE_FLOAT32, i * 10000, samples[i]);
+    }
+    uint64_t elapsed = Benchmark::nowNanos() - start;
+
+    report(bench, elapsed, bytes, AllocationCounter::allocations() - allocations);
+}
@@ -0,0 +1,144 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "BinaryLog.h"
+#include <gtest/gtest.h>
+
+#include <array>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include <stdio.h>
+#include <unistd.h>
+
+namespace
+{
+/// a binary log in memory
+struct Channel
+{
+    BinaryLog::Type type;
+    std::string bytes;
+
+    Channel(BinaryLog::Type type, const std::string& header)
+    :type(type),
+     bytes(BinaryLog::fileHeader(type, header))
+    {}
+
+    template<typename DataContainer>
+    void log(int64_t time_micros, const DataContainer& data)
+    {
+        std::vector<uint8_t> record(BinaryLog::recordLength(type, data.size()));
+        size_t length = BinaryLog::encodeRecord(record.data(), type, time_micros, data);
+        bytes.append(reinterpret_cast<const char*>(record.data()), length);
+    }
+
+    std::string text() const
+    {
+        std::stringstream out;
+        EXPECT_TRUE(BinaryLog::toText(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size(), out));
+        return out.str();
+    }
+};
+
+/// what LogFile::logData and LogfileWriter would have written as text
+template<typename DataContainer>
+std::string textLine(int64_t time_micros, const DataContainer& data)
+{
+    std::stringstream output;
+    output << time_micros << '\t';
+    for (typename DataContainer::const_iterator it = data.begin(); it != data.end(); ++it)
+    {
+        output << std::to_string(*it);
+        output << '\t';
+    }
+    output << std::endl;
+    return output.str();
+}
+}
+
+TEST(BinaryLog, TypeOf)
+{
+    EXPECT_EQ(BinaryLog::TYPE_FLOAT32, BinaryLog::typeOf<float>());
+    EXPECT_EQ(BinaryLog::TYPE_FLOAT64, BinaryLog::typeOf<double>());
+    EXPECT_EQ(BinaryLog::TYPE_UINT16, BinaryLog::typeOf<uint16_t>());
+    EXPECT_EQ(BinaryLog::TYPE_INT32, BinaryLog::typeOf<int>());
+    EXPECT_EQ(BinaryLog::TYPE_INT64, BinaryLog::typeOf<long long>());
+    EXPECT_EQ(BinaryLog::TYPE_UINT8, BinaryLog::typeOf<bool>());
+}
+
+TEST(BinaryLog, TextMatchesTextLogs)
+{
+    std::vector<float> attitude = {0.1f, -0.25f, 3.14159f, 1e-7f, -12345.678f};
+    std::array<uint16_t, 3> pulses = {{1100, 1500, 1900}};
+
+    Channel floats(BinaryLog::TYPE_FLOAT32, "roll\tpitch\tyaw\tx\ty");
+    floats.log(0, std::vector<float>());
+    floats.log(1234, attitude);
+    floats.log(-5, attitude);
+
+    Channel words(BinaryLog::TYPE_UINT16, "CH1(us)\tCH2(us)\tCH3(us)");
+    words.log(99, pulses);
+
+    EXPECT_EQ("Time(micros)\troll\tpitch\tyaw\tx\ty\n" +
+              textLine(0, std::vector<float>()) + textLine(1234, attitude) + textLine(-5, attitude),
+              floats.text());
+    EXPECT_EQ("Time(micros)\tCH1(us)\tCH2(us)\tCH3(us)\n" + textLine(99, pulses), words.text());
+}
+
+TEST(BinaryLog, ConvertsToTheChannelType)
+{
+    Channel channel(BinaryLog::TYPE_FLOAT64, "");
+    channel.log(1, std::vector<int>{1, -2});
+
+    EXPECT_EQ("Time(micros)\t\n" + textLine(1, std::vector<double>{1.0, -2.0}), channel.text());
+    EXPECT_EQ(BinaryLog::MAGIC_LENGTH + 1 + 4 + BinaryLog::RECORD_HEADER_LENGTH + 2 * 8, channel.bytes.size());
+}
+
+TEST(BinaryLog, DropsARecordCutShort)
+{
+    Channel channel(BinaryLog::TYPE_INT32, "a");
+    channel.log(1, std::vector<int>{7});
+    channel.log(2, std::vector<int>{8});
+    channel.bytes.resize(channel.bytes.size() - 1);
+
+    EXPECT_EQ("Time(micros)\ta\n" + textLine(1, std::vector<int>{7}), channel.text());
+}
+
+TEST(BinaryLog, RejectsOtherFiles)
+{
+    std::string text = "Time(micros)\tnot binary\n";
+    std::stringstream out;
+    EXPECT_FALSE(BinaryLog::toText(reinterpret_cast<const uint8_t*>(text.data()), text.size(), out));
+    EXPECT_EQ("", BinaryLog::convertFile("not_a_binary_log.dat"));
+}
+
+TEST(BinaryLog, ConvertFile)
+{
+    char folder[] = "/tmp/binary_log_XXXXXX";
+    ASSERT_NE(nullptr, mkdtemp(folder));
+    std::string plain = std::string(folder) + "/Control Effort.udlog";
+    std::string named = std::string(folder) + "/messages.txt.udlog";
+
+    Channel channel(BinaryLog::TYPE_FLOAT32, "a\tb");
+    channel.log(10, std::vector<float>{1.5f, 2.5f});
+    std::ofstream(plain.c_str(), std::ios::binary) << channel.bytes;
+    std::ofstream(named.c_str(), std::ios::binary) << channel.bytes;
+
+    EXPECT_EQ(std::string(folder) + "/Control Effort.dat", BinaryLog::convertFile(plain));
+    EXPECT_EQ(std::string(folder) + "/messages.txt", BinaryLog::convertFile(named));
+
+    std::ifstream converted((std::string(folder) + "/Control Effort.dat").c_str());
+    std::stringstream text;
+    text << converted.rdbuf();
+    EXPECT_EQ(channel.text(), text.str());
+
+    unlink(plain.c_str());
+    unlink(named.c_str());
+    unlink((std::string(folder) + "/Control Effort.dat").c_str());
+    unlink((std::string(folder) + "/messages.txt").c_str());
+    rmdir(folder);
+}
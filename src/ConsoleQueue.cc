@@ -0,0 +1,182 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#include "ConsoleQueue.h"
+
+/* STL Headers */
+#include <algorithm>
+
+/* C Headers */
+#include <string.h>
+
+namespace
+{
+/// FNV-1a, so most differing messages are told apart without comparing text
+uint32_t hashText(const char* text, size_t length)
+{
+    uint32_t hash = 2166136261u;
+    for(size_t i = 0; i < length; i++)
+    {
+        hash = (hash ^ static_cast<uint8_t>(text[i])) * 16777619u;
+    }
+    return hash;
+}
+}
+
+const size_t ConsoleQueue::TEXT_LENGTH;
+
+ConsoleQueue::ConsoleQueue(size_t capacity, size_t pending, uint64_t repeat_ms)
+    :_warnings(capacity),
+     _critical(capacity),
+     _pendingCapacity(std::max<size_t>(1, pending)),
+     _repeatMs(repeat_ms),
+     _sequence(0),
+     _dropped(0),
+     _coalesced(0)
+{
+    _pending.reserve(_pendingCapacity);
+}
+
+bool ConsoleQueue::push(Debug::DEBUG_LEVEL level, const std::string& text)
+{
+    MpscRing<Slot>* ring;
+    if(level == Debug::CRITICAL)
+    {
+        ring = &_critical;
+    }
+    else if(level == Debug::WARNING)
+    {
+        ring = &_warnings;
+    }
+    else
+    {
+        return false;
+    }
+
+    size_t length = std::min(text.size(), TEXT_LENGTH);
+    bool pushed = ring->push([&](Slot& slot)
+    {
+        memcpy(slot.text, text.data(), length);
+        slot.length = length;
+        slot.hash = hashText(slot.text, length);
+    });
+
+    if(! pushed)
+    {
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+    return pushed;
+}
+
+void ConsoleQueue::drain(Debug::DEBUG_LEVEL level, MpscRing<Slot>& ring)
+{
+    while(ring.pop([&](Slot& slot){ add(level, slot); }))
+    {
+    }
+}
+
+void ConsoleQueue::add(Debug::DEBUG_LEVEL level, const Slot& slot)
+{
+    for(Pending& pending : _pending)
+    {
+        if(pending.level == level && pending.slot.hash == slot.hash && pending.slot.length == slot.length &&
+           memcmp(pending.slot.text, slot.text, slot.length) == 0)
+        {
+            if(pending.count > 0)
+            {
+                _coalesced.fetch_add(1, std::memory_order_relaxed);
+            }
+            pending.count++;
+            return;
+        }
+    }
+
+    if(_pending.size() >= _pendingCapacity)
+    {
+        // only waiting on repeats costs nothing to forget, after that the least severe, newest message goes
+        std::vector<Pending>::iterator victim = _pending.end();
+        for(std::vector<Pending>::iterator it = _pending.begin(); it != _pending.end(); ++it)
+        {
+            if(it->count == 0)
+            {
+                victim = it;
+                break;
+            }
+            if(it->level < level && (victim == _pending.end() || it->level < victim->level ||
+                                     (it->level == victim->level && it->sequence > victim->sequence)))
+            {
+                victim = it;
+            }
+        }
+
+        if(victim == _pending.end())
+        {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        _dropped.fetch_add(victim->count, std::memory_order_relaxed);
+        _pending.erase(victim);
+    }
+
+    Pending pending;
+    pending.level = level;
+    pending.slot = slot;
+    pending.count = 1;
+    pending.sequence = _sequence++;
+    pending.sent = false;
+    pending.sent_ms = 0;
+    _pending.push_back(pending);
+}
+
+bool ConsoleQueue::pop(uint64_t now_ms, Message& message)
+{
+    drain(Debug::CRITICAL, _critical);
+    drain(Debug::WARNING, _warnings);
+
+    // messages that have gone quiet since they were sent
+    _pending.erase(std::remove_if(_pending.begin(), _pending.end(), [&](const Pending& pending)
+    {
+        return pending.count == 0 && now_ms >= pending.sent_ms + _repeatMs;
+    }), _pending.end());
+
+    Pending* next = nullptr;
+    for(Pending& pending : _pending)
+    {
+        if(due(pending, now_ms) && (next == nullptr || pending.level > next->level ||
+                                    (pending.level == next->level && pending.sequence < next->sequence)))
+        {
+            next = &pending;
+        }
+    }
+
+    if(next == nullptr)
+    {
+        return false;
+    }
+
+    message.level = next->level;
+    message.text.assign(next->slot.text, next->slot.length);
+    message.count = next->count;
+
+    next->count = 0;
+    next->sent = true;
+    next->sent_ms = now_ms;
+    // repeats now wait behind anything new
+    next->sequence = _sequence++;
+    return true;
+}
+
+std::string ConsoleQueue::statusText(const Message& message)
+{
+    if(message.count <= 1)
+    {
+        return message.text.substr(0, TEXT_LENGTH);
+    }
+
+    std::string suffix = " (x" + std::to_string(message.count) + ")";
+    return message.text.substr(0, TEXT_LENGTH - std::min(TEXT_LENGTH, suffix.size())) + suffix;
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#ifndef CONSOLE_QUEUE_H_
+#define CONSOLE_QUEUE_H_
+
+/* STL Headers */
+#include <atomic>
+#include <string>
+#include <vector>
+
+/* C Headers */
+#include <stdint.h>
+#include <stddef.h>
+
+/* Project Headers */
+#include "Debug.h"
+#include "MpscRing.h"
+
+/**
+ * @brief The warnings and critical messages waiting to go to the ground
+ * station console.
+ *
+ * QGCSend can only send one STATUSTEXT every loop, so a sensor fault
+ * repeating the same warning would otherwise queue it faster than it goes
+ * out and everything after it would arrive seconds late.
+ *
+ * push() copies the first TEXT_LENGTH characters, all a STATUSTEXT holds,
+ * in to a fixed ring for the level: one compare and swap, no lock and no
+ * allocation. A full ring drops the message and counts it, and critical
+ * messages have a ring of their own so warnings can't crowd them out.
+ *
+ * pop() is for the one sending thread. It moves what was pushed in to a
+ * short table of messages waiting to be sent, where the same text at the
+ * same level becomes one entry with a count. Critical messages go before
+ * warnings, then the oldest first. Once a message has been sent, repeats of
+ * it wait repeat_ms and go out together as "text (xN)". When the table is
+ * full a new message pushes out a less severe one, or is dropped.
+ */
+class ConsoleQueue
+{
+public:
+    /// the characters a STATUSTEXT carries
+    static const size_t TEXT_LENGTH = 50;
+
+    struct Message
+    {
+        Debug::DEBUG_LEVEL level;
+        std::string text;
+        /// how many times it was pushed since it was last sent
+        uint32_t count;
+    };
+
+    /**
+     * capacity messages of each level can wait to be taken by pop(), pending
+     * different ones can wait to be sent.
+     */
+    ConsoleQueue(size_t capacity, size_t pending, uint64_t repeat_ms);
+
+    /**
+     * Queues text if level is WARNING or CRITICAL, returns false if it was
+     * dropped or isn't either. Safe from any thread.
+     */
+    bool push(Debug::DEBUG_LEVEL level, const std::string& text);
+
+    /**
+     * The next message to send at now_ms, false if nothing is due. Only
+     * call from one thread.
+     */
+    bool pop(uint64_t now_ms, Message& message);
+
+    /// message.text with its count, cut to fit in a STATUSTEXT
+    static std::string statusText(const Message& message);
+
+    /// messages dropped because a ring or the pending table was full
+    uint64_t dropped() const
+    {
+        return _dropped.load(std::memory_order_relaxed);
+    }
+
+    /// messages folded in to one already waiting
+    uint64_t coalesced() const
+    {
+        return _coalesced.load(std::memory_order_relaxed);
+    }
+
+private:
+    ConsoleQueue(const ConsoleQueue&);
+    ConsoleQueue& operator=(const ConsoleQueue&);
+
+    struct Slot
+    {
+        uint32_t hash;
+        uint8_t length;
+        char text[TEXT_LENGTH];
+    };
+
+    /// a message waiting to be sent, or sent recently enough that its repeats wait
+    struct Pending
+    {
+        Debug::DEBUG_LEVEL level;
+        Slot slot;
+        uint32_t count;
+        /// the order it arrived in
+        uint64_t sequence;
+        bool sent;
+        uint64_t sent_ms;
+    };
+
+    /// moves everything pushed in to _pending
+    void drain(Debug::DEBUG_LEVEL level, MpscRing<Slot>& ring);
+    void add(Debug::DEBUG_LEVEL level, const Slot& slot);
+
+    /// true if pending has repeats and its last send was long enough ago
+    bool due(const Pending& pending, uint64_t now_ms) const
+    {
+        return pending.count > 0 && (! pending.sent || now_ms >= pending.sent_ms + _repeatMs);
+    }
+
+    MpscRing<Slot> _warnings;
+    MpscRing<Slot> _critical;
+
+    /// only touched by pop()
+    std::vector<Pending> _pending;
+    size_t _pendingCapacity;
+    uint64_t _repeatMs;
+    uint64_t _sequence;
+
+    std::atomic<uint64_t> _dropped;
+    std::atomic<uint64_t> _coalesced;
+};
+
+#endif /* CONSOLE_QUEUE_H_ */
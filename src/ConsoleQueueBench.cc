@@ -0,0 +1,48 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "ConsoleQueue.h"
+#include "AllocationCounter.h"
+#include "Benchmark.h"
+
+#include <string>
+
+namespace
+{
+const int MESSAGES = 100000;
+/// what QGCSend sends in a second at one message every 5 ms
+const int SENDS_PER_SECOND = 200;
+}
+
+// an IMU fault repeating one warning as fast as it can, drained like QGCSend does
+BENCHMARK(ConsoleQueue, RepeatedWarning)
+{
+    ConsoleQueue queue(64, 16, 1000);
+    std::string warning = "Warning:  IMU: checksum failure";
+    ConsoleQueue::Message message;
+
+    uint64_t sent = 0;
+    uint64_t allocations = AllocationCounter::allocations();
+    uint64_t start = Benchmark::nowNanos();
+    for(int i = 0; i < MESSAGES; i++)
+    {
+        queue.push(Debug::WARNING, warning);
+        // a send every 50 messages, the fault out running the link
+        if(i % 50 == 0)
+        {
+            sent += queue.pop(i / 50 * 1000 / SENDS_PER_SECOND, message);
+        }
+    }
+    uint64_t elapsed = Benchmark::nowNanos() - start;
+
+    bench.report("ns_per_message", elapsed / static_cast<double>(MESSAGES), "ns/message");
+    bench.report("allocations_per_message",
+                 (AllocationCounter::allocations() - allocations) / static_cast<double>(MESSAGES),
+                 "allocations/message");
+    bench.report("sent", sent, "messages");
+    bench.report("coalesced", queue.coalesced(), "messages");
+    bench.report("dropped", queue.dropped(), "messages");
+}
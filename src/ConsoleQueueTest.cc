@@ -0,0 +1,120 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "ConsoleQueue.h"
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(ConsoleQueue, CoalescesRepeats)
+{
+    ConsoleQueue queue(64, 8, 1000);
+    for(int i = 0; i < 20; i++)
+    {
+        ASSERT_TRUE(queue.push(Debug::WARNING, "Warning:  IMU: checksum failure"));
+    }
+
+    ConsoleQueue::Message message;
+    ASSERT_TRUE(queue.pop(0, message));
+    EXPECT_EQ(20u, message.count);
+    EXPECT_EQ("Warning:  IMU: checksum failure (x20)", ConsoleQueue::statusText(message));
+    EXPECT_EQ(19u, queue.coalesced());
+
+    // repeats after it was sent wait out the repeat time
+    for(int i = 0; i < 5; i++)
+    {
+        queue.push(Debug::WARNING, "Warning:  IMU: checksum failure");
+    }
+    EXPECT_FALSE(queue.pop(500, message));
+    ASSERT_TRUE(queue.pop(1000, message));
+    EXPECT_EQ(5u, message.count);
+
+    // and once it goes quiet the next one goes straight out
+    EXPECT_FALSE(queue.pop(2000, message));
+    queue.push(Debug::WARNING, "Warning:  IMU: checksum failure");
+    ASSERT_TRUE(queue.pop(2001, message));
+    EXPECT_EQ(1u, message.count);
+    EXPECT_EQ("Warning:  IMU: checksum failure", ConsoleQueue::statusText(message));
+    EXPECT_EQ(0u, queue.dropped());
+}
+
+TEST(ConsoleQueue, CriticalFirstThenOldest)
+{
+    ConsoleQueue queue(64, 8, 1000);
+    queue.push(Debug::WARNING, "first warning");
+    queue.push(Debug::WARNING, "second warning");
+    queue.push(Debug::CRITICAL, "critical");
+    EXPECT_FALSE(queue.push(Debug::MESSAGE, "info never goes to the console"));
+
+    std::vector<std::string> sent;
+    ConsoleQueue::Message message;
+    while(queue.pop(0, message))
+    {
+        sent.push_back(message.text);
+    }
+
+    std::vector<std::string> expected = {"critical", "first warning", "second warning"};
+    EXPECT_EQ(expected, sent);
+}
+
+TEST(ConsoleQueue, BoundedAndCounted)
+{
+    ConsoleQueue queue(16, 4, 1000);
+    for(int i = 0; i < 100; i++)
+    {
+        queue.push(Debug::WARNING, "warning " + std::to_string(i));
+    }
+    queue.push(Debug::CRITICAL, "critical");
+
+    // the ring held 16 warnings, the critical message went in to the table first and 3 warnings fit behind it
+    EXPECT_EQ(84u, queue.dropped());
+    ConsoleQueue::Message message;
+    ASSERT_TRUE(queue.pop(0, message));
+    EXPECT_EQ(84u + 13u, queue.dropped());
+
+    EXPECT_EQ("critical", message.text);
+    int warnings = 0;
+    while(queue.pop(0, message))
+    {
+        warnings++;
+    }
+    EXPECT_EQ(3, warnings);
+}
+
+TEST(ConsoleQueue, LongTextKeepsItsCount)
+{
+    ConsoleQueue::Message message = {Debug::WARNING, std::string(80, 'a'), 123};
+    std::string text = ConsoleQueue::statusText(message);
+    EXPECT_EQ(ConsoleQueue::TEXT_LENGTH, text.size());
+    EXPECT_EQ(" (x123)", text.substr(text.size() - 7));
+}
+
+TEST(ConsoleQueue, ManyProducers)
+{
+    ConsoleQueue queue(1024, 8, 1000);
+    std::vector<std::thread> producers;
+    for(int t = 0; t < 4; t++)
+    {
+        producers.push_back(std::thread([&queue]
+        {
+            for(int i = 0; i < 200; i++)
+            {
+                queue.push(Debug::WARNING, "repeated");
+            }
+        }));
+    }
+    for(std::thread& producer : producers)
+    {
+        producer.join();
+    }
+
+    ConsoleQueue::Message message;
+    ASSERT_TRUE(queue.pop(0, message));
+    EXPECT_EQ(800u, message.count);
+    EXPECT_FALSE(queue.pop(0, message));
+}
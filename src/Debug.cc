@@ -18,6 +18,7 @@
  *     along with ANCL Autopilot.  If not, see <http://www.gnu.org/licenses/>.
  *************************************************************************/
 
+#include <stdlib.h>
 #include <string.h>
 #include <mutex> // c++11
 #include <iostream>
@@ -28,6 +29,7 @@
 
 /* Project Headers */
 #include "Debug.h"
+#include "DebugSink.h"
 #include "LogFile.h"
 
 #include "QGCSend.h"
@@ -42,17 +44,54 @@ const char* ARRAY_SEPARATOR = ", ";
 const char* NUMBER_SEPARATOR = " ";
 
 
-Debug::Debug(DEBUG_LEVEL lvl, std::string prefix)
+/// messages waiting for the sink thread, more than this and debug and info messages are dropped
+const size_t SINK_CAPACITY = 1024;
+
+DebugSink* Debug::sink()
+{
+    // never destroyed, threads may still be logging while the program exits
+    static DebugSink* instance = nullptr;
+    static std::once_flag started;
+    std::call_once(started, []
+    {
+        instance = new DebugSink(&Debug::deliver, SINK_CAPACITY);
+        std::atexit(&Debug::flush);
+    });
+    return instance;
+}
+
+Debug::Debug(DEBUG_LEVEL lvl, const std::string& prefix)
     :debug_level(lvl)
 {
+    if(! delivers(debug_level))
+    {
+        return;
+    }
+
+    ss.reset(new std::stringstream());
     appendLevel();
-    ss << prefix;
+    *ss << prefix;
 }
 
 Debug::Debug(const Debug& other)
     :debug_level(other.debug_level)
 {
-    ss << other.ss.rdbuf();
+    if(other.ss)
+    {
+        ss.reset(new std::stringstream());
+        *ss << other.ss->str();
+    }
+}
+
+Debug::Debug(Debug&& other)
+    :ss(std::move(other.ss)),
+     debug_level(other.debug_level)
+{
+}
+
+void Debug::flush()
+{
+    sink()->flush();
 }
 
 void Debug::appendLevel()
@@ -60,34 +99,47 @@ void Debug::appendLevel()
     switch(debug_level)
     {
     case WARNING:
-        ss << "Warning:  ";
+        *ss << "Warning:  ";
         break;
     case CRITICAL:
-        ss << "Critical: ";
+        *ss << "Critical: ";
         break;
     case MESSAGE:
-        ss << "Info:  ";
+        *ss << "Info:  ";
         break;
     case DEBUG:
-        ss << "Debug:    ";
+        *ss << "Debug:    ";
         break;
     case IGNORE:
-        ss << "Ignore:   ";
+        *ss << "Ignore:   ";
         break;
     default:
-        ss << "UNKNOWN:  ";
+        *ss << "UNKNOWN:  ";
     }
 }
 
 Debug::~Debug()
 {
-    if(debug_level == IGNORE)
+    if(! ss)
     {
         return;
     }
 
-    std::string message = ss.str();
+    std::string message = ss->str();
+    if(sink()->post(debug_level, message))
+    {
+        return;
+    }
+
+    // the sink is full, don't lose anything that matters
+    if(debug_level >= WARNING)
+    {
+        deliver(debug_level, message);
+    }
+}
 
+void Debug::deliver(DEBUG_LEVEL debug_level, const std::string& message)
+{
 #ifndef NDEBUG
     std::string linecolor = "";
     switch(debug_level)
@@ -134,7 +186,7 @@ Debug::~Debug()
         {
             lf->logMessage(LOGFILE_NAME, message);
         }
-        QGCSend::getInstance()->message_queue_push(message);
+        QGCSend::getInstance()->message_queue_push(debug_level, message);
         break;
 
     case MESSAGE:
@@ -156,96 +208,177 @@ Debug::~Debug()
 
 Debug& Debug::operator<<(const std::string& s)
 {
-    ss << s;
+    if(! ss)
+    {
+        return *this;
+    }
+
+    *ss << s;
     return *this;
 }
 
 Debug& Debug::operator<<(const char* c)
 {
-    ss << c;
+    if(! ss)
+    {
+        return *this;
+    }
+
+    *ss << c;
     return *this;
 }
 
 Debug& Debug::operator<<(const int i)
 {
-    ss << NUMBER_SEPARATOR << i << NUMBER_SEPARATOR;
+    if(! ss)
+    {
+        return *this;
+    }
+
+    *ss << NUMBER_SEPARATOR << i << NUMBER_SEPARATOR;
     return *this;
 }
 
 Debug& Debug::operator<<(const unsigned int i)
 {
-    ss << NUMBER_SEPARATOR << i << NUMBER_SEPARATOR;
+    if(! ss)
+    {
+        return *this;
+    }
+
+    *ss << NUMBER_SEPARATOR << i << NUMBER_SEPARATOR;
     return *this;
 }
 
 Debug& Debug::operator<<(const unsigned long i)
 {
-    ss << NUMBER_SEPARATOR << i << NUMBER_SEPARATOR;
+    if(! ss)
+    {
+        return *this;
+    }
+
+    *ss << NUMBER_SEPARATOR << i << NUMBER_SEPARATOR;
     return *this;
 }
 
 Debug& Debug::operator<<(const double d)
 {
-    ss << NUMBER_SEPARATOR << d << NUMBER_SEPARATOR;
+    if(! ss)
+    {
+        return *this;
+    }
+
+    *ss << NUMBER_SEPARATOR << d << NUMBER_SEPARATOR;
     return *this;
 }
 
 Debug& Debug::operator<<(std::ios_base& (*pf)(std::ios_base&))
 {
-    ss << pf;
+    if(! ss)
+    {
+        return *this;
+    }
+
+    *ss << pf;
     return *this;
 }
 
 Debug& Debug::operator<<(std::ostream& (*pf)(std::ostream&))
 {
-    ss << pf;
+    if(! ss)
+    {
+        return *this;
+    }
+
+    *ss << pf;
     return *this;
 }
 
 
 Debug& Debug::operator<<(const std::vector<uint8_t>& v)
 {
-    ss << "[";
+    if(! ss)
+    {
+        return *this;
+    }
+
+    *ss << "[";
     for (size_t i = 0; i<v.size(); i++)
     {
         // TODO check to see if the cast to an int rather than a uint ever gets to the range of errors. - Joseph
-        ss << static_cast<int>(v[i]);
+        *ss << static_cast<int>(v[i]);
         if (i < v.size() - 1)
         {
-            ss << ARRAY_SEPARATOR;
+            *ss << ARRAY_SEPARATOR;
         }
     }
-    ss << "]";
+    *ss << "]";
     return *this;
 }
 
 Debug& Debug::operator<<(const void* ptr)
 {
-    ss << std::hex << ptr << std::dec;
+    if(! ss)
+    {
+        return *this;
+    }
+
+    *ss << std::hex << ptr << std::dec;
     return *this;
 }
 
 
+Debug& Debug::operator<<(const Mat3& m)
+{
+    if(! ss)
+    {
+        return *this;
+    }
+
+    *ss << m;
+    return *this;
+}
+
 Debug& Debug::operator<<(const boost::numeric::ublas::vector<float>& v)
 {
-    ss << v;
+    if(! ss)
+    {
+        return *this;
+    }
+
+    *ss << v;
     return *this;
 }
 
 Debug& Debug::operator<<(const boost::numeric::ublas::matrix<float>& m)
 {
-    ss << m;
+    if(! ss)
+    {
+        return *this;
+    }
+
+    *ss << m;
     return *this;
 }
 
 Debug& Debug::operator<<(const boost::numeric::ublas::vector<double>& v)
 {
-    ss << v;
+    if(! ss)
+    {
+        return *this;
+    }
+
+    *ss << v;
     return *this;
 }
 
 Debug& Debug::operator<<(const boost::numeric::ublas::matrix<double>& m)
 {
-    ss << m;
+    if(! ss)
+    {
+        return *this;
+    }
+
+    *ss << m;
     return *this;
 }
@@ -22,6 +22,7 @@
 
 /* STL Headers */
 #include <iosfwd>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -30,6 +31,11 @@
 /* Boost Headers */
 #include <boost/numeric/ublas/fwd.hpp>
 
+/* Project Headers */
+#include "FixedMath.h"
+
+class DebugSink;
+
 
 /** @brief Implements a debugging object similar to QDebug @see http://doc.qt.nokia.com/latest/qdebug.html
  *
@@ -42,6 +48,11 @@
  * version as well as the debugging version.  In addition, in these modes the message is also sent to the log
  * file messages.log.
  *
+ * Printing and logging happen on a DebugSink thread, the thread writing the
+ * message only formats it. A message at a level that isn't delivered doesn't
+ * format anything, and the LOGGER_ macros below skip evaluating its
+ * arguments too, use them on paths that run for every packet.
+ *
  * @author Bryan Godbolt <godbolt@ece.ualberta.ca>
  * @date November 7, 2011
  * @b Example:
@@ -83,9 +94,24 @@ public:
         WARNING=3,
         CRITICAL=4
     };
-    explicit Debug(DEBUG_LEVEL debug_level = DEBUG, std::string prefix = "");
+    explicit Debug(DEBUG_LEVEL debug_level = DEBUG, const std::string& prefix = "");
     Debug(const Debug& other);
+    Debug(Debug&& other);
     ~Debug();
+
+    /// true if messages at level go anywhere, IGNORE never does and DEBUG only in debug builds
+    static bool delivers(DEBUG_LEVEL level)
+    {
+#ifdef NDEBUG
+        return level > DEBUG;
+#else
+        return level > IGNORE;
+#endif
+    }
+
+    /// waits until every message so far has been printed and logged
+    static void flush();
+
     Debug& operator<<(const std::string& s);
     Debug& operator<<(const char* c);
     Debug& operator<<(const int i);
@@ -98,6 +124,9 @@ public:
     Debug& operator<<(const std::array<T,N>& a);
     template <typename T>
     Debug& operator<<(const std::vector<T>& v);
+    template <size_t N>
+    Debug& operator<<(const Vector<N>& v);
+    Debug& operator<<(const Mat3& m);
     Debug& operator<<(const std::vector<uint8_t>& v);
     Debug& operator<<(std::ios_base& (*pf)(std::ios_base&));
     Debug& operator<<(std::ostream& (*pf)(std::ostream&));
@@ -111,11 +140,18 @@ private:
     static int message_count;
     static std::string last_message;
 
-    std::stringstream ss;
+    /// only made for a message that will be delivered, everything else skips the formatting
+    std::unique_ptr<std::stringstream> ss;
     DEBUG_LEVEL debug_level;
 
     /// appends the string version of the current level to the start of the message.
     void appendLevel();
+
+    /// the thread messages are handed to, started by the first message
+    static DebugSink* sink();
+
+    /// prints and logs a finished message, on the DebugSink thread unless its queue is full
+    static void deliver(DEBUG_LEVEL level, const std::string& message);
 };
 
 /** Logger is a general-purpose logging mechanism in the style of the Apache Commons
@@ -136,10 +172,14 @@ private:
     std::string _prefix;
     Debug::DEBUG_LEVEL _ignore_level; /// all levels less than this won't be printed.
 
-    Debug log(std::string initial_value, Debug::DEBUG_LEVEL desired_level) const
+    Debug log(const std::string& initial_value, Debug::DEBUG_LEVEL desired_level) const
     {
-        auto lvl = (desired_level < _ignore_level)? Debug::IGNORE : desired_level;
-        auto dbg = Debug(lvl, _prefix);
+        if(! enabled(desired_level))
+        {
+            return Debug(Debug::IGNORE);
+        }
+
+        Debug dbg(desired_level, _prefix);
         dbg << initial_value;
         return dbg;
     }
@@ -167,8 +207,17 @@ public:
         _ignore_level = (Debug::DEBUG_LEVEL) log_level;
     }
 
+    /**
+     * True if a message at level would be printed or logged. The LOGGER_
+     * macros check this before evaluating anything streamed in to the message.
+     **/
+    bool enabled(Debug::DEBUG_LEVEL level) const
+    {
+        return level >= _ignore_level && Debug::delivers(level);
+    }
+
     /** Sends an ignore message. **/
-    Debug ignore(std::string init = "") const
+    Debug ignore(const std::string& init = "") const
     {
         return log(init, Debug::IGNORE);
     }
@@ -177,7 +226,7 @@ public:
     dumps.
 
     **/
-    Debug trace(std::string init = "") const
+    Debug trace(const std::string& init = "") const
     {
         return log(init, Debug::IGNORE);
     }
@@ -187,7 +236,7 @@ public:
     Good for fine-grained messages, like locations in code or notification
     that a method ran.
     **/
-    Debug debug(std::string init = "") const
+    Debug debug(const std::string& init = "") const
     {
         return log(init, Debug::DEBUG);
     }
@@ -195,7 +244,7 @@ public:
     /**
     @deprecated - this message is deprecated in favor of info()
     **/
-    Debug message(std::string init = "") const
+    Debug message(const std::string& init = "") const
     {
         return log(init, Debug::MESSAGE);
     }
@@ -206,7 +255,7 @@ public:
      * should be noted in case of a larger problem, i.e. names of files that
      * are being opened for settings/reading/writing.
      */
-    Debug info(std::string init = "") const
+    Debug info(const std::string& init = "") const
     {
         return log(init, Debug::MESSAGE);
     }
@@ -216,7 +265,7 @@ public:
      * Warning messages denote a problem that has occured in the software that
      * may lead to unstable operation.
      */
-    Debug warning(std::string init = "") const
+    Debug warning(const std::string& init = "") const
     {
         return log(init, Debug::WARNING);
     }
@@ -226,38 +275,85 @@ public:
      * Critical messages denote a bad problem that has occured in the software
      * these errors are not recoverable and the system is unstable.
      */
-    Debug critical(std::string init = "") const
+    Debug critical(const std::string& init = "") const
     {
         return log(init, Debug::CRITICAL);
     }
 };
 
 
+/// lets the LOGGER_ macros be one expression whichever way the level check goes
+struct DebugVoidify
+{
+    void operator&(const Debug&) {}
+};
+
+/**
+ * Use these instead of logger.trace() and friends on paths that run for
+ * every packet or control cycle. When logger has the level turned off the
+ * statement is one branch and nothing streamed in to it is evaluated.
+ *
+ * @code
+ * // ecef_to_llh only runs when the message will be printed
+ * LOGGER_DEBUG(*gps) << "LLH: " << ecef_to_llh(position);
+ * @endcode
+ */
+#define LOGGER_AT(logger, level, method) \
+    ! (logger).enabled(level) ? (void) 0 : DebugVoidify() & (logger).method()
+
+#define LOGGER_TRACE(logger) LOGGER_AT(logger, Debug::IGNORE, trace)
+#define LOGGER_DEBUG(logger) LOGGER_AT(logger, Debug::DEBUG, debug)
+#define LOGGER_INFO(logger) LOGGER_AT(logger, Debug::MESSAGE, info)
+#define LOGGER_WARNING(logger) LOGGER_AT(logger, Debug::WARNING, warning)
+#define LOGGER_CRITICAL(logger) LOGGER_AT(logger, Debug::CRITICAL, critical)
+
 template <typename T, size_t N>
 Debug& Debug::operator<<(const std::array<T,N>& a)
 {
-    ss << "[";
+    if(! ss)
+    {
+        return *this;
+    }
+
+    *ss << "[";
     for (size_t i=0; i<a.size(); i++)
     {
-        ss << a[i];
+        *ss << a[i];
         if (i < a.size()-1)
-            ss << ", ";
+            *ss << ", ";
     }
-    ss << "]";
+    *ss << "]";
     return *this;
 }
 
 template <typename T>
 Debug& Debug::operator<<(const std::vector<T>& v)
 {
-    ss << "[";
+    if(! ss)
+    {
+        return *this;
+    }
+
+    *ss << "[";
     for (size_t i = 0; i<v.size(); i++)
     {
-        ss << v[i];
+        *ss << v[i];
         if (i < v.size() - 1)
-            ss << ", ";
+            *ss << ", ";
     }
-    ss << "]";
+    *ss << "]";
+    return *this;
+}
+
+template <size_t N>
+Debug& Debug::operator<<(const Vector<N>& v)
+{
+    if(! ss)
+    {
+        return *this;
+    }
+
+    *ss << v;
     return *this;
 }
 #endif
@@ -0,0 +1,136 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "Debug.h"
+#include "AllocationCounter.h"
+#include "Benchmark.h"
+
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+const int MESSAGES = 100000;
+
+/// something about as costly as GPS::ReadSerial::ecef_to_llh
+std::vector<double> to_llh(const std::vector<double>& ecef)
+{
+    std::vector<double> llh(3);
+    double p = std::sqrt(ecef[0] * ecef[0] + ecef[1] * ecef[1]);
+    llh[0] = std::atan2(ecef[2], p);
+    llh[1] = std::atan2(ecef[1], ecef[0]);
+    llh[2] = std::sqrt(p * p + ecef[2] * ecef[2]) - 6378137.0;
+    return llh;
+}
+
+/// times log(i) MESSAGES times
+template <class Log>
+void run(Benchmark& bench, Log log)
+{
+    uint64_t allocations = AllocationCounter::allocations();
+    uint64_t start = Benchmark::nowNanos();
+    for(int i = 0; i < MESSAGES; i++)
+    {
+        log(i);
+    }
+    uint64_t elapsed = Benchmark::nowNanos() - start;
+
+    bench.report("ns_per_message", elapsed / static_cast<double>(MESSAGES), "ns/message");
+    bench.report("allocations_per_message",
+                 (AllocationCounter::allocations() - allocations) / static_cast<double>(MESSAGES),
+                 "allocations/message");
+}
+}
+
+// trace() is always off, like IMU and GPS log per packet
+BENCHMARK(Logger, DisabledTrace)
+{
+    Logger logger("GPS");
+    run(bench, [&](int)
+    {
+        logger.trace() << "Received BESTXYZ data";
+    });
+}
+
+BENCHMARK(Logger, DisabledTraceDump)
+{
+    Logger logger("GPS");
+    std::vector<double> position = {-1288398.0, -4721697.0, 4078625.0};
+    run(bench, [&](int i)
+    {
+        logger.trace() << "[Message: Status: " << i << "\n"
+                       << "\tECEF position: " << position << "\n"
+                       << "\tLLH: " << to_llh(position) << "]";
+    });
+}
+
+// debug() below the logger's level, like logging_level 2
+BENCHMARK(Logger, DisabledDebug)
+{
+    Logger logger("GPS", Debug::MESSAGE);
+    run(bench, [&](int i)
+    {
+        logger.debug() << "got message " << i;
+    });
+}
+
+// the same dump through LOGGER_TRACE, nothing after the macro runs
+BENCHMARK(Logger, DisabledTraceDumpMacro)
+{
+    Logger logger("GPS");
+    std::vector<double> position = {-1288398.0, -4721697.0, 4078625.0};
+    run(bench, [&](int i)
+    {
+        LOGGER_TRACE(logger) << "[Message: Status: " << i << "\n"
+                             << "\tECEF position: " << position << "\n"
+                             << "\tLLH: " << to_llh(position) << "]";
+    });
+}
+
+BENCHMARK(Logger, DisabledDebugMacro)
+{
+    Logger logger("GPS", Debug::MESSAGE);
+    run(bench, [&](int i)
+    {
+        LOGGER_DEBUG(logger) << "got message " << i;
+    });
+}
+
+/**
+ * What the thread logging an enabled message pays, with stderr thrown away.
+ * Messages go in bursts the message queue can hold, waiting for them to be
+ * delivered in between.
+ */
+BENCHMARK(Logger, EnabledInfo)
+{
+    const int BURST = 100;
+    Logger logger("GPS");
+    std::stringstream discard;
+    std::streambuf* cerr = std::cerr.rdbuf(discard.rdbuf());
+
+    uint64_t elapsed = 0;
+    uint64_t allocations = 0;
+    for(int burst = 0; burst < MESSAGES / BURST; burst++)
+    {
+        uint64_t before = AllocationCounter::allocations();
+        uint64_t start = Benchmark::nowNanos();
+        for(int i = 0; i < BURST; i++)
+        {
+            logger.info() << "Switched to log point " << burst * BURST + i;
+        }
+        elapsed += Benchmark::nowNanos() - start;
+        allocations += AllocationCounter::allocations() - before;
+
+        Debug::flush();
+        discard.str("");
+    }
+
+    std::cerr.rdbuf(cerr);
+    bench.report("ns_per_message", elapsed / static_cast<double>(MESSAGES), "ns/message");
+    bench.report("allocations_per_message", allocations / static_cast<double>(MESSAGES), "allocations/message");
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#include "DebugSink.h"
+
+/* STL Headers */
+#include <chrono>
+
+const int DebugSink::DRAIN_MS;
+
+DebugSink::DebugSink(Deliver deliver, size_t capacity)
+    :_deliver(deliver),
+     _queue(capacity),
+     _stop(false),
+     _dropped(0),
+     _posted(0),
+     _delivered(0),
+     _thread(&DebugSink::run, this)
+{
+}
+
+DebugSink::~DebugSink()
+{
+    _stop = true;
+    _wakeup.notify();
+    _thread.join();
+}
+
+bool DebugSink::post(Debug::DEBUG_LEVEL level, std::string& message)
+{
+    bool queued = _queue.push([&](Entry& slot)
+    {
+        slot.level = level;
+        slot.text.swap(message);
+    });
+
+    if(! queued)
+    {
+        _dropped++;
+        _wakeup.notify();
+        return false;
+    }
+
+    _posted++;
+    if(level >= Debug::WARNING || _queue.size() >= _queue.capacity() / 4)
+    {
+        _wakeup.notify();
+    }
+    return true;
+}
+
+void DebugSink::flush()
+{
+    uint64_t target = _posted.load();
+    while(_delivered.load() < target)
+    {
+        _wakeup.notify();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+void DebugSink::run()
+{
+    while(true)
+    {
+        bool stopping = _stop.load();
+        if(! stopping)
+        {
+            _wakeup.wait(std::chrono::milliseconds(DRAIN_MS));
+        }
+
+        while(_queue.pop([this](Entry& entry)
+        {
+            _deliver(entry.level, entry.text);
+            _delivered++;
+        }))
+        {
+        }
+
+        if(stopping)
+        {
+            break;
+        }
+    }
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#ifndef DEBUG_SINK_H_
+#define DEBUG_SINK_H_
+
+/* STL Headers */
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+
+/* C Headers */
+#include <stdint.h>
+#include <stddef.h>
+
+/* Project Headers */
+#include "Debug.h"
+#include "MpscRing.h"
+#include "Wakeup.h"
+
+/**
+ * @brief The thread that prints and logs Debug messages for everyone else.
+ *
+ * A finished Debug message is swapped in to a slot of a lock-free queue and
+ * the thread that wrote it goes back to work, so it never waits on stderr,
+ * the message log or the ground station queue. The sink thread passes each
+ * message to deliver in the order they were posted.
+ *
+ * Warnings and critical messages wake the sink straight away, everything
+ * else is picked up within DRAIN_MS. When the queue is full post() returns
+ * false and the caller decides what to do, Debug delivers warnings and
+ * critical messages itself and drops the rest.
+ */
+class DebugSink
+{
+public:
+    static const int DRAIN_MS = 50;
+
+    typedef std::function<void (Debug::DEBUG_LEVEL, const std::string&)> Deliver;
+
+    DebugSink(Deliver deliver, size_t capacity);
+
+    /// delivers everything still queued
+    ~DebugSink();
+
+    /**
+     * Queues message, leaving message with whatever string the slot held
+     * before. Never blocks, returns false and counts a drop if the queue is full.
+     */
+    bool post(Debug::DEBUG_LEVEL level, std::string& message);
+
+    /// waits until everything posted so far has been delivered
+    void flush();
+
+    /// messages post() turned away
+    uint64_t dropped() const
+    {
+        return _dropped.load();
+    }
+
+private:
+    DebugSink(const DebugSink&);
+    DebugSink& operator=(const DebugSink&);
+
+    struct Entry
+    {
+        Debug::DEBUG_LEVEL level;
+        std::string text;
+    };
+
+    void run();
+
+    Deliver _deliver;
+    MpscRing<Entry> _queue;
+    Wakeup _wakeup;
+    std::atomic_bool _stop;
+    std::atomic<uint64_t> _dropped;
+    std::atomic<uint64_t> _posted;
+    std::atomic<uint64_t> _delivered;
+    std::thread _thread;
+};
+
+#endif /* DEBUG_SINK_H_ */
@@ -0,0 +1,98 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "DebugSink.h"
+#include <gtest/gtest.h>
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace
+{
+/// keeps what a sink delivered, for checking from the test thread
+struct Delivered
+{
+    std::mutex lock;
+    std::vector<std::string> messages;
+    std::vector<Debug::DEBUG_LEVEL> levels;
+
+    DebugSink::Deliver deliver()
+    {
+        return [this](Debug::DEBUG_LEVEL level, const std::string& message)
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            levels.push_back(level);
+            messages.push_back(message);
+        };
+    }
+};
+}
+
+TEST(DebugSink, DeliversInOrder)
+{
+    Delivered delivered;
+    DebugSink sink(delivered.deliver(), 64);
+
+    for(int i = 0; i < 10; i++)
+    {
+        std::string message = "message " + std::to_string(i);
+        ASSERT_TRUE(sink.post(Debug::MESSAGE, message));
+    }
+    std::string warning = "warning";
+    sink.post(Debug::WARNING, warning);
+    sink.flush();
+
+    std::lock_guard<std::mutex> guard(delivered.lock);
+    ASSERT_EQ(11u, delivered.messages.size());
+    for(int i = 0; i < 10; i++)
+    {
+        EXPECT_EQ("message " + std::to_string(i), delivered.messages[i]);
+    }
+    EXPECT_EQ(Debug::WARNING, delivered.levels.back());
+}
+
+TEST(DebugSink, FullQueueTurnsMessagesAway)
+{
+    std::mutex stall;
+    std::unique_lock<std::mutex> stalled(stall);
+    int delivered = 0;
+    DebugSink sink([&](Debug::DEBUG_LEVEL, const std::string&)
+    {
+        std::lock_guard<std::mutex> wait(stall);
+        delivered++;
+    }, 16);
+
+    // the first message holds the sink thread up, the queue fills behind it
+    int posted = 0;
+    for(int i = 0; i < 100; i++)
+    {
+        std::string message = "message";
+        posted += sink.post(Debug::MESSAGE, message);
+    }
+
+    EXPECT_GT(sink.dropped(), 0u);
+    EXPECT_EQ(100u, posted + sink.dropped());
+
+    stalled.unlock();
+    sink.flush();
+    EXPECT_EQ(posted, delivered);
+}
+
+TEST(DebugSink, DeliversEverythingBeforeStopping)
+{
+    Delivered delivered;
+    {
+        DebugSink sink(delivered.deliver(), 64);
+        for(int i = 0; i < 20; i++)
+        {
+            std::string message = "message";
+            sink.post(Debug::MESSAGE, message);
+        }
+    }
+
+    EXPECT_EQ(20u, delivered.messages.size());
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "Debug.h"
+#include "AllocationCounter.h"
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace
+{
+/// counts how often a message argument was evaluated
+std::string counted(int& evaluations)
+{
+    evaluations++;
+    return "expensive";
+}
+}
+
+TEST(Logger, LevelsBelowTheLoggersAreDisabled)
+{
+    Logger logger("Test", Debug::WARNING);
+    EXPECT_FALSE(logger.enabled(Debug::IGNORE));
+    EXPECT_FALSE(logger.enabled(Debug::DEBUG));
+    EXPECT_FALSE(logger.enabled(Debug::MESSAGE));
+    EXPECT_TRUE(logger.enabled(Debug::WARNING));
+    EXPECT_TRUE(logger.enabled(Debug::CRITICAL));
+
+    logger.setLoggingLevel(Debug::MESSAGE);
+    EXPECT_TRUE(logger.enabled(Debug::MESSAGE));
+}
+
+TEST(Logger, TraceIsNeverEnabled)
+{
+    Logger logger("Test", Debug::IGNORE);
+    EXPECT_FALSE(logger.enabled(Debug::IGNORE));
+}
+
+TEST(Logger, DisabledMacrosEvaluateNothing)
+{
+    Logger logger("Test", Debug::CRITICAL);
+    int evaluations = 0;
+
+    LOGGER_TRACE(logger) << counted(evaluations);
+    LOGGER_DEBUG(logger) << counted(evaluations);
+    LOGGER_INFO(logger) << "value " << counted(evaluations);
+    LOGGER_WARNING(logger) << counted(evaluations);
+
+    EXPECT_EQ(0, evaluations);
+}
+
+TEST(Logger, DisabledMessagesDoNotAllocate)
+{
+    Logger logger("A prefix too long for the small string buffer", Debug::CRITICAL);
+
+    uint64_t allocations = AllocationCounter::allocations();
+    logger.trace() << "Received BESTXYZ data";
+    logger.debug() << "got message " << 42 << " at " << 1.5;
+    EXPECT_EQ(0u, AllocationCounter::allocations() - allocations);
+}
+
+TEST(Logger, MacrosWorkAsOneStatement)
+{
+    Logger logger("Test", Debug::CRITICAL);
+    int evaluations = 0;
+
+    // the macro mustn't swallow the else
+    if(evaluations == 0)
+        LOGGER_DEBUG(logger) << counted(evaluations);
+    else
+        evaluations = 100;
+
+    EXPECT_EQ(0, evaluations);
+}
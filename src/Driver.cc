@@ -37,7 +37,9 @@ Driver::Driver(std::string name, std::string config_prefix)
       _terminate(_all_drivers_terminate.load()),
       _config_prefix(config_prefix),
       _name(name),
-      _savePathFd(-1), // by default don't save anything
+      _capture(nullptr), // by default don't save anything
+      _replayRecording(nullptr),
+      _replay(nullptr),
       _driverInit(std::chrono::system_clock::now())
 {
     {
@@ -51,7 +53,7 @@ Driver::Driver(std::string name, std::string config_prefix)
     setLoggingLevel(configGeti("logging_level", 2));
 
     configDescribe("read_style",
-                   "0:read until min, 1:readcond, 2:read(), 3:wait then read()",
+                   "0:read until min, 1:readcond, 2:read(), 3:wait then read(), 4:shared epoll reactor",
                    "The style of serial port read to use for this driver.");
     _readDeviceType = configGeti("read_style", 2);
 
@@ -68,19 +70,98 @@ Driver::Driver(std::string name, std::string config_prefix)
     configDescribe("read_save_path",
                   "path to a file or blank to not save",
                   "A location on the filesystem where all of the incoming data passed through the driver "
-                   "`readDevice` call will be appended.");
+                   "`readDevice` call will be appended, each read prefixed with a timestamp and length.");
     _savePath = configGets("read_save_path", "");
 
     if(!_savePath.empty())
     {
-        _savePathFd = open(_savePath.c_str(), O_CREAT | O_WRONLY | O_APPEND);
+        _capture = new RawCapture(_savePath);
+        if(! _capture->isOpen())
+        {
+            warning() << "Could not open " << _savePath << " to save reads";
+            delete _capture;
+            _capture = nullptr;
+        }
+    }
+
+    configDescribe("replay_path",
+                   "path to a recording or blank to read the device",
+                   "A capture saved with read_save_path, or plain recorded bytes, that `readDevice` "
+                   "plays back in place of the real port.");
+    std::string replayPath = configGets("replay_path", "");
+
+    configDescribe("replay_speed",
+                   "0 or greater",
+                   "How fast to play replay_path back, 1 is real time and 0 is as fast as possible.");
+    double replaySpeed = configGetd("replay_speed", 1.0);
+
+    configDescribe("replay_baud",
+                   "serial baud rate",
+                   "The rate recordings without timestamps are played back at.");
+    int replayBaud = configGeti("replay_baud", 115200);
+
+    if(!replayPath.empty())
+    {
+        _replayRecording = new ReplayRecording();
+        if(_replayRecording->load(replayPath, replayBaud))
+        {
+            message() << "Replaying " << replayPath << " at " << replaySpeed << "x";
+            _replay = new ReplayInjector(*_replayRecording, replaySpeed);
+        }
+        else
+        {
+            warning() << "Could not load " << replayPath << " to replay";
+            delete _replayRecording;
+            _replayRecording = nullptr;
+        }
     }
 }
 
 Driver::~Driver()
 {
-    std::lock_guard<std::mutex> lock(_all_drivers_lock);
-    all_drivers.remove(this);
+    {
+        std::lock_guard<std::mutex> lock(_all_drivers_lock);
+        all_drivers.remove(this);
+    }
+
+    delete _capture;
+    delete _replay;
+    delete _replayRecording;
+}
+
+bool Driver::watchDevice(int fd, IoReactor::ReadableCallback readable, IoReactor::TickCallback tick)
+{
+    Configuration* config = Configuration::getInstance();
+    config->describe("io_reactor.threads",
+                     "1-2",
+                     "The number of threads servicing every driver using read_style 4, read when the first one starts.");
+    IoReactor* reactor = IoReactor::getInstance(config->geti("io_reactor.threads", 1));
+
+    if(! reactor->add(fd, readable, tick))
+    {
+        warning() << "Could not add fd " << fd << " to the io reactor";
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(_watchedFdsLock);
+    _watchedFds.push_back(fd);
+    return true;
+}
+
+void Driver::unwatchDevices()
+{
+    std::lock_guard<std::mutex> lock(_watchedFdsLock);
+    if(_watchedFds.empty())
+    {
+        return;
+    }
+
+    IoReactor* reactor = IoReactor::getInstanceIfConstructed(0);
+    for(int fd : _watchedFds)
+    {
+        reactor->remove(fd);
+    }
+    _watchedFds.clear();
 }
 
 void Driver::terminateAll()
@@ -114,37 +195,55 @@ std::vector<Driver*> Driver::getDrivers()
 }
 
 int Driver::readDevice(int fd, void * buf, int n)
+{
+    return readDevice(fd, buf, n, n);
+}
+
+int Driver::readDevice(int fd, void * buf, int n, int min)
 {
     int amt = 0;
 
-    switch(_readDeviceType)
+    if(_replay != nullptr)
     {
-        case 0:
-            amt = QNX2Linux::readUntilMin(fd, buf, n, n);
-            break;
-        case 1:
-            amt = QNX2Linux::readcond(fd, buf, n, n, 10,10);
-            break;
-        case 3:
+        amt = _replay->read(buf, n);
+        if(amt == 0)
         {
-            struct termios port_config;
-            tcgetattr(fd, &port_config);                  // get the current port settings
-
-            // Set the baud rate
-            speed_t speed = cfgetospeed(&port_config);
-            int waittimeMS = (1000 * speed) / (n * 8);
-
-            std::this_thread::sleep_for( std::chrono::milliseconds( waittimeMS ) );
-            amt = read(fd, buf, n);
-            break;
+            // the recording has finished, don't let the driver spin
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+    }
+    else
+    {
+        switch(_readDeviceType)
+        {
+            case 0:
+                amt = QNX2Linux::readUntilMin(fd, buf, n, min);
+                break;
+            case 1:
+                amt = QNX2Linux::readcond(fd, buf, n, min, 10,10);
+                break;
+            case 3:
+            {
+                struct termios port_config;
+                tcgetattr(fd, &port_config);                  // get the current port settings
+
+                // Set the baud rate
+                speed_t speed = cfgetospeed(&port_config);
+                int waittimeMS = (1000 * speed) / (n * 8);
+
+                std::this_thread::sleep_for( std::chrono::milliseconds( waittimeMS ) );
+                amt = read(fd, buf, n);
+                break;
+            }
+            case READ_STYLE_REACTOR: // the reactor only calls us once fd is readable, so this won't block
+            default:
+                amt = read(fd, buf, n);
         }
-        default:
-            amt = read(fd, buf, n);
     }
 
-    if(_savePathFd > 0)
+    if(_capture != nullptr && amt > 0)
     {
-        write(_savePathFd, buf, amt);
+        _capture->record(RawCapture::now_ns(), buf, amt);
     }
 
     return amt;
@@ -294,6 +393,9 @@ bool Driver::terminalSettings(int fd,
         return false;
     }
 
+    // readcond sets the port up again on its next read
+    QNX2Linux::resetPort(fd);
+
     if(tcflush(fd, TCIOFLUSH) == -1)
     {
         critical() << "could not purge the serial port";
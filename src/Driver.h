@@ -29,6 +29,9 @@
 
 #include "Debug.h"
 #include "Configuration.h"
+#include "IoReactor.h"
+#include "RawCapture.h"
+#include "Replay.h"
 
 
 /**
@@ -63,8 +66,12 @@ private:
     /// Keeps the value of the save path for reading (a tee location where the raw data can be dumped)
     std::string _savePath;
 
-    /// The file descriptor of the save path.
-    int _savePathFd;
+    /// Timestamps and saves everything read to the save path off the reading thread, null if not saving.
+    RawCapture* _capture;
+
+    /// The recording readDevice plays back in place of the real port, null when reading hardware.
+    ReplayRecording* _replayRecording;
+    ReplayInjector* _replay;
 
     /// Keeps the time that the driver was initiated
     std::chrono::time_point<std::chrono::system_clock> _driverInit;
@@ -75,6 +82,13 @@ private:
     /// Holds the property of whether or not to terminate if init failed.
     std::atomic_bool _terminate_if_init_failed;
 
+    /// The fds this driver has handed to the IoReactor, removed on terminate()
+    std::vector<int> _watchedFds;
+    std::mutex _watchedFdsLock;
+
+    /// Stops the IoReactor servicing this driver's fds.
+    void unwatchDevices();
+
 public:
     Driver(std::string name, std::string config_prefix);
     virtual ~Driver();
@@ -100,6 +114,8 @@ public:
     inline void terminate()
     {
         debug() << "Driver Terminating: " << getName();
+        // once a driver sees terminateRequested() the reactor is done with its fds and it can close them
+        unwatchDevices();
         _terminate = true;
     };
 
@@ -115,6 +131,38 @@ public:
      **/
     int readDevice(int fd, void * buf, int n);
 
+    /**
+     * Reads up to n bytes from fd in to the given buffer, returning once at
+     * least min bytes have arrived. Lets buffered readers take everything the
+     * port has ready in a single call.
+     **/
+    int readDevice(int fd, void * buf, int n, int min);
+
+    /**
+     * Read style 4, the driver's ports are serviced by the shared IoReactor
+     * rather than a thread of its own.
+     **/
+    static const int READ_STYLE_REACTOR = 4;
+
+    /**
+     * Returns true if read_style asks for this driver's ports to be serviced
+     * by the shared IoReactor.
+     **/
+    bool useReactor() const
+    {
+        return _readDeviceType == READ_STYLE_REACTOR;
+    }
+
+    /**
+     * Has the shared IoReactor call readable whenever fd has data waiting and
+     * tick about every IoReactor::TICK_MS. Inside readable, readDevice(fd, buf, n, 1)
+     * takes whatever has arrived without blocking. The fd is unwatched when the
+     * driver terminates.
+     *
+     * @return false if the reactor would not take fd.
+     **/
+    bool watchDevice(int fd, IoReactor::ReadableCallback readable, IoReactor::TickCallback tick = nullptr);
+
     /**
      * Sets the given terminal configuration on the given fd and saves them
      * with name. If name already exists in the configuration file, those
@@ -37,19 +37,19 @@ class EulerAngles
 
         static EulerAngles fromQuaternion(double w, double x, double y, double z);
 
-        double getRollRad()
+        double getRollRad() const
         {
             return _rollRad;
         }
 
 
-        double getPitchRad()
+        double getPitchRad() const
         {
             return _pitchRad;
         }
 
 
-        double getYawRad()
+        double getYawRad() const
         {
             return _yawRad;
         }
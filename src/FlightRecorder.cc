@@ -0,0 +1,65 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#include "FlightRecorder.h"
+
+/* STL Headers */
+#include <algorithm>
+
+/* C Headers */
+#include <string.h>
+
+FlightRecorder::FlightRecorder(size_t capacity)
+    :_buffer(capacity),
+     _head(0),
+     _used(0),
+     _entries(0)
+{
+}
+
+void FlightRecorder::record(uint64_t time_ms, const char* data, size_t length)
+{
+    size_t needed = ENTRY_OVERHEAD + length;
+    if(needed > _buffer.size())
+    {
+        return;
+    }
+
+    while(_buffer.size() - _used < needed)
+    {
+        uint32_t oldest;
+        read(_head + sizeof(uint64_t), reinterpret_cast<char*>(&oldest), sizeof(oldest));
+        _head = (_head + ENTRY_OVERHEAD + oldest) % _buffer.size();
+        _used -= ENTRY_OVERHEAD + oldest;
+        _entries--;
+    }
+
+    size_t tail = (_head + _used) % _buffer.size();
+    uint32_t stored_length = length;
+    write(tail, reinterpret_cast<const char*>(&time_ms), sizeof(time_ms));
+    write(tail + sizeof(time_ms), reinterpret_cast<const char*>(&stored_length), sizeof(stored_length));
+    write(tail + ENTRY_OVERHEAD, data, length);
+
+    _used += needed;
+    _entries++;
+}
+
+void FlightRecorder::read(size_t position, char* out, size_t length) const
+{
+    position %= _buffer.size();
+    size_t first = std::min(length, _buffer.size() - position);
+    memcpy(out, _buffer.data() + position, first);
+    memcpy(out + first, _buffer.data(), length - first);
+}
+
+void FlightRecorder::write(size_t position, const char* in, size_t length)
+{
+    position %= _buffer.size();
+    size_t first = std::min(length, _buffer.size() - position);
+    memcpy(_buffer.data() + position, in, first);
+    memcpy(_buffer.data(), in + first, length - first);
+}
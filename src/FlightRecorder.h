@@ -0,0 +1,98 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#ifndef FLIGHT_RECORDER_H_
+#define FLIGHT_RECORDER_H_
+
+/* STL Headers */
+#include <string>
+#include <vector>
+
+/* C Headers */
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief The last few seconds of one log channel, kept in memory at full rate.
+ *
+ * Every line or record the LogWriter takes off its queue for a channel is
+ * copied in to that channel's FlightRecorder, whether or not it is written to
+ * disk, and the oldest are dropped to make room. The buffer is allocated
+ * once, so a recorder never holds more than its capacity.
+ *
+ * Only the writer thread that owns the channel touches its recorder.
+ */
+class FlightRecorder
+{
+public:
+    /// bytes each entry takes on top of its data
+    static const size_t ENTRY_OVERHEAD = sizeof(uint64_t) + sizeof(uint32_t);
+
+    explicit FlightRecorder(size_t capacity);
+
+    /**
+     * Keeps length bytes of data stamped with time_ms, dropping the oldest
+     * entries to make room. Entries bigger than the whole recorder are left out.
+     */
+    void record(uint64_t time_ms, const char* data, size_t length);
+
+    /// calls visit(data, length) for each entry stamped at or after time_ms, oldest first
+    template<class Visit>
+    void forEachSince(uint64_t time_ms, Visit visit) const;
+
+    /// bytes in use, entries and their overhead
+    size_t size() const
+    {
+        return _used;
+    }
+
+    size_t capacity() const
+    {
+        return _buffer.size();
+    }
+
+    size_t entries() const
+    {
+        return _entries;
+    }
+
+private:
+    /// copies length bytes starting at ring position from in to out, wrapping at the end
+    void read(size_t position, char* out, size_t length) const;
+    void write(size_t position, const char* in, size_t length);
+
+    std::vector<char> _buffer;
+    /// position of the oldest entry
+    size_t _head;
+    size_t _used;
+    size_t _entries;
+};
+
+template<class Visit>
+void FlightRecorder::forEachSince(uint64_t time_ms, Visit visit) const
+{
+    std::string data;
+    size_t position = _head;
+    for(size_t i = 0; i < _entries; i++)
+    {
+        uint64_t stamp;
+        uint32_t length;
+        read(position, reinterpret_cast<char*>(&stamp), sizeof(stamp));
+        read(position + sizeof(stamp), reinterpret_cast<char*>(&length), sizeof(length));
+
+        if(stamp >= time_ms)
+        {
+            data.resize(length);
+            read(position + ENTRY_OVERHEAD, &data[0], length);
+            visit(data.data(), data.size());
+        }
+
+        position = (position + ENTRY_OVERHEAD + length) % _buffer.size();
+    }
+}
+
+#endif /* FLIGHT_RECORDER_H_ */
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "FlightRecorder.h"
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+namespace
+{
+void record(FlightRecorder& recorder, uint64_t time_ms, const std::string& data)
+{
+    recorder.record(time_ms, data.data(), data.size());
+}
+
+std::vector<std::string> since(const FlightRecorder& recorder, uint64_t time_ms)
+{
+    std::vector<std::string> entries;
+    recorder.forEachSince(time_ms, [&](const char* data, size_t length)
+    {
+        entries.push_back(std::string(data, length));
+    });
+    return entries;
+}
+}
+
+TEST(FlightRecorder, KeepsEntriesInOrder)
+{
+    FlightRecorder recorder(1024);
+    record(recorder, 1, "first\n");
+    record(recorder, 2, "second\n");
+    record(recorder, 3, "");
+
+    EXPECT_EQ(std::vector<std::string>({"first\n", "second\n", ""}), since(recorder, 0));
+    EXPECT_EQ(3u, recorder.entries());
+    EXPECT_EQ(3 * FlightRecorder::ENTRY_OVERHEAD + 13, recorder.size());
+}
+
+TEST(FlightRecorder, DropsOldestWhenFull)
+{
+    // room for three ten byte entries
+    FlightRecorder recorder(3 * (FlightRecorder::ENTRY_OVERHEAD + 10) + 5);
+    for(int i = 0; i < 10; i++)
+    {
+        record(recorder, i, "entry-" + std::to_string(1000 + i));
+    }
+
+    EXPECT_EQ(std::vector<std::string>({"entry-1007", "entry-1008", "entry-1009"}), since(recorder, 0));
+    EXPECT_LE(recorder.size(), recorder.capacity());
+}
+
+TEST(FlightRecorder, EntriesWrapAroundTheEnd)
+{
+    FlightRecorder recorder(2 * FlightRecorder::ENTRY_OVERHEAD + 17);
+    for(int i = 0; i < 50; i++)
+    {
+        // uneven lengths land the header and data across the end of the buffer
+        record(recorder, i, std::string(1 + i % 7, 'a' + i % 26));
+    }
+
+    std::vector<std::string> entries = since(recorder, 0);
+    ASSERT_FALSE(entries.empty());
+    EXPECT_EQ(std::string(1 + 49 % 7, 'a' + 49 % 26), entries.back());
+    EXPECT_LE(recorder.size(), recorder.capacity());
+}
+
+TEST(FlightRecorder, OnlyVisitsEntriesSince)
+{
+    FlightRecorder recorder(1024);
+    record(recorder, 100, "old");
+    record(recorder, 200, "trigger");
+    record(recorder, 300, "after");
+
+    EXPECT_EQ(std::vector<std::string>({"trigger", "after"}), since(recorder, 200));
+    EXPECT_TRUE(since(recorder, 301).empty());
+}
+
+TEST(FlightRecorder, LeavesOutEntriesBiggerThanItself)
+{
+    FlightRecorder recorder(FlightRecorder::ENTRY_OVERHEAD + 4);
+    record(recorder, 1, "four");
+    record(recorder, 2, "five!");
+
+    EXPECT_EQ(std::vector<std::string>({"four"}), since(recorder, 0));
+}
@@ -28,9 +28,6 @@
 #include <GeographicLib/LocalCartesian.hpp>
 
 
-#include <boost/numeric/ublas/matrix.hpp>
-
-
 GPSPosition::GPSPosition()
 :_latitudeDD(0),
 _longitudeDD(0),
@@ -48,19 +45,12 @@ _accuracyM(accuracyM)
 
 }
 
-ublas::vector<double> GPSPosition::ecef() const
+Vec3 GPSPosition::ecef() const
 {
     double x=0, y=0, z=0;
     GeographicLib::Geocentric::WGS84.Forward(_latitudeDD, _longitudeDD, _heightM, x, y, z);
 
-    ublas::vector<double> ecef(3);
-    ecef.clear();
-
-    ecef[0] = x;
-    ecef[1] = y;
-    ecef[2] = z;
-
-    return ecef;
+    return Vec3(x, y, z);
 }
 
 double GPSPosition::distanceTo(GPSPosition* other, bool useCurrentAltitude)
@@ -100,7 +90,7 @@ double GPSPosition::distanceTo(GPSPosition* other, bool useCurrentAltitude)
 
 
 
-ublas::vector<double> GPSPosition::ned(GPSPosition &origin) const
+Vec3 GPSPosition::ned(GPSPosition &origin) const
 {
     auto originCoords = GeographicLib::LocalCartesian::LocalCartesian(origin._latitudeDD,
                                                                       origin._longitudeDD,
@@ -110,13 +100,7 @@ ublas::vector<double> GPSPosition::ned(GPSPosition &origin) const
     double x=0, y=0, z=0;
     originCoords.Forward(_latitudeDD, _longitudeDD, _heightM, x, y, z);
 
-    ublas::vector<double> ned(3);
-    ned.clear();
-    ned[0] = x;
-    ned[1] = y;
-    ned[2] = -z;
-
-    return ned;
+    return Vec3(x, y, -z);
 }
 
 
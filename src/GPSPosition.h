@@ -20,10 +20,9 @@
 #ifndef GPS_POSITION_H
 #define GPS_POSITION_H
 
-#include <boost/numeric/ublas/vector.hpp>
 #include <vector>
 
-using namespace boost::numeric;
+#include "FixedMath.h"
 
 /** GPSPosition represents a single point in the geographic reference system
 for Earth. It provides utilities for converting this reference to other formats
@@ -56,7 +55,7 @@ class GPSPosition
          * @return a vector of x,y,z (in meters)
          * TODO - add tests for this to ensure correctness of calculations.
          **/
-        ublas::vector<double> ecef() const;
+        Vec3 ecef() const;
 
         /**
          * Converts the lat/long/height coordinates to North East Down (NED)
@@ -65,7 +64,7 @@ class GPSPosition
          * @param origin - the origin for the ned position
          * @return a vector of n,e,d
          **/
-        ublas::vector<double> ned(GPSPosition &origin) const;
+        Vec3 ned(GPSPosition &origin) const;
 
         /// Returns the latitude in decimal degrees
         const double getLatitudeDD(){return _latitudeDD;};
@@ -22,10 +22,7 @@ TEST(GPSPosition, LLH_POSITION_TO_ECEF)
 {
     GPSPosition gps(1,2,3);
 
-    boost::numeric::ublas::vector<double> exp(3);
-    exp[0] = 6373.29 * 1000;
-    exp[1] = 222.56 * 1000;
-    exp[2] = 110.569 * 1000;
+    Vec3 exp(6373.29 * 1000, 222.56 * 1000, 110.569 * 1000);
 
 
     auto res = gps.ecef();
@@ -40,10 +37,7 @@ TEST(GPSPosition, NED_OFFSET_NONE)
     GPSPosition gps_origin(1,1,1);
     GPSPosition gps(1,1,1);
 
-    boost::numeric::ublas::vector<double> exp(3);
-    exp[0] = 6373.29 * 1000;
-    exp[1] = 222.56 * 1000;
-    exp[2] = 110.569 * 1000;
+    Vec3 exp(6373.29 * 1000, 222.56 * 1000, 110.569 * 1000);
 
 
     auto res = gps.ned(gps_origin);
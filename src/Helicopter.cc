@@ -50,16 +50,9 @@ Helicopter::Helicopter()
      out(servo_switch::getInstance()),
      mass(13.65),
      gravity(9.8),
-     main_hub_offset(3),
-     tail_hub_offset(3),
-     inertia(3,3)
+     main_hub_offset(0, 0, -0.32),
+     tail_hub_offset(-1.06, 0, 0)
 {
-    main_hub_offset.clear();
-    main_hub_offset(2) = -0.32;
-
-    tail_hub_offset.clear();
-    tail_hub_offset(0) = -1.06;
-
     inertia(0,0) = 0.36;
     inertia(1,1) = 1.48;
     inertia(2,2) = 1.21;
@@ -159,17 +152,17 @@ void Helicopter::saveFile()
 
     config->set(XML_MASS, std::to_string(get_mass()));
 
-    blas::vector<double> hub(get_main_hub_offset());
+    Vec3 hub(get_main_hub_offset());
     config->set(XML_MAIN_HUB_OFFSET_X, std::to_string(hub(0)));
     config->set(XML_MAIN_HUB_OFFSET_Y, std::to_string(hub(1)));
     config->set(XML_MAIN_HUB_OFFSET_Z, std::to_string(hub(2)));
 
-    blas::vector<double> tail(get_tail_hub_offset());
+    Vec3 tail(get_tail_hub_offset());
     config->set(XML_TAIL_HUB_OFFSET_X, std::to_string(tail(0)));
     config->set(XML_TAIL_HUB_OFFSET_Y, std::to_string(tail(1)));
     config->set(XML_TAIL_HUB_OFFSET_Z, std::to_string(tail(2)));
 
-    blas::banded_matrix<double> inertia(get_inertia());
+    Mat3 inertia(get_inertia());
     config->set(XML_INERTIA_X, std::to_string(inertia(0,0)));
     config->set(XML_INERTIA_Y, std::to_string(inertia(1,1)));
     config->set(XML_INERTIA_Z, std::to_string(inertia(2,2)));
@@ -247,9 +240,9 @@ uint16_t Helicopter::norm2pulse(double norm, std::array<uint16_t, 5> setpoint)
     return pulse;
 }
 
-std::vector<uint16_t> Helicopter::setScaled(std::vector<double> norm)
+std::array<uint16_t, 6> Helicopter::setScaled(const Vector<6>& norm)
 {
-    std::vector<uint16_t> pulse(6);
+    std::array<uint16_t, 6> pulse;
 
     pulse[AILERON] = setAileron(norm[0]);
     pulse[ELEVATOR] = setElevator(norm[1]);
@@ -23,14 +23,10 @@
 /* STL Headers */
 #include <string>
 #include <vector>
+#include <array>
 #include <mutex>
 //#include <thread>
 
-/* Boost Headers */
-#include <boost/numeric/ublas/vector.hpp>
-#include <boost/numeric/ublas/banded.hpp>
-namespace blas = boost::numeric::ublas;
-
 /* Project Headers */
 #include <servo_switch.h>
 #include "RadioCalibration.h"
@@ -39,6 +35,7 @@ namespace blas = boost::numeric::ublas;
 #include "Parameter.h"
 #include "Debug.h"
 #include "Singleton.h"
+#include "FixedMath.h"
 
 /**
     \brief This class handles output pulse scaling from normalized values
@@ -93,14 +90,8 @@ public:
     uint16_t setPitch(double norm);
 
     /** @param norm vector of scaled pulse values for all 6 channels
-     	   @return pulse vector of de-normalized pulse values for all 6 channels */
-    std::vector<uint16_t> setScaled(blas::vector<double> norm)
-    {
-        return setScaled(std::vector<double>(norm.begin(), norm.end()));
-    }
-    /** @param norm vector of scaled pulse values for all 6 channels
-     	   @return pulse vector of de-normalized pulse values for all 6 channels */
-    std::vector<uint16_t> setScaled(std::vector<double> norm);
+     	   @return pulse de-normalized pulse values for all 6 channels, nothing is allocated */
+    std::array<uint16_t, 6> setScaled(const Vector<6>& norm);
 
     /// get the helicopter's mass
     double get_mass() const
@@ -114,19 +105,19 @@ public:
         return gravity;
     }
     /// return the main rotor hub offset
-    blas::vector<double> get_main_hub_offset()
+    Vec3 get_main_hub_offset()
     {
         std::lock_guard<std::mutex> lock(main_hub_offset_lock);
         return main_hub_offset;
     }
     /// return the tail rotor hub offset
-    blas::vector<double> get_tail_hub_offset()
+    Vec3 get_tail_hub_offset()
     {
         std::lock_guard<std::mutex> lock(tail_hub_offset_lock);
         return tail_hub_offset;
     }
     /// return the inertia matrix
-    blas::banded_matrix<double> get_inertia()
+    Mat3 get_inertia()
     {
         std::lock_guard<std::mutex> lock(inertia_lock);
         return inertia;
@@ -208,11 +199,11 @@ private:
     const double gravity;
 
     /// main rotor hub offset from com (m)
-    blas::vector<double> main_hub_offset;
+    Vec3 main_hub_offset;
     /// serialize access to main_hub_offset
     mutable std::mutex main_hub_offset_lock;
     /// set the main rotor hub offset
-    inline void set_main_hub_offset(const blas::vector<double>& main_hub_offset)
+    inline void set_main_hub_offset(const Vec3& main_hub_offset)
     {
         std::lock_guard<std::mutex> lock(main_hub_offset_lock);
         this->main_hub_offset = main_hub_offset;
@@ -246,11 +237,11 @@ private:
     }
 
     /// tail rotor hub offset from com (m)
-    blas::vector<double> tail_hub_offset;
+    Vec3 tail_hub_offset;
     /// serialize access to tail_hub_offset
     mutable std::mutex tail_hub_offset_lock;
     /// set the tail rotor hub offset
-    inline void set_tail_hub_offset(const blas::vector<double>& tail_hub_offset)
+    inline void set_tail_hub_offset(const Vec3& tail_hub_offset)
     {
         std::lock_guard<std::mutex> lock(tail_hub_offset_lock);
         this->tail_hub_offset = tail_hub_offset;
@@ -283,12 +274,12 @@ private:
         message() << "Tail Hub Offset z set to " << tail_hub_offset_z;
     }
 
-    /// inertia matrix
-    blas::banded_matrix<double> inertia;
+    /// inertia matrix, only the diagonal is used
+    Mat3 inertia;
     /// serialize access to inertia
     mutable std::mutex inertia_lock;
     /// set the inertia matrix
-    inline void set_inertia(const blas::banded_matrix<double>& inertia)
+    inline void set_inertia(const Mat3& inertia)
     {
         std::lock_guard<std::mutex> lock(inertia_lock);
         this->inertia = inertia;
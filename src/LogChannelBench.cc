@@ -0,0 +1,198 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "LogFile.h"
+#include "LogFileWriter.h"
+#include "LogWriter.h"
+#include "LogRecord.h"
+#include "LatencyHistogram.h"
+#include "Benchmark.h"
+
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace
+{
+const int CHANNELS = 20;
+const int BATCHES = 25;
+/// small enough that a batch never fills the writer's queue
+const int BATCH = 2000;
+const int THREADS = 4;
+
+/// names as long as the real ones so hashing and comparing them costs the same
+std::string channelName(int i)
+{
+    return "Bench Attitude PID Error States " + std::to_string(i);
+}
+
+/// six doubles like the attitude PID error states
+const std::vector<double> SAMPLE = {0.012345, -0.54321, 1.0, 0.25, -0.125, 3.141593};
+
+#define BENCH_ERROR_FIELDS(FIELD) \
+    FIELD(double, Roll_Proportional) \
+    FIELD(double, Roll_Derivative) \
+    FIELD(double, Roll_Integral) \
+    FIELD(double, Pitch_Proportional) \
+    FIELD(double, Pitch_Derivative) \
+    FIELD(double, Pitch_Integral)
+LOG_RECORD(BenchErrorStates, BENCH_ERROR_FIELDS);
+
+const BenchErrorStates RECORD = {0.012345, -0.54321, 1.0, 0.25, -0.125, 3.141593};
+
+/**
+ * threads threads call log(channel) BATCH times a batch over all CHANNELS,
+ * timing every call. The queue is flushed between batches, untimed.
+ */
+void run(Benchmark& bench, int threads, std::function<void (int)> log)
+{
+    LogWriter* writer = LogWriter::getInstance();
+    uint64_t dropped = writer->dropped();
+    std::vector<std::vector<uint64_t> > latencies(threads);
+
+    for(int b = 0; b < BATCHES; b++)
+    {
+        std::vector<std::thread> producers;
+        for(int t = 0; t < threads; t++)
+        {
+            producers.push_back(std::thread([t, threads, &log, &latencies]
+            {
+                for(int i = t; i < BATCH; i += threads)
+                {
+                    uint64_t start = Benchmark::nowNanos();
+                    log(i % CHANNELS);
+                    latencies[t].push_back(Benchmark::nowNanos() - start);
+                }
+            }));
+        }
+
+        for(std::thread& producer : producers)
+        {
+            producer.join();
+        }
+        writer->flush();
+    }
+
+    LatencyHistogram latency;
+    for(std::vector<uint64_t>& mine : latencies)
+    {
+        for(uint64_t ns : mine)
+        {
+            latency.record(ns);
+        }
+    }
+
+    bench.report("calls", latency.count(), "calls");
+    bench.report("mean", latency.mean(), "ns");
+    bench.report("p50", latency.percentile(0.5), "ns");
+    bench.report("p99", latency.percentile(0.99), "ns");
+    bench.report("dropped", writer->dropped() - dropped, "records");
+}
+
+std::vector<LogChannel> registerChannels()
+{
+    std::vector<LogChannel> channels;
+    for(int i = 0; i < CHANNELS; i++)
+    {
+        channels.push_back(LogFile::getInstance()->channel(channelName(i)));
+    }
+    return channels;
+}
+
+std::vector<std::string> names()
+{
+    std::vector<std::string> result;
+    for(int i = 0; i < CHANNELS; i++)
+    {
+        result.push_back(channelName(i));
+    }
+    return result;
+}
+}
+
+// the map lookup and lock every logData call starts with
+BENCHMARK(LogChannel, LookupByName)
+{
+    std::vector<std::string> channels = names();
+    registerChannels();
+
+    run(bench, 1, [&](int channel)
+    {
+        LogfileWriter::getLogger(channels[channel]);
+    });
+}
+
+BENCHMARK(LogChannel, LogDataByName)
+{
+    std::vector<std::string> channels = names();
+    registerChannels();
+
+    run(bench, 1, [&](int channel)
+    {
+        LogFile::getInstance()->logData(channels[channel], SAMPLE);
+    });
+}
+
+BENCHMARK(LogChannel, LogThroughHandle)
+{
+    std::vector<LogChannel> channels = registerChannels();
+
+    run(bench, 1, [&](int channel)
+    {
+        channels[channel].log(SAMPLE);
+    });
+}
+
+// the control loop, sensor and telemetry threads all logging at once
+BENCHMARK(LogChannel, LogDataByNameContended)
+{
+    std::vector<std::string> channels = names();
+    registerChannels();
+
+    run(bench, THREADS, [&](int channel)
+    {
+        LogFile::getInstance()->logData(channels[channel], SAMPLE);
+    });
+}
+
+BENCHMARK(LogChannel, LogThroughHandleContended)
+{
+    std::vector<LogChannel> channels = registerChannels();
+
+    run(bench, THREADS, [&](int channel)
+    {
+        channels[channel].log(SAMPLE);
+    });
+}
+
+// the same sample as a LOG_RECORD struct, copied rather than iterated and formatted
+BENCHMARK(LogChannel, LogRecordThroughHandle)
+{
+    std::vector<LogRecordChannel<BenchErrorStates> > channels;
+    for(int i = 0; i < CHANNELS; i++)
+    {
+        channels.push_back(LogFile::getInstance()->channel<BenchErrorStates>(channelName(i) + " Record"));
+    }
+
+    run(bench, 1, [&](int channel)
+    {
+        channels[channel].log(RECORD);
+    });
+}
+
+BENCHMARK(LogChannel, LogRecordThroughHandleContended)
+{
+    std::vector<LogRecordChannel<BenchErrorStates> > channels;
+    for(int i = 0; i < CHANNELS; i++)
+    {
+        channels.push_back(LogFile::getInstance()->channel<BenchErrorStates>(channelName(i) + " Record"));
+    }
+
+    run(bench, THREADS, [&](int channel)
+    {
+        channels[channel].log(RECORD);
+    });
+}
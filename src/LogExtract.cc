@@ -0,0 +1,352 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#include "LogExtract.h"
+
+/* STL Headers */
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <utility>
+
+/* C Headers */
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+/* Project Headers */
+#include "BinaryLog.h"
+#include "LogIndex.h"
+
+/// one log being read forward from where the range starts
+class LogExtract::Channel
+{
+public:
+    static const size_t CHUNK = 64 * 1024;
+
+    Channel()
+    :bytesRead(0),
+     _fd(-1),
+     _binary(false),
+     _buffer(CHUNK),
+     _position(0),
+     _end(0),
+     _offset(0),
+     _eof(false),
+     _haveTime(false),
+     _lastTime(0)
+    {}
+
+    ~Channel()
+    {
+        if(_fd >= 0)
+        {
+            close(_fd);
+        }
+    }
+
+    /// opens the log at path and seeks to the index entry before start
+    bool open(const std::string& path, int64_t start);
+
+    /// the next record and its .dat line, false once the log ends or passes end
+    bool next(int64_t end, int64_t& time, std::string& line);
+
+    /// the file name without its folder or extension
+    std::string name;
+    /// the .dat header line
+    std::string header;
+    uint64_t bytesRead;
+
+private:
+    /// makes at least length bytes from _position available, false if the log ends first
+    bool fill(size_t length);
+
+    /// drops what is buffered and reads on from offset
+    void seekTo(uint64_t offset);
+
+    /// the next text line, newline and all, false if there are no more whole lines
+    bool nextLine(std::string& line);
+
+    int _fd;
+    bool _binary;
+    BinaryLog::FileHeader _fileHeader;
+
+    std::vector<char> _buffer;
+    size_t _position;
+    size_t _end;
+    /// the offset in the file of _buffer[_end]
+    uint64_t _offset;
+    bool _eof;
+
+    /// lines without a time of their own, like the rest of a long message, go with the line before
+    bool _haveTime;
+    int64_t _lastTime;
+};
+
+bool LogExtract::Channel::fill(size_t length)
+{
+    while(_end - _position < length && ! _eof)
+    {
+        if(_position > 0)
+        {
+            memmove(_buffer.data(), _buffer.data() + _position, _end - _position);
+            _end -= _position;
+            _position = 0;
+        }
+        if(_buffer.size() < length)
+        {
+            _buffer.resize(std::max(length, 2 * _buffer.size()));
+        }
+
+        ssize_t got = pread(_fd, _buffer.data() + _end, _buffer.size() - _end, _offset);
+        if(got <= 0)
+        {
+            _eof = true;
+            break;
+        }
+        _end += got;
+        _offset += got;
+        bytesRead += got;
+    }
+
+    return _end - _position >= length;
+}
+
+void LogExtract::Channel::seekTo(uint64_t offset)
+{
+    _position = 0;
+    _end = 0;
+    _offset = offset;
+    _eof = false;
+}
+
+bool LogExtract::Channel::nextLine(std::string& line)
+{
+    size_t searched = 0;
+    while(true)
+    {
+        const char* start = _buffer.data() + _position;
+        const void* newline = memchr(start + searched, '\n', _end - _position - searched);
+        if(newline != nullptr)
+        {
+            size_t length = static_cast<const char*>(newline) - start + 1;
+            line.assign(start, length);
+            _position += length;
+            return true;
+        }
+
+        // a line cut short at the end of the log is left out, like BinaryLog does
+        searched = _end - _position;
+        if(! fill(searched + 1))
+        {
+            return false;
+        }
+    }
+}
+
+bool LogExtract::Channel::open(const std::string& path, int64_t start)
+{
+    size_t slash = path.find_last_of('/');
+    name = path.substr(slash == std::string::npos ? 0 : slash + 1);
+    name = name.substr(0, name.find_last_of('.'));
+
+    _fd = ::open(path.c_str(), O_RDONLY);
+    if(_fd < 0)
+    {
+        return false;
+    }
+
+    size_t data_start = 0;
+    _binary = fill(BinaryLog::MAGIC_LENGTH) &&
+              memcmp(_buffer.data(), BinaryLog::MAGIC, BinaryLog::MAGIC_LENGTH) == 0;
+    if(_binary)
+    {
+        while(! BinaryLog::readHeader(reinterpret_cast<const uint8_t*>(_buffer.data()), _end, _fileHeader))
+        {
+            if(! fill(_end + CHUNK) && ! BinaryLog::readHeader(reinterpret_cast<const uint8_t*>(_buffer.data()),
+                                                                _end, _fileHeader))
+            {
+                return false;
+            }
+        }
+        header = "Time(micros)\t" + _fileHeader.columns + "\n";
+        data_start = _fileHeader.length;
+        _position = data_start;
+    }
+    else
+    {
+        int64_t time;
+        if(nextLine(header) && ! LogIndex::recordTime(header.data(), header.size(), false, time))
+        {
+            data_start = _position;
+        }
+        else
+        {
+            // no header line, read it again as a record
+            header.clear();
+            _position = 0;
+        }
+    }
+
+    std::vector<LogIndex::Entry> entries;
+    LogIndex::read(LogIndex::pathFor(path), entries);
+    uint64_t offset = LogIndex::seek(entries, start);
+    if(offset > data_start)
+    {
+        seekTo(offset);
+    }
+
+    return true;
+}
+
+bool LogExtract::Channel::next(int64_t end, int64_t& time, std::string& line)
+{
+    while(true)
+    {
+        if(_binary)
+        {
+            if(! fill(BinaryLog::RECORD_HEADER_LENGTH))
+            {
+                return false;
+            }
+
+            uint16_t count;
+            memcpy(&count, _buffer.data() + _position + sizeof(int64_t), sizeof(count));
+            size_t value_width = _fileHeader.type == BinaryLog::TYPE_RECORD ? 1 : BinaryLog::width(_fileHeader.type);
+            size_t length = BinaryLog::RECORD_HEADER_LENGTH + count * value_width;
+            if(! fill(length))
+            {
+                return false;
+            }
+
+            const uint8_t* record = reinterpret_cast<const uint8_t*>(_buffer.data() + _position);
+            _position += length;
+            _lastTime = BinaryLog::recordTime(record);
+            _haveTime = true;
+            if(_lastTime > end)
+            {
+                return false;
+            }
+
+            line.clear();
+            BinaryLog::recordToText(_fileHeader, record, length, line);
+        }
+        else
+        {
+            if(! nextLine(line))
+            {
+                return false;
+            }
+
+            int64_t own_time;
+            if(LogIndex::recordTime(line.data(), line.size(), false, own_time))
+            {
+                _lastTime = own_time;
+                _haveTime = true;
+            }
+            if(! _haveTime)
+            {
+                continue;
+            }
+            if(_lastTime > end)
+            {
+                return false;
+            }
+        }
+
+        time = _lastTime;
+        return true;
+    }
+}
+
+LogExtract::LogExtract(int64_t start_micros, int64_t end_micros)
+    :_start(start_micros),
+     _end(end_micros)
+{
+}
+
+LogExtract::~LogExtract()
+{
+}
+
+bool LogExtract::add(const std::string& path)
+{
+    std::unique_ptr<Channel> channel(new Channel());
+    if(! channel->open(path, _start))
+    {
+        return false;
+    }
+
+    _channels.push_back(std::move(channel));
+    return true;
+}
+
+void LogExtract::write(std::ostream& out)
+{
+    std::vector<std::string> lines(_channels.size());
+    // the next record of each channel, earliest first and in the order they were added on a tie
+    typedef std::pair<int64_t, size_t> Head;
+    std::priority_queue<Head, std::vector<Head>, std::greater<Head> > heads;
+
+    for(size_t i = 0; i < _channels.size(); i++)
+    {
+        int64_t time;
+        while(_channels[i]->next(_end, time, lines[i]))
+        {
+            if(time >= _start)
+            {
+                heads.push(Head(time, i));
+                break;
+            }
+        }
+    }
+
+    bool merged = _channels.size() > 1;
+    if(merged)
+    {
+        out << "Time(micros)\tChannel\tValues\n";
+    }
+    else if(! _channels.empty())
+    {
+        out << _channels[0]->header;
+    }
+
+    while(! heads.empty())
+    {
+        size_t i = heads.top().second;
+        heads.pop();
+
+        const std::string& line = lines[i];
+        size_t tab = line.find('\t');
+        if(merged && tab != std::string::npos && tab > 0)
+        {
+            out.write(line.data(), tab + 1);
+            out << _channels[i]->name << '\t';
+            out.write(line.data() + tab + 1, line.size() - tab - 1);
+        }
+        else
+        {
+            out << line;
+        }
+
+        int64_t time;
+        if(_channels[i]->next(_end, time, lines[i]))
+        {
+            heads.push(Head(time, i));
+        }
+    }
+}
+
+uint64_t LogExtract::bytesRead() const
+{
+    uint64_t total = 0;
+    for(const std::unique_ptr<Channel>& channel : _channels)
+    {
+        total += channel->bytesRead;
+    }
+    return total;
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#ifndef LOG_EXTRACT_H_
+#define LOG_EXTRACT_H_
+
+/* STL Headers */
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/* C Headers */
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief Pulls a time range out of one or more log channels, `autopilot logextract`.
+ *
+ * Each channel, text or binary, starts reading where its LogIndex says the
+ * range begins and stops at the first record past the end, so the time
+ * taken depends on the size of the range rather than of the log. A channel
+ * without an index is read from the start.
+ *
+ * One channel is written as the .dat text it would have been, header and
+ * all. Several are merged in time order in to lines of
+ *
+ *     time_micros	channel	values...
+ *
+ * where channel is the file name without its extension.
+ */
+class LogExtract
+{
+public:
+    /// records from start_micros to end_micros, both included
+    LogExtract(int64_t start_micros, int64_t end_micros);
+    ~LogExtract();
+
+    /// adds the .dat or .udlog log at path, false if it can't be read
+    bool add(const std::string& path);
+
+    /// writes the range of every channel added to out
+    void write(std::ostream& out);
+
+    /// bytes read from the logs so far
+    uint64_t bytesRead() const;
+
+private:
+    LogExtract(const LogExtract&);
+    LogExtract& operator=(const LogExtract&);
+
+    class Channel;
+
+    int64_t _start;
+    int64_t _end;
+    std::vector<std::unique_ptr<Channel> > _channels;
+};
+
+#endif /* LOG_EXTRACT_H_ */
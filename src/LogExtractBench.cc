@@ -0,0 +1,159 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "LogExtract.h"
+#include "LogIndex.h"
+#include "Benchmark.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+namespace
+{
+const uint64_t LOG_BYTES = 1024ull * 1024 * 1024;
+const int64_t SAMPLE_MICROS = 1000;
+const int64_t WINDOW_MICROS = 30 * 1000000ll;
+
+/// a line about the size of a control effort sample, after the time
+const std::string VALUES = "\t0.012345\t-0.543210\t1.000000\t0.250000\t-0.125000\t3.141593\t"
+                           "2.718282\t-1.414214\t0.707107\t\n";
+
+/**
+ * A 1 GiB channel logged at 1 kHz, indexed like LogfileWriter does with the
+ * default log.index_records and log.index_kb, and the same log again
+ * without an index. Written once and removed when the benchmarks exit.
+ */
+class BigLog
+{
+public:
+    BigLog()
+    {
+        char folder[] = "/tmp/log_extract_bench_XXXXXX";
+        _folder = mkdtemp(folder);
+        indexed = _folder + "/imu.dat";
+        unindexed = _folder + "/imu_unindexed.dat";
+
+        int fd = open(indexed.c_str(), O_CREAT | O_WRONLY | O_TRUNC, 0644);
+        std::string chunk = "Time(micros)\tvalues\n";
+        std::vector<LogIndex::Entry> entries;
+        uint64_t size = 0;
+        uint64_t records = 0;
+        uint64_t since_entry = 0;
+        int64_t time = 0;
+        while(size + chunk.size() < LOG_BYTES)
+        {
+            if(records > 0 && (records % 1000 == 0 || since_entry >= 64 * 1024))
+            {
+                entries.push_back(LogIndex::Entry{time, size + chunk.size()});
+                since_entry = 0;
+            }
+
+            size_t start = chunk.size();
+            chunk += std::to_string(time);
+            chunk += VALUES;
+            since_entry += chunk.size() - start;
+            records++;
+            time += SAMPLE_MICROS;
+
+            if(chunk.size() >= 1024 * 1024)
+            {
+                size += write(fd, chunk.data(), chunk.size());
+                chunk.clear();
+            }
+        }
+        size += write(fd, chunk.data(), chunk.size());
+        fdatasync(fd);
+        close(fd);
+        end = time;
+
+        fd = open(LogIndex::pathFor(indexed).c_str(), O_CREAT | O_WRONLY | O_TRUNC, 0644);
+        if(write(fd, LogIndex::MAGIC, LogIndex::MAGIC_LENGTH) < 0 ||
+           write(fd, entries.data(), entries.size() * sizeof(LogIndex::Entry)) < 0)
+        {
+            entries.clear();
+        }
+        close(fd);
+
+        if(link(indexed.c_str(), unindexed.c_str()) != 0)
+        {
+            unindexed = indexed;
+        }
+    }
+
+    ~BigLog()
+    {
+        unlink(unindexed.c_str());
+        unlink(indexed.c_str());
+        unlink(LogIndex::pathFor(indexed).c_str());
+        rmdir(_folder.c_str());
+    }
+
+    /// drops the log from the page cache, so it is read from disk
+    void evict()
+    {
+        int fd = open(indexed.c_str(), O_RDONLY);
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+
+    std::string indexed;
+    std::string unindexed;
+    /// the time after the last record
+    int64_t end;
+
+private:
+    std::string _folder;
+};
+
+BigLog& bigLog()
+{
+    static BigLog log;
+    return log;
+}
+
+/// extracts 30 s from the middle of path
+void run(Benchmark& bench, const std::string& path, bool cold)
+{
+    BigLog& log = bigLog();
+    if(cold)
+    {
+        log.evict();
+    }
+
+    int64_t start = log.end / 2;
+    uint64_t begin = Benchmark::nowNanos();
+    LogExtract extract(start, start + WINDOW_MICROS);
+    extract.add(path);
+    std::stringstream out;
+    extract.write(out);
+    uint64_t elapsed = Benchmark::nowNanos() - begin;
+
+    bench.report("time", elapsed / 1e6, "ms");
+    bench.report("read", extract.bytesRead() / (1024.0 * 1024.0), "MiB");
+    bench.report("extracted", out.str().size() / (1024.0 * 1024.0), "MiB");
+}
+}
+
+BENCHMARK(LogExtract, Indexed30sOf1GiB)
+{
+    run(bench, bigLog().indexed, false);
+}
+
+BENCHMARK(LogExtract, Indexed30sOf1GiBCold)
+{
+    run(bench, bigLog().indexed, true);
+}
+
+// what finding the range took before, reading from the start of the log
+BENCHMARK(LogExtract, Unindexed30sOf1GiB)
+{
+    run(bench, bigLog().unindexed, false);
+}
@@ -0,0 +1,205 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "LogExtract.h"
+#include "BinaryLog.h"
+#include "LogIndex.h"
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+namespace
+{
+/// a folder of logs written the way LogfileWriter writes them
+class Logs
+{
+public:
+    Logs()
+    {
+        char folder[] = "/tmp/log_extract_XXXXXX";
+        _folder = mkdtemp(folder);
+    }
+
+    ~Logs()
+    {
+        for(const std::string& path : _paths)
+        {
+            unlink(path.c_str());
+        }
+        rmdir(_folder.c_str());
+    }
+
+    /**
+     * Writes name, the header and then every line at the times given, with an
+     * index entry every index_every lines, 0 for no index.
+     */
+    std::string text(const std::string& name, const std::vector<int64_t>& times, size_t index_every)
+    {
+        std::string log = "Time(micros)\tvalue\n";
+        std::vector<LogIndex::Entry> entries;
+        for(size_t i = 0; i < times.size(); i++)
+        {
+            if(index_every > 0 && i > 0 && i % index_every == 0)
+            {
+                entries.push_back(LogIndex::Entry{times[i], log.size()});
+            }
+            log += line(times[i]);
+        }
+        return write(name, log, entries, index_every > 0);
+    }
+
+    /// a binary channel of one int32 per record
+    std::string binary(const std::string& name, const std::vector<int64_t>& times, size_t index_every)
+    {
+        std::string log = BinaryLog::fileHeader(BinaryLog::TYPE_INT32, "value");
+        std::vector<LogIndex::Entry> entries;
+        for(size_t i = 0; i < times.size(); i++)
+        {
+            if(i > 0 && i % index_every == 0)
+            {
+                entries.push_back(LogIndex::Entry{times[i], log.size()});
+            }
+            std::vector<uint8_t> record(BinaryLog::recordLength(BinaryLog::TYPE_INT32, 1));
+            BinaryLog::encodeRecord(record.data(), BinaryLog::TYPE_INT32, times[i], std::vector<int>{value(times[i])});
+            log.append(reinterpret_cast<const char*>(record.data()), record.size());
+        }
+        return write(name, log, entries, true);
+    }
+
+    static int value(int64_t time)
+    {
+        return static_cast<int>(time % 1000);
+    }
+
+    /// the .dat line at time
+    static std::string line(int64_t time)
+    {
+        return std::to_string(time) + "\t" + std::to_string(value(time)) + "\t\n";
+    }
+
+private:
+    std::string write(const std::string& name, const std::string& log,
+                      const std::vector<LogIndex::Entry>& entries, bool indexed)
+    {
+        std::string path = _folder + "/" + name;
+        std::ofstream(path.c_str(), std::ofstream::binary) << log;
+        _paths.push_back(path);
+
+        if(indexed)
+        {
+            std::ofstream index(LogIndex::pathFor(path).c_str(), std::ofstream::binary);
+            index.write(LogIndex::MAGIC, LogIndex::MAGIC_LENGTH);
+            index.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(LogIndex::Entry));
+            _paths.push_back(LogIndex::pathFor(path));
+        }
+        return path;
+    }
+
+    std::string _folder;
+    std::vector<std::string> _paths;
+};
+
+std::vector<int64_t> every(int64_t first, int64_t last, int64_t step)
+{
+    std::vector<int64_t> times;
+    for(int64_t time = first; time <= last; time += step)
+    {
+        times.push_back(time);
+    }
+    return times;
+}
+
+std::string extract(int64_t start, int64_t end, const std::vector<std::string>& paths, uint64_t* bytes = nullptr)
+{
+    LogExtract extract(start, end);
+    for(const std::string& path : paths)
+    {
+        EXPECT_TRUE(extract.add(path));
+    }
+    std::stringstream out;
+    extract.write(out);
+    if(bytes != nullptr)
+    {
+        *bytes = extract.bytesRead();
+    }
+    return out.str();
+}
+}
+
+TEST(LogExtract, OneChannelIsItsOwnText)
+{
+    Logs logs;
+    std::string path = logs.text("imu.dat", every(0, 99990, 10), 100);
+
+    std::string expected = "Time(micros)\tvalue\n";
+    for(int64_t time = 50000; time <= 50100; time += 10)
+    {
+        expected += Logs::line(time);
+    }
+    EXPECT_EQ(expected, extract(50000, 50100, {path}));
+}
+
+TEST(LogExtract, IndexSkipsTheStartOfTheLog)
+{
+    Logs logs;
+    std::vector<int64_t> times = every(0, 999990, 10);
+    std::string indexed = logs.text("indexed.dat", times, 100);
+    std::string unindexed = logs.text("unindexed.dat", times, 0);
+
+    uint64_t indexed_bytes = 0;
+    uint64_t unindexed_bytes = 0;
+    std::string from_index = extract(900000, 900500, {indexed}, &indexed_bytes);
+    EXPECT_EQ(from_index, extract(900000, 900500, {unindexed}, &unindexed_bytes));
+
+    // the unindexed log is read from the start, the indexed one from just before the range
+    EXPECT_GT(unindexed_bytes, 1000000u);
+    EXPECT_LE(indexed_bytes, 2 * 64 * 1024u);
+}
+
+TEST(LogExtract, MergesChannelsByTime)
+{
+    Logs logs;
+    std::string gps = logs.text("gps.dat", every(0, 1000, 200), 2);
+    std::string imu = logs.text("imu.dat", every(50, 1000, 100), 2);
+
+    EXPECT_EQ("Time(micros)\tChannel\tValues\n"
+              "400\tgps\t400\t\n"
+              "450\timu\t450\t\n"
+              "550\timu\t550\t\n"
+              "600\tgps\t600\t\n",
+              extract(400, 600, {gps, imu}));
+}
+
+TEST(LogExtract, BinaryChannels)
+{
+    Logs logs;
+    std::string path = logs.binary("servo.udlog", every(0, 99990, 10), 100);
+
+    std::string expected = "Time(micros)\tvalue\n";
+    for(int64_t time = 70000; time <= 70020; time += 10)
+    {
+        expected += Logs::line(time);
+    }
+    EXPECT_EQ(expected, extract(70000, 70020, {path}));
+}
+
+TEST(LogExtract, RangeOutsideTheLog)
+{
+    Logs logs;
+    std::string path = logs.text("imu.dat", every(1000, 2000, 10), 10);
+
+    EXPECT_EQ("Time(micros)\tvalue\n", extract(0, 500, {path}));
+    EXPECT_EQ("Time(micros)\tvalue\n", extract(5000, 6000, {path}));
+
+    LogExtract missing(0, 1);
+    EXPECT_FALSE(missing.add("/tmp/no_such_log.dat"));
+}
@@ -22,6 +22,8 @@
 #include "LogFile.h"
 #include "Debug.h"
 #include "LogFileWriter.h"
+#include "LogWriter.h"
+#include "Configuration.h"
 
 // System Headers
 #include <iostream>
@@ -33,8 +35,18 @@
 LogFile::LogFile()
 :startTime(std::chrono::system_clock::now()),
  log_folder(),
- _checkpoint(0)
+ _checkpoint(0),
+ _binary(false)
 {
+    Configuration* config = Configuration::getInstance();
+    config->describe("log.binary",
+                     "true, false",
+                     "Write logData channels as typed binary .udlog files, see autopilot logconvert");
+    _binary = config->getb("log.binary", false);
+
+    // started here so nothing it logs while starting up can come back for it
+    LogWriter::getInstance();
+
     setupLogFolder();
 }
 
@@ -76,13 +88,71 @@ void LogFile::logHeader(const std::string& name, const std::string& header)
     LogfileWriter::getLogger(name)->setHeader(header);
 }
 
+void LogFile::logPrecision(const std::string& name, int digits)
+{
+    LogfileWriter::getLogger(name)->setPrecision(digits);
+}
+
+LogChannel LogFile::channel(const std::string& name, const std::string& header)
+{
+    LogfileWriter* writer = LogfileWriter::getLogger(name);
+    if(! header.empty())
+    {
+        writer->setHeader(header);
+    }
+
+    return LogChannel(this, writer);
+}
+
+LogfileWriter* LogFile::recordChannel(const std::string& name, const BinaryLog::Layout& layout)
+{
+    LogfileWriter* writer = LogfileWriter::getLogger(name);
+    writer->useLayout(layout);
+    return writer;
+}
+
+void LogFile::triggerFlightRecorder(const std::string& reason)
+{
+    LogWriter::getInstance()->trigger(reason);
+}
+
 void LogFile::logMessage(const std::string& name, const std::string& msg)
 {
-    std::stringstream dataStr;
+    channel(name).message(msg);
+}
+
+void LogChannel::message(const std::string& msg) const
+{
+    if(_writer == nullptr)
+    {
+        return;
+    }
 
-    dataStr << getMicrosSinceInit() << '\t';
-    dataStr << msg;
-    dataStr << std::endl;
+    TextLine line;
+    line.appendNumber(static_cast<int64_t>(_file->getMicrosSinceInit()), 0);
+    line.append('\t');
+    line.append(msg.data(), msg.size());
+    line.append('\n');
 
-    LogfileWriter::getLogger(name)->log(dataStr.str());
+    appendLine(_writer, line, false);
+}
+
+BinaryLog::Type LogChannel::binaryType(LogfileWriter* writer, BinaryLog::Type wanted)
+{
+    return writer->useBinary(wanted);
+}
+
+void LogChannel::append(LogfileWriter* writer, const uint8_t* record, size_t length)
+{
+    writer->log(reinterpret_cast<const char*>(record), length, true);
+}
+
+void LogChannel::appendLine(LogfileWriter* writer, const TextLine& line, bool sample)
+{
+    writer->useText()->log(line.data(), line.size(), sample);
+}
+
+int LogChannel::precision(LogfileWriter* writer)
+{
+    return writer->precision();
 }
@@ -28,11 +28,14 @@
 #include <chrono>
 #include <mutex>
 #include <atomic>
+#include <vector>
 
 /* c headers */
 #include <stdint.h>
 #include <time.h>
 
+#include "BinaryLog.h"
+#include "NumberFormat.h"
 #include "Driver.h"
 #include "ThreadSafeVariable.h"
 #include "Singleton.h"
@@ -80,6 +83,36 @@
 	which allows LogFileWrite to tell MainApp it exists so that the main program can wait
 	until LogFileWrite terminates before exiting.
 
+	Code that logs every control cycle should register its channel once with
+	LogFile::channel() and log through the returned LogChannel, which skips
+	the name lookup logData() and logMessage() do on every call.
+
+   \code
+	LogChannel effort = LogFile::getInstance()->channel("Control Effort", "roll\tpitch");
+	...
+	effort.log(control_effort);
+   \endcode
+
+	Channels with a fixed set of columns should declare them as a LOG_RECORD
+	struct (LogRecord.h) and register with channel<Record>(), the header
+	comes from the struct and logging is a copy of it, formatted as text
+	later by the writer thread.
+
+	Text channels write floating point values with log.precision digits
+	after the point, 6 unless it is set, and LogFile::logPrecision() changes
+	it for one channel. Numbers go straight in to the line through
+	NumberFormat rather than through a stringstream.
+
+	Setting log.binary in config.xml writes logData channels in the typed
+	binary format described in BinaryLog instead of text, channels only ever
+	given logMessage stay text. A logMessage to a binary channel goes to a
+	text channel named after it, "NAME text". `autopilot logconvert` turns
+	binary channels back in to the usual .dat files.
+
+	Setting log.recorder keeps each channel's last few seconds in memory and
+	triggerFlightRecorder() dumps them beside the regular logs, which then
+	only get every log.recorder_decimation-th sample. See LogWriter.
+
    \code
 	using std::vector;
 
@@ -102,8 +135,91 @@
    \todo Add the ability to set a base directory
  */
 
+class LogfileWriter;
+class LogFile;
+
+/**
+ * A handle on one log channel from LogFile::channel(). Logging through it
+ * is a lock-free append with no lookup by name. Handles are cheap to copy
+ * and stay valid for the life of the program.
+ */
+class LogChannel
+{
+public:
+    /// a handle that logs nowhere, for members registered later
+    LogChannel()
+    :_file(nullptr),
+     _writer(nullptr)
+    {}
+
+    /// logs a sample from any data container that supports const iterators
+    template<typename DataContainer>
+    void log(const DataContainer& data) const;
+
+    /// appends msg as a timestamped line of text
+    void message(const std::string& msg) const;
+
+    bool isRegistered() const
+    {
+        return _writer != nullptr;
+    }
+
+private:
+    friend class LogFile;
+    template<typename Record> friend class LogRecordChannel;
+
+    LogChannel(LogFile* file, LogfileWriter* writer)
+    :_file(file),
+     _writer(writer)
+    {}
+
+    /// the type the channel stores values as, TYPE_UNKNOWN if it is text
+    static BinaryLog::Type binaryType(LogfileWriter* writer, BinaryLog::Type wanted);
+    /// queues an encoded sample
+    static void append(LogfileWriter* writer, const uint8_t* record, size_t length);
+    /// queues a line, a sample if it is data and not a message
+    static void appendLine(LogfileWriter* writer, const TextLine& line, bool sample);
+    /// digits after the point in the channel's text
+    static int precision(LogfileWriter* writer);
+
+    LogFile* _file;
+    LogfileWriter* _writer;
+};
+
+/**
+ * A handle on a channel of LOG_RECORD structs from LogFile::channel<Record>().
+ * Logging copies the struct in to the writer's queue, the header and the
+ * text or binary layout all come from Record.
+ */
+template<typename Record>
+class LogRecordChannel
+{
+public:
+    /// a handle that logs nowhere, for members registered later
+    LogRecordChannel()
+    {}
+
+    void log(const Record& record) const;
+
+    bool isRegistered() const
+    {
+        return _channel.isRegistered();
+    }
+
+private:
+    friend class LogFile;
+
+    explicit LogRecordChannel(const LogChannel& channel)
+    :_channel(channel)
+    {}
+
+    LogChannel _channel;
+};
+
 class LogFile : public Singleton<LogFile>
 {
+    friend class LogChannel;
+    template<typename Record> friend class LogRecordChannel;
     friend Singleton<LogFile>;
 
 public:
@@ -116,12 +232,32 @@ public:
     */
     void logHeader(const std::string& name, const std::string& header);
 
+    /**
+     * Sets how many digits after the point the text log name writes its
+     * floating point values with, log.precision unless it is set. Binary
+     * logs keep every digit regardless.
+     */
+    void logPrecision(const std::string& name, int digits);
+
     /**
      * Template log function which logs any data container that supports
      * const iterators
      */
     template<typename DataContainer>
     void logData(const std::string& name, const DataContainer& data);
+    /**
+     * Registers the channel name, setting its header if one is given, and
+     * returns a handle for logging to it. Call once and keep the handle.
+     */
+    LogChannel channel(const std::string& name, const std::string& header = "");
+
+    /**
+     * Registers the channel name for Record, a LOG_RECORD struct, taking its
+     * header from the struct. Only Records should be logged to it.
+     */
+    template<typename Record>
+    LogRecordChannel<Record> channel(const std::string& name);
+
     /**
      * Allows message logging by appending msg to the log, name
      * @param name log file to append message to
@@ -134,6 +270,18 @@ public:
      */
     void newLogPoint();
 
+    /**
+     * Dumps the last few seconds of every channel to a folder of their own
+     * when log.recorder is on, see LogWriter::trigger. Safe from any thread.
+     */
+    void triggerFlightRecorder(const std::string& reason);
+
+    /// true if logData channels are written in the binary format
+    bool binaryEnabled() const
+    {
+        return _binary;
+    }
+
     Path getLogFolder()
     {
         std::lock_guard<std::mutex> lg(_logFolderLock);
@@ -156,6 +304,9 @@ private:
 
     void setupLogFolder();
 
+    /// the writer for name, set up to take records of layout
+    static LogfileWriter* recordChannel(const std::string& name, const BinaryLog::Layout& layout);
+
     /// Stores the time when the class is instantiated (i.e., the program starts)
     std::chrono::time_point<std::chrono::system_clock> startTime;
     /// Stores the folder name to store the log files in
@@ -166,22 +317,75 @@ private:
 
     /// The lock for the log folder.
     std::mutex _logFolderLock;
+
+    /// log.binary from config.xml, read once at startup
+    bool _binary;
 };
 
 
 template<typename DataContainer>
 void LogFile::logData(const std::string& name, const DataContainer& data)
 {
-    std::stringstream output;
+    channel(name).log(data);
+}
+
+template<typename Record>
+LogRecordChannel<Record> LogFile::channel(const std::string& name)
+{
+    return LogRecordChannel<Record>(LogChannel(this, recordChannel(name, Record::layout())));
+}
 
+template<typename Record>
+void LogRecordChannel<Record>::log(const Record& record) const
+{
+    if(_channel._writer == nullptr)
+    {
+        return;
+    }
+
+    uint8_t encoded[BinaryLog::RECORD_HEADER_LENGTH + sizeof(Record)];
+    size_t length = BinaryLog::encodeRecord(encoded, _channel._file->getMicrosSinceInit(), record);
+    LogChannel::append(_channel._writer, encoded, length);
+}
+
+template<typename DataContainer>
+void LogChannel::log(const DataContainer& data) const
+{
+    if(_writer == nullptr)
+    {
+        return;
+    }
+
+    if(_file->_binary)
+    {
+        BinaryLog::Type type = binaryType(_writer, BinaryLog::typeOf<typename DataContainer::value_type>());
+        if(type != BinaryLog::TYPE_UNKNOWN)
+        {
+            // most samples fit on the stack
+            uint8_t stack_record[BinaryLog::RECORD_HEADER_LENGTH + 32 * sizeof(double)];
+            size_t length = BinaryLog::recordLength(type, data.size());
+            std::vector<uint8_t> heap_record(length > sizeof(stack_record) ? length : 0);
+            uint8_t* record = heap_record.empty() ? stack_record : heap_record.data();
+
+            length = BinaryLog::encodeRecord(record, type, _file->getMicrosSinceInit(), data);
+            append(_writer, record, length);
+            return;
+        }
+    }
+
+    int digits = precision(_writer);
+    TextLine line;
+    line.appendNumber(static_cast<int64_t>(_file->getMicrosSinceInit()), 0);
+    line.append('\t');
     for (typename DataContainer::const_iterator it = data.begin(); it != data.end(); ++it)
     {
-        output << std::to_string(*it);
-        output << '\t';
+        line.appendNumber(*it, digits);
+        line.append('\t');
     }
+    line.append('\n');
 
-    logMessage(name, output.str()); // adds timestamp, endline
-};
+    appendLine(_writer, line, true);
+}
 
 
 #endif
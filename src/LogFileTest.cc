@@ -0,0 +1,111 @@
+/**
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ *
+**/
+
+#include "LogFile.h"
+#include "LogFileWriter.h"
+#include "LogRecord.h"
+#include "LogWriter.h"
+#include "Path.h"
+#include <gtest/gtest.h>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+#define LOG_FILE_TEST_FIELDS(FIELD) \
+    FIELD(double, Error) \
+    FIELD(uint8_t, Valid)
+LOG_RECORD(LogFileTestRecord, LOG_FILE_TEST_FIELDS);
+
+/// the lines of a channel's file after its header, with the timestamps cut off
+std::vector<std::string> loggedValues(const std::string& name)
+{
+    LogWriter::getInstance()->flush();
+
+    std::ifstream input(LogfileWriter::getLogger(name)->getLogPath().c_str());
+    std::vector<std::string> values;
+    std::string line;
+    std::getline(input, line);
+    while(std::getline(input, line))
+    {
+        values.push_back(line.substr(line.find('\t') + 1));
+    }
+    return values;
+}
+}
+
+// TESTS
+TEST(LogChannel, MatchesLogData)
+{
+    LogFile* log = LogFile::getInstance();
+    LogChannel channel = log->channel("test_channel_matches", "A B");
+    std::vector<double> sample = {1.5, -2.25};
+
+    log->logData("test_channel_matches", sample);
+    channel.log(sample);
+    channel.message("note");
+    log->logMessage("test_channel_matches", "note");
+
+    std::vector<std::string> expected = {"1.500000\t-2.250000\t", "1.500000\t-2.250000\t", "note", "note"};
+    EXPECT_EQ(expected, loggedValues("test_channel_matches"));
+}
+
+TEST(LogChannel, SameWriterAsName)
+{
+    LogChannel first = LogFile::getInstance()->channel("test_channel_same");
+    LogChannel second = LogFile::getInstance()->channel("test_channel_same", "X");
+
+    first.log(std::vector<int>{1});
+    second.log(std::vector<int>{2});
+
+    std::vector<std::string> expected = {"1\t", "2\t"};
+    EXPECT_EQ(expected, loggedValues("test_channel_same"));
+}
+
+TEST(LogChannel, UnregisteredLogsNothing)
+{
+    LogChannel channel;
+    EXPECT_FALSE(channel.isRegistered());
+
+    channel.log(std::vector<double>{1.0});
+    channel.message("nowhere");
+}
+
+TEST(LogRecordChannel, FormattedByTheWriter)
+{
+    LogRecordChannel<LogFileTestRecord> channel = LogFile::getInstance()->channel<LogFileTestRecord>("test_record_channel");
+    LogFileTestRecord record = {-2.5, 1};
+    channel.log(record);
+
+    std::vector<std::string> expected = {"-2.500000\t1\t"};
+    EXPECT_EQ(expected, loggedValues("test_record_channel"));
+
+    std::ifstream input(LogfileWriter::getLogger("test_record_channel")->getLogPath().c_str());
+    std::string header;
+    std::getline(input, header);
+    EXPECT_EQ("Time(micros)\tError Valid", header);
+}
+
+TEST(LogChannel, PrecisionPerChannel)
+{
+    LogFile* log = LogFile::getInstance();
+    log->logPrecision("test_channel_precision", 2);
+    LogChannel channel = log->channel("test_channel_precision");
+    channel.log(std::vector<double>{3.14159, -0.005});
+    channel.log(std::vector<int>{42});
+
+    LogRecordChannel<LogFileTestRecord> records = log->channel<LogFileTestRecord>("test_record_precision");
+    log->logPrecision("test_record_precision", 0);
+    records.log(LogFileTestRecord{2.75, 1});
+
+    std::vector<std::string> expected = {"3.14\t-0.01\t", "42\t"};
+    EXPECT_EQ(expected, loggedValues("test_channel_precision"));
+    expected = {"3\t1\t"};
+    EXPECT_EQ(expected, loggedValues("test_record_precision"));
+}
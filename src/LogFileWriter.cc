@@ -18,17 +18,16 @@
  ******************************************************************************/
 
 #include "LogFileWriter.h"
-#include "RateLimiter.h"
 
 #include <exception>
 #include <iostream>
-#include <fstream>
-#include <thread>
 
 
 // static members
 std::map<std::string, LogfileWriter*> LogfileWriter::_ALL_LOGGERS;
 std::recursive_mutex LogfileWriter::_ALL_LOGGERS_MUTEX;
+const uint64_t LogfileWriter::RETRY_OPEN_MS;
+const uint64_t LogfileWriter::RETRY_OPEN_MAX_MS;
 
 
 LogfileWriter* LogfileWriter::getLogger(const std::string& path)
@@ -54,95 +53,298 @@ LogfileWriter* LogfileWriter::getLogger(const std::string& path)
 
 
 LogfileWriter::LogfileWriter(std::string path)
-    :Driver("LogFile", "log")
+    :_logName(path),
+     _format(LogFile::getInstance()->binaryEnabled() ? FORMAT_UNDECIDED : FORMAT_TEXT),
+     _binaryType(BinaryLog::TYPE_UNKNOWN),
+     _layout(nullptr),
+     _textChannel(nullptr),
+     _precision(NumberFormat::DEFAULT_PRECISION),
+     _worker(nullptr),
+     _dropped(0),
+     _retryOpenMs(0),
+     _openBackoffMs(0),
+     _indexRecords(0),
+     _indexBytes(0),
+     _recordsSinceIndex(0),
+     _bytesSinceIndex(0),
+     _decimation(1),
+     _samples(0)
 {
-    _logName = path;
-    _currentBuffer = &_firstBuffer;
-
-    //debug() << "Created for " << path;
-
-    // all logging write threads will die when the software shuts down.
-    new std::thread(std::bind(&LogfileWriter::writeThread, this));
+    // all channels share the writer threads rather than having one each
+    _worker = LogWriter::getInstance()->attach(this);
 }
 
 LogfileWriter::~LogfileWriter()
 {
+    LogWriter::getInstance()->detach(this);
+
     _ALL_LOGGERS_MUTEX.lock();
     _ALL_LOGGERS.erase(_logName);
     _ALL_LOGGERS_MUTEX.unlock();
 }
 
+std::string LogfileWriter::fileName()
+{
+    if (_format == FORMAT_BINARY)
+    {
+        return _logName + ".udlog";
+    }
+    else if (! Path(_logName).has_extension() )
+    {
+        return _logName + ".dat";
+    }
+
+    return _logName;
+}
+
 Path LogfileWriter::getLogPath()
 {
-    Path filename;
-    if (! Path(_logName).has_extension() )
+    return LogFile::getInstance()->getLogFolder() / fileName();
+}
+
+void LogfileWriter::log(const std::string& message, bool sample)
+{
+    useText()->log(message.data(), message.size(), sample);
+}
+
+void LogfileWriter::log(const char* data, size_t length, bool sample)
+{
+    if(! LogWriter::enqueue(_worker, this, data, length, sample))
     {
-        filename = LogFile::getInstance()->getLogFolder() / (_logName + ".dat");
+        _dropped++;
     }
-    else
+}
+
+void LogfileWriter::decideFormat(Format format, BinaryLog::Type type)
+{
+    std::lock_guard<std::mutex> lock(_formatLock);
+    if(_format == FORMAT_UNDECIDED)
     {
-        filename = LogFile::getInstance()->getLogFolder() / _logName;
+        _binaryType = type;
+        _format = format;
     }
+}
 
-    return filename;
+BinaryLog::Type LogfileWriter::useBinary(BinaryLog::Type type)
+{
+    if(_format == FORMAT_UNDECIDED)
+    {
+        decideFormat(FORMAT_BINARY, type);
+    }
+
+    return _format == FORMAT_BINARY ? _binaryType : BinaryLog::TYPE_UNKNOWN;
 }
 
-std::stringstream* LogfileWriter::swapBuffers()
+LogfileWriter* LogfileWriter::useText()
 {
-    std::lock_guard<std::mutex> lock(_currentBufferLock);
+    if(_format == FORMAT_UNDECIDED)
+    {
+        decideFormat(FORMAT_TEXT, BinaryLog::TYPE_UNKNOWN);
+    }
+
+    if(_format != FORMAT_BINARY)
+    {
+        return this;
+    }
+
+    // getLogger hands every thread that gets here the same channel
+    LogfileWriter* text = _textChannel.load();
+    if(text == nullptr)
+    {
+        text = getLogger(_logName + " text");
+        text->useText();
+        _textChannel = text;
+    }
+    return text;
+}
+
+void LogfileWriter::useLayout(const BinaryLog::Layout& layout)
+{
+    setHeader(BinaryLog::columnNames(layout));
+    _layout = &layout;
+    if(_format == FORMAT_UNDECIDED)
+    {
+        decideFormat(FORMAT_BINARY, BinaryLog::TYPE_RECORD);
+    }
+}
+
+void LogfileWriter::append(const char* data, size_t length, bool sample, uint64_t now_ms)
+{
+    if(_recorder)
+    {
+        _recorder->record(now_ms, data, length);
+    }
+
+    if(sample && _samples++ % _decimation != 0)
+    {
+        return;
+    }
+
+    size_t start = _pending.size();
+    format(data, length, _pending);
 
-    std::stringstream* firstPtr = &_firstBuffer;
-    std::stringstream* secondPtr = &_secondBuffer;
+    // the first record after a new log point starts the file, so needs no entry
+    bool due = (_recordsSinceIndex >= _indexRecords || _bytesSinceIndex >= _indexBytes);
+    _recordsSinceIndex++;
+    _bytesSinceIndex += _pending.size() - start;
 
-    if(_currentBuffer == firstPtr)
+    LogIndex::Entry entry;
+    if(due && _indexRecords > 0 && LogIndex::recordTime(_pending.data() + start, _pending.size() - start,
+                                                        _format == FORMAT_BINARY, entry.time_micros))
     {
-        _currentBuffer = secondPtr;
-        return firstPtr;
+        entry.offset = start;
+        _pendingIndex.push_back(entry);
+        _recordsSinceIndex = 1;
+        _bytesSinceIndex = _pending.size() - start;
+    }
+}
+
+void LogfileWriter::format(const char* data, size_t length, std::string& out)
+{
+    const BinaryLog::Layout* layout = _layout.load();
+    if(layout != nullptr && _format != FORMAT_BINARY)
+    {
+        // formatted here so the thread that logged it only copied the struct
+        BinaryLog::recordText(*layout, reinterpret_cast<const uint8_t*>(data), length, out, precision());
     }
     else
     {
-        _currentBuffer = firstPtr;
-        return secondPtr;
+        out.append(data, length);
     }
 }
 
-void LogfileWriter::log(const std::string& message)
+std::string LogfileWriter::fileHeader()
 {
-    std::lock_guard<std::mutex> lock(_currentBufferLock);
-    *_currentBuffer << message;
+    std::string header = _header;
+    const BinaryLog::Layout* layout = _layout.load();
+    if(_format == FORMAT_BINARY && layout != nullptr)
+    {
+        return BinaryLog::fileHeader(*layout);
+    }
+    else if(_format == FORMAT_BINARY)
+    {
+        return BinaryLog::fileHeader(_binaryType, header);
+    }
+
+    return "Time(micros)\t" + header + "\n";
 }
 
-void LogfileWriter::writeThread()
+void LogfileWriter::dumpRecorder(const Path& folder, uint64_t since_ms)
 {
-    RateLimiter rl(2);
+    if(! _recorder || _recorder->entries() == 0 || _format == FORMAT_UNDECIDED)
+    {
+        return;
+    }
 
-    while(! terminateRequested())
+    Path filename = folder / fileName();
+    std::ofstream output(filename.c_str(), std::ofstream::out | std::ofstream::binary);
+    output << fileHeader();
+
+    std::string line;
+    _recorder->forEachSince(since_ms, [&](const char* data, size_t length)
     {
-        Path filename = getLogPath();
-        bool existed = filename.exists();
+        line.clear();
+        format(data, length, line);
+        output.write(line.data(), line.size());
+    });
+}
 
-        std::fstream output(filename.c_str(), std::fstream::out | std::fstream::ate | std::fstream::app);
+void LogfileWriter::writeOut(const Logger& logger, const DurableFile::Policy& policy, uint64_t now_ms, bool commit)
+{
+    // the file name and header depend on the format
+    if(_format == FORMAT_UNDECIDED)
+    {
+        return;
+    }
 
-        if(! existed)
+    // a new log point moves the file
+    Path filename = getLogPath();
+    if(! _file || _file->path() != filename.toString())
+    {
+        if(filename.toString() == _unopened && now_ms < _retryOpenMs)
         {
-            info() << "Creating log file " << filename.c_str();
-            std::string header = _header;
-            output << "Time(micros)\t" << header << std::endl;
+            // nowhere to put it, and holding on to it would grow without bound
+            _pending.clear();
+            _pendingIndex.clear();
+            return;
         }
 
-        while(! terminateRequested() && filename.exists())
+        _file.reset(new DurableFile(filename.toString(), policy));
+        if(! _file->isOpen())
         {
-            rl.wait();
+            if(filename.toString() != _unopened)
+            {
+                logger.warning() << "Could not open log file " << filename.c_str()
+                                 << ", dropping its data until it can be";
+                _unopened = filename.toString();
+                _openBackoffMs = RETRY_OPEN_MS;
+            }
+            else
+            {
+                _openBackoffMs = std::min(2 * _openBackoffMs, RETRY_OPEN_MAX_MS);
+            }
+            _retryOpenMs = now_ms + _openBackoffMs;
 
-            std::stringstream* writeBuffer = swapBuffers();
-            output << writeBuffer->str();
-            writeBuffer->str("");
+            _file.reset();
+            _index.reset();
+            _pending.clear();
+            _pendingIndex.clear();
+            return;
+        }
 
-            rl.finishedCriticalSection();
+        if(! _unopened.empty())
+        {
+            logger.info() << "Opened log file " << filename.c_str() << " after failing to";
+            _unopened.clear();
+        }
 
-            filename = getLogPath();
+        if(_file->isNew())
+        {
+            logger.info() << "Creating log file " << filename.c_str();
+            std::string header = fileHeader();
+            _file->append(header.data(), header.size(), now_ms);
         }
 
-        output.close();
+        if(_indexRecords > 0)
+        {
+            // the index is small, it isn't worth reserving space for
+            DurableFile::Policy index_policy = policy;
+            index_policy.preallocate_bytes = 0;
+            _index.reset(new DurableFile(LogIndex::pathFor(filename.toString()), index_policy));
+            if(_index->isNew())
+            {
+                _index->append(LogIndex::MAGIC, LogIndex::MAGIC_LENGTH, now_ms);
+            }
+        }
     }
+
+    uint64_t base = _file->size();
+    _file->append(_pending.data(), _pending.size(), now_ms);
+    _pending.clear();
+
+    if(_index)
+    {
+        for(LogIndex::Entry& entry : _pendingIndex)
+        {
+            entry.offset += base;
+        }
+        _index->append(reinterpret_cast<const char*>(_pendingIndex.data()),
+                       _pendingIndex.size() * sizeof(LogIndex::Entry), now_ms);
+    }
+    _pendingIndex.clear();
+
+    if(commit)
+    {
+        _file->commit(now_ms);
+        if(_index)
+        {
+            _index->commit(now_ms);
+        }
+    }
+}
+
+void LogfileWriter::closeFile()
+{
+    _file.reset();
+    _index.reset();
 }
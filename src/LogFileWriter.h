@@ -20,54 +20,187 @@
 #ifndef LOGFILEWRITER_H_
 #define LOGFILEWRITER_H_
 
-#include "Driver.h"
+#include "BinaryLog.h"
+#include "Debug.h"
+#include "DurableFile.h"
+#include "FlightRecorder.h"
+#include "LogIndex.h"
 #include "LogFile.h"
+#include "LogWriter.h"
+#include "NumberFormat.h"
 #include "ThreadSafeVariable.h"
 #include "Path.h"
 
-#include <sstream>
+#include <algorithm>
+#include <atomic>
+#include <fstream>
 #include <map>
+#include <memory>
 #include <string>
 #include <mutex>
+#include <vector>
 
 
 /**
- * A basic file writer that accepts strings and writes them
- * to a file periodically.
+ * One log file. Lines and records handed to log() are queued for the shared
+ * LogWriter, which appends them to the file periodically.
+ *
+ * Channels are created by getLogger() and live until the program exits.
  */
-class LogfileWriter : public Driver
+class LogfileWriter
 {
+    friend class LogWriter;
+    /// makes a channel binary without log.binary set, see LogFileWriterTest.cc
+    friend struct LogfileWriterTest;
+
 private:
     static std::recursive_mutex _ALL_LOGGERS_MUTEX;
     static std::map<std::string, LogfileWriter* > _ALL_LOGGERS;
 
+    /// text or binary is decided by the first thing logged when binary logs are enabled
+    enum Format
+    {
+        FORMAT_UNDECIDED,
+        FORMAT_TEXT,
+        FORMAT_BINARY
+    };
+
     std::string _logName;
     ThreadSafeVariable<std::string> _header;
+    std::atomic<int> _format;
+    std::mutex _formatLock;
+    /// set once before _format becomes FORMAT_BINARY
+    BinaryLog::Type _binaryType;
+    /// the LOG_RECORD struct every record is, if this is a record channel
+    std::atomic<const BinaryLog::Layout*> _layout;
+    /// where text logged to this channel goes once it is binary, made the first time it is needed
+    std::atomic<LogfileWriter*> _textChannel;
+
+    /// digits after the point in text, set from log.precision by LogWriter::attach
+    std::atomic<int> _precision;
+
+    /// the writer this channel's records are queued on
+    LogWriter::Worker* _worker;
+    std::atomic<uint64_t> _dropped;
+
+    /// only touched by the writer thread
+    std::string _pending;
+    std::unique_ptr<DurableFile> _file;
 
-    mutable std::mutex _currentBufferLock;
-    std::stringstream* _currentBuffer;
+    /// a file that can't be opened is tried again after RETRY_OPEN_MS, doubling up to RETRY_OPEN_MAX_MS
+    static const uint64_t RETRY_OPEN_MS = 1000;
+    static const uint64_t RETRY_OPEN_MAX_MS = 60000;
+    /// the file that last failed to open, empty once it has
+    std::string _unopened;
+    uint64_t _retryOpenMs;
+    uint64_t _openBackoffMs;
 
-    std::stringstream _firstBuffer;
-    std::stringstream _secondBuffer;
+    /// the time index beside _file, and entries for _pending with offsets into it
+    std::unique_ptr<DurableFile> _index;
+    std::vector<LogIndex::Entry> _pendingIndex;
+    /// set by LogWriter::attach, an index entry is added every so many records or bytes
+    uint64_t _indexRecords;
+    uint64_t _indexBytes;
+    uint64_t _recordsSinceIndex;
+    uint64_t _bytesSinceIndex;
 
-    /// swaps the buffers and returns a pointer to the one that was just swapped out.
-    std::stringstream* swapBuffers();
+    /// set by LogWriter::attach when log.recorder is on and there is memory for it
+    std::unique_ptr<FlightRecorder> _recorder;
+    /// every _decimation-th sample is written to disk, the rest only recorded
+    int _decimation;
+    uint64_t _samples;
 
-    /// a function that writes the buffers out.
-    void writeThread();
+    /// moves _format on from FORMAT_UNDECIDED
+    void decideFormat(Format format, BinaryLog::Type type);
 
+    /**
+     * Takes a queued line or record: keeps it in the recorder and, unless
+     * it is a sample being decimated, adds it to _pending and the index.
+     */
+    void append(const char* data, size_t length, bool sample, uint64_t now_ms);
+
+    /// adds a line or record to out as it goes in the file, text if this is a text record channel
+    void format(const char* data, size_t length, std::string& out);
+
+    /// what the file starts with
+    std::string fileHeader();
+
+    /// the file name in the log folder
+    std::string fileName();
+
+    /// writes what the recorder holds from since_ms on to a copy of the log in folder
+    void dumpRecorder(const Path& folder, uint64_t since_ms);
+
+    /**
+     * Appends _pending to the file and its index entries to the index,
+     * opening them and writing the header the first time or after a new
+     * log point. commit writes and syncs everything now instead of when
+     * policy says to. While the file can't be opened what is pending is
+     * dropped and the open is retried with a growing backoff, warning once.
+     */
+    void writeOut(const Logger& logger, const DurableFile::Policy& policy, uint64_t now_ms, bool commit);
+
+    /// commits and closes the file and index, a later writeOut() opens them again
+    void closeFile();
 
     LogfileWriter(std::string path);
     ~LogfileWriter();
 public:
     static LogfileWriter* getLogger(const std::string& path);
 
-    void log(const std::string& message);
+    /**
+     * Queues a line of text, making this a text channel. A sample is
+     * decimated while the flight recorder is on, a message never is.
+     * On a binary channel the line goes to its text channel, see useText().
+     */
+    void log(const std::string& message, bool sample = false);
+
+    /// queues raw bytes, like a record from BinaryLog::encodeRecord
+    void log(const char* data, size_t length, bool sample = false);
+
+    /**
+     * Makes this a binary channel storing values as type, unless something
+     * has already been logged. Returns the type values are stored as, or
+     * TYPE_UNKNOWN if this is a text channel.
+     */
+    BinaryLog::Type useBinary(BinaryLog::Type type);
+
+    /**
+     * Makes this a text channel, unless it is already binary. Returns the
+     * channel text should be queued on: this one, or for a binary channel
+     * the text channel "NAME text" beside it, so the .udlog only holds records.
+     */
+    LogfileWriter* useText();
+
+    /**
+     * Makes this a channel of records with layout, from BinaryLog::encodeRecord
+     * of a LOG_RECORD struct, and sets the header to its columns. In a text
+     * log the writer formats each record as a line.
+     */
+    void useLayout(const BinaryLog::Layout& layout);
+
     void setHeader(const std::string& header)
     {
         _header = header;
     }
 
+    /// digits after the point text lines and records are written with
+    void setPrecision(int digits)
+    {
+        _precision = std::max(0, std::min(NumberFormat::MAX_PRECISION, digits));
+    }
+
+    int precision() const
+    {
+        return _precision.load(std::memory_order_relaxed);
+    }
+
+    /// lines or records dropped because the writer's queue was full
+    uint64_t dropped() const
+    {
+        return _dropped.load();
+    }
+
     /// gets the path to the log file
     Path getLogPath();
 };
@@ -7,10 +7,18 @@
 **/
 
 #include "LogFileWriter.h"
+#include "LogWriter.h"
 #include "Path.h"
 #include <gtest/gtest.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <atomic>
 #include <thread>
 #include <chrono>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <vector>
 
 // TESTS
 TEST(LogfileWriter, getLogger)
@@ -41,3 +49,158 @@ TEST(LogfileWriter, getLogPath)
     EXPECT_TRUE(two->getLogPath().exists());
     EXPECT_TRUE(three->getLogPath().exists());
 }
+
+TEST(LogfileWriter, SharesWriterThreads)
+{
+    for(int i = 0; i < 20; i++)
+    {
+        LogfileWriter::getLogger("test_shared_" + std::to_string(i))->log("shared\n");
+    }
+
+    // one (or a configured few) threads no matter how many channels there are
+    EXPECT_LE(LogWriter::getInstance()->threads(), 4u);
+}
+
+TEST(LogfileWriter, FlushWritesEverythingQueued)
+{
+    auto channel = LogfileWriter::getLogger("test_flush");
+    std::string line = "0\t" + std::string(400, 'x') + "\n";
+    channel->log("0\tshort\n");
+    channel->log(line);
+
+    LogWriter::getInstance()->flush();
+
+    std::ifstream input(channel->getLogPath().c_str());
+    std::stringstream contents;
+    contents << input.rdbuf();
+    EXPECT_EQ("Time(micros)\t\n0\tshort\n" + line, contents.str());
+    EXPECT_EQ(0u, channel->dropped());
+}
+
+TEST(LogfileWriter, WritesATimeIndex)
+{
+    auto channel = LogfileWriter::getLogger("test_index");
+    for(int i = 0; i < 2500; i++)
+    {
+        channel->log(std::to_string(i) + "\tvalue\n", true);
+    }
+
+    LogWriter::getInstance()->flush();
+
+    // an entry every log.index_records, 1000 unless the lines pass log.index_kb first
+    std::vector<LogIndex::Entry> entries;
+    ASSERT_TRUE(LogIndex::read(LogIndex::pathFor(channel->getLogPath().toString()), entries));
+    ASSERT_EQ(2u, entries.size());
+
+    std::ifstream input(channel->getLogPath().c_str());
+    std::stringstream contents;
+    contents << input.rdbuf();
+    for(const LogIndex::Entry& entry : entries)
+    {
+        std::string time = std::to_string(entry.time_micros) + "\t";
+        EXPECT_EQ(time, contents.str().substr(entry.offset, time.size()));
+    }
+    EXPECT_EQ(1000, entries[0].time_micros);
+}
+
+/// reaches in to LogfileWriter for the tests below
+struct LogfileWriterTest
+{
+    /// a channel getLogger() doesn't know about, so it can be deleted
+    static LogfileWriter* create(const std::string& path)
+    {
+        return new LogfileWriter(path);
+    }
+
+    static void destroy(LogfileWriter* channel)
+    {
+        delete channel;
+    }
+
+    /// makes a channel binary as log.binary would
+    static void makeBinary(LogfileWriter* channel, BinaryLog::Type type)
+    {
+        channel->_binaryType = type;
+        channel->_format = LogfileWriter::FORMAT_BINARY;
+    }
+};
+
+TEST(LogfileWriter, TextOnABinaryChannelGoesBesideIt)
+{
+    auto channel = LogfileWriter::getLogger("test_binary_text");
+    LogfileWriterTest::makeBinary(channel, BinaryLog::TYPE_FLOAT64);
+
+    std::vector<double> values = {1.5, -2.25};
+    uint8_t record[BinaryLog::RECORD_HEADER_LENGTH + 2 * sizeof(double)];
+    size_t length = BinaryLog::encodeRecord(record, BinaryLog::TYPE_FLOAT64, 42, values);
+    channel->log(reinterpret_cast<const char*>(record), length, true);
+    channel->log("43\tnote\n");
+
+    LogWriter::getInstance()->flush();
+
+    std::ifstream input(channel->getLogPath().c_str(), std::ios::binary);
+    std::string binary((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    std::stringstream text;
+    ASSERT_TRUE(BinaryLog::toText(reinterpret_cast<const uint8_t*>(binary.data()), binary.size(), text));
+    EXPECT_EQ(std::string::npos, text.str().find("note"));
+    EXPECT_NE(std::string::npos, text.str().find("42\t"));
+
+    auto beside = LogfileWriter::getLogger("test_binary_text text");
+    EXPECT_EQ(beside, channel->useText());
+    std::ifstream notes(beside->getLogPath().c_str());
+    std::stringstream contents;
+    contents << notes.rdbuf();
+    EXPECT_EQ("Time(micros)\t\n43\tnote\n", contents.str());
+}
+
+TEST(LogfileWriter, DeletedWhileBeingWritten)
+{
+    std::atomic_bool done(false);
+    std::thread flusher([&done]()
+    {
+        while(! done)
+        {
+            LogWriter::getInstance()->flush();
+        }
+    });
+
+    // each delete races the writer thread writing the channel out
+    for(int i = 0; i < 200; i++)
+    {
+        LogfileWriter* channel = LogfileWriterTest::create("test_deleted_" + std::to_string(i % 10));
+        for(int j = 0; j < 1000; j++)
+        {
+            channel->log(std::to_string(j) + "\tline\n");
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(i % 5));
+        LogfileWriterTest::destroy(channel);
+    }
+
+    done = true;
+    flusher.join();
+}
+
+TEST(LogfileWriter, RetriesAFileThatWontOpen)
+{
+    auto channel = LogfileWriter::getLogger("test_unopenable");
+    std::string path = channel->getLogPath().toString();
+    ASSERT_EQ(0, mkdir(path.c_str(), 0755));
+
+    channel->log("1\tlost\n");
+    LogWriter::getInstance()->flush();
+    ASSERT_EQ(0, rmdir(path.c_str()));
+
+    // not tried again until the backoff is up
+    channel->log("2\tlost\n");
+    LogWriter::getInstance()->flush();
+    EXPECT_FALSE(channel->getLogPath().exists());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    channel->log("3\tkept\n");
+    LogWriter::getInstance()->flush();
+
+    std::ifstream input(path.c_str());
+    std::stringstream contents;
+    contents << input.rdbuf();
+    EXPECT_EQ("Time(micros)\t\n3\tkept\n", contents.str());
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#include "LogIndex.h"
+
+/* STL Headers */
+#include <algorithm>
+#include <fstream>
+
+/* C Headers */
+#include <string.h>
+
+const char LogIndex::MAGIC[8] = {'U', 'D', 'I', 'D', 'X', '0', '0', '1'};
+
+bool LogIndex::recordTime(const char* data, size_t length, bool binary, int64_t& time_micros)
+{
+    if(binary)
+    {
+        if(length < sizeof(time_micros))
+        {
+            return false;
+        }
+        memcpy(&time_micros, data, sizeof(time_micros));
+        return true;
+    }
+
+    size_t i = 0;
+    bool negative = (length > 0 && data[0] == '-');
+    if(negative)
+    {
+        i++;
+    }
+
+    int64_t time = 0;
+    size_t digits = 0;
+    for(; i < length && data[i] >= '0' && data[i] <= '9'; i++, digits++)
+    {
+        time = time * 10 + (data[i] - '0');
+    }
+
+    if(digits == 0)
+    {
+        return false;
+    }
+
+    time_micros = negative ? -time : time;
+    return true;
+}
+
+bool LogIndex::read(const std::string& path, std::vector<Entry>& entries)
+{
+    entries.clear();
+    std::ifstream input(path.c_str(), std::ifstream::in | std::ifstream::binary);
+    char magic[MAGIC_LENGTH];
+    if(! input.read(magic, MAGIC_LENGTH) || memcmp(magic, MAGIC, MAGIC_LENGTH) != 0)
+    {
+        return false;
+    }
+
+    Entry entry;
+    while(input.read(reinterpret_cast<char*>(&entry), sizeof(entry)))
+    {
+        entries.push_back(entry);
+    }
+    return true;
+}
+
+uint64_t LogIndex::seek(const std::vector<Entry>& entries, int64_t time_micros)
+{
+    std::vector<Entry>::const_iterator after = std::lower_bound(entries.begin(), entries.end(), time_micros,
+        [](const Entry& entry, int64_t time)
+        {
+            return entry.time_micros < time;
+        });
+
+    if(after == entries.begin())
+    {
+        return 0;
+    }
+    return (after - 1)->offset;
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#ifndef LOG_INDEX_H_
+#define LOG_INDEX_H_
+
+/* STL Headers */
+#include <string>
+#include <vector>
+
+/* C Headers */
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief The sparse time index LogfileWriter keeps beside each log channel.
+ *
+ * NAME.dat.idx (or NAME.udlog.idx) is MAGIC followed by one Entry every
+ * log.index_records records or log.index_kb of log, whichever comes first,
+ * little endian like BinaryLog. An entry is the time of a record and where
+ * that record starts in the log, so finding a time is a binary search over
+ * a few hundred kilobytes rather than a read of the whole log.
+ *
+ * Channels are logged in time order, so everything before an entry is no
+ * later than it. An index that is missing, or cut short by a power cut,
+ * only means reading more of the log.
+ */
+class LogIndex
+{
+public:
+    static const char MAGIC[8];
+    static const size_t MAGIC_LENGTH = sizeof(MAGIC);
+
+    struct Entry
+    {
+        int64_t time_micros;
+        uint64_t offset;
+    };
+
+    /// the index for the log at log_path
+    static std::string pathFor(const std::string& log_path)
+    {
+        return log_path + ".idx";
+    }
+
+    /**
+     * The time a record of a log was logged at, the leading number of a
+     * text line or the first field of a binary record. False if it has none,
+     * like a .dat header line.
+     */
+    static bool recordTime(const char* data, size_t length, bool binary, int64_t& time_micros);
+
+    /// reads the index at path, false if it is missing or isn't one
+    static bool read(const std::string& path, std::vector<Entry>& entries);
+
+    /**
+     * Where to start reading for records from time_micros on, the offset of
+     * the last entry before it, or 0 if there isn't one.
+     */
+    static uint64_t seek(const std::vector<Entry>& entries, int64_t time_micros);
+};
+
+#endif /* LOG_INDEX_H_ */
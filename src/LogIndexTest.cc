@@ -0,0 +1,75 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "LogIndex.h"
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <stdio.h>
+#include <unistd.h>
+
+TEST(LogIndex, RecordTime)
+{
+    int64_t time = 0;
+    std::string line = "1234567\t0.5\t\n";
+    EXPECT_TRUE(LogIndex::recordTime(line.data(), line.size(), false, time));
+    EXPECT_EQ(1234567, time);
+
+    line = "-42\t1\n";
+    EXPECT_TRUE(LogIndex::recordTime(line.data(), line.size(), false, time));
+    EXPECT_EQ(-42, time);
+
+    line = "Time(micros)\tx\n";
+    EXPECT_FALSE(LogIndex::recordTime(line.data(), line.size(), false, time));
+    EXPECT_FALSE(LogIndex::recordTime("", 0, false, time));
+
+    int64_t stored = 987654321;
+    EXPECT_TRUE(LogIndex::recordTime(reinterpret_cast<const char*>(&stored), sizeof(stored), true, time));
+    EXPECT_EQ(stored, time);
+    EXPECT_FALSE(LogIndex::recordTime(reinterpret_cast<const char*>(&stored), 4, true, time));
+}
+
+TEST(LogIndex, SeekFindsTheEntryBefore)
+{
+    std::vector<LogIndex::Entry> entries = {{100, 10}, {200, 20}, {300, 30}};
+
+    EXPECT_EQ(0u, LogIndex::seek(entries, 50));
+    EXPECT_EQ(0u, LogIndex::seek(entries, 100));
+    EXPECT_EQ(10u, LogIndex::seek(entries, 101));
+    EXPECT_EQ(20u, LogIndex::seek(entries, 300));
+    EXPECT_EQ(30u, LogIndex::seek(entries, 1000));
+    EXPECT_EQ(0u, LogIndex::seek(std::vector<LogIndex::Entry>(), 1000));
+}
+
+TEST(LogIndex, ReadsWhatWasWritten)
+{
+    char path[] = "/tmp/log_index_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    close(fd);
+
+    std::vector<LogIndex::Entry> written = {{1, 100}, {2, 200}};
+    {
+        std::ofstream output(path, std::ofstream::binary);
+        output.write(LogIndex::MAGIC, LogIndex::MAGIC_LENGTH);
+        output.write(reinterpret_cast<const char*>(written.data()), written.size() * sizeof(LogIndex::Entry));
+        // a power cut part way through an entry
+        output.write("\x03\x00\x00", 3);
+    }
+
+    std::vector<LogIndex::Entry> entries;
+    ASSERT_TRUE(LogIndex::read(path, entries));
+    ASSERT_EQ(2u, entries.size());
+    EXPECT_EQ(2, entries[1].time_micros);
+    EXPECT_EQ(200u, entries[1].offset);
+
+    EXPECT_FALSE(LogIndex::read("/tmp/no_such_log_index.idx", entries));
+    EXPECT_TRUE(entries.empty());
+    unlink(path);
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#ifndef LOG_RECORD_H_
+#define LOG_RECORD_H_
+
+/* STL Headers */
+#include <type_traits>
+
+/* C Headers */
+#include <stddef.h>
+
+/* Project Headers */
+#include "BinaryLog.h"
+
+/**
+ * Declares a plain struct NAME for a log channel from a list of fields, and
+ * generates its column names, types and offsets along with it so the header
+ * can't drift from what is logged.
+ *
+ * FIELDS is a macro taking a FIELD macro and applying it to each
+ * (type, name), the name becomes the column header.
+ *
+ * \code
+ * #define TRANSLATION_ERROR_FIELDS(FIELD) \
+ *     FIELD(double, X_Proportional) \
+ *     FIELD(double, X_Derivative) \
+ *     FIELD(uint8_t, Valid)
+ * LOG_RECORD(TranslationErrors, TRANSLATION_ERROR_FIELDS);
+ *
+ * LogRecordChannel<TranslationErrors> errors = LogFile::getInstance()->channel<TranslationErrors>("Errors");
+ * TranslationErrors record = {};
+ * record.X_Proportional = ...;
+ * errors.log(record);
+ * \endcode
+ *
+ * Logging a record copies the struct as it is, values are only formatted as
+ * text by the writer thread, or by `autopilot logconvert` for binary logs.
+ */
+#define LOG_RECORD(NAME, FIELDS) \
+    struct NAME \
+    { \
+        FIELDS(LOG_RECORD_MEMBER) \
+        \
+        static const BinaryLog::Layout& layout() \
+        { \
+            typedef NAME Self; \
+            static const BinaryLog::Column columns[] = { FIELDS(LOG_RECORD_COLUMN) }; \
+            static const BinaryLog::Layout layout = {columns, sizeof(columns) / sizeof(columns[0]), sizeof(Self)}; \
+            return layout; \
+        } \
+    }; \
+    static_assert(std::is_trivial<NAME>::value && std::is_standard_layout<NAME>::value, \
+                  #NAME " has to be copyable with memcpy"); \
+    static_assert(sizeof(NAME) <= 0xFFFF, #NAME " is too big for a log record")
+
+#define LOG_RECORD_MEMBER(TYPE, FIELD) TYPE FIELD;
+
+#define LOG_RECORD_COLUMN(TYPE, FIELD) \
+    {#FIELD, BinaryLog::typeOf<TYPE>(), static_cast<uint16_t>(offsetof(Self, FIELD))},
+
+#endif /* LOG_RECORD_H_ */
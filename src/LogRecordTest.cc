@@ -0,0 +1,85 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "LogRecord.h"
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+
+namespace
+{
+#define TEST_RECORD_FIELDS(FIELD) \
+    FIELD(double, Roll) \
+    FIELD(float, Pitch) \
+    FIELD(uint16_t, CH1) \
+    FIELD(uint8_t, Valid) \
+    FIELD(int64_t, Count)
+LOG_RECORD(TestRecord, TEST_RECORD_FIELDS);
+
+std::string encode(int64_t time_micros, const TestRecord& record)
+{
+    uint8_t encoded[BinaryLog::RECORD_HEADER_LENGTH + sizeof(TestRecord)];
+    size_t length = BinaryLog::encodeRecord(encoded, time_micros, record);
+    return std::string(reinterpret_cast<const char*>(encoded), length);
+}
+
+TestRecord sample()
+{
+    TestRecord record = {};
+    record.Roll = -0.125;
+    record.Pitch = 1.5f;
+    record.CH1 = 1500;
+    record.Valid = 1;
+    record.Count = -7;
+    return record;
+}
+}
+
+TEST(LogRecord, Layout)
+{
+    const BinaryLog::Layout& layout = TestRecord::layout();
+
+    ASSERT_EQ(5, layout.count);
+    EXPECT_EQ(sizeof(TestRecord), layout.size);
+    EXPECT_EQ("Roll Pitch CH1 Valid Count", BinaryLog::columnNames(layout));
+
+    EXPECT_EQ(BinaryLog::TYPE_FLOAT64, layout.columns[0].type);
+    EXPECT_EQ(BinaryLog::TYPE_FLOAT32, layout.columns[1].type);
+    EXPECT_EQ(BinaryLog::TYPE_UINT16, layout.columns[2].type);
+    EXPECT_EQ(BinaryLog::TYPE_UINT8, layout.columns[3].type);
+    EXPECT_EQ(BinaryLog::TYPE_INT64, layout.columns[4].type);
+    EXPECT_EQ(offsetof(TestRecord, Count), layout.columns[4].offset);
+}
+
+// the same line logData would write for the values as a vector
+TEST(LogRecord, RecordText)
+{
+    std::string record = encode(42, sample());
+    std::string text;
+
+    ASSERT_TRUE(BinaryLog::recordText(TestRecord::layout(), reinterpret_cast<const uint8_t*>(record.data()),
+                                      record.size(), text));
+    EXPECT_EQ("42\t-0.125000\t1.500000\t1500\t1\t-7\t\n", text);
+
+    EXPECT_FALSE(BinaryLog::recordText(TestRecord::layout(), reinterpret_cast<const uint8_t*>(record.data()),
+                                       record.size() - 1, text));
+}
+
+TEST(LogRecord, BinaryFileToText)
+{
+    std::string bytes = BinaryLog::fileHeader(TestRecord::layout());
+    bytes += encode(1, sample());
+    bytes += encode(2, sample());
+    // cut short
+    bytes += encode(3, sample()).substr(0, 12);
+
+    std::stringstream out;
+    ASSERT_TRUE(BinaryLog::toText(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size(), out));
+    EXPECT_EQ("Time(micros)\tRoll Pitch CH1 Valid Count\n"
+              "1\t-0.125000\t1.500000\t1500\t1\t-7\t\n"
+              "2\t-0.125000\t1.500000\t1500\t1\t-7\t\n", out.str());
+}
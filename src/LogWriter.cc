@@ -0,0 +1,453 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#include "LogWriter.h"
+
+/* STL Headers */
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+/* Project Headers */
+#include "FlightRecorder.h"
+#include "LogFile.h"
+#include "LogFileWriter.h"
+#include "NumberFormat.h"
+
+class LogWriter::Worker
+{
+public:
+    explicit Worker(size_t capacity)
+    :queue(capacity),
+     dropped(0),
+     cycles(0),
+     flushRequested(false),
+     dumped(0)
+    {}
+
+    MpscRing<Record> queue;
+    Wakeup wakeup;
+    std::atomic<uint64_t> dropped;
+    /// counts trips around the write loop so flush() can tell when one has finished
+    std::atomic<uint64_t> cycles;
+    std::atomic_bool flushRequested;
+    /// the sequence of the last trigger this worker dumped
+    std::atomic<uint64_t> dumped;
+
+    /// the channels this worker writes, only changed when channels come and go
+    std::vector<LogfileWriter*> channels;
+    std::mutex channelsLock;
+    /// held while channels copied out of the list are written or dumped, so detach() can wait them out
+    std::mutex writingLock;
+
+    std::thread thread;
+};
+
+const int LogWriter::DRAIN_MS;
+const int LogWriter::WRITE_MS;
+
+LogWriter::LogWriter()
+    :Driver("LogWriter", "log"),
+     _nextWorker(0),
+     _indexRecords(0),
+     _indexBytes(0),
+     _precision(NumberFormat::DEFAULT_PRECISION),
+     _recorder(false),
+     _recorderMs(0),
+     _recorderAfterMs(0),
+     _recorderChannelBytes(0),
+     _recorderBudget(0),
+     _decimation(1),
+     _lastSequence(0),
+     _dumps(0)
+{
+    configDescribe("writer_threads",
+                   "1-4",
+                   "The number of threads writing log files, channels are shared between them.");
+    int threads = std::max(1, configGeti("writer_threads", 1));
+
+    configDescribe("queue_records",
+                   "positive integer",
+                   "Log lines or records each writer thread can hold before new ones are dropped, rounded up to a power of two.",
+                   "records");
+    int capacity = std::max(16, configGeti("queue_records", 8192));
+
+    configDescribe("write_kb",
+                   "positive integer",
+                   "How much of a log file is held in memory before it is written in whole blocks.",
+                   "KiB");
+    _filePolicy.write_bytes = 1024 * std::max(4, configGeti("write_kb", 64));
+
+    configDescribe("preallocate_kb",
+                   "0 or more",
+                   "Disk space reserved ahead of the end of each log file at a time, 0 to reserve none.",
+                   "KiB");
+    _filePolicy.preallocate_bytes = 1024 * std::max(0, configGeti("preallocate_kb", 1024));
+
+    configDescribe("sync_ms",
+                   "0 or more",
+                   "Longest time logged data waits to be synced to disk, what a power cut can lose. 0 to only use sync_kb.",
+                   "ms");
+    _filePolicy.sync_ms = std::max(0, configGeti("sync_ms", 1000));
+
+    configDescribe("sync_kb",
+                   "0 or more",
+                   "Sync a log file once this much has been logged to it since the last sync. 0 to only use sync_ms.",
+                   "KiB");
+    _filePolicy.sync_bytes = 1024 * std::max(0, configGeti("sync_kb", 1024));
+
+    configDescribe("index_records",
+                   "0 or more",
+                   "Add an entry to each log file's time index every this many records. 0 to write no index.",
+                   "records");
+    _indexRecords = std::max(0, configGeti("index_records", 1000));
+
+    configDescribe("index_kb",
+                   "positive integer",
+                   "Add an entry to each log file's time index at least every this much of the log.",
+                   "KiB");
+    _indexBytes = 1024 * std::max(1, configGeti("index_kb", 64));
+
+    configDescribe("precision",
+                   "0-17",
+                   "Digits after the point floating point values are written with in text logs, LogFile::logPrecision sets it per channel.");
+    _precision = configGeti("precision", NumberFormat::DEFAULT_PRECISION);
+
+    configDescribe("recorder",
+                   "true, false",
+                   "Keep the last few seconds of every channel in memory at full rate and dump them to disk when something goes wrong.");
+    _recorder = configGetb("recorder", false);
+
+    configDescribe("recorder_seconds",
+                   "positive integer",
+                   "How far before a trigger a flight recorder dump reaches.",
+                   "s");
+    _recorderMs = 1000 * std::max(1, configGeti("recorder_seconds", 10));
+
+    configDescribe("recorder_after_seconds",
+                   "0 or more",
+                   "How long after a trigger the dump waits, so it shows what happened next too.",
+                   "s");
+    _recorderAfterMs = 1000 * std::max(0, configGeti("recorder_after_seconds", 2));
+
+    configDescribe("recorder_channel_kb",
+                   "positive integer",
+                   "Memory each channel's flight recorder holds, the oldest entries are dropped past it.",
+                   "KiB");
+    _recorderChannelBytes = 1024 * std::max(1, configGeti("recorder_channel_kb", 256));
+
+    configDescribe("recorder_memory_kb",
+                   "positive integer",
+                   "Memory all flight recorders may use together, channels created once it is spent are not recorded.",
+                   "KiB");
+    _recorderBudget = 1024 * static_cast<int64_t>(std::max(0, configGeti("recorder_memory_kb", 16384)));
+
+    configDescribe("recorder_decimation",
+                   "1 or more",
+                   "While the recorder is on, only every Nth sample of a recorded channel is written to its regular log.");
+    _decimation = std::max(1, configGeti("recorder_decimation", 10));
+
+    for(int i = 0; i < threads; i++)
+    {
+        _workers.push_back(std::unique_ptr<Worker>(new Worker(capacity)));
+    }
+
+    for(std::unique_ptr<Worker>& worker : _workers)
+    {
+        worker->thread = std::thread(&LogWriter::run, this, worker.get());
+    }
+}
+
+LogWriter::~LogWriter()
+{
+    terminate();
+    for(std::unique_ptr<Worker>& worker : _workers)
+    {
+        worker->wakeup.notify();
+        worker->thread.join();
+    }
+}
+
+LogWriter::Worker* LogWriter::attach(LogfileWriter* channel)
+{
+    Worker* worker = _workers[_nextWorker++ % _workers.size()].get();
+
+    channel->_indexRecords = _indexRecords;
+    channel->_indexBytes = _indexBytes;
+    channel->setPrecision(_precision);
+
+    if(_recorder)
+    {
+        int64_t bytes = _recorderChannelBytes;
+        if(_recorderBudget.fetch_sub(bytes) >= bytes)
+        {
+            channel->_recorder.reset(new FlightRecorder(_recorderChannelBytes));
+            channel->_decimation = _decimation;
+        }
+        else
+        {
+            _recorderBudget += bytes;
+            warning() << "Out of log.recorder_memory_kb, not recording " << channel->_logName;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(worker->channelsLock);
+    worker->channels.push_back(channel);
+    return worker;
+}
+
+void LogWriter::detach(LogfileWriter* channel)
+{
+    for(std::unique_ptr<Worker>& worker : _workers)
+    {
+        {
+            std::lock_guard<std::mutex> lock(worker->channelsLock);
+            worker->channels.erase(std::remove(worker->channels.begin(), worker->channels.end(), channel),
+                                   worker->channels.end());
+        }
+
+        // a write or dump may have copied channel out before it was removed, wait for it to finish
+        std::lock_guard<std::mutex> writing(worker->writingLock);
+    }
+}
+
+bool LogWriter::enqueue(Worker* worker, LogfileWriter* channel, const char* data, size_t length, bool sample)
+{
+    bool queued = worker->queue.push([&](Record& slot)
+    {
+        slot.channel = channel;
+        slot.length = length;
+        slot.sample = sample;
+        if(length <= Record::INLINE_BYTES)
+        {
+            slot.overflow = nullptr;
+            memcpy(slot.data, data, length);
+        }
+        else
+        {
+            // long lines are rare, debug messages mostly
+            slot.overflow = new std::string(data, length);
+        }
+    });
+
+    if(! queued)
+    {
+        worker->dropped++;
+        worker->wakeup.notify();
+        return false;
+    }
+
+    // past a quarter full, don't wait for the next drain
+    if(worker->queue.size() >= worker->queue.capacity() / 4)
+    {
+        worker->wakeup.notify();
+    }
+
+    return true;
+}
+
+void LogWriter::flush()
+{
+    for(std::unique_ptr<Worker>& worker : _workers)
+    {
+        // the next full cycle to start has to pick up everything queued before now
+        uint64_t target = worker->cycles.load() + 2;
+        while(worker->cycles.load() < target && worker->thread.joinable() && ! terminateRequested())
+        {
+            worker->flushRequested = true;
+            worker->wakeup.notify();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+uint64_t LogWriter::dropped() const
+{
+    uint64_t total = 0;
+    for(const std::unique_ptr<Worker>& worker : _workers)
+    {
+        total += worker->dropped.load();
+    }
+    return total;
+}
+
+void LogWriter::trigger(const std::string& reason)
+{
+    if(! _recorder)
+    {
+        return;
+    }
+
+    uint64_t now = nowMs();
+    {
+        std::lock_guard<std::mutex> lock(_triggersLock);
+        if(! _triggers.empty() && now < _triggers.back().due_ms)
+        {
+            // one incident often fires several triggers, keep them in one dump
+            Trigger& pending = _triggers.back();
+            if(pending.reasons.find(reason) == std::string::npos)
+            {
+                pending.reasons += "+" + reason;
+            }
+            return;
+        }
+
+        Trigger next;
+        next.sequence = ++_lastSequence;
+        next.since_ms = now > _recorderMs ? now - _recorderMs : 0;
+        next.due_ms = now + _recorderAfterMs;
+        next.reasons = reason;
+        _triggers.push_back(next);
+    }
+
+    message() << "Flight recorder triggered by " << reason;
+}
+
+uint64_t LogWriter::nowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void LogWriter::dumpDue(Worker* worker, uint64_t now_ms, bool stopping)
+{
+    std::vector<Trigger> due;
+    {
+        std::lock_guard<std::mutex> lock(_triggersLock);
+        for(const Trigger& trigger : _triggers)
+        {
+            if(trigger.sequence > worker->dumped.load() && (stopping || now_ms >= trigger.due_ms))
+            {
+                due.push_back(trigger);
+            }
+        }
+    }
+
+    for(const Trigger& trigger : due)
+    {
+        Path folder = LogFile::getInstance()->getLogFolder() /
+                      ("flight_recorder_" + std::to_string(trigger.sequence) + "_" + trigger.reasons);
+        folder.create_directories();
+
+        std::lock_guard<std::mutex> writing(worker->writingLock);
+        std::vector<LogfileWriter*> channels;
+        {
+            std::lock_guard<std::mutex> lock(worker->channelsLock);
+            channels = worker->channels;
+        }
+
+        for(LogfileWriter* channel : channels)
+        {
+            channel->dumpRecorder(folder, trigger.since_ms);
+        }
+
+        worker->dumped = trigger.sequence;
+        info() << "Dumped the flight recorder to " << folder.toString();
+    }
+
+    if(due.empty())
+    {
+        return;
+    }
+
+    // forget triggers every worker has dumped
+    uint64_t everyone = std::numeric_limits<uint64_t>::max();
+    for(const std::unique_ptr<Worker>& other : _workers)
+    {
+        everyone = std::min(everyone, other->dumped.load());
+    }
+
+    std::lock_guard<std::mutex> lock(_triggersLock);
+    while(! _triggers.empty() && _triggers.front().sequence <= everyone)
+    {
+        _triggers.erase(_triggers.begin());
+        _dumps++;
+    }
+}
+
+void LogWriter::run(Worker* worker)
+{
+    auto nextWrite = std::chrono::steady_clock::now();
+
+    while(true)
+    {
+        bool stopping = terminateRequested();
+        if(! stopping)
+        {
+            worker->wakeup.wait(std::chrono::milliseconds(DRAIN_MS));
+        }
+
+        uint64_t now_ms = nowMs();
+
+        {
+            // held while draining so detach() can't return while a record for its channel is in hand
+            std::lock_guard<std::mutex> lock(worker->channelsLock);
+            LogfileWriter* attached = nullptr;
+
+            // only this thread touches a channel's _pending, recorder and file
+            while(worker->queue.pop([now_ms, worker, &attached](Record& record)
+            {
+                if(record.channel != attached)
+                {
+                    // records left behind by a detached channel are dropped
+                    bool found = std::find(worker->channels.begin(), worker->channels.end(), record.channel)
+                                 != worker->channels.end();
+                    attached = found ? record.channel : nullptr;
+                }
+
+                if(attached != nullptr && record.overflow == nullptr)
+                {
+                    attached->append(record.data, record.length, record.sample, now_ms);
+                }
+                else if(attached != nullptr)
+                {
+                    attached->append(record.overflow->data(), record.overflow->size(), record.sample, now_ms);
+                }
+                delete record.overflow;
+            }))
+            {
+            }
+        }
+
+        if(_recorder)
+        {
+            dumpDue(worker, now_ms, stopping);
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        bool commit = stopping || worker->flushRequested.exchange(false);
+        if(now >= nextWrite || commit)
+        {
+            nextWrite = now + std::chrono::milliseconds(WRITE_MS);
+
+            std::lock_guard<std::mutex> writing(worker->writingLock);
+            std::vector<LogfileWriter*> channels;
+            {
+                // copied so a new channel isn't held up behind the disk
+                std::lock_guard<std::mutex> lock(worker->channelsLock);
+                channels = worker->channels;
+            }
+
+            for(LogfileWriter* channel : channels)
+            {
+                channel->writeOut(*this, _filePolicy, now_ms, commit);
+                if(stopping)
+                {
+                    // gives back the space reserved past the end of the file
+                    channel->closeFile();
+                }
+            }
+        }
+
+        worker->cycles++;
+
+        if(stopping)
+        {
+            break;
+        }
+    }
+}
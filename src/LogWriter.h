@@ -0,0 +1,171 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#ifndef LOG_WRITER_H_
+#define LOG_WRITER_H_
+
+/* STL Headers */
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* C Headers */
+#include <stdint.h>
+#include <stddef.h>
+
+/* Project Headers */
+#include "Driver.h"
+#include "DurableFile.h"
+#include "MpscRing.h"
+#include "Singleton.h"
+#include "Wakeup.h"
+
+class LogfileWriter;
+
+/**
+ * @brief The thread (or few threads) that write every log channel to disk.
+ *
+ * A channel (LogfileWriter) is given one writer when it is created. Logging
+ * copies the line or record in to a slot of that writer's lock-free queue and
+ * returns, so producers on the control path never take a lock or touch the
+ * disk. The writer drains its queue every DRAIN_MS, or sooner once it is a
+ * quarter full, and appends to the files every WRITE_MS.
+ *
+ * If a writer falls so far behind that its queue fills, new records are
+ * dropped and counted against their channel rather than blocking.
+ *
+ * log.writer_threads sets how many writers there are and log.queue_records
+ * how many records each can hold, both are read once at startup.
+ *
+ * Each file is kept open as a DurableFile and synced at least every
+ * log.sync_ms or log.sync_kb, which bounds what a power cut can take. Asking
+ * for a flush() and stopping sync everything.
+ *
+ * Each file has a sparse time index beside it (see LogIndex) with an entry
+ * every log.index_records records or log.index_kb, which `autopilot
+ * logextract` uses to find a time range without reading the whole log.
+ *
+ * With log.recorder set, every channel also keeps its last few seconds in a
+ * FlightRecorder at full rate while only every log.recorder_decimation-th
+ * sample goes to disk. trigger() dumps the recorders a little later, so the
+ * dump covers both sides of whatever fired it, in to a flight_recorder_N
+ * folder beside the regular logs. Messages are never decimated.
+ */
+class LogWriter : public Driver, public Singleton<LogWriter>
+{
+    friend Singleton<LogWriter>;
+
+public:
+    static const int DRAIN_MS = 100;
+    static const int WRITE_MS = 500;
+
+    /// a queue slot, lines longer than INLINE_BYTES spill in to a string
+    struct Record
+    {
+        static const size_t INLINE_BYTES = 256 - sizeof(void*) * 2 - sizeof(uint32_t) - sizeof(bool);
+
+        LogfileWriter* channel;
+        std::string* overflow;
+        uint32_t length;
+        /// a data sample, as opposed to a message, which the disk log may decimate
+        bool sample;
+        char data[INLINE_BYTES];
+    };
+
+    /// one writer thread and the queue feeding it
+    class Worker;
+
+    /// picks the writer for a new channel
+    Worker* attach(LogfileWriter* channel);
+
+    /**
+     * Stops writing channel, anything it still has queued is discarded and it
+     * is never touched after this returns. Waits for a write or dump already
+     * in progress on its writer to finish.
+     */
+    void detach(LogfileWriter* channel);
+
+    /**
+     * Queues length bytes for channel on worker, returns false and counts a
+     * drop if the queue is full. Never blocks, and only allocates for lines
+     * longer than Record::INLINE_BYTES.
+     */
+    static bool enqueue(Worker* worker, LogfileWriter* channel, const char* data, size_t length, bool sample);
+
+    /// waits until everything queued so far has been written to disk
+    void flush();
+
+    /// the number of writer threads
+    size_t threads() const
+    {
+        return _workers.size();
+    }
+
+    /// records dropped because a queue was full, across every channel
+    uint64_t dropped() const;
+
+    /**
+     * Asks for the flight recorders to be dumped once log.recorder_after_seconds
+     * have passed. Triggers before then are folded in to the same dump. Does
+     * nothing unless log.recorder is set, safe from any thread.
+     */
+    void trigger(const std::string& reason);
+
+    /// dumps written so far
+    uint64_t dumps() const
+    {
+        return _dumps.load();
+    }
+
+private:
+    LogWriter();
+    ~LogWriter();
+
+    /// a dump asked for by trigger()
+    struct Trigger
+    {
+        uint64_t sequence;
+        /// recorded entries from this time on are dumped
+        uint64_t since_ms;
+        uint64_t due_ms;
+        std::string reasons;
+    };
+
+    void run(Worker* worker);
+
+    /// dumps worker's channels for every trigger that is due, or all of them if stopping
+    void dumpDue(Worker* worker, uint64_t now_ms, bool stopping);
+
+    /// the clock recorder entries and triggers are stamped with
+    static uint64_t nowMs();
+
+    std::vector<std::unique_ptr<Worker> > _workers;
+    std::atomic<size_t> _nextWorker;
+    DurableFile::Policy _filePolicy;
+    uint64_t _indexRecords;
+    uint64_t _indexBytes;
+    int _precision;
+
+    bool _recorder;
+    uint64_t _recorderMs;
+    uint64_t _recorderAfterMs;
+    size_t _recorderChannelBytes;
+    /// log.recorder_memory_kb less what channels have taken
+    std::atomic<int64_t> _recorderBudget;
+    int _decimation;
+
+    std::mutex _triggersLock;
+    /// triggers not yet dumped by every worker, oldest first
+    std::vector<Trigger> _triggers;
+    uint64_t _lastSequence;
+    std::atomic<uint64_t> _dumps;
+};
+
+#endif /* LOG_WRITER_H_ */
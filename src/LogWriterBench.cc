@@ -0,0 +1,171 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "LogFileWriter.h"
+#include "LogWriter.h"
+#include "LatencyHistogram.h"
+#include "RateLimiter.h"
+#include "Benchmark.h"
+
+#include <atomic>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+const int CHANNELS = 20;
+const int PRODUCERS = 4;
+const int ITERATIONS = 250;
+
+/// a line about the size of a control effort sample
+const std::string LINE = "123456789\t0.012345\t-0.543210\t1.000000\t0.250000\t-0.125000\t3.141593\t"
+                         "2.718282\t-1.414214\t0.707107\t\n";
+
+/**
+ * PRODUCERS threads each log a line to their share of CHANNELS every
+ * millisecond, like the control loop and sensor threads do, and time every
+ * call. log(channel, line) is whatever is being measured.
+ */
+void run(Benchmark& bench, std::function<void (int, const std::string&)> log)
+{
+    std::vector<std::vector<uint64_t> > latencies(PRODUCERS);
+    std::vector<std::thread> producers;
+
+    for(int p = 0; p < PRODUCERS; p++)
+    {
+        producers.push_back(std::thread([p, &log, &latencies]
+        {
+            std::vector<uint64_t>& mine = latencies[p];
+            mine.reserve(ITERATIONS * CHANNELS / PRODUCERS);
+
+            for(int i = 0; i < ITERATIONS; i++)
+            {
+                for(int channel = p; channel < CHANNELS; channel += PRODUCERS)
+                {
+                    uint64_t start = Benchmark::nowNanos();
+                    log(channel, LINE);
+                    mine.push_back(Benchmark::nowNanos() - start);
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }));
+    }
+
+    for(std::thread& producer : producers)
+    {
+        producer.join();
+    }
+
+    LatencyHistogram latency;
+    for(std::vector<uint64_t>& mine : latencies)
+    {
+        for(uint64_t ns : mine)
+        {
+            latency.record(ns);
+        }
+    }
+
+    bench.report("records", latency.count(), "records");
+    bench.report("producer_p50", latency.percentile(0.5), "ns");
+    bench.report("producer_p99", latency.percentile(0.99), "ns");
+    bench.report("producer_max", latency.max() / 1000.0, "us");
+}
+
+/**
+ * What every channel used to be, a thread of its own swapping a pair of
+ * stringstreams under a mutex and writing them out twice a second.
+ */
+class ThreadPerChannel
+{
+public:
+    ThreadPerChannel()
+    :_current(&_first),
+     _stop(false),
+     _thread(&ThreadPerChannel::write, this)
+    {}
+
+    ~ThreadPerChannel()
+    {
+        _stop = true;
+        _thread.join();
+    }
+
+    void log(const std::string& message)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        *_current << message;
+    }
+
+private:
+    void write()
+    {
+        std::ofstream output("/dev/null");
+        RateLimiter rl(2);
+        while(! _stop)
+        {
+            rl.wait();
+            std::stringstream* full;
+            {
+                std::lock_guard<std::mutex> lock(_lock);
+                full = _current;
+                _current = (_current == &_first) ? &_second : &_first;
+            }
+            output << full->str();
+            full->str("");
+            rl.finishedCriticalSection();
+        }
+    }
+
+    std::mutex _lock;
+    std::stringstream* _current;
+    std::stringstream _first;
+    std::stringstream _second;
+    std::atomic_bool _stop;
+    std::thread _thread;
+};
+}
+
+BENCHMARK(LogWriter, ThreadPerChannel)
+{
+    std::vector<std::unique_ptr<ThreadPerChannel> > channels;
+    for(int i = 0; i < CHANNELS; i++)
+    {
+        channels.push_back(std::unique_ptr<ThreadPerChannel>(new ThreadPerChannel()));
+    }
+
+    run(bench, [&](int channel, const std::string& line)
+    {
+        channels[channel]->log(line);
+    });
+
+    bench.report("writer_threads", CHANNELS, "threads");
+    bench.report("dropped", 0, "records");
+}
+
+BENCHMARK(LogWriter, SharedQueue)
+{
+    std::vector<LogfileWriter*> channels;
+    for(int i = 0; i < CHANNELS; i++)
+    {
+        channels.push_back(LogfileWriter::getLogger("bench_log_writer_" + std::to_string(i)));
+    }
+
+    LogWriter* writer = LogWriter::getInstance();
+    uint64_t dropped = writer->dropped();
+
+    run(bench, [&](int channel, const std::string& line)
+    {
+        channels[channel]->log(line);
+    });
+    writer->flush();
+
+    bench.report("writer_threads", writer->threads(), "threads");
+    bench.report("dropped", writer->dropped() - dropped, "records");
+}
@@ -38,13 +38,31 @@
 #include "TCPSerial.h"
 #include "Linux.h"
 #include "SystemState.h"
+#include "AllocationCounter.h"
 #include "CommonMessages.h"
 #include "WaypointManager.h"
 #include "ExternalMavlink.h"
 #include "FakeRc.h"
+#include "LogRecord.h"
 
 const std::string MainApp::LOG_SCALED_INPUTS = "Scaled Inputs";
 
+namespace
+{
+/// the system state each tick ran with, all from one snapshot
+#define SYSTEM_STATE_FIELDS(FIELD) \
+    FIELD(uint64_t, Version) \
+    FIELD(double, Roll) \
+    FIELD(double, Pitch) \
+    FIELD(double, Yaw) \
+    FIELD(float, Roll_Rate) \
+    FIELD(float, Pitch_Rate) \
+    FIELD(float, Yaw_Rate) \
+    FIELD(float, Altimeter_Height) \
+    FIELD(uint8_t, Pilot_Mode)
+LOG_RECORD(SystemStateRecord, SYSTEM_STATE_FIELDS);
+}
+
 MainApp::MainApp()
     :Logger("MainApp"),
      autopilot_mode(heli::MODE_AUTOMATIC_CONTROL)
@@ -115,7 +133,7 @@ void MainApp::run()
 
     using std::vector;
     vector<uint16_t> inputMicros(6);
-    vector<double> inputScaled(6);
+    Vector<6> inputScaled;
 
     // Set default autopilot mode
     autopilot_mode = heli::MODE_AUTOMATIC_CONTROL;
@@ -127,6 +145,10 @@ void MainApp::run()
     boost::signals2::scoped_connection pilot_connection(servo_board->pilot_mode_changed.connect(
                 boost::bind(&MainApp::change_pilot_mode, this, _1)));
 
+    LogChannel scaledInputsLog = log->channel(LOG_SCALED_INPUTS, "CH1 CH2 CH3 CH4 CH5 CH6");
+    LogChannel flightMarkerLog = log->channel("Flight log marker");
+    LogRecordChannel<SystemStateRecord> systemStateLog = log->channel<SystemStateRecord>("System State");
+
     message() << "Started main loop";
     RateLimiter rl(100, true); // 100 times a second and report percent of time used.
 
@@ -138,12 +160,28 @@ void MainApp::run()
         info() << "used " << amt << "time";
         systemState->main_loop_load.set(amt, 0);
 
+        // one consistent read of everything the drivers have published, no locks taken
+        SystemState::Snapshot state = systemState->snapshot();
+        {
+            SystemStateRecord record;
+            record.Version = state.version;
+            record.Roll = state.rotation.getRollRad();
+            record.Pitch = state.rotation.getPitchRad();
+            record.Yaw = state.rotation.getYawRad();
+            record.Roll_Rate = state.rollSpeed_radPerS;
+            record.Pitch_Rate = state.pitchSpeed_radPerS;
+            record.Yaw_Rate = state.yawSpeed_radPerS;
+            record.Altimeter_Height = state.altimeterHeight;
+            record.Pilot_Mode = static_cast<uint8_t>(state.servoPilotMode);
+            systemStateLog.log(record);
+        }
 
         // Pilot Flight log marker.
-        ch7PulseWidth = servo_board->getRaw(heli::CH7);
+        ch7PulseWidth = state.servoRawInputs[heli::CH7];
         if(ch7PulseWidth - ch7PulseWidthLast > 500)
         {
-            log->logData("Flight log marker", std::vector<uint16_t>());
+            flightMarkerLog.log(std::vector<uint16_t>());
+            log->triggerFlightRecorder("flight_log_marker");
             ch7PulseWidthLast = ch7PulseWidth;
         }
         else if (ch7PulseWidth - ch7PulseWidthLast < -500)
@@ -152,9 +190,8 @@ void MainApp::run()
         }
 
 
-        inputScaled = RCTrans::getScaledVector();
-        log->logHeader(LOG_SCALED_INPUTS, "CH1 CH2 CH3 CH4 CH5 CH6");
-        log->logData(LOG_SCALED_INPUTS, inputScaled);
+        inputScaled = RCTrans::getScaled(state);
+        scaledInputsLog.log(inputScaled);
 
         switch(autopilot_mode.load())
         {
@@ -164,8 +201,11 @@ void MainApp::run()
             break;
 
         case heli::MODE_SCALED_MANUAL:
+        {
+            NoAllocationRegion region("scaled manual output");
             bergen->setScaled(inputScaled);
             break;
+        }
 
         case heli::MODE_AUTOMATIC_CONTROL:
         {
@@ -173,11 +213,14 @@ void MainApp::run()
             {
                 try
                 {
-                    (*control)();
-                    bergen->setScaled(control->get_control_effort());
+                    // the tick and servo output must not touch the heap, see AllocationCounter.h
+                    NoAllocationRegion region("control tick");
+                    (*control)(state);
+                    bergen->setScaled(control->get_control_effort(state));
                 }
                 catch (bad_control& b)
                 {
+                    LogFile::getInstance()->triggerFlightRecorder("bad_control");
                     critical() << "MainApp: Caught control error exception.";
                     critical() << "Exception Message: " << b;
                     critical() << "MainApp: Switching to Direct Manual Mode.";
@@ -212,6 +255,7 @@ void MainApp::change_mode(heli::AUTOPILOT_MODE mode)
     debug() << "Switching autopilot mode out of " << MainApp::getModeString();
     autopilot_mode = mode;
     message() << "Switched autopilot mode into " << MainApp::getModeString();
+    LogFile::getInstance()->triggerFlightRecorder("mode_change");
     MainApp::mode_changed(mode);
 }
 
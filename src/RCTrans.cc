@@ -132,19 +132,19 @@ double RCTrans::pulse2norm(uint16_t pulse, std::array<uint16_t, 5> setpoint)
 }
 
 
-std::vector<double> RCTrans::getScaledVector()
+Vector<6> RCTrans::getScaled(const SystemState::Snapshot& state)
 {
-    std::vector<double> norms(6);
+    Vector<6> norms;
 
-    auto ss = servo_switch::getInstance();
-    auto rc = RadioCalibration::getInstance();
+    const std::array<uint16_t, 8>& raw = state.servoRawInputs;
+    const SystemState::RadioSetpoints& rc = state.radioCalibration;
 
-    norms[AILERON] =    pulse2norm(ss->getRaw(heli::CH1), rc->getAileron());
-    norms[ELEVATOR] =   pulse2norm(ss->getRaw(heli::CH2), rc->getElevator());
-    norms[THROTTLE] =   pulse2norm(ss->getRaw(heli::CH3), rc->getThrottle());
-    norms[RUDDER] =     pulse2norm(ss->getRaw(heli::CH4), rc->getRudder());
-    norms[GYRO] =       pulse2norm(ss->getRaw(heli::CH5), rc->getGyro());
-    norms[PITCH] =      pulse2norm(ss->getRaw(heli::CH6), rc->getPitch());
+    norms[AILERON] =    pulse2norm(raw[heli::CH1], rc.aileron);
+    norms[ELEVATOR] =   pulse2norm(raw[heli::CH2], rc.elevator);
+    norms[THROTTLE] =   pulse2norm(raw[heli::CH3], rc.throttle);
+    norms[RUDDER] =     pulse2norm(raw[heli::CH4], rc.rudder);
+    norms[GYRO] =       pulse2norm(raw[heli::CH5], rc.gyro);
+    norms[PITCH] =      pulse2norm(raw[heli::CH6], rc.pitch);
 
     return norms;
 }
@@ -24,6 +24,8 @@
 /* Project Headers */
 #include "servo_switch.h"
 #include "RadioCalibration.h"
+#include "FixedMath.h"
+#include "SystemState.h"
 
 /**
     \brief This class handles input pulse scaling to normalized values
@@ -37,8 +39,8 @@
 class RCTrans
 {
 public:
-    /** returns a vector of scaled valued for all channels */
-    static std::vector<double> getScaledVector();
+    /** returns the scaled values of the servo inputs in state for all channels, indexed by RadioElement */
+    static Vector<6> getScaled(const SystemState::Snapshot& state);
     /// List provides index to channel mapping for the RCTrans::getScaled function.
     enum RadioElement
     {
@@ -219,14 +219,13 @@ void RadioCalibration::saveFile()
 
 void RadioCalibration::writeToSystemState()
 {
-    SystemState *state = SystemState::getInstance();
-    state->state_lock.lock();
-    state->radio_calibration_gyro = getGyro();
-    state->radio_calibration_aileron = getAileron();
-    state->radio_calibration_elevator = getElevator();
-    state->radio_calibration_rudder = getRudder();
-    state->radio_calibration_throttle = getThrottle();
-    state->radio_calibration_pitch = getPitch();
-    state->radio_calibration_flightMode = getFlightMode();
-    state->state_lock.unlock();
+    SystemState::RadioSetpoints setpoints;
+    setpoints.gyro = getGyro();
+    setpoints.aileron = getAileron();
+    setpoints.elevator = getElevator();
+    setpoints.rudder = getRudder();
+    setpoints.throttle = getThrottle();
+    setpoints.pitch = getPitch();
+    setpoints.flightMode = getFlightMode();
+    SystemState::getInstance()->setRadioCalibration(setpoints);
 }
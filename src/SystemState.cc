@@ -18,6 +18,60 @@
 
 #include "SystemState.h"
 
+#include <algorithm>
+#include <vector>
+
+thread_local SystemState::Batch* SystemState::_batch = nullptr;
+
+SystemState::Snapshot::Snapshot()
+:version(0),
+ batteryVoltage_mV(0),
+ position(0,0,0,500),
+ nedOrigin(0,0,0,500),
+ cpu_load(0),
+ main_loop_load(0),
+ rollSpeed_radPerS(0),
+ pitchSpeed_radPerS(0),
+ yawSpeed_radPerS(0),
+ rotation(0,0,0),
+ servoRawInputs(),
+ servoRawOutputs(),
+ servoPilotMode(heli::PILOT_UNKNOWN),
+ altimeterHeight(0),
+ radioCalibration(),
+ nedPosition(),
+ nedVelocity()
+{
+}
+
+SystemState::Batch::Batch()
+:_fields(0),
+ _outer(_batch == nullptr)
+{
+    if(_outer)
+    {
+        _batch = this;
+    }
+}
+
+SystemState::Batch::~Batch()
+{
+    if(! _outer)
+    {
+        return;
+    }
+
+    _batch = nullptr;
+    if(_fields != 0)
+    {
+        Span span = spanOf(_fields);
+        SystemState::getInstance()->_state.write(span.offset, span.length, [&](Snapshot& state)
+        {
+            copyFields(_changes, _fields, state);
+        });
+    }
+}
+
 SystemState::SystemState()
 :batteryVoltage_mV(500),
  position(1000 , GPSPosition(0,0,0,500)),
@@ -30,4 +84,140 @@ SystemState::SystemState()
  rotation(500, EulerAngles(0,0,0)),
  servoRawInputs(3000, std::array<uint16_t, 8>()) // wait 3 seconds before defaulting.
 {
+    batteryVoltage_mV.publishTo([this](uint16_t value)
+    {
+        publish(BATTERY, [&](Snapshot& state){ state.batteryVoltage_mV = value; });
+    });
+    position.publishTo([this](GPSPosition value)
+    {
+        publish(POSITION, [&](Snapshot& state){ state.position = value; });
+    });
+    nedOrigin.publishTo([this](GPSPosition value)
+    {
+        publish(NED_ORIGIN, [&](Snapshot& state){ state.nedOrigin = value; });
+    });
+    cpu_load.publishTo([this](float value)
+    {
+        publish(CPU_LOAD, [&](Snapshot& state){ state.cpu_load = value; });
+    });
+    main_loop_load.publishTo([this](float value)
+    {
+        publish(MAIN_LOOP_LOAD, [&](Snapshot& state){ state.main_loop_load = value; });
+    });
+    rollSpeed_radPerS.publishTo([this](float value)
+    {
+        publish(ROLL_SPEED, [&](Snapshot& state){ state.rollSpeed_radPerS = value; });
+    });
+    pitchSpeed_radPerS.publishTo([this](float value)
+    {
+        publish(PITCH_SPEED, [&](Snapshot& state){ state.pitchSpeed_radPerS = value; });
+    });
+    yawSpeed_radPerS.publishTo([this](float value)
+    {
+        publish(YAW_SPEED, [&](Snapshot& state){ state.yawSpeed_radPerS = value; });
+    });
+    rotation.publishTo([this](EulerAngles value)
+    {
+        publish(ROTATION, [&](Snapshot& state){ state.rotation = value; });
+    });
+    servoRawInputs.publishTo([this](std::array<uint16_t, 8> value)
+    {
+        publish(SERVO_INPUTS, [&](Snapshot& state){ state.servoRawInputs = value; });
+    });
+}
+
+void SystemState::setServoOutputs(const std::array<uint16_t, 9>& outputs, heli::PILOT_MODE pilotMode)
+{
+    publish(SERVO_OUTPUTS, [&](Snapshot& state)
+    {
+        state.servoRawOutputs = outputs;
+        state.servoPilotMode = pilotMode;
+    });
+}
+
+void SystemState::setAltimeterHeight(float height)
+{
+    publish(ALTIMETER, [&](Snapshot& state){ state.altimeterHeight = height; });
+}
+
+void SystemState::setRadioCalibration(const RadioSetpoints& setpoints)
+{
+    publish(RADIO_CALIBRATION, [&](Snapshot& state){ state.radioCalibration = setpoints; });
+}
+
+void SystemState::setNavigation(const Vec3& nedPosition, const Vec3& nedVelocity)
+{
+    publish(NAVIGATION, [&](Snapshot& state)
+    {
+        state.nedPosition = nedPosition;
+        state.nedVelocity = nedVelocity;
+    });
+}
+
+void SystemState::copyFields(const Snapshot& from, unsigned fields, Snapshot& to)
+{
+    if(fields & BATTERY) to.batteryVoltage_mV = from.batteryVoltage_mV;
+    if(fields & POSITION) to.position = from.position;
+    if(fields & NED_ORIGIN) to.nedOrigin = from.nedOrigin;
+    if(fields & CPU_LOAD) to.cpu_load = from.cpu_load;
+    if(fields & MAIN_LOOP_LOAD) to.main_loop_load = from.main_loop_load;
+    if(fields & ROLL_SPEED) to.rollSpeed_radPerS = from.rollSpeed_radPerS;
+    if(fields & PITCH_SPEED) to.pitchSpeed_radPerS = from.pitchSpeed_radPerS;
+    if(fields & YAW_SPEED) to.yawSpeed_radPerS = from.yawSpeed_radPerS;
+    if(fields & ROTATION) to.rotation = from.rotation;
+    if(fields & SERVO_INPUTS) to.servoRawInputs = from.servoRawInputs;
+    if(fields & SERVO_OUTPUTS)
+    {
+        to.servoRawOutputs = from.servoRawOutputs;
+        to.servoPilotMode = from.servoPilotMode;
+    }
+    if(fields & ALTIMETER) to.altimeterHeight = from.altimeterHeight;
+    if(fields & RADIO_CALIBRATION) to.radioCalibration = from.radioCalibration;
+    if(fields & NAVIGATION)
+    {
+        to.nedPosition = from.nedPosition;
+        to.nedVelocity = from.nedVelocity;
+    }
+}
+
+SystemState::Span SystemState::spanOf(unsigned fields)
+{
+    // one per Field bit, in order
+    static const std::vector<Span> spans = []()
+    {
+        Snapshot s;
+        // the span from the start of first to the end of last
+        auto join = [](Span first, Span last)
+        {
+            return Span{first.offset, last.offset + last.length - first.offset};
+        };
+        return std::vector<Span>{
+            spanOf(s, &Snapshot::batteryVoltage_mV),
+            spanOf(s, &Snapshot::position),
+            spanOf(s, &Snapshot::nedOrigin),
+            spanOf(s, &Snapshot::cpu_load),
+            spanOf(s, &Snapshot::main_loop_load),
+            spanOf(s, &Snapshot::rollSpeed_radPerS),
+            spanOf(s, &Snapshot::pitchSpeed_radPerS),
+            spanOf(s, &Snapshot::yawSpeed_radPerS),
+            spanOf(s, &Snapshot::rotation),
+            spanOf(s, &Snapshot::servoRawInputs),
+            join(spanOf(s, &Snapshot::servoRawOutputs), spanOf(s, &Snapshot::servoPilotMode)),
+            spanOf(s, &Snapshot::altimeterHeight),
+            spanOf(s, &Snapshot::radioCalibration),
+            join(spanOf(s, &Snapshot::nedPosition), spanOf(s, &Snapshot::nedVelocity))
+        };
+    }();
+
+    size_t begin = sizeof(Snapshot);
+    size_t end = 0;
+    for(size_t i = 0; i < spans.size(); i++)
+    {
+        if(fields & (1u << i))
+        {
+            begin = std::min(begin, spans[i].offset);
+            end = std::max(end, spans[i].offset + spans[i].length);
+        }
+    }
+    return Span{begin, end > begin ? end - begin : 0};
 }
@@ -19,6 +19,7 @@
 #define SYSTEMSTATE_H_
 
 // System imports
+#include <array>
 #include <vector>
 #include <atomic>
 #include <mutex>
@@ -34,6 +35,8 @@
 #include "gps_time.h"
 #include "Singleton.h"
 #include "EulerAngles.h"
+#include "SeqLock.h"
+#include "FixedMath.h"
 
 /**
  * The SystemState keeps track of variables that multiple drivers wish to manipulate
@@ -78,27 +81,120 @@ friend class Singleton<SystemState>;
 
 public:
 
-    // System state lock
-    std::mutex state_lock;
+    /// The radio calibration setpoints, see RadioCalibration.
+    struct RadioSetpoints
+    {
+        std::array<uint16_t, 2> gyro;
+        std::array<uint16_t, 3> aileron;
+        std::array<uint16_t, 3> elevator;
+        std::array<uint16_t, 3> rudder;
+        std::array<uint16_t, 5> throttle;
+        std::array<uint16_t, 5> pitch;
+        std::array<uint16_t, 3> flightMode;
+    };
 
-    // servo data
+    /**
+     * Everything in the SystemState at one instant.
+     *
+     * The parameters below publish each value they accept here, and the
+     * drivers without a parameter publish through the setters. A snapshot is
+     * copied out whole, so the control loop can read all of it once a tick
+     * without taking a lock, and never gets half of one update and half of
+     * another.
+     *
+     * Only plain copyable values go in here, it is copied with memcpy.
+     **/
+    struct Snapshot
+    {
+        Snapshot();
 
+        /// how many updates came before this one, filled in by snapshot()
+        uint64_t version;
 
-    //std::vector<uint16_t> 			servo_raw_inputs;
-    std::vector<uint16_t> 			servo_raw_outputs;
-    std::atomic<heli::PILOT_MODE> 	servo_pilot_mode;
+        uint16_t batteryVoltage_mV;
+        GPSPosition position;
+        GPSPosition nedOrigin;
+        float cpu_load;
+        float main_loop_load;
+        float rollSpeed_radPerS;
+        float pitchSpeed_radPerS;
+        float yawSpeed_radPerS;
+        EulerAngles rotation;
+        std::array<uint16_t, 8> servoRawInputs;
 
-    // altimeter data
-    float altimeter_height;
+        std::array<uint16_t, 9> servoRawOutputs;
+        heli::PILOT_MODE servoPilotMode;
+        float altimeterHeight;
+        RadioSetpoints radioCalibration;
 
-    // radio calibration data
-    std::array<uint16_t, 2> radio_calibration_gyro;
-    std::array<uint16_t, 3> radio_calibration_aileron;
-    std::array<uint16_t, 3> radio_calibration_elevator;
-    std::array<uint16_t, 3> radio_calibration_rudder;
-    std::array<uint16_t, 5> radio_calibration_throttle;
-    std::array<uint16_t, 5> radio_calibration_pitch;
-    std::array<uint16_t, 3> radio_calibration_flightMode;
+        /// where the IMU is in the ned frame, from the same sample as rotation
+        Vec3 nedPosition;
+        Vec3 nedVelocity;
+
+        /// rotation as roll, pitch and yaw
+        Vec3 euler() const
+        {
+            return Vec3(rotation.getRollRad(), rotation.getPitchRad(), rotation.getYawRad());
+        }
+
+        /// the roll, pitch and yaw rates
+        Vec3 eulerRate() const
+        {
+            return Vec3(rollSpeed_radPerS, pitchSpeed_radPerS, yawSpeed_radPerS);
+        }
+    };
+
+    /**
+     * Groups the updates a thread makes while it exists in to one, so a
+     * snapshot has all of them or none. IMU uses it so its attitude and
+     * rates always come from the same sample. Only batch values one driver
+     * owns, a value another thread sets while the batch is open can be
+     * replaced by the batched one when it closes.
+     *
+     * @code
+     * {
+     *     SystemState::Batch batch;
+     *     state->rotation.set(angles, 0);
+     *     state->rollSpeed_radPerS.set(rate, 0);
+     * }
+     * @endcode
+     **/
+    class Batch
+    {
+    public:
+        Batch();
+        ~Batch();
+
+    private:
+        Batch(const Batch&);
+        Batch& operator=(const Batch&);
+
+        friend class SystemState;
+        Snapshot _changes;
+        unsigned _fields;
+        /// a batch made inside another adds to the outer one
+        bool _outer;
+    };
+
+    /// The state as of the last update, wait free unless an update is half way through.
+    Snapshot snapshot() const
+    {
+        Snapshot now;
+        _state.read(now, now.version);
+        return now;
+    }
+
+    /// Sets the raw servo outputs and which pilot is in control.
+    void setServoOutputs(const std::array<uint16_t, 9>& outputs, heli::PILOT_MODE pilotMode);
+
+    /// Sets the height above ground from the altimeter.
+    void setAltimeterHeight(float height);
+
+    /// Sets the radio calibration setpoints.
+    void setRadioCalibration(const RadioSetpoints& setpoints);
+
+    /// Sets the position and velocity in the ned frame.
+    void setNavigation(const Vec3& nedPosition, const Vec3& nedVelocity);
 
     // Data from the helicopter.
     SystemStateParam<uint16_t> batteryVoltage_mV;
@@ -130,6 +226,67 @@ public:
 
 private:
     SystemState();
+
+    /// Bits for the parts of a Snapshot a Batch has changed.
+    enum Field
+    {
+        BATTERY = 1 << 0,
+        POSITION = 1 << 1,
+        NED_ORIGIN = 1 << 2,
+        CPU_LOAD = 1 << 3,
+        MAIN_LOOP_LOAD = 1 << 4,
+        ROLL_SPEED = 1 << 5,
+        PITCH_SPEED = 1 << 6,
+        YAW_SPEED = 1 << 7,
+        ROTATION = 1 << 8,
+        SERVO_INPUTS = 1 << 9,
+        SERVO_OUTPUTS = 1 << 10,
+        ALTIMETER = 1 << 11,
+        RADIO_CALIBRATION = 1 << 12,
+        NAVIGATION = 1 << 13
+    };
+
+    /// copies the fields of from in to to
+    static void copyFields(const Snapshot& from, unsigned fields, Snapshot& to);
+
+    /// the bytes of a Snapshot that hold some fields
+    struct Span
+    {
+        size_t offset;
+        size_t length;
+    };
+
+    /// the smallest Span holding every one of fields
+    static Span spanOf(unsigned fields);
+
+    /// where member is in snapshot
+    template <class M>
+    static Span spanOf(const Snapshot& snapshot, const M Snapshot::* member)
+    {
+        const char* base = reinterpret_cast<const char*>(&snapshot);
+        const char* field = reinterpret_cast<const char*>(&(snapshot.*member));
+        return Span{static_cast<size_t>(field - base), sizeof(M)};
+    }
+
+    /// Calls apply(Snapshot&) on the state, or on this thread's batch if it has one.
+    template <class Apply>
+    void publish(Field field, Apply apply)
+    {
+        Batch* batch = _batch;
+        if(batch != nullptr)
+        {
+            apply(batch->_changes);
+            batch->_fields |= field;
+            return;
+        }
+
+        // only the words holding the field are copied while writers are held off
+        Span span = spanOf(field);
+        _state.write(span.offset, span.length, apply);
+    }
+
+    SeqLock<Snapshot> _state;
+    static thread_local Batch* _batch;
 };
 
 #endif //SYSTEMSTATE_H_
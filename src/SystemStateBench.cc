@@ -0,0 +1,190 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "SystemState.h"
+#include "LatencyHistogram.h"
+#include "Benchmark.h"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace
+{
+/// how long the control loop reads for
+const uint64_t RUN_NS = 500 * 1000 * 1000ull;
+
+/// a driver writing its part of the state k at a time
+struct Writer
+{
+    /// how often it writes when paced like the hardware
+    int hz;
+    std::function<void (uint32_t)> write;
+};
+
+/// every value the IMU writes is k, so the angles and rates should always agree
+void writeImu(uint32_t k)
+{
+    SystemState* state = SystemState::getInstance();
+    SystemState::Batch batch;
+    state->rotation.set(EulerAngles(k, k, k), 0);
+    state->rollSpeed_radPerS.set(k, 0);
+    state->pitchSpeed_radPerS.set(k, 0);
+    state->yawSpeed_radPerS.set(k, 0);
+}
+
+void writeServo(uint32_t k)
+{
+    SystemState* state = SystemState::getInstance();
+    SystemState::Batch batch;
+    std::array<uint16_t, 8> inputs;
+    inputs.fill(static_cast<uint16_t>(k));
+    state->servoRawInputs.set(inputs, 0);
+
+    std::array<uint16_t, 9> outputs;
+    outputs.fill(static_cast<uint16_t>(k));
+    state->setServoOutputs(outputs, heli::PILOT_AUTO);
+}
+
+void writeGps(uint32_t k)
+{
+    SystemState::getInstance()->position.set(GPSPosition(k, k, k, 1), 0);
+}
+
+void writeAltimeter(uint32_t k)
+{
+    SystemState::getInstance()->setAltimeterHeight(k);
+}
+
+/// the IMU, servo board, GPS and altimeter at about the rates they send
+const std::vector<Writer> WRITERS = {
+    {500, writeImu},
+    {50, writeServo},
+    {20, writeGps},
+    {20, writeAltimeter},
+};
+
+/**
+ * Runs the writers while read() is called in a loop for RUN_NS, timing each
+ * call. read returns true if what it read didn't agree with itself. Unpaced
+ * writers write as fast as they can.
+ */
+void run(Benchmark& bench, bool paced, std::function<bool ()> read)
+{
+    SystemState* state = SystemState::getInstance();
+    uint64_t version = state->snapshot().version;
+    std::atomic<bool> done(false);
+    std::atomic<uint64_t> writes(0);
+
+    std::vector<std::thread> writers;
+    for(const Writer& writer : WRITERS)
+    {
+        writers.push_back(std::thread([&writer, paced, &done, &writes]
+        {
+            uint64_t period = 1000000000ull / writer.hz;
+            uint64_t next = Benchmark::nowNanos();
+            for(uint32_t k = 1; ! done.load(std::memory_order_relaxed); k++)
+            {
+                writer.write(k);
+                writes.fetch_add(1, std::memory_order_relaxed);
+
+                if(paced)
+                {
+                    next += period;
+                    uint64_t now = Benchmark::nowNanos();
+                    if(next > now)
+                    {
+                        std::this_thread::sleep_for(std::chrono::nanoseconds(next - now));
+                    }
+                }
+            }
+        }));
+    }
+
+    LatencyHistogram latency;
+    uint64_t torn = 0;
+    uint64_t end = Benchmark::nowNanos() + RUN_NS;
+    while(true)
+    {
+        uint64_t start = Benchmark::nowNanos();
+        if(start >= end)
+        {
+            break;
+        }
+        bool inconsistent = read();
+        latency.record(Benchmark::nowNanos() - start);
+        if(inconsistent)
+        {
+            torn++;
+        }
+    }
+
+    done = true;
+    for(std::thread& writer : writers)
+    {
+        writer.join();
+    }
+
+    bench.report("reads", latency.count(), "reads");
+    bench.report("mean", latency.mean(), "ns");
+    bench.report("p50", latency.percentile(0.5), "ns");
+    bench.report("p99", latency.percentile(0.99), "ns");
+    bench.report("p99.9", latency.percentile(0.999), "ns");
+    bench.report("torn_reads", torn, "reads");
+    bench.report("writes", writes.load(), "writes");
+    bench.report("snapshot_versions", state->snapshot().version - version, "versions");
+}
+
+/// what a control tick read before snapshots: a lock or an atomic per field
+bool readEachField()
+{
+    SystemState* state = SystemState::getInstance();
+    EulerAngles rotation = state->rotation.get();
+    float rollSpeed = state->rollSpeed_radPerS.get();
+    float pitchSpeed = state->pitchSpeed_radPerS.get();
+    float yawSpeed = state->yawSpeed_radPerS.get();
+    GPSPosition position = state->position.get();
+    std::array<uint16_t, 8> inputs = state->servoRawInputs.get();
+    (void) position;
+
+    return rotation.getRollRad() != rollSpeed || rotation.getPitchRad() != pitchSpeed ||
+           rotation.getYawRad() != yawSpeed || inputs[0] != inputs[7];
+}
+
+bool readSnapshot()
+{
+    SystemState::Snapshot now = SystemState::getInstance()->snapshot();
+
+    return now.rotation.getRollRad() != now.rollSpeed_radPerS ||
+           now.rotation.getPitchRad() != now.pitchSpeed_radPerS ||
+           now.rotation.getYawRad() != now.yawSpeed_radPerS ||
+           now.servoRawInputs[0] != now.servoRawOutputs[8];
+}
+}
+
+// the control loop reading field by field while the drivers write at their usual rates
+BENCHMARK(SystemState, EachFieldSensorRates)
+{
+    run(bench, true, readEachField);
+}
+
+BENCHMARK(SystemState, SnapshotSensorRates)
+{
+    run(bench, true, readSnapshot);
+}
+
+// the same with every driver writing flat out, the worst the reader can see
+BENCHMARK(SystemState, EachFieldFlatOut)
+{
+    run(bench, false, readEachField);
+}
+
+BENCHMARK(SystemState, SnapshotFlatOut)
+{
+    run(bench, false, readSnapshot);
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#include "SystemStateNotifier.h"
+
+/* STL Headers */
+#include <algorithm>
+#include <chrono>
+
+const size_t SystemStateNotifier::CAPACITY;
+
+SystemStateNotifier::SystemStateNotifier()
+    :_queue(CAPACITY),
+     _terminate(false),
+     _dropped(0),
+     _delivering(nullptr)
+{
+    _thread = std::thread(&SystemStateNotifier::run, this);
+}
+
+SystemStateNotifier::~SystemStateNotifier()
+{
+    _terminate = true;
+    _wakeup.notify();
+    if(_thread.joinable())
+    {
+        _thread.join();
+    }
+
+    // posts that raced the thread stopping
+    dropQueued();
+}
+
+void SystemStateNotifier::attach(Deferred* deferred)
+{
+    std::lock_guard<std::mutex> lock(_attachedLock);
+    _attached.push_back(deferred);
+}
+
+void SystemStateNotifier::detach(Deferred* deferred)
+{
+    std::unique_lock<std::mutex> lock(_attachedLock);
+    _attached.erase(std::remove(_attached.begin(), _attached.end(), deferred), _attached.end());
+    _delivered.wait(lock, [this, deferred](){ return _delivering != deferred; });
+}
+
+bool SystemStateNotifier::post(Deferred* deferred)
+{
+    if(_terminate.load() || ! _queue.push(deferred))
+    {
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    _wakeup.notify();
+    return true;
+}
+
+void SystemStateNotifier::run()
+{
+    while(! _terminate.load())
+    {
+        while(_queue.pop([this](Deferred*& deferred)
+        {
+            // a post left behind by a detached parameter is skipped, it may be gone
+            std::unique_lock<std::mutex> lock(_attachedLock);
+            if(std::find(_attached.begin(), _attached.end(), deferred) == _attached.end())
+            {
+                return;
+            }
+            _delivering = deferred;
+            lock.unlock();
+
+            deferred->deliver();
+
+            lock.lock();
+            _delivering = nullptr;
+            _delivered.notify_all();
+        }))
+        {
+        }
+        _wakeup.wait(std::chrono::milliseconds(100));
+    }
+
+    dropQueued();
+}
+
+void SystemStateNotifier::dropQueued()
+{
+    while(_queue.pop([this](Deferred*&){ _dropped.fetch_add(1, std::memory_order_relaxed); }))
+    {
+    }
+}
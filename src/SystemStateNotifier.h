@@ -0,0 +1,112 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#ifndef SYSTEM_STATE_NOTIFIER_H_
+#define SYSTEM_STATE_NOTIFIER_H_
+
+/* STL Headers */
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* C Headers */
+#include <stdint.h>
+
+/* Project Headers */
+#include "MpscRing.h"
+#include "Singleton.h"
+#include "Wakeup.h"
+
+/**
+ * @brief The thread that runs deferred SystemState observers.
+ *
+ * A parameter with deferred observers posts itself here when it takes a new
+ * value, once until it has been delivered, and this thread hands the latest
+ * value to the observers. Sensor threads only ever push a pointer and never
+ * run observer code, and an observer that falls behind sees fewer, newer
+ * values rather than a backlog.
+ *
+ * Only attached parameters are delivered to, so one that detaches before it
+ * is destroyed is never called again even with a post still queued. Posts
+ * still queued when the notifier stops are dropped.
+ */
+class SystemStateNotifier : public Singleton<SystemStateNotifier>
+{
+    friend class Singleton<SystemStateNotifier>;
+
+public:
+    /// where an observer runs
+    enum Delivery
+    {
+        /// on the thread that set the value, before set() returns
+        IMMEDIATE,
+        /// later on the notifier thread, with the latest value
+        DEFERRED
+    };
+
+    /// something with values waiting for its deferred observers
+    class Deferred
+    {
+    public:
+        virtual ~Deferred() {}
+
+        /// called on the notifier thread
+        virtual void deliver() = 0;
+    };
+
+    /// the most parameters that can be waiting at once
+    static const size_t CAPACITY = 256;
+
+    /// lets deferred be posted, safe from any thread
+    void attach(Deferred* deferred);
+
+    /**
+     * Stops delivering to deferred, any post of it still queued is skipped.
+     * Waits for a delivery to it already running, so it can be destroyed
+     * once this returns. Must not be called from a deliver().
+     */
+    void detach(Deferred* deferred);
+
+    /**
+     * Queues deferred->deliver() on the notifier thread, returns false if
+     * the queue was full or the notifier is stopping. Safe from any thread.
+     */
+    bool post(Deferred* deferred);
+
+    /// posts that didn't fit in the queue or were still queued when stopping
+    uint64_t dropped() const
+    {
+        return _dropped.load(std::memory_order_relaxed);
+    }
+
+    ~SystemStateNotifier();
+
+private:
+    SystemStateNotifier();
+    SystemStateNotifier(const SystemStateNotifier&);
+    SystemStateNotifier& operator=(const SystemStateNotifier&);
+
+    void run();
+
+    /// drops everything queued, only from the thread popping
+    void dropQueued();
+
+    MpscRing<Deferred*> _queue;
+    Wakeup _wakeup;
+    std::atomic<bool> _terminate;
+    std::atomic<uint64_t> _dropped;
+    std::mutex _attachedLock;
+    std::vector<Deferred*> _attached;
+    /// the one being delivered to, detach() waits on _delivered while it is this
+    Deferred* _delivering;
+    std::condition_variable _delivered;
+    std::thread _thread;
+};
+
+#endif /* SYSTEM_STATE_NOTIFIER_H_ */
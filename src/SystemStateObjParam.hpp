@@ -13,9 +13,10 @@
 #include <stdint.h>
 #include <chrono>
 #include <mutex>
+#include <functional>
 
 
-#include <boost/signals2.hpp>
+#include "SystemStateObservers.hpp"
 
 
 /** SystemStateObjParam represents a system state parameter that is a copyable object,
@@ -50,8 +51,10 @@ public:
 
     **/
     SystemStateObjParam(uint64_t invalidationTimeMS, T def)
-    :_value(def)
+    :onSet(def),
+     _value(def)
     {
+        _invalidationTimeMS = invalidationTimeMS;
         _lastTime = std::chrono::system_clock::now();
         _currentError = std::numeric_limits<double>::max();
     }
@@ -83,6 +86,10 @@ public:
             _value = value;
             _currentError = error;
             _lastTime = currtime;
+            if(_publish)
+            {
+                _publish(_value);
+            }
 
             return true;
         }
@@ -98,13 +105,27 @@ public:
         return _value;
     }
 
-    void notifySet(SystemStateObjParam<T> & other)
+    /** Sets other to every value set here, straight away on the same thread.
+    @return false if there is no room for another observer.
+    **/
+    bool notifySet(SystemStateObjParam<T> & other)
+    {
+        SystemStateObjParam<T>* target = &other;
+        return onSet.connect([target](const T& val, double err){target->set(val, err);});
+    }
+
+    /** Calls publish with each value this parameter takes from now on. It is
+    called while the value is held so publishes arrive in the order the values did,
+    which is how SystemState keeps its snapshot up to date.
+    **/
+    void publishTo(std::function<void (T)> publish)
     {
-        // the & captures all variables inside lambda by reference
-        onSet.connect([&](T val, double err){other.set(val, err);});
+        std::lock_guard<std::mutex> lock(_lock);
+        _publish = publish;
     }
 
-    boost::signals2::signal<void (T, double)> onSet;
+    /// told about every value set, accepted or not
+    SystemStateObservers<T> onSet;
 
 
 private:
@@ -113,6 +134,7 @@ private:
     double _currentError;
     uint64_t _invalidationTimeMS;
     std::chrono::time_point<std::chrono::system_clock> _lastTime;
+    std::function<void (T)> _publish;
 };
 
 #endif
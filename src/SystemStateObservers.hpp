@@ -0,0 +1,192 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#pragma once
+#ifndef SYSTEM_STATE_OBSERVERS_H
+#define SYSTEM_STATE_OBSERVERS_H
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <stddef.h>
+
+#include "SystemStateNotifier.h"
+
+/** The observers told about every value set on a SystemStateParam or
+SystemStateObjParam, the onSet of each.
+
+Parameters are set at full sensor rate and most have no observers, so with
+none connected calling this is one relaxed load. Observers go in a fixed
+array and are never removed, so calling them takes no lock and copies
+nothing, the value is passed by reference.
+
+IMMEDIATE observers run on the thread calling set(). DEFERRED observers run on
+the SystemStateNotifier thread, so sensor threads never wait on them: the
+setter keeps the latest value and posts this list to the notifier at most
+once until it is delivered, a slow observer gets fewer values rather than a
+growing queue. Destroying the list detaches it from the notifier, which skips
+a post still queued and waits for at most the one delivery running.
+
+@code
+state->servoRawInputs.onSet.connect([](const std::array<uint16_t, 8>& raw, double error)
+{
+    ...
+}, SystemStateNotifier::DEFERRED);
+@endcode
+**/
+template <class T>
+class SystemStateObservers : private SystemStateNotifier::Deferred
+{
+public:
+    typedef std::function<void (const T&, double)> Observer;
+
+    /// the most observers one parameter can have
+    static const size_t CAPACITY = 8;
+
+    /// initial is only there so T needn't have a default constructor
+    explicit SystemStateObservers(const T& initial = T())
+    :_count(0),
+     _notifier(nullptr),
+     _pending(initial),
+     _pendingError(0),
+     _queued(false)
+    {
+    }
+
+    /// waits for a deferred delivery in progress so it can't outlive this
+    ~SystemStateObservers()
+    {
+        if(_notifier != nullptr)
+        {
+            _notifier->detach(this);
+        }
+    }
+
+    /** Adds observer, returns false if there are already CAPACITY.
+    Safe from any thread, observers connected while a value is being set
+    might miss that one.
+    **/
+    bool connect(Observer observer, SystemStateNotifier::Delivery delivery = SystemStateNotifier::IMMEDIATE)
+    {
+        std::lock_guard<std::mutex> lock(_connectLock);
+
+        size_t count = _count.load(std::memory_order_relaxed);
+        if(count >= CAPACITY)
+        {
+            return false;
+        }
+
+        if(delivery == SystemStateNotifier::DEFERRED && _notifier == nullptr)
+        {
+            _notifier = SystemStateNotifier::getInstance();
+            _notifier->attach(this);
+        }
+
+        _observers[count].observer = observer;
+        _observers[count].delivery = delivery;
+        _count.store(count + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// the number of observers connected
+    size_t size() const
+    {
+        return _count.load(std::memory_order_acquire);
+    }
+
+    /// tells the observers about value
+    void operator()(const T& value, double error)
+    {
+        if(_count.load(std::memory_order_relaxed) == 0)
+        {
+            return;
+        }
+        notify(value, error);
+    }
+
+private:
+    SystemStateObservers(const SystemStateObservers&);
+    SystemStateObservers& operator=(const SystemStateObservers&);
+
+    struct Slot
+    {
+        Observer observer;
+        SystemStateNotifier::Delivery delivery;
+    };
+
+    void notify(const T& value, double error)
+    {
+        size_t count = _count.load(std::memory_order_acquire);
+        bool deferred = false;
+        for(size_t i = 0; i < count; i++)
+        {
+            if(_observers[i].delivery == SystemStateNotifier::DEFERRED)
+            {
+                deferred = true;
+            }
+            else
+            {
+                _observers[i].observer(value, error);
+            }
+        }
+
+        if(! deferred)
+        {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_pendingLock);
+            _pending = value;
+            _pendingError = error;
+        }
+
+        // already waiting to be delivered, it will pick up this value
+        if(_queued.exchange(true))
+        {
+            return;
+        }
+
+        if(! _notifier->post(this))
+        {
+            _queued = false;
+        }
+    }
+
+    virtual void deliver() override
+    {
+        // cleared before the copy so a value set from here on posts again
+        _queued = false;
+
+        std::unique_lock<std::mutex> lock(_pendingLock);
+        T value(_pending);
+        double error = _pendingError;
+        lock.unlock();
+
+        size_t count = _count.load(std::memory_order_acquire);
+        for(size_t i = 0; i < count; i++)
+        {
+            if(_observers[i].delivery == SystemStateNotifier::DEFERRED)
+            {
+                _observers[i].observer(value, error);
+            }
+        }
+    }
+
+    Slot _observers[CAPACITY];
+    std::atomic<size_t> _count;
+    std::mutex _connectLock;
+    SystemStateNotifier* _notifier;
+
+    /// the latest value for the deferred observers
+    std::mutex _pendingLock;
+    T _pending;
+    double _pendingError;
+    std::atomic<bool> _queued;
+};
+
+#endif
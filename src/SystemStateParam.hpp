@@ -15,8 +15,9 @@
 #include <stdint.h>
 #include <chrono>
 #include <mutex>
+#include <functional>
 
-#include <boost/signals2.hpp>
+#include "SystemStateObservers.hpp"
 
 
 /** SystemStateParam represents a system state parameter.
@@ -65,6 +66,7 @@ public:
             _max = maxValue;
         }
 
+        _invalidationTimeMS = invalidationTimeMS;
         _lastTime = std::chrono::system_clock::now();
         _currentError = std::numeric_limits<double>::max();
     }
@@ -77,8 +79,9 @@ public:
     **/
     bool set(T value, double error)
     {
-        std::lock_guard<std::mutex> lock(_setLock);
+        // observers run before the lock so a chained set can't wait on this one
         onSet(value, error);
+        std::lock_guard<std::mutex> lock(_setLock);
 
         if(error < 0)
         {
@@ -99,6 +102,10 @@ public:
             _value = value;
             _currentError = error;
             _lastTime = currtime;
+            if(_publish)
+            {
+                _publish(_value);
+            }
             return true;
         }
 
@@ -112,15 +119,27 @@ public:
         return _value.load();
     }
 
-    void notifySet(SystemStateParam<T> & other)
+    /** Sets other to every value set here, straight away on the same thread.
+    @return false if there is no room for another observer.
+    **/
+    bool notifySet(SystemStateParam<T> & other)
     {
-        std::lock_guard<std::mutex> lock(_setLock);
+        SystemStateParam<T>* target = &other;
+        return onSet.connect([target](const T& val, double err){target->set(val, err);});
+    }
 
-        // the & captures all variables inside lambda by reference
-        onSet.connect([&](T val, double err){other.set(val, err);});
+    /** Calls publish with each value this parameter takes from now on. It is
+    called while the value is held so publishes arrive in the order the values did,
+    which is how SystemState keeps its snapshot up to date.
+    **/
+    void publishTo(std::function<void (T)> publish)
+    {
+        std::lock_guard<std::mutex> lock(_setLock);
+        _publish = publish;
     }
 
-    boost::signals2::signal<void (T, double)> onSet;
+    /// told about every value set, accepted or not
+    SystemStateObservers<T> onSet;
 
 
 private:
@@ -130,6 +149,7 @@ private:
     double _currentError;
     uint64_t _invalidationTimeMS;
     std::chrono::time_point<std::chrono::system_clock> _lastTime;
+    std::function<void (T)> _publish;
     std::mutex _setLock;
 };
 
@@ -0,0 +1,75 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "SystemStateParam.hpp"
+#include "SystemStateObjParam.hpp"
+#include "AllocationCounter.h"
+#include "Benchmark.h"
+
+#include <array>
+
+namespace
+{
+const int SETS = 1000000;
+
+/// times SETS calls of set(i), reporting the cost of each
+template <class Set>
+void run(Benchmark& bench, Set set)
+{
+    uint64_t allocations = AllocationCounter::allocations();
+    uint64_t start = Benchmark::nowNanos();
+    for(int i = 0; i < SETS; i++)
+    {
+        set(i);
+    }
+    uint64_t elapsed = Benchmark::nowNanos() - start;
+
+    bench.report("ns_per_set", elapsed / static_cast<double>(SETS), "ns/set");
+    bench.report("allocations_per_set",
+                 (AllocationCounter::allocations() - allocations) / static_cast<double>(SETS),
+                 "allocations/set");
+}
+
+typedef std::array<uint16_t, 8> Pulses;
+
+Pulses pulses(int i)
+{
+    Pulses raw;
+    raw.fill(static_cast<uint16_t>(i));
+    return raw;
+}
+}
+
+// the rates the IMU sets, nothing watching them
+BENCHMARK(SystemStateParam, NoObservers)
+{
+    SystemStateParam<float> rate(0);
+    run(bench, [&](int i){ rate.set(i, 0); });
+}
+
+// Linux's cpu load chained on to the SystemState's
+BENCHMARK(SystemStateParam, Chained)
+{
+    SystemStateParam<float> rate(0);
+    SystemStateParam<float> chained(0);
+    rate.notifySet(chained);
+    run(bench, [&](int i){ rate.set(i, 0); });
+}
+
+// servo inputs as the servo board sets them, nothing watching
+BENCHMARK(SystemStateObjParam, NoObservers)
+{
+    SystemStateObjParam<Pulses> inputs(0, Pulses());
+    run(bench, [&](int i){ inputs.set(pulses(i), 0); });
+}
+
+// servo inputs with an observer like FakeRc's on the notifier thread
+BENCHMARK(SystemStateObjParam, Deferred)
+{
+    SystemStateObjParam<Pulses> inputs(0, Pulses());
+    inputs.onSet.connect([](const Pulses&, double){}, SystemStateNotifier::DEFERRED);
+    run(bench, [&](int i){ inputs.set(pulses(i), 0); });
+}
@@ -7,6 +7,10 @@
 #include "SystemStateParam.hpp"
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+
 
 
 // TESTS
@@ -72,3 +76,84 @@ TEST(SystemStateParam, observer)
     EXPECT_EQ(ssp2.get(), 100);
 }
 
+TEST(SystemStateParam, ObserversAreBounded)
+{
+    SystemStateParam<int> ssp(0);
+    int calls = 0;
+    for(size_t i = 0; i < SystemStateObservers<int>::CAPACITY; i++)
+    {
+        EXPECT_TRUE(ssp.onSet.connect([&calls](const int&, double){ calls++; }));
+    }
+    EXPECT_FALSE(ssp.onSet.connect([&calls](const int&, double){ calls++; }));
+
+    ssp.set(5, 0);
+    EXPECT_EQ(static_cast<int>(SystemStateObservers<int>::CAPACITY), calls);
+}
+
+TEST(SystemStateParam, DeferredObserversRunOnTheNotifier)
+{
+    SystemStateParam<int> ssp(0);
+    std::atomic<int> latest(0);
+    std::atomic<bool> otherThread(false);
+    std::thread::id setter = std::this_thread::get_id();
+
+    ssp.onSet.connect([&](const int& value, double)
+    {
+        otherThread = std::this_thread::get_id() != setter;
+        latest = value;
+    }, SystemStateNotifier::DEFERRED);
+
+    for(int i = 1; i <= 1000; i++)
+    {
+        ssp.set(i, 0);
+    }
+
+    // values can be skipped but the last one always arrives
+    for(int wait = 0; wait < 1000 && latest.load() != 1000; wait++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(1000, latest.load());
+    EXPECT_TRUE(otherThread.load());
+}
+
+TEST(SystemStateParam, DestroyedWithADeferredPostQueued)
+{
+    // holds the notifier up so the post below stays queued
+    SystemStateParam<int> slow(0);
+    std::atomic<bool> started(false), release(false);
+    slow.onSet.connect([&](const int&, double)
+    {
+        started = true;
+        while(! release.load())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }, SystemStateNotifier::DEFERRED);
+    slow.set(1, 0);
+    while(! started.load())
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    std::atomic<int> calls(0);
+    {
+        SystemStateParam<int> gone(0);
+        gone.onSet.connect([&](const int&, double){ calls++; }, SystemStateNotifier::DEFERRED);
+        gone.set(1, 0);
+        // destroyed without waiting for the notifier to get to it
+    }
+    release = true;
+
+    // a later post is delivered, the one left by gone never is
+    std::atomic<int> after(0);
+    SystemStateParam<int> next(0);
+    next.onSet.connect([&](const int& value, double){ after = value; }, SystemStateNotifier::DEFERRED);
+    next.set(5, 0);
+    for(int wait = 0; wait < 1000 && after.load() != 5; wait++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(5, after.load());
+    EXPECT_EQ(0, calls.load());
+}
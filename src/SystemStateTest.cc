@@ -0,0 +1,94 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "SystemState.h"
+#include <gtest/gtest.h>
+
+TEST(SystemState, SnapshotHasAcceptedValues)
+{
+    SystemState* state = SystemState::getInstance();
+    uint64_t version = state->snapshot().version;
+
+    state->rotation.set(EulerAngles(0.1, 0.2, 0.3), 0);
+    state->setAltimeterHeight(12.5);
+
+    SystemState::Snapshot now = state->snapshot();
+    EXPECT_EQ(0.1, now.rotation.getRollRad());
+    EXPECT_EQ(0.3, now.rotation.getYawRad());
+    EXPECT_EQ(12.5f, now.altimeterHeight);
+    EXPECT_EQ(version + 2, now.version);
+
+    // a less accurate value the parameter turns down stays out of the snapshot too
+    state->rotation.set(EulerAngles(1, 1, 1), 5);
+    EXPECT_EQ(0.1, state->snapshot().rotation.getRollRad());
+    EXPECT_EQ(version + 2, state->snapshot().version);
+}
+
+TEST(SystemState, BatchPublishesOnce)
+{
+    SystemState* state = SystemState::getInstance();
+    uint64_t version = state->snapshot().version;
+
+    {
+        SystemState::Batch batch;
+        state->rollSpeed_radPerS.set(1.5f, 0);
+        state->pitchSpeed_radPerS.set(2.5f, 0);
+
+        {
+            SystemState::Batch inner;
+            state->yawSpeed_radPerS.set(3.5f, 0);
+        }
+
+        // nothing shows until the outer batch closes
+        EXPECT_EQ(version, state->snapshot().version);
+    }
+
+    SystemState::Snapshot now = state->snapshot();
+    EXPECT_EQ(version + 1, now.version);
+    EXPECT_EQ(1.5f, now.rollSpeed_radPerS);
+    EXPECT_EQ(2.5f, now.pitchSpeed_radPerS);
+    EXPECT_EQ(3.5f, now.yawSpeed_radPerS);
+    // the parameters themselves change as soon as they are set
+    EXPECT_EQ(3.5f, state->yawSpeed_radPerS.get());
+}
+
+TEST(SystemState, SettersWithoutParameters)
+{
+    SystemState* state = SystemState::getInstance();
+
+    std::array<uint16_t, 9> outputs = {{1100, 1200, 1300, 1400, 1500, 1600, 1700, 1800, 1900}};
+    state->setServoOutputs(outputs, heli::PILOT_MANUAL);
+
+    SystemState::RadioSetpoints setpoints = {};
+    setpoints.throttle = {{1000, 1250, 1500, 1750, 2000}};
+    state->setRadioCalibration(setpoints);
+
+    SystemState::Snapshot now = state->snapshot();
+    EXPECT_EQ(outputs, now.servoRawOutputs);
+    EXPECT_EQ(heli::PILOT_MANUAL, now.servoPilotMode);
+    EXPECT_EQ(setpoints.throttle, now.radioCalibration.throttle);
+}
+
+TEST(SystemState, NavigationArrivesWithTheAttitude)
+{
+    SystemState* state = SystemState::getInstance();
+    uint64_t version = state->snapshot().version;
+
+    // as IMU::writeToSystemState publishes them
+    {
+        SystemState::Batch batch;
+        state->setNavigation(Vec3(1, 2, -3), Vec3(0.5, 0, 0));
+        state->rotation.set(EulerAngles(0.05, -0.05, 1.5), 0);
+        state->rollSpeed_radPerS.set(0.25f, 0);
+    }
+
+    SystemState::Snapshot now = state->snapshot();
+    EXPECT_EQ(version + 1, now.version);
+    EXPECT_EQ(Vec3(1, 2, -3), now.nedPosition);
+    EXPECT_EQ(Vec3(0.5, 0, 0), now.nedVelocity);
+    EXPECT_EQ(Vec3(0.05, -0.05, 1.5), now.euler());
+    EXPECT_EQ(0.25, now.eulerRate()[0]);
+}
@@ -52,12 +52,17 @@ Control::Control()
      controller_mode(heli::Mode_Position_Hold_PID),
      mode_connection(QGCLink::getInstance()->control_mode.connect(
                          std::bind(&Control::set_controller_mode, this, std::placeholders::_1))),
-     reference_position(3),
      trajectory_type(heli::Point_Trajectory)
 {
     // load config file
     loadFile();
-    reference_position.clear();
+
+    LogFile* log = LogFile::getInstance();
+    log_position_reference = log->channel(LOG_POSITION_REFERENCE);
+    log_pid_trans_attitude_ref = log->channel(LOG_PID_TRANS_ATTITUDE_REF);
+    log_sbf_trans_attitude_ref = log->channel(LOG_SBF_TRANS_ATTITUDE_REF);
+    log_control_effort = log->channel("Control Effort");
+    log_mixed_control_output = log->channel("Mixed Control Output");
 
 
     // Set the huge map for lookups
@@ -154,21 +159,25 @@ bool Control::setParameter(Parameter p)
     return true;
 }
 
-blas::vector<double> Control::get_control_effort() const
+Vector<6> Control::get_control_effort() const
+{
+    return get_control_effort(SystemState::getInstance()->snapshot());
+}
+
+Vector<6> Control::get_control_effort(const SystemState::Snapshot& state) const
 {
-    std::vector<double> pilot_inputs(RCTrans::getScaledVector());
+    Vector<6> pilot_inputs(RCTrans::getScaled(state));
 
-    // compute control effort
-    blas::vector<double> control_effort(attitude_pid_controller().get_control_effort());
-    control_effort.resize(6);
+    // compute control effort, only roll and pitch are controlled
+    Vector<6> control_effort(attitude_pid_controller().get_control_effort().extend<6>());
 
-    if (!(pilot_inputs.size() == control_effort.size() && pilot_inputs.size() == 6 && pilot_inputs.size() == pilot_mix.size()))
+    if (!(pilot_inputs.size() == control_effort.size() && pilot_inputs.size() == pilot_mix.size()))
     {
         bad_control b("At least one of the vectors are not of length 6", std::string(__FILE__), __LINE__);
         throw b;
     }
 
-    blas::vector<double> control_output(6);
+    Vector<6> control_output;
 
     // mix according to pilot_mix
     for (unsigned int i=0; i < control_output.size(); i++)
@@ -182,9 +191,9 @@ blas::vector<double> Control::get_control_effort() const
     }
 
     // log control effort
-    LogFile::getInstance()->logData("Control Effort", control_effort);
+    log_control_effort.log(control_effort);
     //log final control output
-    LogFile::getInstance()->logData("Mixed Control Output", control_output);
+    log_mixed_control_output.log(control_output);
     return control_output;
 }
 
@@ -252,10 +261,10 @@ void Control::loadFile()
     circle_trajectory.parse_xml_node();
 }
 
-void Control::operator()()
+void Control::operator()(const SystemState::Snapshot& state)
 {
-    blas::vector<double> reference_position(get_reference_position());
-    LogFile::getInstance()->logData(LOG_POSITION_REFERENCE, reference_position);
+    Vec3 reference_position(get_reference_position());
+    log_position_reference.log(reference_position);
 
     if (get_controller_mode() == heli::Mode_Position_Hold_PID)
     {
@@ -263,11 +272,11 @@ void Control::operator()()
         {
             try
             {
-                translation_pid_controller()(reference_position);
-                blas::vector<double> roll_pitch_reference(translation_pid_controller().get_control_effort());
+                translation_pid_controller()(reference_position, state);
+                Vec2 roll_pitch_reference(translation_pid_controller().get_control_effort());
                 set_reference_attitude(roll_pitch_reference);
-                LogFile::getInstance()->logData(LOG_PID_TRANS_ATTITUDE_REF, roll_pitch_reference);
-                attitude_pid_controller()(roll_pitch_reference);
+                log_pid_trans_attitude_ref.log(roll_pitch_reference);
+                attitude_pid_controller()(roll_pitch_reference, state);
             }
             catch (bad_control& bc)
             {
@@ -290,11 +299,11 @@ void Control::operator()()
         {
             try
             {
-                x_y_sbf_controller(reference_position);
-                blas::vector<double> attitude_reference(x_y_sbf_controller.get_control_effort());
+                x_y_sbf_controller(reference_position, state);
+                Vec2 attitude_reference(x_y_sbf_controller.get_control_effort());
                 set_reference_attitude(attitude_reference);
-                LogFile::getInstance()->logData(LOG_SBF_TRANS_ATTITUDE_REF, attitude_reference);
-                attitude_pid_controller()(attitude_reference);
+                log_sbf_trans_attitude_ref.log(attitude_reference);
+                attitude_pid_controller()(attitude_reference, state);
             }
             catch (bad_control& bc)
             {
@@ -312,11 +321,10 @@ void Control::operator()()
     // not else if so that it will run if the mode was changed
     if (get_controller_mode() == heli::Mode_Attitude_Stabilization_PID)
     {
-        blas::vector<double> roll_pitch_reference(2);
-        roll_pitch_reference[ROLL] = attitude_pid_controller().get_roll_trim_radians();
-        roll_pitch_reference[PITCH] = attitude_pid_controller().get_pitch_trim_radians();
+        Vec2 roll_pitch_reference(attitude_pid_controller().get_roll_trim_radians(),
+                                  attitude_pid_controller().get_pitch_trim_radians());
         set_reference_attitude(roll_pitch_reference);
-        attitude_pid_controller()(roll_pitch_reference);
+        attitude_pid_controller()(roll_pitch_reference, state);
 
         // prevents exception being thrown
         return;
@@ -379,9 +387,10 @@ std::string Control::getTrajectoryString(heli::Trajectory_Type trajectory_type)
 
 void Control::set_reference_position()
 {
-    blas::vector<double> reference(IMU::getInstance()->get_ned_position());
+    SystemState::Snapshot state(SystemState::getInstance()->snapshot());
+    Vec3 reference(state.nedPosition);
     set_reference_position(reference);
-    reset();
+    reset(state);
     message() << "Control: Position reference set to: " << reference;
 }
 void Control::set_controller_mode(heli::Controller_Mode mode)
@@ -404,12 +413,17 @@ void Control::set_controller_mode(heli::Controller_Mode mode)
 }
 
 void Control::reset()
+{
+    reset(SystemState::getInstance()->snapshot());
+}
+
+void Control::reset(const SystemState::Snapshot& state)
 {
     x_y_pid_controller.reset();
     roll_pitch_pid_controller.reset();
     x_y_sbf_controller.reset();
-    line_trajectory.reset();
-    circle_trajectory.reset();
+    line_trajectory.reset(state);
+    circle_trajectory.reset(state);
 }
 
 bool Control::runnable() const
@@ -418,7 +432,7 @@ bool Control::runnable() const
     return attitude_pid_controller().runnable();
 }
 
-blas::vector<double> Control::get_reference_position() const
+Vec3 Control::get_reference_position() const
 {
     if (get_trajectory_type() == heli::Line_Trajectory)
     {
@@ -37,10 +37,8 @@
 #include "heli.h"
 #include "Singleton.h"
 #include "Debug.h"
-
-/* Boost Headers */
-#include <boost/numeric/ublas/vector.hpp>
-namespace blas = boost::numeric::ublas;
+#include "LogFile.h"
+#include "FixedMath.h"
 
 /**
  * @brief Perform automatic control computation
@@ -59,7 +57,7 @@ namespace blas = boost::numeric::ublas;
  * @date February 10, 2012: Refactored to comply with ControllerInterface
  * @date September 27, 2012: Added Tail SBF Controller
  */
-class Control : public ControllerInterface, public Singleton<Control>, public Logger
+class Control : public ControllerInterface<Vec3, Vector<6> >, public Singleton<Control>, public Logger
 {
     friend class Singleton<Control>;
 
@@ -92,7 +90,9 @@ public:
      * have been mixed with the pilot inputs using the weights stored in
      * Control::pilot_mix.
      */
-    blas::vector<double> get_control_effort() const;
+    Vector<6> get_control_effort() const;
+    /// same as Control::get_control_effort but mixed with the pilot inputs in state
+    Vector<6> get_control_effort(const SystemState::Snapshot& state) const;
 
     /**
      * This function computes the control effort for the autopilot.  How the control is computed
@@ -103,11 +103,13 @@ public:
      * the same attitude controller is then used as for heli::MODE_ATTITUDE_STABILIZATION_PID.  In this mode,
      * the gps measurement is required to be valid (GPS::pos_is_valid and GPS::vel_is_valid).
      *
+     * Every controller reads its measurements from state, so the whole tick
+     * works from one consistent SystemState::Snapshot.
      */
-    void operator()();
+    void operator()(const SystemState::Snapshot& state);
 
     /// only declared to be compatible with ControllerInterface
-    void operator()(const blas::vector<double>& reference) throw(bad_control) {}
+    void operator()(const Vec3& reference, const SystemState::Snapshot& state) throw(bad_control) {}
 
     /// string representation of roll mix parameter
     static const std::string PARAM_MIX_ROLL;
@@ -145,7 +147,10 @@ public:
     /// emitted when the controller mode changes
     boost::signals2::signal<void (heli::Controller_Mode)> mode_changed;
 
+    /// resets the controllers and restarts the trajectories from the latest snapshot
     void reset();
+    /// resets the controllers and restarts the trajectories from state
+    void reset(const SystemState::Snapshot& state);
 
     bool runnable() const;
 
@@ -168,22 +173,22 @@ public:
     }
 
     /// threadsafe access reference_position depending on trajectory type
-    blas::vector<double> get_reference_position() const;
+    Vec3 get_reference_position() const;
 
-    /// return the difference between the current position and the reference position in the body frame
-    blas::vector<double> get_body_postion_error() const
+    /// return the difference between the position in state and the reference position in the body frame
+    Vec3 get_body_postion_error(const SystemState::Snapshot& state) const
     {
-        return prod(trans(IMU::getInstance()->get_rotation()), get_ned_position_error());
+        return IMU::euler_to_rotation(state.euler()).transpose() * get_ned_position_error(state);
     }
 
     /// return the position error in the navigation frame
-    blas::vector<double> get_ned_position_error() const
+    Vec3 get_ned_position_error(const SystemState::Snapshot& state) const
     {
-        return IMU::getInstance()->get_ned_position() - get_reference_position();
+        return state.nedPosition - get_reference_position();
     }
 
     /// return the current reference attitude
-    blas::vector<double> get_reference_attitude() const
+    Vec2 get_reference_attitude() const
     {
         std::lock_guard<std::mutex> lock(reference_attitude_lock);
         return reference_attitude;
@@ -229,6 +234,12 @@ private:
     static const std::string LOG_PID_TRANS_ATTITUDE_REF;
     static const std::string LOG_SBF_TRANS_ATTITUDE_REF;
 
+    /// channels logged every control cycle, registered in the constructor
+    LogChannel log_position_reference;
+    LogChannel log_pid_trans_attitude_ref;
+    LogChannel log_sbf_trans_attitude_ref;
+    LogChannel log_control_effort;
+    LogChannel log_mixed_control_output;
 
 
     Control();
@@ -289,16 +300,16 @@ private:
     boost::signals2::scoped_connection mode_connection;
 
     /// ned reference position used for translation control
-    blas::vector<double> reference_position;
+    Vec3 reference_position;
     /// serialize access to reference_position
     mutable std::mutex reference_position_lock;
 
     /// reference attitude (roll-pitch) either generated by outer loop or attitude trim
-    blas::vector<double> reference_attitude;
+    Vec2 reference_attitude;
     /// serialize access to reference_attitude
     mutable std::mutex reference_attitude_lock;
     /// set the reference attitude
-    void set_reference_attitude(const blas::vector<double>& reference_attitude)
+    void set_reference_attitude(const Vec2& reference_attitude)
     {
         std::lock_guard<std::mutex> lock(reference_attitude_lock);
         this->reference_attitude = reference_attitude;
@@ -306,7 +317,7 @@ private:
 
 
     /// threadsafe set reference_position
-    void set_reference_position(const blas::vector<double>& position)
+    void set_reference_position(const Vec3& position)
     {
         std::lock_guard<std::mutex> lock(reference_position_lock);
         reference_position = position;
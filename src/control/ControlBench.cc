@@ -0,0 +1,58 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "Control.h"
+#include "AllocationCounter.h"
+#include "Benchmark.h"
+
+namespace
+{
+const int TICKS = 100000;
+
+/// times TICKS control ticks in mode, then puts the mode back
+void run(Benchmark& bench, heli::Controller_Mode mode)
+{
+    Control* control = Control::getInstance();
+    heli::Controller_Mode previous = control->get_controller_mode();
+    control->set_controller_mode(mode);
+    control->reset();
+    SystemState::Snapshot state(SystemState::getInstance()->snapshot());
+
+    uint64_t allocations = AllocationCounter::allocations();
+    uint64_t start = Benchmark::nowNanos();
+    for(int i = 0; i < TICKS; i++)
+    {
+        (*control)(state);
+    }
+    uint64_t elapsed = Benchmark::nowNanos() - start;
+    uint64_t allocated = AllocationCounter::allocations() - allocations;
+
+    bench.report("ns_per_tick", elapsed / static_cast<double>(TICKS), "ns/tick");
+    bench.report("allocations_per_tick", allocated / static_cast<double>(TICKS), "allocations/tick");
+    // a controller that threw switched to attitude control part way through
+    bench.report("kept_mode", control->get_controller_mode() == mode, "bool");
+
+    control->set_controller_mode(previous);
+}
+}
+
+// roll and pitch held at trim
+BENCHMARK(Control, AttitudePid)
+{
+    run(bench, heli::Mode_Attitude_Stabilization_PID);
+}
+
+// the outer translation pid feeding the attitude pid, the usual flight mode
+BENCHMARK(Control, PositionHoldPid)
+{
+    run(bench, heli::Mode_Position_Hold_PID);
+}
+
+// tail rotor compensated translation feeding the attitude pid
+BENCHMARK(Control, PositionHoldSbf)
+{
+    run(bench, heli::Mode_Position_Hold_SBF);
+}
@@ -6,6 +6,8 @@
  */
 #include "Control.h"
 #include "Parameter.h"
+#include "Helicopter.h"
+#include "AllocationCounter.h"
 #include <gtest/gtest.h>
 
 
@@ -330,3 +332,67 @@ TEST(Control, EMPTY_PARAM_DOES_NOT_EXIST)
     Parameter p("", 1, 0);
     EXPECT_FALSE(Control::getInstance()->setParameter(p));
 }
+
+namespace
+{
+void failOnAllocation(const NoAllocationRegion::Violation& violation)
+{
+    ADD_FAILURE() << NoAllocationRegion::describe(violation);
+}
+}
+
+// the tick and servo output MainApp runs every loop, once warmed up, in every mode
+TEST(Control, TickDoesNotAllocate)
+{
+    const heli::Controller_Mode modes[] = {heli::Mode_Attitude_Stabilization_PID,
+                                           heli::Mode_Position_Hold_PID,
+                                           heli::Mode_Position_Hold_SBF};
+
+    Control* control = Control::getInstance();
+    Helicopter* helicopter = Helicopter::getInstance();
+    heli::Controller_Mode previous = control->get_controller_mode();
+    NoAllocationRegion::Handler handler = NoAllocationRegion::setHandler(&failOnAllocation);
+
+    for(heli::Controller_Mode mode : modes)
+    {
+        control->set_controller_mode(mode);
+        control->reset();
+        SystemState::Snapshot state(SystemState::getInstance()->snapshot());
+        for(int i = 0; i < 10; i++)
+        {
+            (*control)(state);
+            helicopter->setScaled(control->get_control_effort(state));
+        }
+
+        NoAllocationRegion region("control tick");
+        for(int i = 0; i < 100; i++)
+        {
+            (*control)(state);
+            helicopter->setScaled(control->get_control_effort(state));
+        }
+        EXPECT_EQ(0u, region.allocations()) << "mode " << mode;
+    }
+
+    NoAllocationRegion::setHandler(handler);
+    control->set_controller_mode(previous);
+}
+
+// the attitude controller measures from the snapshot it is given, not the IMU
+TEST(Control, AttitudeComesFromTheSnapshot)
+{
+    attitude_pid& pid = Control::getInstance()->attitude_pid_controller();
+
+    SystemState::Snapshot level;
+    pid.reset();
+    pid(Vec2(0, 0), level);
+    Vec2 level_effort(pid.get_control_effort());
+
+    SystemState::Snapshot rolled;
+    rolled.rotation = EulerAngles(0.2, 0, 0);
+    pid.reset();
+    pid(Vec2(0, 0), rolled);
+
+    EXPECT_NE(level_effort[0], pid.get_control_effort()[0]);
+    EXPECT_EQ(level_effort[1], pid.get_control_effort()[1]);
+    pid.reset();
+}
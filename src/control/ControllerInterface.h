@@ -20,20 +20,23 @@
 #ifndef CONTROLLERINTERFACE_H_
 #define CONTROLLERINTERFACE_H_
 
-/* Boost Headers */
-#include <boost/numeric/ublas/vector.hpp>
-namespace blas = boost::numeric::ublas;
-
 /* Project Headers */
 #include "bad_control.h"
+#include "FixedMath.h"
+#include "SystemState.h"
 
 /**
  * @brief defines a standard interface for a controller class.
  * This class declares functions which should be present in all controllers.
+ * Reference and Effort are the fixed size vectors the controller takes and
+ * produces, e.g. a Vec3 position in and a Vec2 roll-pitch out. Measurements
+ * come from the tick's SystemState::Snapshot, so every controller in a tick
+ * sees the same attitude, rates and position.
  *
  * @author Bryan Godbolt <godbolt@ece.ualberta.ca>
  * @date February 10, 2012: Class creation
  */
+template <class Reference, class Effort>
 class ControllerInterface
 {
 public:
@@ -54,13 +57,14 @@ public:
      * are updated (i.e., integrated).  This function should only be called once per timestep.
      * If an error unrecoverable condition is detected during the control computation which prevents
      * a valid control effort from being computed a bad_control object will be thrown.
+     * @param state the measurements for this timestep
      */
-    virtual void operator()(const blas::vector<double>& reference) throw(bad_control) = 0;
+    virtual void operator()(const Reference& reference, const SystemState::Snapshot& state) throw(bad_control) = 0;
     /**
      * Return the control effort.  This function does not actually compute the control
      * (i.e., integrate any states) since it may be called several times per timestep.
      * @returns current control effort
      */
-    virtual blas::vector<double> get_control_effort() const = 0;
+    virtual Effort get_control_effort() const = 0;
 };
 #endif
@@ -22,7 +22,6 @@
 
 /* Project Headers */
 #include "RCTrans.h"
-#include "IMU.h"
 #include "Control.h"
 #include "Configuration.h"
 #include "LogFile.h"
@@ -56,7 +55,6 @@ attitude_pid::attitude_pid()
     :Logger("Attitude PID"),
      roll(5),
      pitch(5),
-     control_effort(blas::zero_vector<double>(2)),
      roll_trim(0),
      pitch_trim(0),
      _runnable(true)
@@ -65,15 +63,18 @@ attitude_pid::attitude_pid()
     pitch.name() = "Pitch";
 
     LogFile *log = LogFile::getInstance();
-    log->logHeader(LOG_ATTITUDE_ERROR, "Roll_Proportional Roll_Derivative Roll_Integral Pitch_Proportional Pitch_Derivative Pitch_Integral");
-    log->logData(LOG_ATTITUDE_ERROR, std::vector<double>());
-    log->logHeader(LOG_ATTITUDE_REFERENCE, "Roll Pitch");
-    log->logData(LOG_ATTITUDE_REFERENCE, std::vector<double>());
+    log_error_states = log->channel<ErrorStates>(LOG_ATTITUDE_ERROR);
+    log->channel(LOG_ATTITUDE_REFERENCE, "Roll Pitch").log(std::vector<double>());
+    log_euler_error = log->channel<EulerError>("Attitude PID error");
+    log_control_effort = log->channel<ControlEffort>(LOG_ATTITUDE_CONTROL_EFFORT);
 
 }
 
 attitude_pid::attitude_pid(const attitude_pid& other)
-    :Logger("Attitude PID")
+    :Logger("Attitude PID"),
+     log_euler_error(other.log_euler_error),
+     log_error_states(other.log_error_states),
+     log_control_effort(other.log_control_effort)
 {
 
     {
@@ -101,46 +102,37 @@ void attitude_pid::reset()
     pitch.reset();
 }
 
-void attitude_pid::operator()(const blas::vector<double>& reference) throw(bad_control)
+void attitude_pid::operator()(const Vec2& reference, const SystemState::Snapshot& state) throw(bad_control)
 {
     if (!runnable())
         throw bad_control("attempted to compute attitude_pid, but it wasn't runnable.");
 
-    if (reference.size() < 2)
-        throw bad_control("Attitude control received less than two references (roll pitch)");
-
-    blas::vector<double> roll_pitch_reference(reference);
-    roll_pitch_reference.resize(2);
-
-    IMU* imu = IMU::getInstance();
-    blas::vector<double> euler(imu->get_euler());
-    blas::vector<double> euler_rate(imu->get_euler_rate());
-    // resize to perform vector subtraction
-    euler.resize(2);
-
-
-    blas::vector<double> euler_error(euler - roll_pitch_reference);
+    Vec3 euler_rate(state.eulerRate());
+    // only roll and pitch are controlled
+    Vec2 euler_error(state.euler().head<2>() - reference);
 
-    std::vector<double> log(euler_error.begin(), euler_error.end());
-    log.insert(log.end(), euler_rate.begin(), euler_rate.end()-1);
-    LogFile::getInstance()->logData("Attitude PID error", log);
-    blas::vector<double> control_effort(2);
-    control_effort.clear();
+    EulerError logged_error;
+    logged_error.Roll_Error = euler_error[0];
+    logged_error.Pitch_Error = euler_error[1];
+    logged_error.Roll_Rate = euler_rate[0];
+    logged_error.Pitch_Rate = euler_rate[1];
+    log_euler_error.log(logged_error);
+    Vec2 control_effort;
 
-    std::vector<double> error_states;
+    ErrorStates error_states;
     roll_lock.lock();
-    error_states.push_back(roll.error().setProportional(euler_error[0]));
-    error_states.push_back(roll.error().setDerivative(euler_rate[0]));
-    error_states.push_back(++roll.error());
+    error_states.Roll_Proportional = roll.error().setProportional(euler_error[0]);
+    error_states.Roll_Derivative = roll.error().setDerivative(euler_rate[0]);
+    error_states.Roll_Integral = ++roll.error();
     control_effort[0] = roll.compute_pid();
     roll_lock.unlock();
 
     pitch_lock.lock();
-    error_states.push_back(pitch.error().setProportional(euler_error[1]));
-    error_states.push_back(pitch.error().setDerivative(euler_rate[1]));
-    error_states.push_back(++pitch.error());
+    error_states.Pitch_Proportional = pitch.error().setProportional(euler_error[1]);
+    error_states.Pitch_Derivative = pitch.error().setDerivative(euler_rate[1]);
+    error_states.Pitch_Integral = ++pitch.error();
 
-    LogFile::getInstance()->logData(LOG_ATTITUDE_ERROR, error_states);
+    log_error_states.log(error_states);
     control_effort[1] = pitch.compute_pid();
     pitch_lock.unlock();
 
@@ -148,7 +140,10 @@ void attitude_pid::operator()(const blas::vector<double>& reference) throw(bad_c
     Control::saturate(control_effort);
     set_control_effort(control_effort);
 
-    LogFile::getInstance()->logData(LOG_ATTITUDE_CONTROL_EFFORT, control_effort);
+    ControlEffort logged_effort;
+    logged_effort.Roll = control_effort[0];
+    logged_effort.Pitch = control_effort[1];
+    log_control_effort.log(logged_effort);
 //	debug() << "Attitude PID control effort: " << control_effort;
 }
 
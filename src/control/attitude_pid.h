@@ -28,8 +28,6 @@
 
 /* Boost Headers */
 #include <thread>
-#include <boost/numeric/ublas/vector.hpp>
-namespace blas = boost::numeric::ublas;
 
 /* Project Headers */
 #include "Parameter.h"
@@ -37,6 +35,8 @@ namespace blas = boost::numeric::ublas;
 #include "ControllerInterface.h"
 #include "util/AutopilotMath.hpp"
 #include "Debug.h"
+#include "LogFile.h"
+#include "LogRecord.h"
 
 /**
  * @brief track pilot reference attitude
@@ -46,7 +46,7 @@ namespace blas = boost::numeric::ublas;
  * @date October 26, 2011
  * @date February 10, 2012: Refactored into separate file and cleaned up
  */
-class attitude_pid : public ControllerInterface, public Logger
+class attitude_pid : public ControllerInterface<Vec2, Vec2>, public Logger
 {
 public:
     attitude_pid();
@@ -55,11 +55,12 @@ public:
      * @brief Performs the control computation.  The control attempts to
      * regulate the reference orientation with zero angular velocity.
      * @param reference roll pitch reference values in radians.
+     * @param state the attitude and rates measured this tick
      */
-    void operator()(const blas::vector<double>& reference) throw(bad_control);
+    void operator()(const Vec2& reference, const SystemState::Snapshot& state) throw(bad_control);
 
     /// threadsafe get control_effort
-    inline blas::vector<double> get_control_effort() const
+    inline Vec2 get_control_effort() const
     {
         std::lock_guard<std::mutex> lock(control_effort_lock);
         return control_effort;
@@ -195,6 +196,31 @@ private:
     static const std::string LOG_ATTITUDE_REFERENCE;
     static const std::string LOG_ATTITUDE_CONTROL_EFFORT;
 
+#define ATTITUDE_PID_ERROR_FIELDS(FIELD) \
+    FIELD(double, Roll_Proportional) \
+    FIELD(double, Roll_Derivative) \
+    FIELD(double, Roll_Integral) \
+    FIELD(double, Pitch_Proportional) \
+    FIELD(double, Pitch_Derivative) \
+    FIELD(double, Pitch_Integral)
+    LOG_RECORD(ErrorStates, ATTITUDE_PID_ERROR_FIELDS);
+
+#define ATTITUDE_PID_EULER_ERROR_FIELDS(FIELD) \
+    FIELD(double, Roll_Error) \
+    FIELD(double, Pitch_Error) \
+    FIELD(double, Roll_Rate) \
+    FIELD(double, Pitch_Rate)
+    LOG_RECORD(EulerError, ATTITUDE_PID_EULER_ERROR_FIELDS);
+
+#define ATTITUDE_PID_EFFORT_FIELDS(FIELD) \
+    FIELD(double, Roll) \
+    FIELD(double, Pitch)
+    LOG_RECORD(ControlEffort, ATTITUDE_PID_EFFORT_FIELDS);
+
+    /// registered once so operator() doesn't look them up every cycle
+    LogRecordChannel<EulerError> log_euler_error;
+    LogRecordChannel<ErrorStates> log_error_states;
+    LogRecordChannel<ControlEffort> log_control_effort;
 
     pid_channel roll;
     mutable std::mutex roll_lock;
@@ -202,11 +228,11 @@ private:
     mutable std::mutex pitch_lock;
 
     /// store the current normalized servo commands
-    blas::vector<double> control_effort;
+    Vec2 control_effort;
     /// serialize access to control_effort
     mutable std::mutex control_effort_lock;
     /// threadsafe set control_effort
-    inline void set_control_effort(const blas::vector<double>& control_effort)
+    inline void set_control_effort(const Vec2& control_effort)
     {
         std::lock_guard<std::mutex> lock(control_effort_lock);
         this->control_effort = control_effort;
@@ -24,7 +24,6 @@
 #include <math.h>
 
 /* Project Headers */
-#include "IMU.h"
 #include "Configuration.h"
 #include "util/AutopilotMath.hpp"
 
@@ -41,8 +40,6 @@ const double XML_SPEED_PARAM_DEFAULT  = 0.30000001192092896;
 circle::circle()
     : Logger("Circle"),
       radius(XML_RADIUS_PARAM_DEFAULT),
-      start_location(blas::zero_vector<double>(3)),
-      center_location(blas::zero_vector<double>(3)),
       speed(XML_SPEED_PARAM_DEFAULT),
       hover_time(XML_HOVER_PARAM_DEFAULT),
       initial_angle(0)
@@ -53,13 +50,13 @@ const std::string circle::PARAM_HOVER_TIME = "CIR_HOVER_TIME";
 const std::string circle::PARAM_RADIUS = "CIR_RADIUS";
 const std::string circle::PARAM_SPEED = "CIR_SPEED";
 
-void circle::reset()
+void circle::reset(const SystemState::Snapshot& state)
 {
-    set_start_location(IMU::getInstance()->get_ned_position());
+    set_start_location(state.nedPosition);
     set_start_time();
-    set_center_location();
+    set_center_location(state.euler()(2));
 
-    blas::vector<double> initial_vector(get_start_location() - get_center_location());
+    Vec3 initial_vector(get_start_location() - get_center_location());
     set_initial_angle(atan2(initial_vector(1), initial_vector(0)));
 }
 
@@ -72,7 +69,7 @@ std::vector<Parameter> circle::getParameters() const
     return plist;
 }
 
-blas::vector<double> circle::get_reference_position() const
+Vec3 circle::get_reference_position() const
 {
     double elapsed_time = getMsSinceInit() / 1000.0;
     double period = (get_speed() > 0 ? get_circumference()/get_speed() : 0);
@@ -84,7 +81,7 @@ blas::vector<double> circle::get_reference_position() const
     else
     {
         elapsed_time -= hover_time;
-        blas::vector<double> reference_position(get_center_location());
+        Vec3 reference_position(get_center_location());
         reference_position(0) += get_radius()*cos(2*AutopilotMath::PI*elapsed_time/period + get_initial_angle());
         reference_position(1) += get_radius()*sin(2*AutopilotMath::PI*elapsed_time/period + get_initial_angle());
         return reference_position;
@@ -96,13 +93,12 @@ double circle::get_circumference() const
     return 2*AutopilotMath::PI*get_radius();
 }
 
-void circle::set_center_location()
+void circle::set_center_location(double heading)
 {
-    blas::vector<double> center(blas::zero_vector<double>(3));
-    center(0) = get_radius();  // vector in body frame with origin at heli
+    Vec3 center(get_radius(), 0, 0);  // vector in body frame with origin at heli
     {
         std::lock_guard<std::mutex> lock(center_location_lock);
-        center_location = prod(IMU::getInstance()->get_heading_rotation(), center) + get_start_location();
+        center_location = Mat3::rotationZ(heading) * center + get_start_location();
     }
     message() << "Circle: center_location set to: " << center_location;
 }
@@ -22,9 +22,6 @@
 #define CIRCLE_H_
 
 /* Boost Headers */
-#include <boost/numeric/ublas/vector.hpp>
-#include <boost/numeric/ublas/matrix.hpp>
-namespace blas = boost::numeric::ublas;
 #include <thread>
 
 /* STL Headers */
@@ -35,6 +32,8 @@ namespace blas = boost::numeric::ublas;
 
 /* Project Headers */
 #include "Debug.h"
+#include "FixedMath.h"
+#include "SystemState.h"
 #include "Parameter.h"
 #include "heli.h"
 #include "Timer.hpp"
@@ -50,9 +49,9 @@ class circle : public Logger, protected Timer
 public:
     circle();
     /// return the reference position for the current time
-    blas::vector<double> get_reference_position() const;
-    /// reset the trajectory to begin from the current location
-    void reset();
+    Vec3 get_reference_position() const;
+    /// reset the trajectory to begin from the location and heading in state
+    void reset(const SystemState::Snapshot& state);
 
     /// set the speed
     void set_speed(const double speed);
@@ -85,11 +84,11 @@ protected:
     std::atomic<double> radius;
 
     /// position to begin trajectory in NED frame
-    blas::vector<double> start_location;
+    Vec3 start_location;
     /// serialzie access to start_location
     mutable std::mutex start_location_lock;
     /// set the start_location
-    void set_start_location(const blas::vector<double>& start_location)
+    void set_start_location(const Vec3& start_location)
     {
         {
             std::lock_guard<std::mutex>  lock(start_location_lock);
@@ -98,20 +97,20 @@ protected:
         message() << "Circle: start location set to " << start_location;
     }
     /// get the start_location
-    blas::vector<double> get_start_location() const
+    Vec3 get_start_location() const
     {
         std::lock_guard<std::mutex>  lock(start_location_lock);
         return start_location;
     }
 
     /// position of center of circle
-    blas::vector<double> center_location;
+    Vec3 center_location;
     /// serialize access to center_location
     mutable std::mutex center_location_lock;
     /// set the center location based on the current start_location, radius, and heading
-    void set_center_location();
+    void set_center_location(double heading);
     /// get the center location
-    blas::vector<double> get_center_location() const
+    Vec3 get_center_location() const
     {
         std::lock_guard<std::mutex> lock(center_location_lock);
         return center_location;
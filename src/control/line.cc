@@ -24,7 +24,6 @@
 #include <math.h>
 
 /* Project Headers */
-#include "IMU.h"
 #include "heli.h"
 #include "Configuration.h"
 
@@ -38,8 +37,6 @@ const std::string XML_SPEED_PARAM = "controller_params.line.speed";
 
 line::line()
     : Logger("Line"),
-      start_location(blas::zero_vector<double>(3)),
-      end_location(blas::zero_vector<double>(3)),
       x_travel(0),
       y_travel(0),
       speed(0),
@@ -52,14 +49,12 @@ const std::string line::PARAM_X_TRAVEL = "LIN_X_TRAVEL";
 const std::string line::PARAM_Y_TRAVEL = "LIN_Y_TRAVEL";
 const std::string line::PARAM_SPEED = "LIN_SPEED";
 
-void line::reset()
+void line::reset(const SystemState::Snapshot& state)
 {
-    set_start_location(IMU::getInstance()->get_ned_position());
+    set_start_location(state.nedPosition);
     set_start_time();
-    blas::vector<double> body_travel(blas::zero_vector<double>(3));
-    body_travel(0) = get_x_travel();
-    body_travel(1) = get_y_travel();
-    set_end_location(get_start_location() + prod(IMU::getInstance()->get_heading_rotation(), body_travel));
+    Vec3 body_travel(get_x_travel(), get_y_travel(), 0);
+    set_end_location(get_start_location() + Mat3::rotationZ(state.euler()(2)) * body_travel);
 }
 
 std::vector<Parameter> line::getParameters() const
@@ -72,7 +67,7 @@ std::vector<Parameter> line::getParameters() const
     return plist;
 }
 
-blas::vector<double> line::get_reference_position() const
+Vec3 line::get_reference_position() const
 {
     double elapsed_time = getMsSinceInit() / 1000.0;
     double flight_time = (get_speed() > 0 ? get_distance()/get_speed() : 0);
@@ -84,7 +79,7 @@ blas::vector<double> line::get_reference_position() const
     else if ((elapsed_time - hover_time) <= flight_time)
     {
         elapsed_time -= hover_time;
-        blas::vector<double> ned_velocity((get_end_location() - get_start_location())/flight_time);
+        Vec3 ned_velocity((get_end_location() - get_start_location())/flight_time);
         return get_start_location() + ned_velocity*elapsed_time;
     }
     else
@@ -95,7 +90,7 @@ blas::vector<double> line::get_reference_position() const
 
 double line::get_distance() const
 {
-    return norm_2(get_end_location() - get_start_location());
+    return (get_end_location() - get_start_location()).norm();
 }
 
 void line::get_xml_node()
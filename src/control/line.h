@@ -21,9 +21,6 @@
 #define LINE_H_
 
 /* Boost Headers */
-#include <boost/numeric/ublas/vector.hpp>
-#include <boost/numeric/ublas/matrix.hpp>
-namespace blas = boost::numeric::ublas;
 #include <thread>
 
 /* STL Headers */
@@ -34,6 +31,8 @@ namespace blas = boost::numeric::ublas;
 
 /* Project Headers */
 #include "Debug.h"
+#include "FixedMath.h"
+#include "SystemState.h"
 #include "Parameter.h"
 #include "Timer.hpp"
 
@@ -47,10 +46,10 @@ class line : public Logger, protected Timer
 public:
     line();
     /// return the reference position for the current time
-    blas::vector<double> get_reference_position() const;
+    Vec3 get_reference_position() const;
 
-    /// reset the trajectory to begin from the current location
-    void reset();
+    /// reset the trajectory to begin from the location and heading in state
+    void reset(const SystemState::Snapshot& state);
 
     /// set the x_travel
     void set_x_travel(const double newXTravel)
@@ -117,11 +116,11 @@ public:
 
 protected:
     /// position to begin trajectory in NED frame
-    blas::vector<double> start_location;
+    Vec3 start_location;
     /// serialzie access to start_location
     mutable std::mutex start_location_lock;
     /// set the start_location
-    void set_start_location(const blas::vector<double>& start_location)
+    void set_start_location(const Vec3& start_location)
     {
         {
             std::lock_guard<std::mutex> lock(start_location_lock);
@@ -130,18 +129,18 @@ protected:
         message() << "Line: Start Location set to " << start_location;
     }
     /// get the start_location
-    blas::vector<double> get_start_location() const
+    Vec3 get_start_location() const
     {
         std::lock_guard<std::mutex> lock(start_location_lock);
         return start_location;
     }
 
     /// end location in NED frame
-    blas::vector<double> end_location;
+    Vec3 end_location;
     /// serialize access to end_location
     mutable std::mutex end_location_lock;
     /// set the end_location
-    void set_end_location(const blas::vector<double>& end_location)
+    void set_end_location(const Vec3& end_location)
     {
         {
             std::lock_guard<std::mutex> lock(end_location_lock);
@@ -150,7 +149,7 @@ protected:
         message() << "Line: End location set to " << end_location;
     }
     /// get the end_location
-    blas::vector<double> get_end_location() const
+    Vec3 get_end_location() const
     {
         std::lock_guard<std::mutex> lock(end_location_lock);
         return end_location;
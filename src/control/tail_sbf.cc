@@ -20,7 +20,6 @@
 #include "tail_sbf.h"
 
 /* Project Headers */
-#include "IMU.h"
 #include "tail_sbf.h"
 #include "Helicopter.h"
 #include "Control.h"
@@ -50,6 +49,7 @@ tail_sbf::tail_sbf()
       ned_y(10)
 {
     scaled_travel = 0;
+    log_error_states = LogFile::getInstance()->channel<ErrorStates>(LOG_TRANS_SBF_ERROR_STATES);
 }
 
 void tail_sbf::reset()
@@ -63,56 +63,44 @@ bool tail_sbf::runnable() const
     return true;
 }
 
-void tail_sbf::operator()(const blas::vector<double>& reference) throw(bad_control)
+void tail_sbf::operator()(const Vec3& reference, const SystemState::Snapshot& state) throw(bad_control)
 {
+    Vec3 ned_position_error(state.nedPosition - reference);
+    Vec3 ned_velocity_error(state.nedVelocity);
 
-    IMU* imu = IMU::getInstance();
-    blas::vector<double> ned_position_error(imu->get_ned_position() - reference);
-    blas::vector<double> ned_velocity_error(imu->get_ned_velocity());
-
-    blas::vector<double> ned_control(3);
-    ned_control.clear();
-    std::vector<double> error_states;
+    Vec3 ned_control;
+    ErrorStates error_states;
     {
         std::lock_guard<std::mutex> lock(ned_x_lock);
-        error_states.push_back(ned_x.error().setProportional(ned_position_error(0)));
-        error_states.push_back(ned_x.error().setDerivative(ned_velocity_error(0)));
-        error_states.push_back(++(ned_x.error()));
+        error_states.X_Proportional = ned_x.error().setProportional(ned_position_error(0));
+        error_states.X_Derivative = ned_x.error().setDerivative(ned_velocity_error(0));
+        error_states.X_Integral = ++(ned_x.error());
         ned_control(0) = ned_x.compute_pid();
     }
     {
         std::lock_guard<std::mutex> lock(ned_y_lock);
-        error_states.push_back(ned_y.error().setProportional(ned_position_error(1)));
-        error_states.push_back(ned_y.error().setDerivative(ned_velocity_error(1)));
-        error_states.push_back(++(ned_y.error()));
+        error_states.Y_Proportional = ned_y.error().setProportional(ned_position_error(1));
+        error_states.Y_Derivative = ned_y.error().setDerivative(ned_velocity_error(1));
+        error_states.Y_Integral = ++(ned_y.error());
         ned_control(1) = ned_y.compute_pid();
     }
 
-    LogFile::getInstance()->logData(LOG_TRANS_SBF_ERROR_STATES, error_states);
+    log_error_states.log(error_states);
 
-    double heading = imu->get_euler()(2);
-    blas::matrix<double> Rz(3,3);
-    Rz.clear();
-    Rz(0,0) = cos(heading);
-    Rz(0,1) = -sin(heading);
-    Rz(1,0) = sin(heading);
-    Rz(1,1) = cos(heading);
-    Rz(2,2) = 1;
+    Mat3 Rz(Mat3::rotationZ(state.euler()(2)));
 
     Helicopter* bergen = Helicopter::getInstance();
     double m = bergen->get_mass();
     double g = bergen->get_gravity();
     ned_control(2) = -g;
-    blas::vector<double> body_control(m*prod(trans(Rz),ned_control));
+    Vec3 body_control(m*(Rz.transpose()*ned_control));
     double alpham = 0.04; // countertorque approximate slope
     double xt = abs(bergen->get_tail_hub_offset()(0));
 
     double theta_ref = atan(body_control(0)/body_control(2));
     double phi_ref = -atan((alpham*sqrt(pow(body_control(0),2)+pow(body_control(2),2))+xt*body_control(1))/(alpham*body_control(1) - xt*sqrt(pow(body_control(0),2)+pow(body_control(2),2))));
 
-    blas::vector<double> attitude_reference(2);
-    attitude_reference(0) = phi_ref;
-    attitude_reference(1) = theta_ref;
+    Vec2 attitude_reference(phi_ref, theta_ref);
 
     Control::saturate(attitude_reference, scaled_travel_radians());
 
@@ -29,14 +29,14 @@
 
 /* Boost Headers */
 #include <boost/math/constants/constants.hpp>
-#include <boost/numeric/ublas/vector.hpp>
-namespace blas = boost::numeric::ublas;
 
 /* Project Headers */
 #include "pid_channel.h"
 #include "ControllerInterface.h"
 #include "Parameter.h"
 #include "Debug.h"
+#include "LogFile.h"
+#include "LogRecord.h"
 
 /* STL Headers */
 #include <vector>
@@ -45,7 +45,7 @@ namespace blas = boost::numeric::ublas;
 #include <atomic>
 
 
-class tail_sbf : public ControllerInterface, public Logger
+class tail_sbf : public ControllerInterface<Vec3, Vec2>, public Logger
 {
 public:
     tail_sbf();
@@ -56,11 +56,11 @@ public:
     /// test if the controller is safe to run ** NOT IMPLEMENTED **
     bool runnable() const;
 
-    /// integrate position error, and compute the resulting control effort
-    void operator()(const blas::vector<double>& reference) throw(bad_control);
+    /// integrate position error from state, and compute the resulting control effort
+    void operator()(const Vec3& reference, const SystemState::Snapshot& state) throw(bad_control);
 
     /// @returns the roll pitch reference in radians (threadsafe)
-    inline blas::vector<double> get_control_effort() const
+    inline Vec2 get_control_effort() const
     {
         std::lock_guard<std::mutex> lock(control_effort_lock);
         return control_effort;
@@ -162,11 +162,11 @@ private:
     mutable std::mutex ned_x_lock, ned_y_lock;
 
     /// store the current control effort
-    blas::vector<double> control_effort;
+    Vec2 control_effort;
     /// serialize access to control_effort
     mutable std::mutex control_effort_lock;
     /// threadsafe set control_effort
-    inline void set_control_effort(const blas::vector<double>& control_effort)
+    inline void set_control_effort(const Vec2& control_effort)
     {
         std::lock_guard<std::mutex> lock(control_effort_lock);
         this->control_effort = control_effort;
@@ -184,6 +184,18 @@ private:
      * This function is threadsafe.
      */
     void set_scaled_travel(double travel);
+
+#define TAIL_SBF_ERROR_FIELDS(FIELD) \
+    FIELD(double, X_Proportional) \
+    FIELD(double, X_Derivative) \
+    FIELD(double, X_Integral) \
+    FIELD(double, Y_Proportional) \
+    FIELD(double, Y_Derivative) \
+    FIELD(double, Y_Integral)
+    LOG_RECORD(ErrorStates, TAIL_SBF_ERROR_FIELDS);
+
+    /// error states channel, registered once in the constructor
+    LogRecordChannel<ErrorStates> log_error_states;
 };
 
 #endif /* TAIL_SBF_H_ */
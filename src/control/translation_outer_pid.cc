@@ -43,14 +43,16 @@ translation_outer_pid::translation_outer_pid()
     : Logger("Translation Outer PID"),
       x(10),
       y(10),
-      scaled_travel(15)
+      scaled_travel(15),
+      log_error_states(LogFile::getInstance()->channel<ErrorStates>(LOG_TRANS_PID_ERROR_STATES))
 {
     x.name() = "X";
     y.name() = "Y";
 }
 
 translation_outer_pid::translation_outer_pid(const translation_outer_pid& other)
-    : Logger("Translation Outer PID")
+    : Logger("Translation Outer PID"),
+      log_error_states(other.log_error_states)
 {
     {
         std::lock_guard<std::mutex> lock(other.x_lock);
@@ -67,38 +69,32 @@ translation_outer_pid::translation_outer_pid(const translation_outer_pid& other)
 
 
 
-void translation_outer_pid::operator()(const blas::vector<double>& reference) throw(bad_control)
+void translation_outer_pid::operator()(const Vec3& reference, const SystemState::Snapshot& state) throw(bad_control)
 {
-    // get attitude measurement
-    IMU* imu = IMU::getInstance();
-    blas::vector<double> euler(imu->get_euler());
-
-    // get ned position/velocity
-    blas::vector<double> position(imu->get_ned_position());
-    blas::matrix<double> body_rotation(trans(IMU::euler_to_rotation(euler)));
-    blas::vector<double> body_position_error(blas::prod(body_rotation, position - reference));
-    blas::vector<double> body_velocity_error(blas::prod(body_rotation, imu->get_ned_velocity()));
+    // attitude and ned position/velocity, all from the same snapshot
+    Mat3 body_rotation(IMU::euler_to_rotation(state.euler()).transpose());
+    Vec3 body_position_error(body_rotation * (state.nedPosition - reference));
+    Vec3 body_velocity_error(body_rotation * state.nedVelocity);
 
     // roll pitch reference
-    blas::vector<double> attitude_reference(2);
-    attitude_reference.clear();
-    std::vector<double> error_states;
+    Vec2 attitude_reference;
+    ErrorStates error_states;
     {
         std::lock_guard<std::mutex> lock(x_lock);
-        error_states.push_back(x.error().setProportional(body_position_error[0]));
-        error_states.push_back(x.error().setDerivative(body_velocity_error[0]));
-        error_states.push_back(++(x.error()));
+        error_states.X_Proportional = x.error().setProportional(body_position_error[0]);
+        error_states.X_Derivative = x.error().setDerivative(body_velocity_error[0]);
+        error_states.X_Integral = ++(x.error());
         attitude_reference[1] = -x.compute_pid();
     }
     {
         std::lock_guard<std::mutex> lock(y_lock);
-        error_states.push_back(y.error().setProportional(body_position_error[1]));
-        error_states.push_back(y.error().setDerivative(body_velocity_error[1]));
-        error_states.push_back(++(y.error()));
+        error_states.Y_Proportional = y.error().setProportional(body_position_error[1]);
+        error_states.Y_Derivative = y.error().setDerivative(body_velocity_error[1]);
+        error_states.Y_Integral = ++(y.error());
         attitude_reference[0] = y.compute_pid();
     }
 
-    LogFile::getInstance()->logData(LOG_TRANS_PID_ERROR_STATES, error_states);
+    log_error_states.log(error_states);
 
     Control::saturate(attitude_reference, scaled_travel_radians());
 
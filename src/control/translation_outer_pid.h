@@ -33,6 +33,8 @@
 #include "ControllerInterface.h"
 #include "AutopilotMath.hpp"
 #include "Debug.h"
+#include "LogFile.h"
+#include "LogRecord.h"
 
 /* Boost Headers */
 #include <boost/math/constants/constants.hpp>
@@ -47,7 +49,7 @@
  * @date January 2012: Class Creation
  * @date February 10, 2012: Refactored into separate file
  */
-class translation_outer_pid : public ControllerInterface, public Logger
+class translation_outer_pid : public ControllerInterface<Vec3, Vec2>, public Logger
 {
 public:
     translation_outer_pid();
@@ -85,11 +87,11 @@ public:
     void set_y_integral(double ki);
     /**
      * Perform the pid control computation and return
-     * the roll pitch reference
+     * the roll pitch reference from the attitude, position and velocity in state
      */
-    void operator()(const blas::vector<double>& reference) throw(bad_control);
+    void operator()(const Vec3& reference, const SystemState::Snapshot& state) throw(bad_control);
     /// @returns the roll pitch reference in radians (threadsafe)
-    inline blas::vector<double> get_control_effort() const
+    inline Vec2 get_control_effort() const
     {
         std::lock_guard<std::mutex> lock(control_effort_lock);
         return control_effort;
@@ -162,11 +164,11 @@ private:
     mutable std::mutex y_lock;
 
     /// store the current control effort
-    blas::vector<double> control_effort;
+    Vec2 control_effort;
     /// serialize access to control_effort
     mutable std::mutex control_effort_lock;
     /// threadsafe set control_effort
-    inline void set_control_effort(const blas::vector<double>& control_effort)
+    inline void set_control_effort(const Vec2& control_effort)
     {
         std::lock_guard<std::mutex> lock(control_effort_lock);
         this->control_effort = control_effort;
@@ -186,5 +188,16 @@ private:
      */
     void set_scaled_travel(double travel);
 
+#define TRANSLATION_PID_ERROR_FIELDS(FIELD) \
+    FIELD(double, X_Proportional) \
+    FIELD(double, X_Derivative) \
+    FIELD(double, X_Integral) \
+    FIELD(double, Y_Proportional) \
+    FIELD(double, Y_Derivative) \
+    FIELD(double, Y_Integral)
+    LOG_RECORD(ErrorStates, TRANSLATION_PID_ERROR_FIELDS);
+
+    /// error states channel, registered once in the constructor
+    LogRecordChannel<ErrorStates> log_error_states;
 };
 #endif
@@ -26,19 +26,6 @@
 #include <chrono>
 
 
-CommonMessages* CommonMessages::_instance = NULL;
-std::mutex CommonMessages::_instance_lock;
-
-CommonMessages* CommonMessages::getInstance()
-{
-    std::lock_guard<std::mutex> lock(_instance_lock);
-    if (_instance == NULL)
-    {
-        _instance = new CommonMessages;
-    }
-    return _instance;
-}
-
 CommonMessages::CommonMessages()
     :Driver("Mavlink Common Messages","common_messages")
 {
@@ -92,22 +79,23 @@ void CommonMessages::sendMavlinkMsg(std::vector<mavlink_message_t>& msgs, int ua
 
     SystemState* state = SystemState::getInstance();
 
+    // the attitude, radio and control messages are from the same snapshot, the angles and rates from the same IMU sample
+    SystemState::Snapshot now = state->snapshot();
+
 
     // Send attitude
     if(shouldSendMavlinkMessage(msgNumber, sendRateHz, 5))
     {
         mavlink_message_t msg;
 
-        auto angles = state->rotation.get();
-
         mavlink_msg_attitude_pack(uasId, MAV_COMP_ID_IMU, &msg,
                                  getMsSinceInit(),
-                                 angles.getRollRad(),
-                                 angles.getPitchRad(),
-                                 angles.getYawRad(),
-                                 state->rollSpeed_radPerS.get(),
-                                 state->pitchSpeed_radPerS.get(),
-                                 state->yawSpeed_radPerS.get());
+                                 now.rotation.getRollRad(),
+                                 now.rotation.getPitchRad(),
+                                 now.rotation.getYawRad(),
+                                 now.rollSpeed_radPerS,
+                                 now.pitchSpeed_radPerS,
+                                 now.yawSpeed_radPerS);
 
         msgs.push_back(msg);
     }
@@ -116,7 +104,7 @@ void CommonMessages::sendMavlinkMsg(std::vector<mavlink_message_t>& msgs, int ua
     if(shouldSendMavlinkMessage(msgNumber, sendRateHz, rcChannelRate.load()))
     {
         {
-            auto raw = state->servoRawInputs.get();
+            const std::array<uint16_t, 8>& raw = now.servoRawInputs;
             mavlink_message_t msg;
             mavlink_msg_rc_channels_raw_pack(100, 200, &msg,
                                              0, 0,
@@ -125,7 +113,7 @@ void CommonMessages::sendMavlinkMsg(std::vector<mavlink_message_t>& msgs, int ua
             msgs.push_back(msg);
         }
         {
-            std::vector<double> scaled(RCTrans::getScaledVector());
+            Vector<6> scaled(RCTrans::getScaled(now));
             mavlink_message_t msg;
             mavlink_msg_rc_channels_scaled_pack(100, 200, &msg,
                                                 0,0,
@@ -143,7 +131,7 @@ void CommonMessages::sendMavlinkMsg(std::vector<mavlink_message_t>& msgs, int ua
     if(msgNumber % (sendRateHz / controlEffortRate.load()) == 0)
     {
         mavlink_message_t msg;
-        blas::vector<double> effort(Control::getInstance()->get_control_effort());
+        Vector<6> effort(Control::getInstance()->get_control_effort(now));
         std::vector<float> control(effort.begin(), effort.end());
         mavlink_msg_ualberta_control_effort_pack(uasId, heli::CONTROLLER_ID, &msg, &control[0]);
 
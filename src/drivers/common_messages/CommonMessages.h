@@ -21,21 +21,20 @@
 #define COMMON_MESSAGES_H
 
 #include <atomic>  // Used for atomic types
-#include <mutex>   // Used for singleton design.
+#include <mutex>   // Used for the requested param list
 #include <queue>   // User for requested param list
 #include "Driver.h" // All drivers implement this.
 #include "Parameter.h"
+#include "Singleton.h"
 
 /**
  * Provides an interface to the performance of Linux.
  **/
-class CommonMessages: public Driver
+class CommonMessages: public Driver, public Singleton<CommonMessages>
 {
+    friend Singleton<CommonMessages>;
+
 public:
-    /**
-    Returns the one allowed instance of this Driver
-    **/
-    static CommonMessages* getInstance();
     virtual void sendMavlinkMsg(std::vector<mavlink_message_t>& msgs, int uasId, int sendRateHz, int msgNumber) override;
     std::atomic_bool _sendParams;
     std::atomic_bool _sendRCCalibration;
@@ -49,9 +48,6 @@ public:
     std::atomic<int> controlEffortRate;
 
 private:
-    static CommonMessages* _instance;
-    static std::mutex _instance_lock;
-
     CommonMessages();
     virtual ~CommonMessages();
     std::atomic<int> _frequencyHz; // frequency at which to send these messages.
@@ -66,6 +66,12 @@ bool ExternalMavlink::init()
     }
 
     namedTerminalSettings("read_settings", fd, 57600, "8N1", false, true);
+
+    // with the reactor reading the port loop() has nothing left to do
+    if(useReactor() && ! watchDevice(fd, [this](uint64_t){ readAvailable(); }))
+    {
+        return false;
+    }
     trace() << "started";
 
     LogFile* lf = LogFile::getInstance();
@@ -87,11 +93,18 @@ void ExternalMavlink::teardown()
 
 void ExternalMavlink::loop()
 {
+    if(! useReactor())
+    {
+        readAvailable();
+    }
+}
 
-    // read message
+void ExternalMavlink::readAvailable()
+{
+    // read message, taking whatever has arrived rather than waiting for a full buffer
     char buf[1024];
 	int bytes_received = 0;
-    bytes_received = readDevice(fd, buf, 1024);
+    bytes_received = readDevice(fd, buf, sizeof(buf), 1);
     
 
     // parse message
@@ -47,6 +47,9 @@ public:
 private:
     ExternalMavlink();
 
+    /// reads and handles whatever has arrived on fd, from loop() or the IoReactor
+    void readAvailable();
+
     /// The open file for the external mavlink to read from (file or device node)
     int fd;
 
@@ -31,7 +31,8 @@ bool FakeRc::init()
     }
 
     auto state = SystemState::getInstance();
-    state->servoRawInputs.onSet.connect([&](std::array<uint16_t, 8> val, double err){debug() << "Got servo positions" << val;});
+    state->servoRawInputs.onSet.connect([this](const std::array<uint16_t, 8>& val, double err){debug() << "Got servo positions" << val;},
+                                        SystemStateNotifier::DEFERRED);
 
 
     return true;
@@ -58,13 +58,8 @@ IMU::IMU()
      fd_ser(-1),
      _position(),
      _ned_origin(),
-     velocity(blas::zero_vector<double>(3)),
      use_nav_attitude(false),
-     nav_euler(blas::zero_vector<double>(3)),
-     ahrs_euler(blas::zero_vector<double>(3)),
-     nav_rotation(blas::identity_matrix<double>(3)),
-     nav_angular_rate(blas::zero_vector<double>(3)),
-     ahrs_angular_rate(blas::zero_vector<double>(3)),
+     nav_rotation(Mat3::identity()),
     attitude_source_connection(QGCLink::getInstance()->attitude_source.connect(
                                     boost::bind(&IMU::set_use_nav_attitude, this, _1)))
 {
@@ -98,7 +93,18 @@ IMU::IMU()
     }
 
 
-    new std::thread(read_serial());
+    if(useReactor())
+    {
+        read_serial* reader = new read_serial();
+        set_last_data();
+        watchDevice(fd_ser,
+                    [reader](uint64_t arrival_ns){ reader->readable(arrival_ns); },
+                    [reader]{ reader->check_alive(); });
+    }
+    else
+    {
+        new std::thread(read_serial());
+    }
     new std::thread(message_parser());
     new send_serial(this);
 }
@@ -176,10 +182,9 @@ void IMU::set_use_nav_attitude(bool attitude_source)
     message() << "Attitude source changed to " << (attitude_source?"nav filter":"ahrs") << ".";
 }
 
-blas::matrix<double> IMU::euler_to_rotation(const blas::vector<double>& euler)
+Mat3 IMU::euler_to_rotation(const Vec3& euler)
 {
-    blas::matrix<double> rot(3,3);
-    rot.clear();
+    Mat3 rot;
 
     double roll = euler[0], pitch = euler[1], yaw = euler[2];
     rot(0, 0) = cos(yaw)*cos(pitch);
@@ -192,21 +197,12 @@ blas::matrix<double> IMU::euler_to_rotation(const blas::vector<double>& euler)
     rot(2, 1) = -cos(yaw)*sin(roll)+sin(yaw)*sin(pitch)*cos(roll);
     rot(2, 2) = cos(pitch)*cos(roll);
 
-    return trans(rot);
+    return rot.transpose();
 }
 
-blas::matrix<double> IMU::get_heading_rotation() const
+Mat3 IMU::get_heading_rotation() const
 {
-    double heading = get_euler()(2);
-    blas::matrix<double> Rz(3,3);
-    Rz.clear();
-    Rz(0,0) = cos(heading);
-    Rz(0,1) = -sin(heading);
-    Rz(1,0) = sin(heading);
-    Rz(1,1) = cos(heading);
-    Rz(2,2) = 1;
-
-    return Rz;
+    return Mat3::rotationZ(get_euler()(2));
 }
 
 
@@ -224,11 +220,11 @@ void IMU::sendMavlinkMsg(std::vector<mavlink_message_t>& msgs, int uasId, int se
         std::vector<float> llh_pos(_llh_pos.begin(), _llh_pos.end());
 
         // get ned pos
-        blas::vector<double> _ned_pos = get_ned_position();
+        Vec3 _ned_pos = get_ned_position();
         std::vector<float> ned_pos(_ned_pos.begin(), _ned_pos.end());
 
         // get ned vel
-        blas::vector<double> _ned_vel(get_ned_velocity());
+        Vec3 _ned_vel(get_ned_velocity());
         std::vector<float> ned_vel(_ned_vel.begin(), _ned_vel.end());
 
         // get ned origin
@@ -237,15 +233,18 @@ void IMU::sendMavlinkMsg(std::vector<mavlink_message_t>& msgs, int uasId, int se
 
         Control *control = Control::getInstance();
         // get reference position
-        blas::vector<double> _ref_pos(control->get_reference_position());
+        Vec3 _ref_pos(control->get_reference_position());
         std::vector<float> ref_pos(_ref_pos.begin(), _ref_pos.end());
 
+        // the errors as the control tick sees them
+        SystemState::Snapshot state(SystemState::getInstance()->snapshot());
+
         // get position error in body
-        blas::vector<double> _body_error(control->get_body_postion_error());
+        Vec3 _body_error(control->get_body_postion_error(state));
         std::vector<float> body_error(_body_error.begin(), _body_error.end());
 
         // get position error in ned
-        blas::vector<double> _ned_error(control->get_ned_position_error());
+        Vec3 _ned_error(control->get_ned_position_error(state));
         std::vector<float> ned_error(_ned_error.begin(), _ned_error.end());
 
         mavlink_message_t msg;
@@ -267,19 +266,19 @@ void IMU::sendMavlinkMsg(std::vector<mavlink_message_t>& msgs, int uasId, int se
     {
         //trace() << "Sending mavlink_msg_ualberta_attitude";
 
-        blas::vector<double> _nav_euler(get_nav_euler());
+        Vec3 _nav_euler(get_nav_euler());
         std::vector<float> nav_euler(_nav_euler.begin(), _nav_euler.end());
 
-        blas::vector<double> _nav_ang_rate(get_nav_angular_rate());
+        Vec3 _nav_ang_rate(get_nav_angular_rate());
         std::vector<float> nav_ang_rate(_nav_ang_rate.begin(), _nav_ang_rate.end());
 
-        blas::vector<double> _ahrs_euler(get_ahrs_euler());
+        Vec3 _ahrs_euler(get_ahrs_euler());
         std::vector<float> ahrs_euler(_ahrs_euler.begin(), _ahrs_euler.end());
 
-        blas::vector<double> _ahrs_ang_rate(get_ahrs_angular_rate());
+        Vec3 _ahrs_ang_rate(get_ahrs_angular_rate());
         std::vector<float> ahrs_ang_rate(_ahrs_ang_rate.begin(), _ahrs_ang_rate.end());
 
-        blas::vector<double> _attitude_reference(Control::getInstance()->get_reference_attitude());
+        Vec2 _attitude_reference(Control::getInstance()->get_reference_attitude());
         std::vector<float> attitude_reference(_attitude_reference.begin(), _attitude_reference.end());
 
         mavlink_message_t msg;
@@ -317,17 +316,24 @@ void IMU::writeToSystemState()
     state->nedOrigin.set(getNedOriginPosition(), 0);
 
 
-    // set the rotation
-    auto euler = get_euler();
-    EulerAngles ea(euler[0], euler[1], euler[2]);
-    debug() << "Roll: " << euler[0] << " Pitch: " << euler[1] << " Yaw: " << euler[2];
-    state->rotation.set(ea, 0);
+    // the ned position and velocity, rotation and rates the control tick reads reach the snapshot together
+    {
+        SystemState::Batch batch;
+
+        state->setNavigation(get_ned_position(), get_ned_velocity());
 
-    // set the angular rates.
-    auto eulerrate =  get_euler_rate();
-    state->rollSpeed_radPerS.set(eulerrate[0], 0);
-    state->pitchSpeed_radPerS.set(eulerrate[1], 0);
-    state->yawSpeed_radPerS.set(eulerrate[2], 0);
+        // set the rotation
+        auto euler = get_euler();
+        EulerAngles ea(euler[0], euler[1], euler[2]);
+        LOGGER_DEBUG(*this) << "Roll: " << euler[0] << " Pitch: " << euler[1] << " Yaw: " << euler[2];
+        state->rotation.set(ea, 0);
+
+        // set the angular rates.
+        auto eulerrate =  get_euler_rate();
+        state->rollSpeed_radPerS.set(eulerrate[0], 0);
+        state->pitchSpeed_radPerS.set(eulerrate[1], 0);
+        state->yawSpeed_radPerS.set(eulerrate[2], 0);
+    }
 
     /**
 
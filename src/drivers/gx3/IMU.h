@@ -22,8 +22,6 @@
 
 /* Boost Headers */
 #include <boost/signals2.hpp>
-#include <boost/numeric/ublas/vector.hpp>
-#include <boost/numeric/ublas/matrix.hpp>
 
 /* STL Headers */
 #include <vector>
@@ -33,12 +31,13 @@
 
 /* Project Headers */
 #include "Driver.h"
-#include "ThreadQueue.h"
+#include "SpscRing.h"
+#include "Wakeup.h"
+#include "gx3_packet_pool.h"
 #include "ThreadSafeVariable.h"
 #include "Singleton.h"
 #include "GPSPosition.h"
-
-namespace blas = boost::numeric::ublas;
+#include "FixedMath.h"
 
 
 /**
@@ -53,6 +52,8 @@ namespace blas = boost::numeric::ublas;
 class IMU : public Driver, public Singleton<IMU>
 {
     friend Singleton<IMU>;
+    /// plays recorded data to read_serial down a pipe in place of the port, see gx3_packet_pool_test.cc
+    friend struct GX3PipelineTest;
 public:
     virtual ~IMU();
 
@@ -82,7 +83,7 @@ public:
     };
 
     /// get position in local ned frame (origin must be set)
-    blas::vector<double> get_ned_position() const
+    Vec3 get_ned_position() const
     {
         GPSPosition tmp = getNedOriginPosition();
         return getPosition().ned(tmp);
@@ -110,26 +111,26 @@ public:
 
 
     /// function to keep names symmetrical with position
-    inline blas::vector<double> get_ned_velocity() const
+    inline Vec3 get_ned_velocity() const
     {
         std::lock_guard<std::mutex> lock(velocity_lock);
         return velocity;
     }
     /// get rotation matrix depending on use_nav_attitude
-    inline blas::matrix<double> get_rotation() const
+    inline Mat3 get_rotation() const
     {
         return euler_to_rotation(get_euler());
     }
     /// get the rotation matrix for the heading angle only (body->navigation)
-    blas::matrix<double> get_heading_rotation() const;
+    Mat3 get_heading_rotation() const;
     /// get the euler angles depending on use_nav_attitude
-    inline blas::vector<double> get_euler() const
+    inline Vec3 get_euler() const
     {
         return (get_use_nav_attitude()) ? get_nav_euler() : get_ahrs_euler();
     }
 
     /// get the euler angle derivatives
-    blas::vector<double> get_euler_rate() const
+    Vec3 get_euler_rate() const
     {
         // just return the angular rate since the yaw gyro measurement is not reliable
         return (get_use_nav_attitude()) ? get_nav_angular_rate() : get_ahrs_angular_rate();
@@ -146,7 +147,7 @@ public:
         _newStatusMessage = true;
     }
 
-    static blas::matrix<double> euler_to_rotation(const blas::vector<double>& euler);
+    static Mat3 euler_to_rotation(const Vec3& euler);
 
 	virtual void sendMavlinkMsg(std::vector<mavlink_message_t>& msgs, int uasId, int sendRateHz, int msgNumber) override;
 
@@ -180,14 +181,24 @@ private:
     static std::vector<uint8_t> compute_checksum(std::vector<uint8_t> data);
 
 
+    /// the number of packet buffers shared between read_serial and message_parser
+    static const size_t PACKET_POOL_SIZE = 128;
+    typedef GX3PacketPool<PACKET_POOL_SIZE> PacketPool;
+    /// packets queued for the parser by their index in the pool, read_serial produces, message_parser consumes
+    typedef SpscRing<PacketPool::Index, PACKET_POOL_SIZE> PacketQueue;
+
+    /// buffers for every packet in flight between read_serial and message_parser
+    PacketPool packet_pool;
     /// container for command data
-    ThreadQueue<std::vector<uint8_t> > command_queue;
+    PacketQueue command_queue;
     /// container for ahrs data
-    ThreadQueue<std::vector<uint8_t> > ahrs_queue;
+    PacketQueue ahrs_queue;
     /// container for gps data
-    ThreadQueue<std::vector<uint8_t> > gps_queue;
+    PacketQueue gps_queue;
     /// container for nav data
-    ThreadQueue<std::vector<uint8_t> > nav_queue;
+    PacketQueue nav_queue;
+    /// posted by read_serial whenever it queues packets so message_parser can sleep until there is work
+    Wakeup packet_arrived;
 
 
     /// keep track of the gx3's mode
@@ -215,11 +226,11 @@ private:
 
 
     /// store current velocity in ned coords
-    blas::vector<double> velocity;
+    Vec3 velocity;
     /// serialize access to IMU::velocity
     mutable std::mutex velocity_lock;
     /// threadsafe set velocity
-    inline void set_velocity(const blas::vector<double>& velocity)
+    inline void set_velocity(const Vec3& velocity)
     {
         std::lock_guard<std::mutex> lock(velocity_lock);
         this->velocity = velocity;
@@ -236,44 +247,44 @@ private:
     void set_use_nav_attitude(bool attitude_source);
 
     /// store the current euler angle estimate from the nav filter
-    blas::vector<double> nav_euler;
+    Vec3 nav_euler;
     /// serialize access to nav_euler
     mutable std::mutex nav_euler_lock;
     /// threadsafe set nav_euler
-    inline void set_nav_euler(const blas::vector<double>& euler)
+    inline void set_nav_euler(const Vec3& euler)
     {
         std::lock_guard<std::mutex> lock(nav_euler_lock);
         nav_euler = euler;
     }
 
     /// store the current euler angle estimate from the ahrs filter
-    blas::vector<double> ahrs_euler;
+    Vec3 ahrs_euler;
     /// serialize access to ahrs_euler
     mutable std::mutex ahrs_euler_lock;
     /// threadsafe set ahrs_euler
-    inline void set_ahrs_euler(const blas::vector<double>& euler)
+    inline void set_ahrs_euler(const Vec3& euler)
     {
         std::lock_guard<std::mutex> lock(ahrs_euler_lock);
         ahrs_euler = euler;
     }
 
     /// store the current rotation matrix between ned and body frames
-    blas::matrix<double> nav_rotation;
+    Mat3 nav_rotation;
     /// serialize access to IMU::rotation
     mutable std::mutex nav_rotation_lock;
     /// threadsafe set rotation
-    inline void set_nav_rotation(const blas::matrix<double>& rotation)
+    inline void set_nav_rotation(const Mat3& rotation)
     {
         std::lock_guard<std::mutex> lock(nav_rotation_lock);
         this->nav_rotation = rotation;
     }
 
     /// store the current angular rates
-    blas::vector<double> nav_angular_rate;
+    Vec3 nav_angular_rate;
     /// serialize access to IMU::angular_rate
     mutable std::mutex nav_angular_rate_lock;
     /// threadsafe set angular_rate
-    inline void set_nav_angular_rate(const blas::vector<double>& angular_rate)
+    inline void set_nav_angular_rate(const Vec3& angular_rate)
     {
         std::lock_guard<std::mutex> lock(nav_angular_rate_lock);
         nav_angular_rate = angular_rate;
@@ -281,11 +292,11 @@ private:
 
 
     /// store the current angular rates
-    blas::vector<double> ahrs_angular_rate;
+    Vec3 ahrs_angular_rate;
     /// serialize access to IMU::angular_rate
     mutable std::mutex ahrs_angular_rate_lock;
     /// threadsafe set angular_rate
-    inline void set_ahrs_angular_rate(const blas::vector<double>& angular_rate)
+    inline void set_ahrs_angular_rate(const Vec3& angular_rate)
     {
         std::lock_guard<std::mutex> lock(ahrs_angular_rate_lock);
         ahrs_angular_rate = angular_rate;
@@ -319,33 +330,33 @@ private:
     boost::signals2::scoped_connection attitude_source_connection;
 
     /// threadsafe get nav_euler
-    inline blas::vector<double> get_nav_euler() const // 2014-06-23 -- now only used internally
+    inline Vec3 get_nav_euler() const // 2014-06-23 -- now only used internally
     {
         std::lock_guard<std::mutex> lock(nav_euler_lock);
         return nav_euler;
     }
     /// threadsafe get ahrs_euler
-    inline blas::vector<double> get_ahrs_euler() const // 2014-06-23 -- now only used internally
+    inline Vec3 get_ahrs_euler() const // 2014-06-23 -- now only used internally
     {
         std::lock_guard<std::mutex> lock(ahrs_euler_lock);
         return ahrs_euler;
     }
 
     /// threadsafe get nav angular_rate
-    inline blas::vector<double> get_nav_angular_rate() const  // 2014-06-23 -- now only used internally
+    inline Vec3 get_nav_angular_rate() const  // 2014-06-23 -- now only used internally
     {
         std::lock_guard<std::mutex> lock(nav_angular_rate_lock);
         return nav_angular_rate;
     }
     /// threadsafe get ahrs angular_rate
-    inline blas::vector<double> get_ahrs_angular_rate() const  // 2014-06-23 -- now only used internally
+    inline Vec3 get_ahrs_angular_rate() const  // 2014-06-23 -- now only used internally
     {
         std::lock_guard<std::mutex> lock(ahrs_angular_rate_lock);
         return ahrs_angular_rate;
     }
 
     /// threadsafe get rotation
-    inline blas::matrix<double> get_nav_rotation() const // 2014-06-23 -- not used
+    inline Mat3 get_nav_rotation() const // 2014-06-23 -- not used
     {
         std::lock_guard<std::mutex> lock(nav_rotation_lock);
         return nav_rotation;
@@ -20,6 +20,9 @@
 #ifndef IMU_FILTER_H_
 #define IMU_FILTER_H_
 
+/* STL Headers */
+#include <array>
+
 /* Boost Headers*/
 #include <boost/circular_buffer.hpp>
 
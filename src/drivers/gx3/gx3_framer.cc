@@ -0,0 +1,79 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#include "gx3_framer.h"
+
+GX3Framer::GX3Framer()
+    :_packets(0),
+     _checksum_failures(0),
+     _bytes_discarded(0)
+{
+}
+
+uint16_t GX3Framer::checksum(const uint8_t* data, size_t length)
+{
+    uint8_t a = 0, b = 0;
+    for(size_t i = 0; i < length; i++)
+    {
+        a += data[i];
+        b += a;
+    }
+    return (static_cast<uint16_t>(a) << 8) | b;
+}
+
+bool GX3Framer::sync()
+{
+    while(_ring.size() >= 2)
+    {
+        if(_ring[0] == FIRST_SYNC_BYTE && _ring[1] == SECOND_SYNC_BYTE)
+        {
+            return true;
+        }
+
+        // skip ahead to the next candidate first sync byte
+        size_t skip = _ring.find(FIRST_SYNC_BYTE, 1);
+        _ring.consume(skip);
+        _bytes_discarded += skip;
+    }
+
+    return false;
+}
+
+size_t GX3Framer::next(uint8_t* packet)
+{
+    while(sync())
+    {
+        if(_ring.size() < HEADER_LENGTH_BYTES)
+        {
+            return 0;
+        }
+
+        size_t length = HEADER_LENGTH_BYTES + _ring[3];
+        if(_ring.size() < length + CHECKSUM_LENGTH_BYTES)
+        {
+            return 0;
+        }
+
+        _ring.copyOut(0, packet, length);
+        uint16_t expected = (static_cast<uint16_t>(_ring[length]) << 8) | _ring[length + 1];
+
+        if(checksum(packet, length) != expected)
+        {
+            // the sync bytes were probably payload, look for the next header after them
+            _checksum_failures++;
+            _bytes_discarded++;
+            _ring.consume(1);
+            continue;
+        }
+
+        _ring.consume(length + CHECKSUM_LENGTH_BYTES);
+        _packets++;
+        return length;
+    }
+
+    return 0;
+}
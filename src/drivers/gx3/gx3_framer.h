@@ -0,0 +1,123 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#ifndef GX3_FRAMER_H_
+#define GX3_FRAMER_H_
+
+/* C Headers */
+#include <stdint.h>
+#include <stddef.h>
+
+/* Project Headers */
+#include "ByteRing.h"
+
+/**
+ * @brief Splits the raw byte stream coming from the 3DM-GX3 in to MIP packets.
+ *
+ * Bytes are read from the port directly in to the framer's ring (see writeSpan() and commit())
+ * in whatever sized chunks the port has available, next() then scans the ring in memory for the
+ * 0x75 0x65 sync bytes and hands back complete packets whose checksum is valid.
+ *
+ * Packets are returned the same way the rest of the GX3 code expects them, the four byte header
+ * (sync, sync, descriptor, length) followed by the payload, the two checksum bytes are stripped.
+ *
+ * @code
+ * GX3Framer framer;
+ * uint8_t packet[GX3Framer::MAX_PACKET_LENGTH];
+ *
+ * size_t space = 0;
+ * uint8_t* dst = framer.writeSpan(space);
+ * framer.commit(read(fd, dst, space));
+ *
+ * size_t length;
+ * while((length = framer.next(packet)) > 0)
+ * {
+ *     // packet[2] is the descriptor set
+ * }
+ * @endcode
+ */
+class GX3Framer
+{
+public:
+    static const uint8_t FIRST_SYNC_BYTE = 0x75;
+    static const uint8_t SECOND_SYNC_BYTE = 0x65;
+    static const size_t HEADER_LENGTH_BYTES = 4;
+    static const size_t CHECKSUM_LENGTH_BYTES = 2;
+    /// header plus the largest payload a one byte length field can describe
+    static const size_t MAX_PACKET_LENGTH = HEADER_LENGTH_BYTES + 255;
+
+    GX3Framer();
+
+    /// see ByteRing::writeSpan
+    uint8_t* writeSpan(size_t& len)
+    {
+        return _ring.writeSpan(len);
+    }
+
+    /// see ByteRing::commit, negative values (failed reads) are ignored
+    void commit(int n)
+    {
+        if(n > 0)
+        {
+            _ring.commit(n);
+        }
+    }
+
+    /// copies bytes in to the framer, returns the number accepted
+    size_t write(const uint8_t* data, size_t n)
+    {
+        return _ring.write(data, n);
+    }
+
+    /**
+     * Finds the next complete packet in the buffered bytes and copies its header and payload
+     * to packet, which must hold at least MAX_PACKET_LENGTH bytes.
+     *
+     * @return the length of the packet copied, or 0 if no complete packet is buffered yet.
+     */
+    size_t next(uint8_t* packet);
+
+    /// drops all buffered bytes
+    void reset()
+    {
+        _ring.clear();
+    }
+
+    /// the number of packets returned by next()
+    uint64_t packets() const
+    {
+        return _packets;
+    }
+
+    /// the number of packets thrown away because their checksum didn't match
+    uint64_t checksumFailures() const
+    {
+        return _checksum_failures;
+    }
+
+    /// the number of bytes skipped while looking for a sync header
+    uint64_t bytesDiscarded() const
+    {
+        return _bytes_discarded;
+    }
+
+    /// the fletcher checksum the GX3 uses over header and payload
+    static uint16_t checksum(const uint8_t* data, size_t length);
+
+private:
+    /// big enough for several packets so one read() can drain the port
+    ByteRing<4096> _ring;
+
+    uint64_t _packets;
+    uint64_t _checksum_failures;
+    uint64_t _bytes_discarded;
+
+    /// drops bytes until the ring starts with a possible sync header, returns false if more bytes are needed
+    bool sync();
+};
+
+#endif /* GX3_FRAMER_H_ */
@@ -0,0 +1,157 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "gx3_framer.h"
+#include "AllocationCounter.h"
+#include "Benchmark.h"
+
+/* STL Headers */
+#include <vector>
+
+/* C Headers */
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+namespace
+{
+/// counts the read() calls made against the recorded data
+struct CountingReader
+{
+    int fd;
+    uint64_t syscalls;
+
+    int operator()(void* buf, int n)
+    {
+        syscalls++;
+        return read(fd, buf, n);
+    }
+};
+
+/// writes data to an unlinked temporary file so reads are real syscalls, returns the fd
+int temporary_fd(const std::vector<uint8_t>& data)
+{
+    char path[] = "/tmp/gx3_framer_benchXXXXXX";
+    int fd = mkstemp(path);
+    if(fd < 0)
+    {
+        return -1;
+    }
+    unlink(path);
+
+    if(write(fd, &data[0], data.size()) != (ssize_t) data.size())
+    {
+        close(fd);
+        return -1;
+    }
+    lseek(fd, 0, SEEK_SET);
+    return fd;
+}
+
+/// the reader this framer replaced, one byte at a time until the sync bytes then the rest of the packet
+uint64_t legacy_read(CountingReader& reader)
+{
+    uint64_t packets = 0;
+    uint8_t last_byte = 0, curr_byte = 0;
+    std::vector<uint8_t> buffer;
+    buffer.reserve(GX3Framer::MAX_PACKET_LENGTH);
+
+    while(true)
+    {
+        if(reader(&curr_byte, 1) < 1)
+        {
+            return packets;
+        }
+
+        if(!(last_byte == GX3Framer::FIRST_SYNC_BYTE && curr_byte == GX3Framer::SECOND_SYNC_BYTE))
+        {
+            last_byte = curr_byte;
+            continue;
+        }
+        last_byte = 0;
+
+        uint8_t descriptor = 0, length = 0, checksum[2];
+        if(reader(&descriptor, 1) < 1 || reader(&length, 1) < 1)
+        {
+            return packets;
+        }
+
+        buffer.assign({GX3Framer::FIRST_SYNC_BYTE, GX3Framer::SECOND_SYNC_BYTE, descriptor, length});
+        buffer.resize(GX3Framer::HEADER_LENGTH_BYTES + length);
+        if(length > 0 && reader(&buffer[GX3Framer::HEADER_LENGTH_BYTES], length) < length)
+        {
+            return packets;
+        }
+
+        if(reader(checksum, 2) < 2)
+        {
+            return packets;
+        }
+
+        if(GX3Framer::checksum(&buffer[0], buffer.size()) == ((checksum[0] << 8) | checksum[1]))
+        {
+            packets++;
+        }
+    }
+}
+
+uint64_t framer_read(CountingReader& reader)
+{
+    GX3Framer framer;
+    uint8_t packet[GX3Framer::MAX_PACKET_LENGTH];
+
+    while(true)
+    {
+        size_t space = 0;
+        uint8_t* dst = framer.writeSpan(space);
+        int amt = reader(dst, space);
+        if(amt <= 0)
+        {
+            return framer.packets();
+        }
+        framer.commit(amt);
+
+        while(framer.next(packet) > 0);
+    }
+}
+
+void run(Benchmark& bench, uint64_t (*reader_fn)(CountingReader&))
+{
+    std::vector<uint8_t> data;
+    if(! Benchmark::readRecordedData("imu_data.bin", data))
+    {
+        bench.skip("recorded_data/imu_data.bin not found");
+        return;
+    }
+
+    CountingReader reader = {temporary_fd(data), 0};
+    if(reader.fd < 0)
+    {
+        bench.skip("could not create a temporary file");
+        return;
+    }
+
+    uint64_t allocations = AllocationCounter::allocations();
+    uint64_t start = Benchmark::nowNanos();
+    uint64_t packets = reader_fn(reader);
+    uint64_t elapsed = Benchmark::nowNanos() - start;
+    allocations = AllocationCounter::allocations() - allocations;
+    close(reader.fd);
+
+    bench.reportPackets(packets, data.size(), elapsed, allocations);
+    bench.report("syscalls_per_packet", (double) reader.syscalls / packets, "read/packet");
+}
+}
+
+BENCHMARK(GX3Framer, LegacyByteReads)
+{
+    run(bench, legacy_read);
+}
+
+BENCHMARK(GX3Framer, BufferedReads)
+{
+    run(bench, framer_read);
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "gx3_framer.h"
+#include "Benchmark.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace
+{
+std::vector<uint8_t> make_packet(uint8_t descriptor, const std::vector<uint8_t>& payload)
+{
+    std::vector<uint8_t> packet = {GX3Framer::FIRST_SYNC_BYTE, GX3Framer::SECOND_SYNC_BYTE, descriptor, (uint8_t) payload.size()};
+    packet.insert(packet.end(), payload.begin(), payload.end());
+    uint16_t checksum = GX3Framer::checksum(&packet[0], packet.size());
+    packet.push_back(checksum >> 8);
+    packet.push_back(checksum & 0xFF);
+    return packet;
+}
+}
+
+TEST(GX3Framer, SinglePacket)
+{
+    GX3Framer framer;
+    std::vector<uint8_t> packet = make_packet(0x82, {1, 2, 3, 4});
+    framer.write(&packet[0], packet.size());
+
+    uint8_t out[GX3Framer::MAX_PACKET_LENGTH];
+    ASSERT_EQ(8u, framer.next(out));
+    EXPECT_EQ(0x82, out[2]);
+    EXPECT_EQ(4, out[3]);
+    EXPECT_EQ(4, out[7]);
+    EXPECT_EQ(0u, framer.next(out));
+}
+
+TEST(GX3Framer, PartialPacketWaitsForMoreBytes)
+{
+    GX3Framer framer;
+    std::vector<uint8_t> packet = make_packet(0x80, {9, 8, 7});
+    uint8_t out[GX3Framer::MAX_PACKET_LENGTH];
+
+    framer.write(&packet[0], packet.size() - 1);
+    EXPECT_EQ(0u, framer.next(out));
+
+    framer.write(&packet[packet.size() - 1], 1);
+    EXPECT_EQ(7u, framer.next(out));
+}
+
+TEST(GX3Framer, ResyncsAfterGarbage)
+{
+    GX3Framer framer;
+    std::vector<uint8_t> stream = {0x00, 0x75, 0x13, 0x75, 0x65, 0x82, 0x02, 0x42};
+    std::vector<uint8_t> packet = make_packet(0x81, {5});
+    stream.insert(stream.end(), packet.begin(), packet.end());
+    framer.write(&stream[0], stream.size());
+
+    uint8_t out[GX3Framer::MAX_PACKET_LENGTH];
+    ASSERT_EQ(5u, framer.next(out));
+    EXPECT_EQ(0x81, out[2]);
+    EXPECT_EQ(5, out[4]);
+    EXPECT_EQ(1u, framer.checksumFailures());
+}
+
+TEST(GX3Framer, RecordedDataChunking)
+{
+    std::vector<uint8_t> data;
+    if(! Benchmark::readRecordedData("imu_data.bin", data))
+    {
+        return;
+    }
+
+    // feeding the whole file in one large chunk or a byte at a time must frame the same packets
+    GX3Framer whole, bytewise;
+    uint8_t a[GX3Framer::MAX_PACKET_LENGTH], b[GX3Framer::MAX_PACKET_LENGTH];
+    size_t offset_whole = 0, offset_bytewise = 0;
+    size_t packets = 0;
+
+    while(offset_whole < data.size())
+    {
+        offset_whole += whole.write(&data[offset_whole], data.size() - offset_whole);
+
+        size_t length;
+        while((length = whole.next(a)) > 0)
+        {
+            size_t other = 0;
+            while(other == 0 && offset_bytewise < data.size())
+            {
+                bytewise.write(&data[offset_bytewise++], 1);
+                other = bytewise.next(b);
+            }
+
+            ASSERT_EQ(length, other);
+            ASSERT_EQ(0, memcmp(a, b, length));
+            packets++;
+        }
+    }
+
+    EXPECT_GT(packets, 1000u);
+    EXPECT_EQ(whole.checksumFailures(), bytewise.checksumFailures());
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#ifndef GX3_PACKET_POOL_H_
+#define GX3_PACKET_POOL_H_
+
+/* STL Headers */
+#include <chrono>
+
+/* C Headers */
+#include <stdint.h>
+#include <stddef.h>
+
+/* Project Headers */
+#include "gx3_framer.h"
+#include "SpscRing.h"
+
+/**
+ * One framed GX3 packet, the header followed by the payload as returned by GX3Framer::next().
+ */
+struct GX3Packet
+{
+    /// steady_clock time in nanoseconds the read that completed this packet returned
+    uint64_t received_ns;
+    uint16_t length;
+    uint8_t data[GX3Framer::MAX_PACKET_LENGTH];
+
+    uint8_t descriptor() const
+    {
+        return data[2];
+    }
+
+    /// the clock received_ns is measured with
+    static uint64_t now_ns()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+};
+
+/**
+ * @brief A fixed slab of packet buffers handed between the GX3 reader and parser by index.
+ *
+ * The reader thread acquire()s a free buffer, frames a packet straight in to it and then
+ * passes the index along on one of the IMU's SpscRing queues. The parser thread reads the
+ * packet in place and release()s the index when it is done, so a packet is never copied
+ * or allocated after it leaves the framer.
+ *
+ * acquire() must only be called from the reader and release() from the parser.
+ */
+template <size_t Capacity>
+class GX3PacketPool
+{
+public:
+    typedef uint16_t Index;
+
+    GX3PacketPool()
+    {
+        for(size_t i = 0; i < Capacity; i++)
+        {
+            _free.push(static_cast<Index>(i));
+        }
+    }
+
+    /// takes a free buffer, returns false if the parser is holding all of them
+    bool acquire(Index& index)
+    {
+        return _free.pop(index);
+    }
+
+    /// gives a buffer back once the parser is finished with it
+    void release(Index index)
+    {
+        _free.push(index);
+    }
+
+    GX3Packet& operator[](Index index)
+    {
+        return _packets[index];
+    }
+
+    const GX3Packet& operator[](Index index) const
+    {
+        return _packets[index];
+    }
+
+    /// the number of buffers not currently held by the reader or parser
+    size_t available() const
+    {
+        return _free.size();
+    }
+
+    static size_t capacity()
+    {
+        return Capacity;
+    }
+
+private:
+    GX3Packet _packets[Capacity];
+    SpscRing<Index, Capacity> _free;
+};
+
+#endif /* GX3_PACKET_POOL_H_ */
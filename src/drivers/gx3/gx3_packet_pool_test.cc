@@ -0,0 +1,190 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "gx3_packet_pool.h"
+#include "gx3_read_serial.h"
+#include "message_parser.h"
+#include "AllocationCounter.h"
+#include "Benchmark.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+
+/* C Headers */
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+TEST(GX3PacketPool, AcquireRelease)
+{
+    GX3PacketPool<4> pool;
+    GX3PacketPool<4>::Index index[4], extra;
+
+    for(int i = 0; i < 4; i++)
+    {
+        ASSERT_TRUE(pool.acquire(index[i]));
+    }
+    EXPECT_FALSE(pool.acquire(extra));
+
+    pool.release(index[2]);
+    ASSERT_TRUE(pool.acquire(extra));
+    EXPECT_EQ(index[2], extra);
+}
+
+/// plays bytes to the IMU's own read_serial and message_parser down a pipe standing in for the port
+struct GX3PipelineTest
+{
+    /// points read_serial at fd instead of the serial port, returning the fd it was reading
+    static int setPort(int fd)
+    {
+        IMU* imu = IMU::getInstance();
+        int previous = imu->fd_ser;
+        imu->fd_ser = fd;
+        return previous;
+    }
+
+    /// free buffers in the pool read_serial and message_parser share
+    static size_t available()
+    {
+        return IMU::getInstance()->packet_pool.available();
+    }
+
+    /**
+     * Writes bytes in to the pipe 512 at a time, after each write reader takes
+     * what has arrived as it would when the IoReactor finds the port readable,
+     * then parser drains the queues. Returns the number of packets parsed.
+     */
+    static size_t play(const int port[2], IMU::read_serial& reader, IMU::message_parser& parser,
+                       const std::vector<uint8_t>& bytes)
+    {
+        size_t parsed = 0;
+        for(size_t offset = 0; offset < bytes.size();)
+        {
+            size_t chunk = std::min<size_t>(512, bytes.size() - offset);
+            EXPECT_EQ((ssize_t) chunk, write(port[1], &bytes[offset], chunk));
+            offset += chunk;
+
+            int pending = 0;
+            while(ioctl(port[0], FIONREAD, &pending) == 0 && pending > 0)
+            {
+                reader.readable(GX3Packet::now_ns());
+                parsed += parser.parse_queued();
+            }
+        }
+        return parsed;
+    }
+};
+
+/// splits data in to the packets the GX3 sent, each with its header and checksum as it was on the wire
+static std::vector<std::vector<uint8_t> > framePackets(const std::vector<uint8_t>& data)
+{
+    std::vector<std::vector<uint8_t> > packets;
+    GX3Framer framer;
+    GX3Packet packet;
+    for(size_t offset = 0; offset < data.size();)
+    {
+        size_t space = 0;
+        uint8_t* dst = framer.writeSpan(space);
+        space = std::min(space, data.size() - offset);
+        std::copy(data.begin() + offset, data.begin() + offset + space, dst);
+        framer.commit(space);
+        offset += space;
+
+        while((packet.length = framer.next(packet.data)) > 0)
+        {
+            uint16_t checksum = GX3Framer::checksum(packet.data, packet.length);
+            packets.push_back(std::vector<uint8_t>(packet.data, packet.data + packet.length));
+            packets.back().push_back(checksum >> 8);
+            packets.back().push_back(checksum & 0xFF);
+        }
+    }
+    return packets;
+}
+
+TEST(GX3PacketPool, ZeroAllocationsPerPacket)
+{
+    std::vector<uint8_t> data;
+    if(! Benchmark::readRecordedData("imu_data.bin", data))
+    {
+        return;
+    }
+
+    std::vector<std::vector<uint8_t> > packets = framePackets(data);
+    ASSERT_GT(packets.size(), 3000u);
+
+    // the nav filter has settled by the last third of the recording, everything before it
+    // warms up the parser's filters, log channels and status flags. Acks are replies to our
+    // own commands that the ack signal copies, only the data stream is measured.
+    const size_t settled = packets.size() * 2 / 3;
+    std::vector<uint8_t> warm_up, steady;
+    size_t steady_packets = 0;
+    for(size_t i = 0; i < packets.size(); i++)
+    {
+        uint8_t descriptor = packets[i][2];
+        if(i < settled)
+        {
+            warm_up.insert(warm_up.end(), packets[i].begin(), packets[i].end());
+        }
+        else if(descriptor == IMU::DATA_AHRS || descriptor == IMU::DATA_NAV)
+        {
+            steady.insert(steady.end(), packets[i].begin(), packets[i].end());
+            steady_packets++;
+        }
+    }
+
+    int port[2];
+    ASSERT_EQ(0, pipe(port));
+    int serial = GX3PipelineTest::setPort(port[0]);
+    size_t available = GX3PipelineTest::available();
+    {
+        IMU::read_serial reader;
+        IMU::message_parser parser;
+        GX3PipelineTest::play(port, reader, parser, warm_up);
+
+        uint64_t before = AllocationCounter::allocations();
+        size_t parsed = GX3PipelineTest::play(port, reader, parser, steady);
+        uint64_t allocations = AllocationCounter::allocations() - before;
+
+        EXPECT_EQ(steady_packets, parsed);
+        EXPECT_EQ(0.0, (double) allocations / parsed) << allocations << " allocations for " << parsed << " packets";
+    }
+    // read_serial holds on to the buffer it will frame its next packet in to
+    EXPECT_EQ(available - 1, GX3PipelineTest::available());
+
+    GX3PipelineTest::setPort(serial);
+    close(port[0]);
+    close(port[1]);
+}
+
+TEST(GX3PacketPool, UnknownDescriptorsAreDropped)
+{
+    // a well formed packet with one field, for a descriptor set the IMU doesn't have
+    std::vector<uint8_t> unknown {0x75, 0x65, 0x42, 4, 4, 0x01, 0, 0};
+    uint16_t checksum = GX3Framer::checksum(unknown.data(), unknown.size());
+    unknown.push_back(checksum >> 8);
+    unknown.push_back(checksum & 0xFF);
+
+    // more packets than the pool has buffers, so a buffer kept for each would run it dry
+    size_t available = GX3PipelineTest::available();
+    std::vector<uint8_t> bytes;
+    for(size_t i = 0; i < 2 * available; i++)
+    {
+        bytes.insert(bytes.end(), unknown.begin(), unknown.end());
+    }
+
+    int port[2];
+    ASSERT_EQ(0, pipe(port));
+    int serial = GX3PipelineTest::setPort(port[0]);
+    {
+        IMU::read_serial reader;
+        IMU::message_parser parser;
+        EXPECT_EQ(0u, GX3PipelineTest::play(port, reader, parser, bytes));
+    }
+    EXPECT_EQ(available - 1, GX3PipelineTest::available());
+
+    GX3PipelineTest::setPort(serial);
+    close(port[0]);
+    close(port[1]);
+}
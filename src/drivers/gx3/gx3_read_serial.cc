@@ -20,9 +20,6 @@
 
 #include "gx3_read_serial.h"
 
-/* STL Headers */
-#include <vector>
-
 /* C headers */
 #include <stdint.h>
 
@@ -33,17 +30,12 @@
 /**
  * Constants
  */
-static const uint8_t FIRST_SYNC_BYTE = 0x75;
-static const uint8_t SECOND_SYNC_BYTE = 0x65;
 static const int SECONDS_UNTIL_ASSUMED_DEAD = 10;
-static const int HEADER_LENGTH_BYTES = 4;
-static const int MAX_PAYLOAD_SIZE_BYTES = 256 + HEADER_LENGTH_BYTES; // the gx3 specs a 1 byte length field so this should be enough for max packet length including header
-static const int CHECKSUM_LENGTH_BYTES = 2;
 
 int IMU::read_serial::read_ser(int fd, void * buf, int n)
 {
     IMU* imu = IMU::getInstance();
-    return imu->readDevice(fd, buf, n);
+    return imu->readDevice(fd, buf, n, 1);
 }
 
 
@@ -62,40 +54,66 @@ void IMU::read_serial::check_alive()
 }
 
 
-bool IMU::read_serial::sync()
+bool IMU::read_serial::fill()
 {
-    static uint8_t last_byte, curr_byte;
-
-    IMU* imu = IMU::getInstance();
-    int fd_ser = imu->fd_ser;
-
-    imu->trace() << "Sync()";
+    size_t space = 0;
+    uint8_t* dst = framer.writeSpan(space);
 
-    last_byte = 0;
-    curr_byte = 0;
+    if(space == 0)
+    {
+        // the framer only fills up if it is stuck on a bogus header, start over.
+        IMU::getInstance()->warning("GX3 receive buffer full, discarding buffered bytes.");
+        framer.reset();
+        dst = framer.writeSpan(space);
+    }
 
+    int amt = read_ser(IMU::getInstance()->fd_ser, dst, space);
+    framer.commit(amt);
+    return amt > 0;
+}
 
-    // Check to see if we have been requested to terminate
-    while(! imu->terminateRequested())
+GX3Packet& IMU::read_serial::next_buffer()
+{
+    if(! have_slot)
     {
-        check_alive();
+        have_slot = IMU::getInstance()->packet_pool.acquire(slot);
+    }
 
-        if (read_ser(fd_ser, &curr_byte, 1) < 1)
-        {
-            continue;
-        }
+    return have_slot ? IMU::getInstance()->packet_pool[slot] : scratch;
+}
 
-        if(last_byte == FIRST_SYNC_BYTE && curr_byte == SECOND_SYNC_BYTE)
-        {
-            imu->set_last_data();
-            return true;
-        }
-        else if(last_byte != 0x00 || curr_byte != 0x75 )// for some reason 0x00 and 0x75 happen between packets.
-        {
-            imu->trace() << "got useless bytes: " << std::hex << last_byte << ", " << curr_byte;
-        }
+bool IMU::read_serial::dispatch()
+{
+    IMU* imu = IMU::getInstance();
+    PacketQueue* queue = nullptr;
+
+    switch (imu->packet_pool[slot].descriptor())
+    {
+    case COMMAND_BASE:
+    case COMMAND_3DM:
+    case COMMAND_NAV_FILT:
+    case COMMAND_SYS:
+        queue = &imu->command_queue;
+        break;
+    case DATA_AHRS:
+        queue = &imu->ahrs_queue;
+        break;
+    case DATA_GPS:
+        queue = &imu->gps_queue;
+        break;
+    case DATA_NAV:
+        queue = &imu->nav_queue;
+        break;
+    default:
+        imu->warning("Unknown command received from GX3. Cannot add it to a queue");
+        return false;
+    }
 
-        last_byte = curr_byte;
+    // on success the parser owns the buffer, otherwise it is reused for the next packet
+    if(queue->push(slot))
+    {
+        have_slot = false;
+        return true;
     }
 
     return false;
@@ -104,91 +122,66 @@ bool IMU::read_serial::sync()
 void IMU::read_serial::operator()()
 {
     IMU* imu = IMU::getInstance();
-    std::vector<uint8_t> header(HEADER_LENGTH_BYTES,0);
-    header[0] = FIRST_SYNC_BYTE;
-    header[1] = SECOND_SYNC_BYTE;
-    std::vector<uint8_t> buffer;
-    buffer.reserve(MAX_PAYLOAD_SIZE_BYTES);
-    std::vector<uint8_t> checksum(CHECKSUM_LENGTH_BYTES, 0);
-    const int fd_ser = IMU::getInstance()->fd_ser;
     imu->set_last_data();
 
-    while (true)
+    while (! imu->terminateRequested())
     {
-        // if a serious error has happened (can't sync), kill the thread.
-        if(sync() == false)
-        {
-            return;
-        }
+        check_alive();
 
-        // got both sync bytes - get message
-        uint8_t descriptor = 0, length = 0;
-        if (read_ser(fd_ser, &descriptor, 1) < 1)
+        if(fill())
         {
-            continue;
+            handle_packets(GX3Packet::now_ns());
         }
+    }
+}
 
-        if (read_ser(fd_ser, &length, 1) < 1)
-        {
-            continue;
-        }
+void IMU::read_serial::readable(uint64_t arrival_ns)
+{
+    if(fill())
+    {
+        handle_packets(arrival_ns);
+    }
+}
 
-        buffer.resize(length);
-        if (read_ser(fd_ser, &buffer[0], length) < length)
+void IMU::read_serial::handle_packets(uint64_t received)
+{
+    IMU* imu = IMU::getInstance();
+    bool queued = false;
+    while(true)
+    {
+        GX3Packet& packet = next_buffer();
+        packet.length = framer.next(packet.data);
+        if(packet.length == 0)
         {
-            imu->warning("Received valid message header from IMU but did not receive payload.");
-            continue;
+            break;
         }
 
-        if (read_ser(fd_ser, &checksum[0], CHECKSUM_LENGTH_BYTES) < CHECKSUM_LENGTH_BYTES)
+        packet.received_ns = received;
+        imu->set_last_data();
+        if(have_slot && dispatch())
         {
-            continue;
+            queued = true;
         }
-
-        // successfully received entire message - compare checksum
-        header[2] = descriptor;
-        header[3] = length;
-        buffer.insert(buffer.begin(), header.begin(), header.end());
-        if (checksum != IMU::compute_checksum(buffer))
+        else
         {
-            imu->warning() << "IMU checksum failure.  message checksum: " << std::hex << checksum[0] << checksum[1] << "computed checksum: " << IMU::compute_checksum(buffer) ;
-            continue;
+            dropped++;
         }
+    }
 
-        // got message, checksum passed, queue it up
-        switch (descriptor)
-        {
-        case COMMAND_BASE:
-        case COMMAND_3DM:
-        case COMMAND_NAV_FILT:
-        case COMMAND_SYS:
-        {
-            imu->trace() << "Received command message";
+    if(queued)
+    {
+        imu->packet_arrived.notify();
+    }
 
-            imu->command_queue.push(buffer);
-            break;
-        }
-        case DATA_AHRS:
-        {
-            imu->trace() << "Received ahrs message";
-            imu->ahrs_queue.push(buffer);
-            break;
-        }
-        case DATA_GPS:
-        {
-            imu->trace() << "Received GPS message";
-            imu->gps_queue.push(buffer);
-            break;
-        }
-        case DATA_NAV:
-        {
-            imu->trace() << "Got Nav Message";
-            imu->nav_queue.push(buffer);
-            break;
-        }
-        default:
-            imu->warning("Unknown command received from GX3. Cannot add it to a queue");
-            break;
-        }
+    if(framer.checksumFailures() != reported_failures)
+    {
+        imu->warning() << "IMU checksum failure, " << framer.checksumFailures() - reported_failures << " packet(s) dropped";
+        reported_failures = framer.checksumFailures();
+    }
+
+    if(dropped != reported_drops)
+    {
+        imu->warning() << "IMU parser falling behind or packets unknown, " << dropped - reported_drops << " packet(s) dropped";
+        reported_drops = dropped;
     }
 }
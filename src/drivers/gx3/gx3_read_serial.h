@@ -22,6 +22,7 @@
 #define GX3_READ_SERIAL_H_
 
 #include "IMU.h"
+#include "gx3_framer.h"
 /**
  * Read and interpret messages arriving on the serial port connected to the 3dm-gx3
  * @author Bryan Godbolt <godbolt@ece.ualberta.ca>
@@ -30,18 +31,63 @@
 class IMU::read_serial
 {
 public:
+    /// reads the port from a thread of its own until the IMU terminates
     void operator()();
-private:
+
     /**
-     * Loops until it finds the sync header.
+     * Takes whatever has arrived on the port when the IoReactor finds it
+     * readable, arrival_ns is used as the packets' received time.
      */
-    bool sync();
+    void readable(uint64_t arrival_ns);
 
     /**
      * Checks to see if the IMU is still alive.
      */
     void check_alive();
 
+private:
+    /**
+     * Splits the bytes read from the port in to packets, each read takes
+     * everything the port has buffered rather than a byte at a time.
+     */
+    GX3Framer framer;
+
+    /**
+     * Reads whatever is available on the port in to the framer, returns
+     * false if nothing was read.
+     */
+    bool fill();
+
+    /// the pool buffer the next packet will be framed in to
+    PacketPool::Index slot;
+    /// true while slot holds a buffer acquired from the pool
+    bool have_slot = false;
+    /// packets are framed here and dropped when the parser is holding every pool buffer
+    GX3Packet scratch;
+    /// packets dropped because the pool or a queue was full or their descriptor unknown
+    uint64_t dropped = 0;
+    /// the counts last warned about
+    uint64_t reported_failures = 0;
+    uint64_t reported_drops = 0;
+
+    /**
+     * Returns the buffer the next packet should be framed in to.
+     */
+    GX3Packet& next_buffer();
+
+    /**
+     * Hands the packet in slot to the queue matching its descriptor,
+     * returns false if it had to be dropped because its descriptor is
+     * unknown or its queue is full. slot is then kept for the next packet.
+     */
+    bool dispatch();
+
+    /**
+     * Frames and queues every complete packet in the framer, stamping them
+     * with the time received.
+     */
+    void handle_packets(uint64_t received);
+
     /**
      * A better way to read serial than readcond, as it'll work cross
      * platform easier.
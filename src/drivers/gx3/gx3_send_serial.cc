@@ -307,17 +307,17 @@ void IMU::send_serial::external_gps_update()
     {
         // get gps data
         GPS* gps = GPS::getInstance();
-        blas::vector<double> llh(gps->get_llh_position());
-        blas::vector<float> vel(gps->get_ned_velocity());
-        blas::vector<float> pos_error(gps->get_pos_sigma());
-        blas::vector<float> vel_error(gps->get_vel_sigma());
+        Vec3 llh(gps->get_llh_position());
+        Vec3 vel(gps->get_ned_velocity());
+        Vec3 pos_error(gps->get_pos_sigma());
+        Vec3 vel_error(gps->get_vel_sigma());
         gps_time time(gps->get_gps_time());
 
-        imu->trace() << "[External GPS update, llh: " << llh << std::endl <<
-                     "\t vel: " << vel << std::endl <<
-                     "\t pos_error: " << pos_error << std::endl <<
-                     "\t vel_error: " << vel_error << std::endl <<
-                     "\t time: " << time << "]" << std::endl;
+        LOGGER_TRACE(*imu) << "[External GPS update, llh: " << llh << std::endl <<
+                           "\t vel: " << vel << std::endl <<
+                           "\t pos_error: " << pos_error << std::endl <<
+                           "\t vel_error: " << vel_error << std::endl <<
+                           "\t time: " << time << "]" << std::endl;
         llh[0] = AutopilotMath::radiansToDegrees(llh[0]);
         llh[1] = AutopilotMath::radiansToDegrees(llh[1]);
 
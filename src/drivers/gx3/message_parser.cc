@@ -25,11 +25,6 @@
 #include <thread>
 #include <chrono>
 
-/* Boost Headers */
-#include <boost/numeric/ublas/vector.hpp>
-#include <boost/numeric/ublas/matrix.hpp>
-namespace blas = boost::numeric::ublas;
-
 #include "heli.h"
 
 
@@ -47,11 +42,18 @@ std::string const IMU::message_parser::LOG_EULER = "GX3 Nav Euler Angles";
 std::string const IMU::message_parser::Log_AHRS_Euler = "GX3 AHRS Euler Angles";
 std::string const IMU::message_parser::Log_AHRS_Ang_Rate = "GX3 AHRS Angular Rates";
 std::string const IMU::message_parser::Log_AHRS_Ang_Rate_Filtered = "GX3 AHRS Angular Rates Filtered";
+std::string const IMU::message_parser::LOG_PARSE_LATENCY = "GX3 Parse Latency";
 
 
 IMU::message_parser::message_parser()
 {
-
+    LogFile *log = LogFile::getInstance();
+    log_position = log->channel<NavPosition>(LOG_LLH_POS);
+    log_velocity = log->channel<NavVelocity>(LOG_NED_VEL);
+    log_orientation = log->channel<NavOrientation>(LOG_ORIENTATION);
+    log_euler = log->channel<NavEuler>(LOG_EULER);
+    log_angular_rate = log->channel<NavAngularRate>(LOG_ANG_RATE);
+    log_angular_rate_filtered = log->channel<NavAngularRateFiltered>(LOG_ANG_RATE_FILTERED);
 }
 
 IMU::message_parser::~message_parser()
@@ -64,79 +66,101 @@ void IMU::message_parser::operator()()
 
     // set up log files
     LogFile *log = LogFile::getInstance();
-    log->logHeader(LOG_LLH_POS, "Latitude Longitude Height Valid");
-    log->logData(LOG_LLH_POS, std::vector<double>());
-
-    log->logHeader(LOG_NED_VEL, "Vel_X, Vel_Y, Vel_Z Valid");
-    log->logData(LOG_NED_VEL, std::vector<double>());
-
-    log->logHeader(LOG_ORIENTATION, "R11, R12, R13, R21, R22, R23, R31, R32, R33 Valid");
-    log->logData(LOG_ORIENTATION, std::vector<double>());
-
-    log->logHeader(LOG_ANG_RATE, "X, Y, Z Valid");
-    log->logData(LOG_ANG_RATE, std::vector<double>());
-
-    log->logHeader(LOG_ANG_RATE_FILTERED, "X, Y, Z");
-    log->logData(LOG_ANG_RATE_FILTERED, std::vector<double>());
-
     log->logHeader(Log_AHRS_Ang_Rate, "X, Y, Z");
     log->logData(Log_AHRS_Ang_Rate, std::vector<double>());
 
     log->logHeader(Log_AHRS_Ang_Rate_Filtered, "X, Y, Z");
     log->logData(Log_AHRS_Ang_Rate_Filtered, std::vector<double>());
 
-    log->logHeader(LOG_EULER, "Roll Pitch Yaw Valid");
-    log->logData(LOG_EULER, std::vector<double>());
+    IMU* imu = IMU::getInstance();
+
+    log->logHeader(LOG_PARSE_LATENCY, "Packets Mean(us) P50(us) P90(us) P99(us) Max(us)");
+    const uint64_t LATENCY_REPORT_NS = 1000000000;
+    uint64_t next_latency_report = GX3Packet::now_ns() + LATENCY_REPORT_NS;
 
-    while (true)
+    while (! imu->terminateRequested())
     {
-        // parse messages in order of priority
-        while (!IMU::getInstance()->nav_queue.empty())
-        {
-            parse_nav_message(IMU::getInstance()->nav_queue.pop());
-        }
-        while (!IMU::getInstance()->ahrs_queue.empty())
-        {
-            // ahrs messages currently unhandled
-            parse_ahrs_message(IMU::getInstance()->ahrs_queue.pop());
-        }
-        while (!IMU::getInstance()->gps_queue.empty())
-        {
-            // gps messages currently unhandled
-            IMU::getInstance()->gps_queue.pop();
-        }
-        while (!IMU::getInstance()->command_queue.empty())
+        parse_queued();
+
+        if(GX3Packet::now_ns() >= next_latency_report)
         {
-            parse_command_message(IMU::getInstance()->command_queue.pop());
+            report_latency();
+            next_latency_report = GX3Packet::now_ns() + LATENCY_REPORT_NS;
         }
-        std::this_thread::sleep_for( std::chrono::milliseconds( 5 ) );// don't need precise timing, just want to yield
+
+        // sleep until read_serial queues more, the timeout lets us notice termination
+        imu->packet_arrived.wait(std::chrono::milliseconds(100));
     }
 }
 
-void IMU::message_parser::parse_ahrs_message(const std::vector<uint8_t>& message)
+size_t IMU::message_parser::parse_queued()
 {
     IMU* imu = IMU::getInstance();
+    PacketPool::Index index;
+    size_t count = 0;
 
-    // divide message into fields
-    std::vector<std::vector<uint8_t> > payload;
+    // parse messages in order of priority, packets are read in place and their buffer handed back after
+    for (; imu->nav_queue.pop(index); count++)
     {
-        std::vector<uint8_t>::const_iterator it = message.begin() + 4;
-        while (it != message.end())
-        {
-            payload.push_back(std::vector<uint8_t>(it, it + *it));
-            it += *it;
-        }
+        parse_nav_message(imu->packet_pool[index]);
+        parsed(index);
+    }
+    for (; imu->ahrs_queue.pop(index); count++)
+    {
+        parse_ahrs_message(imu->packet_pool[index]);
+        parsed(index);
+    }
+    for (; imu->gps_queue.pop(index); count++)
+    {
+        // gps messages currently unhandled
+        parsed(index);
     }
-    for (std::vector<std::vector<uint8_t> >::const_iterator it = payload.begin();
-            it != payload.end(); ++it)
+    for (; imu->command_queue.pop(index); count++)
     {
-        switch ((*it)[1])
+        parse_command_message(imu->packet_pool[index]);
+        parsed(index);
+    }
+
+    return count;
+}
+
+void IMU::message_parser::parsed(PacketPool::Index index)
+{
+    IMU* imu = IMU::getInstance();
+    parse_latency.record(GX3Packet::now_ns() - imu->packet_pool[index].received_ns);
+    imu->packet_pool.release(index);
+}
+
+void IMU::message_parser::report_latency()
+{
+    if(parse_latency.count() == 0)
+    {
+        return;
+    }
+
+    std::vector<double> log {static_cast<double>(parse_latency.count()),
+                             parse_latency.mean() / 1000.0,
+                             parse_latency.percentile(0.5) / 1000.0,
+                             parse_latency.percentile(0.9) / 1000.0,
+                             parse_latency.percentile(0.99) / 1000.0,
+                             parse_latency.max() / 1000.0};
+    LogFile::getInstance()->logData(LOG_PARSE_LATENCY, log);
+    parse_latency.reset();
+}
+
+void IMU::message_parser::parse_ahrs_message(const GX3Packet& packet)
+{
+    IMU* imu = IMU::getInstance();
+
+    const uint8_t* end = packet.data + packet.length;
+    for (const uint8_t* field = packet.data + 4; field_fits(field, end); field += field[0])
+    {
+        switch (field[1])
         {
         case 0x05: // scaled gyro
         {
-            blas::vector<double> ang_rate(3);
-            ang_rate.clear();
-            std::vector<uint8_t>::const_iterator first_data = (*it).begin() + 2;
+            Vec3 ang_rate;
+            const uint8_t* first_data = field + 2;
             ang_rate[0] = raw_to_float(first_data);
             ang_rate[1] = raw_to_float(first_data + 4);
             ang_rate[2] = raw_to_float(first_data + 8);
@@ -150,45 +174,34 @@ void IMU::message_parser::parse_ahrs_message(const std::vector<uint8_t>& message
         }
         case 0x0C: //euler angles
         {
-            blas::vector<double> euler(3);
-            euler.clear();
-            std::vector<uint8_t>::const_iterator first_data = (*it).begin() + 2;
+            Vec3 euler;
+            const uint8_t* first_data = field + 2;
             euler[0] = raw_to_float(first_data);
             euler[1] = raw_to_float(first_data + 4);
             euler[2] = raw_to_float(first_data + 8);
             LogFile::getInstance()->logData(Log_AHRS_Euler, euler);
             imu->set_ahrs_euler(euler);
-			imu->debug() << "AHRS Euler roll: " << euler[0] << " pitch: " << euler[1] << " yaw: " << euler[2];
+			LOGGER_DEBUG(*imu) << "AHRS Euler roll: " << euler[0] << " pitch: " << euler[1] << " yaw: " << euler[2];
             break;
         }
         default:
-            imu->warning() << "Message Parser: Received unhandled AHRS message with descriptor: " << std::hex << it->at(1);
+            imu->warning() << "Message Parser: Received unhandled AHRS message with descriptor: " << std::hex << field[1];
             break;
         }
     }
 }
 
-void IMU::message_parser::parse_nav_message(const std::vector<uint8_t>& message)
+void IMU::message_parser::parse_nav_message(const GX3Packet& packet)
 {
-    // divide message into fields
-    std::vector<std::vector<uint8_t> > payload;
+    const uint8_t* end = packet.data + packet.length;
+    for (const uint8_t* field = packet.data + 4; field_fits(field, end); field += field[0])
     {
-        std::vector<uint8_t>::const_iterator it = message.begin() + 4;
-        while (it != message.end())
-        {
-            payload.push_back(std::vector<uint8_t>(it, it + *it));
-            it += *it;
-        }
-    }
-    for (std::vector<std::vector<uint8_t> >::const_iterator it = payload.begin();
-            it != payload.end(); ++it)
-    {
-        switch ((*it)[1])
+        switch (field[1])
         {
         case 0x10: // Filter Status
         {
-            uint16_t filter_state = static_cast<uint16_t>((*it)[2] << 8) + (*it)[3];
-            std::bitset<16> status_flags(static_cast<uint16_t>((*it)[6] << 8) + (*it)[7]);
+            uint16_t filter_state = static_cast<uint16_t>(field[2] << 8) + field[3];
+            std::bitset<16> status_flags(static_cast<uint16_t>(field[6] << 8) + field[7]);
 
             IMU* imu = IMU::getInstance();
             imu->set_gx3_mode(static_cast<GX3_MODE>(filter_state));
@@ -252,15 +265,15 @@ void IMU::message_parser::parse_nav_message(const std::vector<uint8_t>& message)
         }
         case 0x01: // LLH Position
         {
-            double lat = raw_to_double((*it).begin()+2, (*it).begin()+10);
-            double lon = raw_to_double((*it).begin()+10, (*it).begin()+18);
-            double height = raw_to_double((*it).begin()+18, (*it).begin()+26);
-            uint8_t valid = (*it)[27];
+            double lat = raw_to_double(field+2, field+10);
+            double lon = raw_to_double(field+10, field+18);
+            double height = raw_to_double(field+18, field+26);
+            uint8_t valid = field[27];
 
             GPSPosition pos(lat, lon, height);
 
-            std::vector<double> log {lat, lon, height, static_cast<double>(valid)};
-            LogFile::getInstance()->logData(LOG_LLH_POS, log);
+            NavPosition logged = {lat, lon, height, valid};
+            log_position.log(logged);
 
             if (valid)
             {
@@ -272,16 +285,16 @@ void IMU::message_parser::parse_nav_message(const std::vector<uint8_t>& message)
         }
         case 0x02:
         {
-            blas::vector<double> velocity(3);
-            std::vector<uint8_t>::const_iterator first_data = (*it).begin() + 2;
+            Vec3 velocity;
+            const uint8_t* first_data = field + 2;
             velocity[0] = raw_to_float(first_data, first_data + 4);
             velocity[1] = raw_to_float(first_data + 4, first_data + 8);
             velocity[2] = raw_to_float(first_data + 8, first_data + 12);
             uint8_t valid = *(first_data + 13);
 
-            std::vector<double> log(velocity.begin(), velocity.end());
-            log.push_back(static_cast<double>(valid));
-            LogFile::getInstance()->logData(LOG_NED_VEL, log);
+            NavVelocity logged = {static_cast<float>(velocity[0]), static_cast<float>(velocity[1]),
+                                  static_cast<float>(velocity[2]), valid};
+            log_velocity.log(logged);
             if (valid)
             {
                 IMU::getInstance()->set_velocity(velocity);
@@ -290,8 +303,8 @@ void IMU::message_parser::parse_nav_message(const std::vector<uint8_t>& message)
         }
         case 0x04:  // rotation matrix
         {
-            blas::matrix<double> rotation(3,3);
-            std::vector<uint8_t>::const_iterator first_data = (*it).begin() + 2;
+            Mat3 rotation;
+            const uint8_t* first_data = field + 2;
             rotation(0,0) = raw_to_float(first_data, first_data + 4);
             rotation(0,1) = raw_to_float(first_data + 4, first_data + 8);
             rotation(0,2) = raw_to_float(first_data + 8, first_data + 12);
@@ -303,22 +316,17 @@ void IMU::message_parser::parse_nav_message(const std::vector<uint8_t>& message)
             rotation(2,2) = raw_to_float(first_data + 32, first_data + 36);
             uint8_t valid = *(first_data + 37);
 //			debug() << "Orientation Matrix: " << rotation;
-            std::vector<double> orientation(9, 0);
-            for (int i=0; i<3; i++)
-            {
-                for (int j=0; j<3; j++)
-                {
-                    orientation[i*3+j] = rotation(i,j);
-                }
-            }
-
-            orientation.push_back(static_cast<double>(valid));
-            LogFile::getInstance()->logData(LOG_ORIENTATION, orientation);
+            NavOrientation orientation = {
+                static_cast<float>(rotation(0,0)), static_cast<float>(rotation(0,1)), static_cast<float>(rotation(0,2)),
+                static_cast<float>(rotation(1,0)), static_cast<float>(rotation(1,1)), static_cast<float>(rotation(1,2)),
+                static_cast<float>(rotation(2,0)), static_cast<float>(rotation(2,1)), static_cast<float>(rotation(2,2)),
+                valid};
+            log_orientation.log(orientation);
             if (valid)
             {
                 IMU::getInstance()->set_nav_rotation(rotation);
                 // also log euler if rotation valid
-                blas::vector<double> euler(IMU::getInstance()->get_euler());
+                Vec3 euler(IMU::getInstance()->get_euler());
                 LogFile::getInstance()->logData("Euler Angles (converted)", euler);
             }
 
@@ -326,16 +334,15 @@ void IMU::message_parser::parse_nav_message(const std::vector<uint8_t>& message)
         }
         case 0x05: //euler angles
         {
-            blas::vector<double> euler(3);
-            euler.clear();
-            std::vector<uint8_t>::const_iterator first_data = (*it).begin() + 2;
+            Vec3 euler;
+            const uint8_t* first_data = field + 2;
             euler[0] = raw_to_float(first_data);
             euler[1] = raw_to_float(first_data + 4);
             euler[2] = raw_to_float(first_data + 8);
             uint8_t valid = *(first_data + 13);
-            std::vector<double> log(euler.begin(), euler.end());
-            log.push_back(static_cast<double>(valid));
-            LogFile::getInstance()->logData(LOG_EULER, log);
+            NavEuler logged = {static_cast<float>(euler[0]), static_cast<float>(euler[1]),
+                               static_cast<float>(euler[2]), valid};
+            log_euler.log(logged);
 
             if (valid)
             {
@@ -345,16 +352,16 @@ void IMU::message_parser::parse_nav_message(const std::vector<uint8_t>& message)
         }
         case 0x0E:
         {
-            blas::vector<double> angular_rate(3);
-            std::vector<uint8_t>::const_iterator first_data = (*it).begin() + 2;
+            Vec3 angular_rate;
+            const uint8_t* first_data = field + 2;
             angular_rate[0] = raw_to_float(first_data);
             angular_rate[1] = raw_to_float(first_data + 4);
             angular_rate[2] = raw_to_float(first_data + 8);
             uint8_t valid = *(first_data + 13);
 
-            std::vector<double> log(angular_rate.begin(), angular_rate.end());
-            log.push_back(valid);
-            LogFile::getInstance()->logData(LOG_ANG_RATE, log);
+            NavAngularRate logged = {static_cast<float>(angular_rate[0]), static_cast<float>(angular_rate[1]),
+                                     static_cast<float>(angular_rate[2]), valid};
+            log_angular_rate.log(logged);
 
             if (valid)
             {
@@ -362,43 +369,35 @@ void IMU::message_parser::parse_nav_message(const std::vector<uint8_t>& message)
                 {
                     angular_rate[i] = nav_filters[i](angular_rate[i]);
                 }
-                LogFile::getInstance()->logData(LOG_ANG_RATE_FILTERED, angular_rate);
+                NavAngularRateFiltered filtered = {angular_rate[0], angular_rate[1], angular_rate[2]};
+                log_angular_rate_filtered.log(filtered);
                 IMU::getInstance()->set_nav_angular_rate(angular_rate);
             }
             break;
         }
         default:
-            IMU::getInstance()->warning() << "Message Parser: Received unhandled NAV message with descriptor: " << std::hex << it->at(1);
+            IMU::getInstance()->warning() << "Message Parser: Received unhandled NAV message with descriptor: " << std::hex << field[1];
             break;
         }
     }
     IMU::getInstance()->writeToSystemState();
 }
 
-void IMU::message_parser::parse_command_message(const std::vector<uint8_t>& message)
+void IMU::message_parser::parse_command_message(const GX3Packet& packet)
 {
-    std::vector<std::vector<uint8_t> > payload;
-    {
-        std::vector<uint8_t>::const_iterator it = message.begin() + 4;
-        while (it != message.end())
-        {
-            payload.push_back(std::vector<uint8_t>(it, it + *it));
-            it += *it;
-        }
-    }
-    for (std::vector<std::vector<uint8_t> >::const_iterator it = payload.begin();
-            it != payload.end(); ++it)
+    const uint8_t* end = packet.data + packet.length;
+    for (const uint8_t* field = packet.data + 4; field_fits(field, end); field += field[0])
     {
-        switch (it->at(1))
+        switch (field[1])
         {
         case 0xF1: //ACK/NACK
         {
 //			debug() << "Received ACK/NACK, emitting ack signal with code " << it->at(2);
-            IMU::getInstance()->ack(std::vector<uint8_t>(it->begin() + 2, it->begin() + it->at(0)));
+            IMU::getInstance()->ack(std::vector<uint8_t>(field + 2, field + field[0]));
             break;
         }
         default:
-            IMU::getInstance()->warning() << "Message Parser: Received unknown command message with descriptor: " << std::hex << it->at(1);
+            IMU::getInstance()->warning() << "Message Parser: Received unknown command message with descriptor: " << std::hex << field[1];
             break;
         }
     }
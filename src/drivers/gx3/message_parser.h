@@ -22,6 +22,9 @@
 
 #include "IMU.h"
 #include "IMU_Filter.h"
+#include "LatencyHistogram.h"
+#include "LogFile.h"
+#include "LogRecord.h"
 
 /* STL HEADERS */
 #include <bitset>
@@ -33,11 +36,19 @@
  */
 class IMU::message_parser
 {
+    /// times the parse functions over recorded data, see message_parser_bench.cc
+    friend struct MessageParserBench;
 public:
     message_parser();
     virtual ~message_parser();
     void operator()();
 
+    /**
+     * Parses every packet read_serial has queued, nav first then ahrs, gps and
+     * command, handing each buffer back to the pool. Returns how many it parsed.
+     */
+    size_t parse_queued();
+
 private:
 
     static std::string const LOG_LLH_POS;
@@ -49,15 +60,80 @@ private:
     static std::string const Log_AHRS_Euler;
     static std::string const Log_AHRS_Ang_Rate;
     static std::string const Log_AHRS_Ang_Rate_Filtered;
+    static std::string const LOG_PARSE_LATENCY;
+
+#define GX3_NAV_POSITION_FIELDS(FIELD) \
+    FIELD(double, Latitude) \
+    FIELD(double, Longitude) \
+    FIELD(double, Height) \
+    FIELD(uint8_t, Valid)
+    LOG_RECORD(NavPosition, GX3_NAV_POSITION_FIELDS);
+
+#define GX3_NAV_VELOCITY_FIELDS(FIELD) \
+    FIELD(float, Vel_X) \
+    FIELD(float, Vel_Y) \
+    FIELD(float, Vel_Z) \
+    FIELD(uint8_t, Valid)
+    LOG_RECORD(NavVelocity, GX3_NAV_VELOCITY_FIELDS);
+
+#define GX3_NAV_ORIENTATION_FIELDS(FIELD) \
+    FIELD(float, R11) \
+    FIELD(float, R12) \
+    FIELD(float, R13) \
+    FIELD(float, R21) \
+    FIELD(float, R22) \
+    FIELD(float, R23) \
+    FIELD(float, R31) \
+    FIELD(float, R32) \
+    FIELD(float, R33) \
+    FIELD(uint8_t, Valid)
+    LOG_RECORD(NavOrientation, GX3_NAV_ORIENTATION_FIELDS);
+
+#define GX3_NAV_EULER_FIELDS(FIELD) \
+    FIELD(float, Roll) \
+    FIELD(float, Pitch) \
+    FIELD(float, Yaw) \
+    FIELD(uint8_t, Valid)
+    LOG_RECORD(NavEuler, GX3_NAV_EULER_FIELDS);
+
+#define GX3_NAV_ANGULAR_RATE_FIELDS(FIELD) \
+    FIELD(float, X) \
+    FIELD(float, Y) \
+    FIELD(float, Z) \
+    FIELD(uint8_t, Valid)
+    LOG_RECORD(NavAngularRate, GX3_NAV_ANGULAR_RATE_FIELDS);
+
+#define GX3_NAV_ANGULAR_RATE_FILTERED_FIELDS(FIELD) \
+    FIELD(double, X) \
+    FIELD(double, Y) \
+    FIELD(double, Z)
+    LOG_RECORD(NavAngularRateFiltered, GX3_NAV_ANGULAR_RATE_FILTERED_FIELDS);
+
+    /// nav filter channels, registered by the constructor
+    LogRecordChannel<NavPosition> log_position;
+    LogRecordChannel<NavVelocity> log_velocity;
+    LogRecordChannel<NavOrientation> log_orientation;
+    LogRecordChannel<NavEuler> log_euler;
+    LogRecordChannel<NavAngularRate> log_angular_rate;
+    LogRecordChannel<NavAngularRateFiltered> log_angular_rate_filtered;
 
 
 
     /// parse nav filter data message and take appropriate action
-    void parse_nav_message(const std::vector<uint8_t>& message);
+    void parse_nav_message(const GX3Packet& packet);
     /// parse command message and take appropriate action
-    void parse_command_message(const std::vector<uint8_t>& message);
+    void parse_command_message(const GX3Packet& packet);
     /// parse ahrs message and take appropriate action
-    void parse_ahrs_message(const std::vector<uint8_t>& message);
+    void parse_ahrs_message(const GX3Packet& packet);
+
+    /**
+     * Fields are stored in place in the packet as length, descriptor, data. Returns
+     * true if a whole field starts at field, a zero length field would never advance.
+     */
+    static bool field_fits(const uint8_t* field, const uint8_t* end)
+    {
+        return field + 2 <= end && field[0] >= 2 && field + field[0] <= end;
+    }
 
     /** convert raw binary representation of a double precision
      * floating point number which is stored between first and last into
@@ -86,6 +162,15 @@ private:
         return raw_to_float(first, first + sizeof(float));
     }
 
+    /// time from the read that completed a packet to the end of its parse, reported once a second
+    LatencyHistogram parse_latency;
+
+    /// records the latency of a parsed packet and hands its buffer back to the pool
+    void parsed(PacketPool::Index index);
+
+    /// logs the parse_latency distribution to LOG_PARSE_LATENCY and starts a new one
+    void report_latency();
+
     /// store the status flags for the ins kalman.  does not need mutex since it isn't used outside this thread.
     std::bitset<16> nav_status_flags;
 
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "message_parser.h"
+#include "gx3_framer.h"
+#include "gx3_packet_pool.h"
+#include "AllocationCounter.h"
+#include "Benchmark.h"
+
+/* STL Headers */
+#include <algorithm>
+#include <vector>
+
+struct MessageParserBench
+{
+    /// frames imu_data.bin up front, then times parsing every packet with the given descriptor
+    static void run(Benchmark& bench, uint8_t descriptor)
+    {
+        std::vector<uint8_t> data;
+        if(! Benchmark::readRecordedData("imu_data.bin", data))
+        {
+            bench.skip("recorded_data/imu_data.bin not found");
+            return;
+        }
+
+        std::vector<GX3Packet> packets;
+        GX3Framer framer;
+        GX3Packet packet;
+        for(size_t offset = 0; offset < data.size();)
+        {
+            size_t space = 0;
+            uint8_t* dst = framer.writeSpan(space);
+            space = std::min(space, data.size() - offset);
+            std::copy(data.begin() + offset, data.begin() + offset + space, dst);
+            framer.commit(space);
+            offset += space;
+
+            while((packet.length = framer.next(packet.data)) > 0)
+            {
+                if(packet.descriptor() == descriptor)
+                {
+                    packets.push_back(packet);
+                }
+            }
+        }
+
+        IMU::message_parser parser;
+        const int PASSES = 5;
+        uint64_t bytes = 0;
+        uint64_t allocations = AllocationCounter::allocations();
+        uint64_t start = Benchmark::nowNanos();
+        for(int pass = 0; pass < PASSES; pass++)
+        {
+            for(const GX3Packet& p : packets)
+            {
+                if(descriptor == IMU::DATA_NAV)
+                {
+                    parser.parse_nav_message(p);
+                }
+                else
+                {
+                    parser.parse_ahrs_message(p);
+                }
+                bytes += p.length;
+            }
+        }
+        uint64_t elapsed = Benchmark::nowNanos() - start;
+        allocations = AllocationCounter::allocations() - allocations;
+
+        bench.reportPackets(packets.size() * PASSES, bytes, elapsed, allocations);
+    }
+};
+
+BENCHMARK(GX3Parser, NavMessages)
+{
+    MessageParserBench::run(bench, IMU::DATA_NAV);
+}
+
+BENCHMARK(GX3Parser, AhrsMessages)
+{
+    MessageParserBench::run(bench, IMU::DATA_AHRS);
+}
@@ -29,21 +29,6 @@
 const std::string ALTIMETER_PATH = "mdl_altimeter.device";
 const std::string ALTIMETER_PATH_DEFAULT = "/dev/ttyUSB0";
 
-MdlAltimeter* MdlAltimeter::_instance = NULL;
-std::mutex MdlAltimeter::_instance_lock;
-
-MdlAltimeter* MdlAltimeter::getInstance()
-{
-    std::lock_guard<std::mutex> lock(_instance_lock);
-
-    if (!_instance)
-    {
-        _instance = new MdlAltimeter();
-    }
-
-    return _instance;
-}
-
 MdlAltimeter::MdlAltimeter()
     :Driver("MDL Altimeter", "mdl_altimeter")
 {
@@ -72,7 +57,14 @@ MdlAltimeter::MdlAltimeter()
         debug() << "Altimeter set up!";
         distance = 0;
         has_new_distance = false;
-        new std::thread(&MdlAltimeter::mainLoop, this);
+        if(useReactor())
+        {
+            watchDevice(_serialFd, [this](uint64_t){ readAvailable(); });
+        }
+        else
+        {
+            new std::thread(&MdlAltimeter::mainLoop, this);
+        }
     }
 }
 
@@ -83,46 +75,58 @@ MdlAltimeter::~MdlAltimeter()
 
 void MdlAltimeter::mainLoop()
 {
-
-    uint8_t first = '\0', second = '\0';
-    uint16_t multiplierCM = 10;
-    uint16_t numberToAverage = 100;
-    uint16_t averagedThusFar = 0;
-    uint16_t sum = 0;
-
     debug() << "Started main Altimeter loop ";
 
     while(! terminateRequested())
     {
-        while(((first >> 6) & 0b11) != 0x2)
-        {
-            readDevice(_serialFd, &first, 1);
-        }
-        if((readDevice(_serialFd, &second, 1) >> 6) != 0x0)
-        {
-            continue;
-        }
+        readAvailable();
+    }
+}
 
-        // Average a number of results because the error on this device is huge.
-        if(averagedThusFar < numberToAverage)
-        {
-            uint16_t first_masked = first & 0b00111111; // last six bits of first byte
-            uint16_t second_masked = second & 0b00111111; // last six bits of second byte
-            uint16_t decoded_dist = (first_masked << 6) | second_masked; // combine them to decode distance
-            sum += decoded_dist;
-            averagedThusFar++;
-        }
-        else
-        {
-            distance = (float(sum) / float(averagedThusFar)) * multiplierCM;
-            has_new_distance = true;
-            sum = 0;
-            averagedThusFar = 0;
-            writeToSystemState();
-        }
-        first = '\0';
-        second = '\0';
+void MdlAltimeter::readAvailable()
+{
+    uint8_t buffer[64];
+    int amt = readDevice(_serialFd, buffer, sizeof(buffer), 1);
+    for(int i = 0; i < amt; i++)
+    {
+        decode(buffer[i]);
+    }
+}
+
+void MdlAltimeter::decode(uint8_t byte)
+{
+    const uint16_t multiplierCM = 10;
+    const uint16_t numberToAverage = 100;
+
+    // a reading is a byte starting 0b10 then one starting 0b00, six bits of distance in each
+    if(((byte >> 6) & 0b11) == 0x2)
+    {
+        _first = byte;
+        return;
+    }
+    if(_first == 0 || (byte >> 6) != 0x0)
+    {
+        return;
+    }
+
+    // Average a number of results because the error on this device is huge.
+    if(_averagedThusFar < numberToAverage)
+    {
+        uint16_t first_masked = _first & 0b00111111; // last six bits of first byte
+        uint16_t second_masked = byte & 0b00111111; // last six bits of second byte
+        uint16_t decoded_dist = (first_masked << 6) | second_masked; // combine them to decode distance
+        _sum += decoded_dist;
+        _averagedThusFar++;
+    }
+    else
+    {
+        distance = (float(_sum) / float(_averagedThusFar)) * multiplierCM;
+        has_new_distance = true;
+        _sum = 0;
+        _averagedThusFar = 0;
+        writeToSystemState();
     }
+    _first = 0;
 }
 
 void MdlAltimeter::sendMavlinkMsg(std::vector<mavlink_message_t>& msgs, int uasId, int sendRateHz, int msgNumber)
@@ -141,8 +145,5 @@ void MdlAltimeter::sendMavlinkMsg(std::vector<mavlink_message_t>& msgs, int uasI
 
 void MdlAltimeter::writeToSystemState()
 {
-    SystemState *state = SystemState::getInstance();
-    state->state_lock.lock();
-    state->altimeter_height = distance;
-    state->state_lock.unlock();
+    SystemState::getInstance()->setAltimeterHeight(distance);
 };
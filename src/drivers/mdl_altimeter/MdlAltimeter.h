@@ -9,23 +9,34 @@
 #define MDLALTIMETER_H_
 
 #include "Driver.h"
+#include "Singleton.h"
 
-class MdlAltimeter: public Driver
+class MdlAltimeter: public Driver, public Singleton<MdlAltimeter>
 {
+    friend Singleton<MdlAltimeter>;
+
 public:
-    MdlAltimeter();
-    virtual ~MdlAltimeter();
-    static MdlAltimeter* getInstance();
     float distance;
     void mainLoop();
     virtual void sendMavlinkMsg(std::vector<mavlink_message_t>& msgs, int uasId, int sendRateHz, int msgNumber) override;
     virtual void writeToSystemState() override;
 private:
-    static MdlAltimeter* _instance; /// pointer to the instance of Alitimiter
-    static std::mutex _instance_lock; /// serialize access to _instance
+    MdlAltimeter();
+    virtual ~MdlAltimeter();
     int _serialFd;
     bool has_new_distance;
 
+    /// the first byte of a reading, 0 until one arrives
+    uint8_t _first = 0;
+    /// readings summed towards the next averaged distance
+    uint32_t _sum = 0;
+    uint16_t _averagedThusFar = 0;
+
+    /// reads whatever the altimeter has sent, from mainLoop or when the IoReactor finds the port readable
+    void readAvailable();
+    /// takes the next byte from the altimeter
+    void decode(uint8_t byte);
+
 };
 
 #endif /* MDLALTIMETER_H_ */
@@ -30,11 +30,7 @@
 
 GPS::GPS()
     :Driver("NovAtel GPS","novatel"),
-     read_serial_thread(ReadSerial()),
-     llh_position(blas::vector<double>(0,3)),
-     ned_velocity(blas::vector<double>(0,3)),
-     pos_sigma(blas::vector<double>(0,3)),
-     vel_sigma(blas::vector<double>(0,3))
+     read_serial_thread(ReadSerial())
 {
 }
 
@@ -49,8 +45,8 @@ void GPS::writeToSystemState()
 
     // no need to lock for the position because it uses SystemStateObjParams
     {
-        blas::vector<double> llh_position = get_llh_position();
-        blas::vector<double> llh_errors = get_pos_sigma();
+        Vec3 llh_position = get_llh_position();
+        Vec3 llh_errors = get_pos_sigma();
 
         // take the maximum error from the NovAtel to report as the position
         double max = -1;
@@ -86,9 +82,9 @@ void GPS::sendMavlinkMsg(std::vector<mavlink_message_t>& msgs, int uasId, int se
         auto gps = GPS::getInstance();
         gps->trace() << "Sending novatel gps raw message";
 
-        blas::vector<double> _pos_error(get_pos_sigma());
+        Vec3 _pos_error(get_pos_sigma());
         std::vector<float> pos_error(_pos_error.begin(), _pos_error.end());
-        blas::vector<double> _vel_error(get_vel_sigma());
+        Vec3 _vel_error(get_vel_sigma());
         std::vector<float> vel_error(_vel_error.begin(), _vel_error.end());
 
         mavlink_message_t msg;
@@ -27,15 +27,13 @@
 #include <thread>
 
 /* Boost Headers */
-#include <boost/numeric/ublas/vector.hpp>
-#include <boost/numeric/ublas/matrix.hpp>
-namespace blas = boost::numeric::ublas;
 #include <boost/signals2/signal.hpp>
 
 /* Project Headers */
 #include "gps_time.h"
 #include "Driver.h"
 #include "Singleton.h"
+#include "FixedMath.h"
 
 /**
  * @brief Read position and velocity measurements from the Novatel GPS.
@@ -66,25 +64,25 @@ public:
     class ReadSerial;
 
     /// threadsafe get llh_position
-    inline blas::vector<double> get_llh_position()
+    inline Vec3 get_llh_position()
     {
         std::lock_guard<std::mutex> lock(llh_position_lock);
         return llh_position;
     }
     /// threadsafe get ned_velocity
-    inline blas::vector<double> get_ned_velocity()
+    inline Vec3 get_ned_velocity()
     {
         std::lock_guard<std::mutex> lock(ned_velocity_lock);
         return ned_velocity;
     }
     /// threadafe get position error std dev
-    inline blas::vector<double> get_pos_sigma()
+    inline Vec3 get_pos_sigma()
     {
         std::lock_guard<std::mutex> lock(pos_sigma_lock);
         return pos_sigma;
     }
     /// threadsafe get vel error std dev
-    inline blas::vector<double> get_vel_sigma()
+    inline Vec3 get_vel_sigma()
     {
         std::lock_guard<std::mutex> lock(vel_sigma_lock);
         return vel_sigma;
@@ -141,11 +139,11 @@ private:
     std::thread read_serial_thread;
 
     /// container for llh_position
-    blas::vector<double> llh_position;
+    Vec3 llh_position;
     /// serialize access to llh_position
     std::mutex llh_position_lock;
     /// threadsafe set llh_position
-    inline void set_llh_position(const blas::vector<double>& llh)
+    inline void set_llh_position(const Vec3& llh)
     {
         std::lock_guard<std::mutex> lock(llh_position_lock);
         llh_position = llh;
@@ -153,33 +151,33 @@ private:
 
 
     /// container for ned_velocity
-    blas::vector<double> ned_velocity;
+    Vec3 ned_velocity;
     /// serialize access to ned_velocity
     std::mutex ned_velocity_lock;
     /// threadsafe set ned_velocity
-    inline void set_ned_velocity(const blas::vector<double>& ned_vel)
+    inline void set_ned_velocity(const Vec3& ned_vel)
     {
         std::lock_guard<std::mutex> lock(ned_velocity_lock);
         ned_velocity = ned_vel;
     }
 
     /// container for pos error std dev
-    blas::vector<double> pos_sigma;
+    Vec3 pos_sigma;
     /// serialize access to pos_sigma
     std::mutex pos_sigma_lock;
     /// threadsafe set pos_sigma
-    inline void set_pos_sigma(const blas::vector<double>& pos_error)
+    inline void set_pos_sigma(const Vec3& pos_error)
     {
         std::lock_guard<std::mutex> lock(pos_sigma_lock);
         pos_sigma = pos_error;
     }
 
     /// container for velocity error std dev
-    blas::vector<double> vel_sigma;
+    Vec3 vel_sigma;
     /// serialize access to vel_sigma
     std::mutex vel_sigma_lock;
     /// threadsafe set vel sigma
-    inline void set_vel_sigma(const blas::vector<double>& vel_error)
+    inline void set_vel_sigma(const Vec3& vel_error)
     {
         std::lock_guard<std::mutex> lock(vel_sigma_lock);
         vel_sigma = vel_error;
@@ -0,0 +1,118 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#include "novatel_framer.h"
+
+/* Project Headers */
+#include "Crc32.h"
+
+NovatelFramer::NovatelFramer()
+    :_crc(0),
+     _crc_length(0),
+     _messages(0),
+     _crc_failures(0),
+     _bytes_discarded(0)
+{
+}
+
+void NovatelFramer::reset()
+{
+    _ring.clear();
+    _crc = 0;
+    _crc_length = 0;
+}
+
+void NovatelFramer::discard(size_t n)
+{
+    _ring.consume(n);
+    _bytes_discarded += n;
+    _crc = 0;
+    _crc_length = 0;
+}
+
+bool NovatelFramer::sync()
+{
+    while(_ring.size() >= SYNC_LENGTH)
+    {
+        if(_ring[0] == SYNC_BYTE_0 && _ring[1] == SYNC_BYTE_1 && _ring[2] == SYNC_BYTE_2)
+        {
+            return true;
+        }
+
+        discard(_ring.find(SYNC_BYTE_0, 1));
+    }
+
+    return false;
+}
+
+void NovatelFramer::updateCrc(size_t length)
+{
+    // at most two pieces, the ring may wrap
+    while(_crc_length < length)
+    {
+        size_t span = 0;
+        const uint8_t* data = _ring.readSpan(_crc_length, span);
+        if(span == 0)
+        {
+            return;
+        }
+        if(span > length - _crc_length)
+        {
+            span = length - _crc_length;
+        }
+
+        _crc = Crc32::update(_crc, data, span);
+        _crc_length += span;
+    }
+}
+
+size_t NovatelFramer::next(uint8_t* message)
+{
+    while(sync())
+    {
+        if(_ring.size() < HEADER_LENGTH)
+        {
+            return 0;
+        }
+
+        // the header length byte is fixed for binary messages, anything else means a false sync
+        size_t data_length = _ring[8] | (_ring[9] << 8);
+        if(_ring[3] != HEADER_LENGTH || data_length > MAX_DATA_LENGTH)
+        {
+            discard(1);
+            continue;
+        }
+
+        size_t length = HEADER_LENGTH + data_length;
+        updateCrc(std::min(length, _ring.size()));
+        if(_ring.size() < length + CRC_LENGTH)
+        {
+            return 0;
+        }
+
+        uint32_t expected = _ring[length] |
+                            (_ring[length + 1] << 8) |
+                            (_ring[length + 2] << 16) |
+                            (static_cast<uint32_t>(_ring[length + 3]) << 24);
+
+        if(_crc != expected)
+        {
+            _crc_failures++;
+            discard(1);
+            continue;
+        }
+
+        _ring.copyOut(0, message, length);
+        _ring.consume(length + CRC_LENGTH);
+        _crc = 0;
+        _crc_length = 0;
+        _messages++;
+        return length;
+    }
+
+    return 0;
+}
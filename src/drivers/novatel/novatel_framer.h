@@ -0,0 +1,135 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#ifndef NOVATEL_FRAMER_H_
+#define NOVATEL_FRAMER_H_
+
+/* C Headers */
+#include <stdint.h>
+#include <stddef.h>
+
+/* Project Headers */
+#include "ByteRing.h"
+
+/**
+ * @brief Splits the byte stream from a NovAtel OEM6 in to binary messages.
+ *
+ * Works like GX3Framer: bytes are read straight in to the framer's ring and next() hands
+ * back each complete message whose CRC matches. The CRC is updated as the bytes of a
+ * message arrive, so a message is only ever checksummed once no matter how many reads
+ * it is split across.
+ *
+ * Messages are returned starting at the sync bytes and including the 28 byte header,
+ * the log data starts at HEADER_LENGTH, the CRC is stripped.
+ */
+class NovatelFramer
+{
+public:
+    static const uint8_t SYNC_BYTE_0 = 0xAA;
+    static const uint8_t SYNC_BYTE_1 = 0x44;
+    static const uint8_t SYNC_BYTE_2 = 0x12;
+    static const size_t SYNC_LENGTH = 3;
+    /// sync bytes plus the 25 byte binary header
+    static const size_t HEADER_LENGTH = 28;
+    static const size_t CRC_LENGTH = 4;
+    /// anything longer is assumed to be a corrupt header, the logs we request are a few hundred bytes
+    static const size_t MAX_DATA_LENGTH = 4096;
+    static const size_t MAX_MESSAGE_LENGTH = HEADER_LENGTH + MAX_DATA_LENGTH;
+
+    NovatelFramer();
+
+    /// see ByteRing::writeSpan
+    uint8_t* writeSpan(size_t& len)
+    {
+        return _ring.writeSpan(len);
+    }
+
+    /// see ByteRing::commit, negative values (failed reads) are ignored
+    void commit(int n)
+    {
+        if(n > 0)
+        {
+            _ring.commit(n);
+        }
+    }
+
+    /// copies bytes in to the framer, returns the number accepted
+    size_t write(const uint8_t* data, size_t n)
+    {
+        return _ring.write(data, n);
+    }
+
+    /**
+     * Finds the next complete message and copies its header and data to message, which
+     * must hold at least MAX_MESSAGE_LENGTH bytes.
+     *
+     * @return the length of the message copied, or 0 if no complete message is buffered yet.
+     */
+    size_t next(uint8_t* message);
+
+    /// drops all buffered bytes
+    void reset();
+
+    /// the number of messages returned by next()
+    uint64_t messages() const
+    {
+        return _messages;
+    }
+
+    /// the number of messages thrown away because their CRC didn't match
+    uint64_t crcFailures() const
+    {
+        return _crc_failures;
+    }
+
+    /// the number of bytes skipped while looking for a sync header
+    uint64_t bytesDiscarded() const
+    {
+        return _bytes_discarded;
+    }
+
+    /// the message id field of a message returned by next()
+    static uint16_t messageId(const uint8_t* message)
+    {
+        return message[4] | (message[5] << 8);
+    }
+
+    /// the length of the log data following the header
+    static uint16_t dataLength(const uint8_t* message)
+    {
+        return message[8] | (message[9] << 8);
+    }
+
+    /// true if the message is the receiver's response to a command
+    static bool isResponse(const uint8_t* message)
+    {
+        return (message[6] & 0x80) != 0;
+    }
+
+private:
+    /// big enough to hold the longest message we accept
+    ByteRing<8192> _ring;
+
+    /// crc of the first _crc_length bytes of the message at the front of the ring
+    uint32_t _crc;
+    size_t _crc_length;
+
+    uint64_t _messages;
+    uint64_t _crc_failures;
+    uint64_t _bytes_discarded;
+
+    /// drops bytes until the ring starts with the sync bytes, returns false if more bytes are needed
+    bool sync();
+
+    /// drops n bytes from the front of the ring, forgetting any partial crc
+    void discard(size_t n);
+
+    /// extends _crc over the ring up to length bytes
+    void updateCrc(size_t length);
+};
+
+#endif /* NOVATEL_FRAMER_H_ */
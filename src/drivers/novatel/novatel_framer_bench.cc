@@ -0,0 +1,169 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "novatel_framer.h"
+#include "novatel_logs.h"
+#include "Crc32.h"
+#include "AllocationCounter.h"
+#include "Benchmark.h"
+
+/* STL Headers */
+#include <vector>
+#include <algorithm>
+
+namespace
+{
+const uint16_t BESTXYZ = 241;
+
+/// reads the recorded data the way a port would hand it over, in chunks of up to n bytes
+struct ChunkReader
+{
+    const std::vector<uint8_t>& data;
+    size_t offset;
+    uint64_t reads;
+
+    size_t operator()(uint8_t* dst, size_t n)
+    {
+        n = std::min(n, data.size() - offset);
+        std::copy(data.begin() + offset, data.begin() + offset + n, dst);
+        offset += n;
+        reads++;
+        return n;
+    }
+};
+
+/// the reader this framer replaced: a byte at a time to sync, then separate vectors for each part
+uint64_t legacy_read(ChunkReader& read, uint64_t& xyz_logs)
+{
+    const uint8_t sync[] = {NovatelFramer::SYNC_BYTE_0, NovatelFramer::SYNC_BYTE_1, NovatelFramer::SYNC_BYTE_2};
+    uint64_t messages = 0;
+    int position = 0;
+    uint8_t byte;
+
+    while(read(&byte, 1) == 1)
+    {
+        if(byte != sync[position])
+        {
+            position = 0;
+            continue;
+        }
+        if(++position < 3)
+        {
+            continue;
+        }
+        position = 0;
+
+        std::vector<uint8_t> header(NovatelFramer::HEADER_LENGTH - 3);
+        if(read(&header[0], header.size()) < header.size())
+        {
+            break;
+        }
+
+        std::vector<uint8_t> log_data(header[5] | (header[6] << 8));
+        if(! log_data.empty() && read(&log_data[0], log_data.size()) < log_data.size())
+        {
+            break;
+        }
+
+        std::vector<uint8_t> checksum(4);
+        if(read(&checksum[0], 4) < 4)
+        {
+            break;
+        }
+
+        std::vector<uint8_t> whole_message(sync, sync + 3);
+        whole_message.insert(whole_message.end(), header.begin(), header.end());
+        whole_message.insert(whole_message.end(), log_data.begin(), log_data.end());
+
+        uint32_t crc = Crc32::updateBytewise(0, &whole_message[0], whole_message.size());
+        std::vector<uint8_t> computed(4);
+        for(int i = 0; i < 4; i++)
+        {
+            computed[i] = (crc >> (8 * i)) & 0xFF;
+        }
+        if(computed != checksum)
+        {
+            continue;
+        }
+
+        messages++;
+        NovatelXYZ xyz;
+        if((header[1] | (header[2] << 8)) == BESTXYZ && xyz.decode(&log_data[0], log_data.size()))
+        {
+            xyz_logs++;
+        }
+    }
+
+    return messages;
+}
+
+uint64_t framer_read(ChunkReader& read, uint64_t& xyz_logs)
+{
+    NovatelFramer framer;
+    static uint8_t message[NovatelFramer::MAX_MESSAGE_LENGTH];
+
+    while(true)
+    {
+        size_t space = 0;
+        uint8_t* dst = framer.writeSpan(space);
+        // serial reads rarely return more than a few hundred bytes
+        size_t amt = read(dst, std::min<size_t>(space, 256));
+        if(amt == 0)
+        {
+            return framer.messages();
+        }
+        framer.commit(amt);
+
+        size_t length;
+        while((length = framer.next(message)) > 0)
+        {
+            NovatelXYZ xyz;
+            if(NovatelFramer::messageId(message) == BESTXYZ &&
+                    xyz.decode(message + NovatelFramer::HEADER_LENGTH, length - NovatelFramer::HEADER_LENGTH))
+            {
+                xyz_logs++;
+            }
+        }
+    }
+}
+
+void run(Benchmark& bench, uint64_t (*reader_fn)(ChunkReader&, uint64_t&))
+{
+    std::vector<uint8_t> data;
+    if(! Benchmark::readRecordedData("novatel_gps_data.bin", data))
+    {
+        bench.skip("recorded_data/novatel_gps_data.bin not found");
+        return;
+    }
+
+    const int PASSES = 20;
+    uint64_t messages = 0, xyz_logs = 0, reads = 0;
+    uint64_t allocations = AllocationCounter::allocations();
+    uint64_t start = Benchmark::nowNanos();
+    for(int i = 0; i < PASSES; i++)
+    {
+        ChunkReader reader = {data, 0, 0};
+        messages += reader_fn(reader, xyz_logs);
+        reads += reader.reads;
+    }
+    uint64_t elapsed = Benchmark::nowNanos() - start;
+    allocations = AllocationCounter::allocations() - allocations;
+
+    bench.reportPackets(messages, data.size() * PASSES, elapsed, allocations);
+    bench.report("bestxyz_logs", xyz_logs / PASSES, "logs");
+    bench.report("reads_per_message", (double) reads / messages, "reads/message");
+}
+}
+
+BENCHMARK(NovatelFramer, LegacyVectors)
+{
+    run(bench, legacy_read);
+}
+
+BENCHMARK(NovatelFramer, Streaming)
+{
+    run(bench, framer_read);
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "novatel_framer.h"
+#include "novatel_logs.h"
+#include "Crc32.h"
+#include "Benchmark.h"
+#include <gtest/gtest.h>
+#include <vector>
+#include <cmath>
+
+namespace
+{
+const uint16_t BESTXYZ = 241;
+
+std::vector<uint8_t> make_message(uint16_t id, const std::vector<uint8_t>& data)
+{
+    std::vector<uint8_t> message(NovatelFramer::HEADER_LENGTH, 0);
+    message[0] = NovatelFramer::SYNC_BYTE_0;
+    message[1] = NovatelFramer::SYNC_BYTE_1;
+    message[2] = NovatelFramer::SYNC_BYTE_2;
+    message[3] = NovatelFramer::HEADER_LENGTH;
+    message[4] = id & 0xFF;
+    message[5] = id >> 8;
+    message[8] = data.size() & 0xFF;
+    message[9] = data.size() >> 8;
+    message.insert(message.end(), data.begin(), data.end());
+
+    uint32_t crc = Crc32::update(0, &message[0], message.size());
+    for(int i = 0; i < 4; i++)
+    {
+        message.push_back((crc >> (8 * i)) & 0xFF);
+    }
+    return message;
+}
+}
+
+TEST(NovatelFramer, SingleMessage)
+{
+    NovatelFramer framer;
+    std::vector<uint8_t> message = make_message(BESTXYZ, {1, 2, 3});
+    framer.write(&message[0], message.size());
+
+    uint8_t out[NovatelFramer::MAX_MESSAGE_LENGTH];
+    ASSERT_EQ(NovatelFramer::HEADER_LENGTH + 3, framer.next(out));
+    EXPECT_EQ(BESTXYZ, NovatelFramer::messageId(out));
+    EXPECT_EQ(3, NovatelFramer::dataLength(out));
+    EXPECT_FALSE(NovatelFramer::isResponse(out));
+    EXPECT_EQ(0u, framer.next(out));
+}
+
+TEST(NovatelFramer, BadCrcAndGarbage)
+{
+    NovatelFramer framer;
+    std::vector<uint8_t> bad = make_message(BESTXYZ, {1, 2, 3});
+    bad[NovatelFramer::HEADER_LENGTH] ^= 0xFF;
+    std::vector<uint8_t> good = make_message(42, {4, 5});
+
+    std::vector<uint8_t> stream = {0xAA, 0x00, 0xAA, 0x44};
+    stream.insert(stream.end(), bad.begin(), bad.end());
+    stream.insert(stream.end(), good.begin(), good.end());
+
+    // a byte at a time, so the crc is built up incrementally
+    uint8_t out[NovatelFramer::MAX_MESSAGE_LENGTH];
+    size_t found = 0;
+    for(uint8_t b : stream)
+    {
+        framer.write(&b, 1);
+        found += framer.next(out);
+    }
+
+    EXPECT_EQ(NovatelFramer::HEADER_LENGTH + 2, found);
+    EXPECT_EQ(42, NovatelFramer::messageId(out));
+    EXPECT_EQ(1u, framer.crcFailures());
+}
+
+TEST(NovatelFramer, RecordedBestXYZ)
+{
+    std::vector<uint8_t> data;
+    if(! Benchmark::readRecordedData("novatel_gps_data.bin", data))
+    {
+        return;
+    }
+
+    NovatelFramer framer;
+    uint8_t out[NovatelFramer::MAX_MESSAGE_LENGTH];
+    size_t offset = 0, xyz_logs = 0;
+
+    while(offset < data.size())
+    {
+        offset += framer.write(&data[offset], std::min<size_t>(700, data.size() - offset));
+
+        size_t length;
+        while((length = framer.next(out)) > 0)
+        {
+            ASSERT_EQ(length, NovatelFramer::HEADER_LENGTH + NovatelFramer::dataLength(out));
+            if(NovatelFramer::messageId(out) != BESTXYZ || NovatelFramer::isResponse(out))
+            {
+                continue;
+            }
+
+            NovatelXYZ xyz;
+            ASSERT_TRUE(xyz.decode(out + NovatelFramer::HEADER_LENGTH, length - NovatelFramer::HEADER_LENGTH));
+
+            // somewhere on the surface of the earth
+            double radius = std::sqrt(xyz.position[0] * xyz.position[0] +
+                                      xyz.position[1] * xyz.position[1] +
+                                      xyz.position[2] * xyz.position[2]);
+            EXPECT_NEAR(6.37e6, radius, 0.05e6);
+            xyz_logs++;
+        }
+    }
+
+    EXPECT_GT(xyz_logs, 100u);
+    EXPECT_EQ(0u, framer.crcFailures());
+}
+
+// fields are little endian on the wire whatever the host's byte order
+TEST(NovatelFramer, LittleEndianFields)
+{
+    const uint8_t data[] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0x3F, 0xAB};
+
+    EXPECT_EQ(0xABu, novatel_field<uint8_t>(data + 8));
+    EXPECT_EQ(0xF000u, novatel_field<uint16_t>(data + 5));
+    EXPECT_EQ(0x3FF00000u, novatel_field<uint32_t>(data + 4));
+    EXPECT_EQ(1.875f, novatel_field<float>(data + 4));
+    EXPECT_EQ(1.0, novatel_field<double>(data));
+}
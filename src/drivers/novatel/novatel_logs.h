@@ -0,0 +1,113 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#ifndef NOVATEL_LOGS_H_
+#define NOVATEL_LOGS_H_
+
+/* C Headers */
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+/// the unsigned integer exactly N bytes wide
+template <size_t N> struct novatel_raw;
+template <> struct novatel_raw<1> { typedef uint8_t type; };
+template <> struct novatel_raw<2> { typedef uint16_t type; };
+template <> struct novatel_raw<4> { typedef uint32_t type; };
+template <> struct novatel_raw<8> { typedef uint64_t type; };
+
+/**
+ * Reads a little endian field of type T straight out of a NovAtel message.
+ * The bytes are shifted in to an integer as wide as T before its bits are
+ * copied in to T, so this reads the same on big and little endian hosts.
+ */
+template <typename T>
+T novatel_field(const uint8_t* data)
+{
+    typedef typename novatel_raw<sizeof(T)>::type Raw;
+    Raw raw = 0;
+    for(size_t i = sizeof(T); i > 0; i--)
+    {
+        raw = static_cast<Raw>((raw << 8) | data[i - 1]);
+    }
+
+    T value;
+    memcpy(&value, &raw, sizeof(T));
+    return value;
+}
+
+/**
+ * The time fields of a binary message header, message points at the first sync byte.
+ * OEM6 communication manual p 23
+ */
+struct NovatelTime
+{
+    uint8_t time_status;
+    uint16_t week;
+    uint32_t milliseconds;
+
+    void decode(const uint8_t* message)
+    {
+        time_status = message[13];
+        week = novatel_field<uint16_t>(message + 14);
+        milliseconds = novatel_field<uint32_t>(message + 16);
+    }
+};
+
+/**
+ * The fields of a BESTXYZ or RTKXYZ log, both share the same layout.
+ * OEM6 firmware reference manual p 399
+ */
+struct NovatelXYZ
+{
+    /// bytes up to and including the number of satellites field
+    static const size_t MIN_LENGTH = 105;
+
+    uint32_t pos_status;
+    uint32_t pos_type;
+    double position[3];
+    float position_error[3];
+    uint32_t vel_status;
+    uint32_t vel_type;
+    double velocity[3];
+    float velocity_error[3];
+    float velocity_latency;
+    float differential_age;
+    float solution_age;
+    uint8_t num_sats;
+
+    /// fills the fields from log data, returns false if the log is too short
+    bool decode(const uint8_t* data, size_t length)
+    {
+        if(length < MIN_LENGTH)
+        {
+            return false;
+        }
+
+        pos_status = novatel_field<uint32_t>(data);
+        pos_type = novatel_field<uint32_t>(data + 4);
+        for(int i = 0; i < 3; i++)
+        {
+            position[i] = novatel_field<double>(data + 8 + 8 * i);
+            position_error[i] = novatel_field<float>(data + 32 + 4 * i);
+        }
+        vel_status = novatel_field<uint32_t>(data + 44);
+        vel_type = novatel_field<uint32_t>(data + 48);
+        for(int i = 0; i < 3; i++)
+        {
+            velocity[i] = novatel_field<double>(data + 52 + 8 * i);
+            velocity_error[i] = novatel_field<float>(data + 76 + 4 * i);
+        }
+        velocity_latency = novatel_field<float>(data + 92);
+        differential_age = novatel_field<float>(data + 96);
+        solution_age = novatel_field<float>(data + 100);
+        num_sats = data[104];
+        return true;
+    }
+};
+
+#endif /* NOVATEL_LOGS_H_ */
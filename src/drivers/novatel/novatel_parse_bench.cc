@@ -0,0 +1,81 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "novatel_read_serial.h"
+#include "novatel_framer.h"
+#include "novatel_logs.h"
+#include "AllocationCounter.h"
+#include "Benchmark.h"
+
+/* STL Headers */
+#include <algorithm>
+#include <vector>
+
+struct NovatelParseBench
+{
+    /// frames novatel_gps_data.bin up front, then times decoding and parsing every BESTXYZ log
+    static void run(Benchmark& bench)
+    {
+        std::vector<uint8_t> data;
+        if(! Benchmark::readRecordedData("novatel_gps_data.bin", data))
+        {
+            bench.skip("recorded_data/novatel_gps_data.bin not found");
+            return;
+        }
+
+        const uint16_t BESTXYZ = 241;
+        std::vector<std::vector<uint8_t>> logs;
+        NovatelFramer framer;
+        std::vector<uint8_t> message(NovatelFramer::MAX_MESSAGE_LENGTH);
+        for(size_t offset = 0; offset < data.size();)
+        {
+            size_t space = 0;
+            uint8_t* dst = framer.writeSpan(space);
+            space = std::min(space, data.size() - offset);
+            std::copy(data.begin() + offset, data.begin() + offset + space, dst);
+            framer.commit(space);
+            offset += space;
+
+            size_t length;
+            while((length = framer.next(&message[0])) > 0)
+            {
+                if(NovatelFramer::messageId(&message[0]) == BESTXYZ)
+                {
+                    logs.push_back(std::vector<uint8_t>(message.begin(), message.begin() + length));
+                }
+            }
+        }
+
+        GPS::ReadSerial reader;
+        GPS::ReadSerial::LogRecord record;
+        const int PASSES = 20;
+        uint64_t bytes = 0;
+        uint64_t allocations = AllocationCounter::allocations();
+        uint64_t start = Benchmark::nowNanos();
+        for(int pass = 0; pass < PASSES; pass++)
+        {
+            for(const std::vector<uint8_t>& log : logs)
+            {
+                NovatelXYZ xyz;
+                if(xyz.decode(&log[NovatelFramer::HEADER_LENGTH], log.size() - NovatelFramer::HEADER_LENGTH))
+                {
+                    reader.parse_header(&log[0], record);
+                    reader.parse_log(xyz, record);
+                }
+                bytes += log.size();
+            }
+        }
+        uint64_t elapsed = Benchmark::nowNanos() - start;
+        allocations = AllocationCounter::allocations() - allocations;
+
+        bench.reportPackets(logs.size() * PASSES, bytes, elapsed, allocations);
+    }
+};
+
+BENCHMARK(NovatelParser, BestXyzLogs)
+{
+    NovatelParseBench::run(bench);
+}
@@ -43,6 +43,7 @@
 #include "MainApp.h"
 #include "qnx2linux.h"
 #include "LogFile.h"
+#include "Crc32.h"
 
 #include <boost/assign.hpp>
 // this scope only pollutes the global namespace in a minimal way consistent with the stl global operators
@@ -58,7 +59,6 @@ const double GPS::ReadSerial::OEM6_LOG_4_HZ = .25;
 const double GPS::ReadSerial::OEM6_LOG_2_HZ = 0.5;
 const uint8_t GPS::ReadSerial::HEADER_SYNC_BYTES[] = {0xAA, 0x44, 0x12};
 const uint8_t GPS::ReadSerial::HEADER_SYNC_BYTES_LENGTH = 3;
-const uint8_t GPS::ReadSerial::HEADER_LENGTH_BYTES = 25;
 
 
 const std::string LOG_NOVATEL_GPS = "Novatel GPS (Invalid Solutions Removed)";
@@ -88,6 +88,22 @@ void GPS::ReadSerial::operator()()
         gps->debug() << "Waiting a moment to startup";
         std::this_thread::sleep_for( std::chrono::milliseconds( 1000 ) );
         //send_log_command();
+        if(gps->useReactor())
+        {
+            // the reactor services the port from here on, this thread's copy of us goes away.
+            // nothing is left to send the unlog command at shutdown.
+            ReadSerial* reader = new ReadSerial(*this);
+            reader->setupLogging();
+            reader->last_data = gps->getMsSinceInit();
+            if(gps->watchDevice(fd_ser,
+                                [reader](uint64_t arrival_ns){ reader->readable(arrival_ns); },
+                                [reader]{ reader->checkTimeout(); }))
+            {
+                return;
+            }
+
+            delete reader;
+        }
         readPort();
     }
     else
@@ -120,229 +136,229 @@ bool GPS::ReadSerial::initPort()
     return true;
 }
 
-bool GPS::ReadSerial::synchronize()
+void GPS::ReadSerial::checkTimeout()
 {
     GPS* gps = GPS::getInstance();
 
-    //gps->trace() << "Synchronize Called";
-    uint8_t currentByte;
-    int position = 0;
-
-    last_data = gps->getMsSinceInit();
-
-    while(!gps->terminateRequested())
+    auto ms_since_init = gps->getMsSinceInit();
+    if (unlogged_at >= 0)
     {
-        // Check for overall timeout.
-
-        auto ms_since_init = gps->getMsSinceInit();
-        if ((ms_since_init - last_data) / 1000 > 10)
+        // give the NovAtel a moment to stop logging before asking for the logs again
+        if (ms_since_init - unlogged_at >= RESTART_SETTLE_MS)
         {
-            gps->warning() << "NovAtel: Stopped receiving data, attempting restart.";
-            send_unlog_command();
-            std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) );
-
             setupLogging();
             last_data = ms_since_init; // reset the last time
+            unlogged_at = -1;
         }
+        return;
+    }
 
-        // Check for local timeout
-        if(gps->readDevice(fd_ser, &currentByte, 1) < 1)
-        {
-            continue; // timed out reading bytes.
-        }
-
-        // Check for byte matches.
-        if(currentByte == HEADER_SYNC_BYTES[position])
-        {
-            position++;
+    if ((ms_since_init - last_data) / 1000 > 10)
+    {
+        gps->warning() << "NovAtel: Stopped receiving data, attempting restart.";
+        send_unlog_command();
+        unlogged_at = ms_since_init;
+    }
+}
 
-            if(position == HEADER_SYNC_BYTES_LENGTH)
-            {
-                gps->trace() << "Got sync!";
-                return true;
-            }
+bool GPS::ReadSerial::readAvailable()
+{
+    GPS* gps = GPS::getInstance();
 
-            continue;
-        }
+    size_t space = 0;
+    uint8_t* dst = framer.writeSpan(space);
+    if(space == 0)
+    {
+        gps->warning("NovAtel receive buffer full, discarding buffered bytes.");
+        framer.reset();
+        return false;
+    }
 
-        // not a matching byte, start looking for a new header
-        position = 0;
+    // take whatever the port has ready rather than a byte at a time
+    int bytes = gps->readDevice(fd_ser, dst, space, 1);
+    if(bytes > 0)
+    {
+        framer.commit(bytes);
+        return true;
     }
 
     return false;
-
 }
 
-
-void GPS::ReadSerial::readPort()
+bool GPS::ReadSerial::fill()
 {
     GPS* gps = GPS::getInstance();
 
-    setupLogging();
-    last_data = gps->getMsSinceInit(); // reset the last time
-    while(synchronize())
+    while(!gps->terminateRequested())
     {
-        // Read the header
-        std::vector<uint8_t> header(HEADER_LENGTH_BYTES);
-        int bytes = gps->readDevice(fd_ser, &header[0], HEADER_LENGTH_BYTES);
-        gps->trace() << "got header bytes: " << bytes << " " << header;
-        if (bytes < HEADER_LENGTH_BYTES)
+        // Check for overall timeout.
+        checkTimeout();
+
+        if(readAvailable())
         {
-            gps->warning("Received valid sync bytes, but could not read header ");
-            continue;
+            return true;
         }
+    }
 
-        gps->trace() << "Received Header: " << header;
-
-        int data_size = raw_to_int<uint16_t>(header.begin() + 5);
+    return false;
+}
 
 
-        gps->trace() << "Fetching data";
+void GPS::ReadSerial::readPort()
+{
+    setupLogging();
+    last_data = GPS::getInstance()->getMsSinceInit(); // reset the last time
+    while(fill())
+    {
+        handleMessages();
+    }
+}
 
-        std::vector<uint8_t> log_data(data_size);
-        bytes = gps->readDevice(fd_ser, &log_data[0], data_size);
+void GPS::ReadSerial::readable(uint64_t)
+{
+    if(readAvailable())
+    {
+        handleMessages();
+    }
+}
 
-        gps->trace() << "received data bytes: " << bytes << " " << log_data;
+void GPS::ReadSerial::handleMessages()
+{
+    uint8_t message[NovatelFramer::MAX_MESSAGE_LENGTH];
+    size_t length;
+    while((length = framer.next(message)) > 0)
+    {
+        handleMessage(message, length);
+    }
 
-        if (bytes < data_size)
-        {
-            gps->warning("Received header, but could not receive data log.");
-            continue;
-        }
+    if(framer.crcFailures() != reported_failures)
+    {
+        GPS::getInstance()->warning("received complete message but checksum was invalid");
+        reported_failures = framer.crcFailures();
+    }
+}
 
+void GPS::ReadSerial::handleMessage(const uint8_t* message, size_t length)
+{
+    GPS* gps = GPS::getInstance();
 
-        gps->trace() << "looking up checksum";
-        int checksum_size = 4;
-        std::vector<uint8_t> checksum(checksum_size);
-        bytes = gps->readDevice(fd_ser, &checksum[0], checksum_size);
+    const uint8_t* log_data = message + NovatelFramer::HEADER_LENGTH;
+    const size_t data_size = length - NovatelFramer::HEADER_LENGTH;
+    const bool response = NovatelFramer::isResponse(message);
+    const uint16_t message_id = NovatelFramer::messageId(message);
 
-        gps->trace() << "got checksum bytes " << bytes << " " << checksum;
+    if (response)
+    {
+        LOGGER_DEBUG(*gps) << "response message: " << response_text(log_data, data_size);
+    }
 
-        if (bytes < checksum_size)
+    LOGGER_DEBUG(*gps) << "got message " << message_id;
+    switch (message_id)
+    {
+    case OEM6_COMMAND_LOG: // log command (response)
+        if (response && data_size >= 4)
         {
-            gps->warning("received log data but could not receive checksum.");
-            continue;
+            switch(parse_enum(log_data))
+            {
+            case OEM6_OK:
+                gps->message() << "data logging successfully initialized: \""  << response_text(log_data, data_size) << '"';;
+                break;
+            case OEM6_INVALID_CHECKSUM:
+                gps->warning("checksum failure");
+                break;
+            default:
+                gps->warning() << "RX Message: \"" << response_text(log_data, data_size) << '"';
+            }
         }
-
-        std::vector<uint8_t> whole_message;
-
-        for(int i = 0; i < HEADER_SYNC_BYTES_LENGTH; i++)
+    case OEM6_LOG_RTKXYZ:  // RTKXYZ
+        if (!response)
         {
-            whole_message += HEADER_SYNC_BYTES[i];
+            LOGGER_TRACE(*gps) << "Received RTKXYZ data";
+            NovatelXYZ xyz;
+            if(xyz.decode(log_data, data_size))
+            {
+                parse_rtkxyz(xyz);
+            }
         }
+        break;
 
-        whole_message.insert(whole_message.end(), header.begin(), header.end());
-        whole_message.insert(whole_message.end(), log_data.begin(), log_data.end());
-
-        std::vector<uint8_t> computed_checksum(compute_checksum(whole_message));
-        if (checksum != computed_checksum)
+    case OEM6_LOG_REFSTATION:
+        LOGGER_TRACE(*gps) << "\n\nrefstation\n\n";
+        if(!response)
         {
-            gps->warning("received complete message but checksum was invalid");
-
-            gps->trace() << "NovAtel: checksum: " << checksum << ", computed checksum: " << computed_checksum;
-            continue;
+            LOGGER_TRACE(*gps) << "\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n";
+            LOGGER_TRACE(*gps) << "Received base station health report";
+            LOGGER_TRACE(*gps) << "\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n";
+            break;
         }
 
-        uint16_t message_id = raw_to_int<uint16_t>(header.begin() + 1);
-        if (is_response(header))
+    case OEM6_LOG_BESTPOS:
+    {
+        if(data_size < 65)
         {
-            gps->debug() << "response message: " << std::string(log_data.begin() + 4, log_data.end());
+            break;
         }
 
-        gps->debug() << "got message " << message_id;
-        switch (message_id)
+        LOGGER_TRACE(*gps) << "Best position";
+
+        Vec3 position(parse_3floats<double>(log_data, 8));
+        LOGGER_TRACE(*gps) << std::endl
+                           <<"[Fallback GPS: Status: " << solStatusToString(parse_enum(log_data)) << std::endl
+                           << "\tPosition type: " << posVelTypeToString(parse_enum(log_data, 4)) << std::endl
+                           << "\tPosition Error: " << parse_3floats<float>(log_data, 40) << std::endl
+                           << "\tECEF position: " << position << std::endl
+                           << "\tLLH: " << ecef_to_llh(position) << std::endl
+                           << "\t# of sats visible: " << log_data[64] << "]" << std::endl;
+        break;
+    }
+
+    case OEM6_LOG_BESTXYZ:  // RTKXYZ
+        if (!response)
         {
-        case OEM6_COMMAND_LOG: // log command (response)
-            if (is_response(header))
-            {
-                switch(parse_enum(log_data))
-                {
-                case OEM6_OK:
-                    gps->message() << "data logging successfully initialized: \""  << std::string(log_data.begin() + 4, log_data.end()) << '"';;
-                    break;
-                case OEM6_INVALID_CHECKSUM:
-                    gps->warning("checksum failure");
-                    break;
-                default:
-                    gps->warning() << "RX Message: \"" << std::string(log_data.begin() + 4, log_data.end()) << '"';
-                }
-            }
-        case OEM6_LOG_RTKXYZ:  // RTKXYZ
-            if (!is_response(header))
-            {
-                gps->trace() << "Received RTKXYZ data";
-                parse_rtkxyz(log_data);
-            }
-            break;
+            LOGGER_TRACE(*gps) << "Received BESTXYZ data";
 
-        case OEM6_LOG_REFSTATION:
-            gps->trace() << "\n\nrefstation\n\n";
-            if(!is_response(header))
+            NovatelXYZ xyz;
+            if(!xyz.decode(log_data, data_size))
             {
-                gps->trace() << "\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n";
-                gps->trace() << "Received base station health report";
-                gps->trace() << "\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n";
+                gps->warning() << "BESTXYZ log too short: " << data_size;
                 break;
             }
 
-        case OEM6_LOG_BESTPOS:
-        {
-            gps->trace() << "Best position";
-
-            blas::vector<double> position(parse_3floats<double>(log_data, 8));
-            gps->trace() << std::endl
-                         <<"[Fallback GPS: Status: " << solStatusToString(parse_enum(log_data)) << std::endl
-                         << "\tPosition type: " << posVelTypeToString(parse_enum(log_data, 4)) << std::endl
-                         << "\tPosition Error: " << parse_3floats<float>(log_data, 40) << std::endl
-                         << "\tECEF position: " << position << std::endl
-                         << "\tLLH: " << ecef_to_llh(position) << std::endl
-                         << "\t# of sats visible: " << log_data[64] << "]" << std::endl;
-            break;
+            LogRecord log;
+            parse_header(message, log);
+            parse_log(xyz, log);
+            last_data = gps->getMsSinceInit();
+            //GPS::getInstance()->gps_updated();
+            LogFile::getInstance()->logData(LOG_NOVATEL_GPS, log);
         }
+        break;
 
-        case OEM6_LOG_BESTXYZ:  // RTKXYZ
-            if (!is_response(header))
-            {
-                gps->trace() << "Received BESTXYZ data";
-
-                std::vector<double> log;
-                parse_header(header, log);
-                parse_log(log_data, log);
-                last_data = gps->getMsSinceInit();
-                //GPS::getInstance()->gps_updated();
-                LogFile::getInstance()->logData(LOG_NOVATEL_GPS, log);
-            }
-            break;
-
-        default:
-            gps->warning() << "Received unexpected message id: " << message_id;
-            continue;
-        }
+    default:
+        gps->warning() << "Received unexpected message id: " << message_id;
+        break;
     }
 }
 
-bool GPS::ReadSerial::is_response(const std::vector<uint8_t>& header)
+std::string GPS::ReadSerial::response_text(const uint8_t* data, size_t length)
 {
-    std::bitset<8> message_type(header[3]);
-    return message_type[7];
+    // responses are a four byte enum followed by a string
+    if(length <= 4)
+    {
+        return "";
+    }
+    return std::string(data + 4, data + length);
 }
 
-void GPS::ReadSerial::parse_header(const std::vector<uint8_t>& header, std::vector<double>& log)
+void GPS::ReadSerial::parse_header(const uint8_t* message, LogRecord& log)
 {
     GPS* gps = GPS::getInstance();
-    std::vector<uint8_t>::const_iterator it = header.begin() + 10;
-    uint32_t time_status = *it;
-
-    //gps->trace() << "time status: " << time_status;
-
-    log += time_status;
-    it += 1;
-    uint16_t week = raw_to_int<uint16_t>(it);
-    log += week;
-    it += 2;
-    uint32_t milliseconds = raw_to_int<uint32_t>(it);
-    log += milliseconds;
-    gps->set_gps_time(gps_time(week, milliseconds, static_cast<gps_time::TIME_STATUS>(time_status)));
+    NovatelTime time;
+    time.decode(message);
+
+    log[0] = time.time_status;
+    log[1] = time.week;
+    log[2] = time.milliseconds;
+    gps->set_gps_time(gps_time(time.week, time.milliseconds, static_cast<gps_time::TIME_STATUS>(time.time_status)));
 }
 
 std::string GPS::ReadSerial::solStatusToString(uint32_t status)
@@ -421,97 +437,98 @@ std::string GPS::ReadSerial::posVelTypeToString(uint32_t type)
 }
 
 
-void GPS::ReadSerial::parse_rtkxyz(const std::vector<uint8_t>& data)
+void GPS::ReadSerial::parse_rtkxyz(const NovatelXYZ& xyz)
 {
     GPS& gps = *GPS::getInstance();
 
-    uint32_t pos_status = parse_enum(data);
-    uint32_t pos_type = parse_enum(data, 4);
-    blas::vector<double> position(parse_3floats<double>(data, 8));
-    blas::vector<double> llh(ecef_to_llh(position));
-    blas::vector<float> position_error(parse_3floats<float>(data, 32));
-    blas::vector<double> velocity(parse_3floats<double>(data, 52));
-    blas::vector<float> velocity_error(parse_3floats<float>(data, 76));
-    uint8_t num_sats = data[104];
-    blas::vector<float> latency_dage_solage(parse_3floats<float>(data, 92));
-
-
-    gps.trace() << std::endl <<"[Message: Status: " << solStatusToString(pos_status) << std::endl
-                << "\tPosition type: " << posVelTypeToString(pos_type) << std::endl
-                << "\tECEF position: " << position << std::endl
-                << "\tLLH: " << llh << std::endl
-                << "\t# of sats visible: " << num_sats << std::endl
-                << "\tV-Latency: " << latency_dage_solage[0] << std::endl
-                << "\tDiff Age(s): " << latency_dage_solage[1] << std::endl
-                << "\tSolution Age(s): " << latency_dage_solage[2] << "]";
+    Vec3 position(to_vector(xyz.position));
+
+    LOGGER_TRACE(gps) << std::endl <<"[Message: Status: " << solStatusToString(xyz.pos_status) << std::endl
+                      << "\tPosition type: " << posVelTypeToString(xyz.pos_type) << std::endl
+                      << "\tECEF position: " << position << std::endl
+                      << "\tLLH: " << ecef_to_llh(position) << std::endl
+                      << "\t# of sats visible: " << xyz.num_sats << std::endl
+                      << "\tV-Latency: " << xyz.velocity_latency << std::endl
+                      << "\tDiff Age(s): " << xyz.differential_age << std::endl
+                      << "\tSolution Age(s): " << xyz.solution_age << "]";
 }
 
 
 
-void GPS::ReadSerial::parse_log(const std::vector<uint8_t>& data, std::vector<double>& log)
+void GPS::ReadSerial::parse_log(const NovatelXYZ& xyz, LogRecord& log)
 {
     GPS& gps = *GPS::getInstance();
 
-    uint32_t pos_status = parse_enum(data);
-    uint32_t pos_type = parse_enum(data, 4);
-    blas::vector<double> position(parse_3floats<double>(data, 8));
-    blas::vector<double> llh(ecef_to_llh(position));
-    blas::vector<float> position_error(parse_3floats<float>(data, 32));
-    uint vel_status = parse_enum(data, 44);
-    uint vel_type = parse_enum(data, 48);
-    blas::vector<double> velocity(parse_3floats<double>(data, 52));
-    blas::vector<float> velocity_error(parse_3floats<float>(data, 76));
-    uint8_t num_sats = data[104];
-    blas::vector<float> latency_dage_solage(parse_3floats<float>(data, 92));
-
-
-    gps.trace() << std::endl <<"[Message: Status: " << solStatusToString(pos_status) << std::endl
-                << "\tPosition type: " << posVelTypeToString(pos_type) << std::endl
-                << "\tECEF position: " << position << std::endl
-                << "\tLLH: " << llh << std::endl
-                << "\t# of sats visible: " << num_sats << std::endl
-                << "\tV-Latency: " << latency_dage_solage[0] << std::endl
-                << "\tDiff Age(s): " << latency_dage_solage[1] << std::endl
-                << "\tSolution Age(s): " << latency_dage_solage[2] << "]";
-
-
-    log += pos_status;
-    log += pos_type;
-    log.insert(log.end(), position.begin(), position.end());
-    log.insert(log.end(), position_error.begin(), position_error.end());
-    log += vel_status;
-    log += vel_type;
-    log.insert(log.end(), velocity.begin(), velocity.end());
-    log.insert(log.end(), velocity_error.begin(), velocity_error.end());
-    log += num_sats;
-
-
-    gps.set_position_status(pos_status);
-    gps.set_position_type(pos_type);
+    Vec3 position(to_vector(xyz.position));
+    Vec3 llh(ecef_to_llh(position));
+    Vec3 position_error(to_vector(xyz.position_error));
+    Vec3 velocity(to_vector(xyz.velocity));
+    Vec3 velocity_error(to_vector(xyz.velocity_error));
+
+    LOGGER_TRACE(gps) << std::endl <<"[Message: Status: " << solStatusToString(xyz.pos_status) << std::endl
+                      << "\tPosition type: " << posVelTypeToString(xyz.pos_type) << std::endl
+                      << "\tECEF position: " << position << std::endl
+                      << "\tLLH: " << llh << std::endl
+                      << "\t# of sats visible: " << xyz.num_sats << std::endl
+                      << "\tV-Latency: " << xyz.velocity_latency << std::endl
+                      << "\tDiff Age(s): " << xyz.differential_age << std::endl
+                      << "\tSolution Age(s): " << xyz.solution_age << "]";
+
+    // fields follow the three time fields from parse_header, see GPS_LOGFILE_HEADER
+    log[3] = xyz.pos_status;
+    log[4] = xyz.pos_type;
+    for (int i = 0; i < 3; i++)
+    {
+        log[5 + i] = xyz.position[i];
+        log[8 + i] = xyz.position_error[i];
+        log[13 + i] = xyz.velocity[i];
+        log[16 + i] = xyz.velocity_error[i];
+    }
+    log[11] = xyz.vel_status;
+    log[12] = xyz.vel_type;
+    log[19] = xyz.num_sats;
+
+    gps.set_position_status(xyz.pos_status);
+    gps.set_position_type(xyz.pos_type);
     gps.set_llh_position(llh);
     gps.set_pos_sigma(ecef_to_ned(position_error, llh));
-    gps.set_velocity_status(vel_status);
-    gps.set_velocity_type(vel_type);
+    gps.set_velocity_status(xyz.vel_status);
+    gps.set_velocity_type(xyz.vel_type);
     gps.set_ned_velocity(ecef_to_ned(velocity, llh));
     gps.set_vel_sigma(ecef_to_ned(velocity_error, llh));
-    gps.set_num_sats(num_sats);
+    gps.set_num_sats(xyz.num_sats);
 
     gps.writeToSystemState();
 
     gps.gps_updated();
 }
 
-uint GPS::ReadSerial::parse_enum(const std::vector<uint8_t>& log, int offset)
+uint GPS::ReadSerial::parse_enum(const uint8_t* log, int offset)
+{
+    return novatel_field<uint32_t>(log + offset);
+}
+
+Vec3 GPS::ReadSerial::ecef_to_ned(const Vec3& ecef, const Vec3& llh)
 {
-    return raw_to_int<uint32_t>(log.begin() + offset);
+    Mat3 ned_rotation;
+    ned_rotation(0,0) = -sin(llh[0])*cos(llh[1]);
+    ned_rotation(0,1) = -sin(llh[0])*sin(llh[1]);
+    ned_rotation(0,2) = cos(llh[0]);
+    ned_rotation(1,0) = -sin(llh[1]);
+    ned_rotation(1,1) = cos(llh[1]);
+    ned_rotation(1,2) = 0;
+    ned_rotation(2,0) = -cos(llh[0])*cos(llh[1]);
+    ned_rotation(2,1) = -cos(llh[0])*sin(llh[1]);
+    ned_rotation(2,2) = -sin(llh[0]);
+
+    return ned_rotation * ecef;
 }
 
-blas::vector<double> GPS::ReadSerial::ecef_to_llh(const blas::vector<double>& ecef)
+Vec3 GPS::ReadSerial::ecef_to_llh(const Vec3& ecef)
 {
     /* Transformation from ECEF [x,y,z] to geodetic [phi,lamda,h] coordinates using Jay A. Farrel algorithm p.34 */
     // ECEF2GEO Parameters
-    blas::vector<double> llh(3);
-    llh.clear();
+    Vec3 llh;
 
     const double a = 6378137.0;
     const double f = 1.0/298.257223563;
@@ -646,36 +663,5 @@ void GPS::ReadSerial::setupLogging()
 
 std::vector<uint8_t> GPS::ReadSerial::compute_checksum(const std::vector<uint8_t>& message)
 {
-    uint32_t ulTemp1;
-    uint32_t ulTemp2;
-    uint32_t ulCRC = 0;
-
-    for (size_t i=0; i < message.size(); i++)
-    {
-        ulTemp1 = ( ulCRC >> 8 ) & 0x00FFFFFFL;
-        ulTemp2 = CRC32Value( ((int) ulCRC ^ message[i] ) & 0xff );
-        ulCRC = ulTemp1 ^ ulTemp2;
-    }
-
-    return(int_to_raw(ulCRC));
-}
-
-unsigned long GPS::ReadSerial::CRC32Value(int i)
-{
-    int j;
-    uint32_t ulCRC;
-
-    ulCRC = i;
-    for ( j = 8 ; j > 0; j-- )
-    {
-        if ( ulCRC & 1 )
-        {
-            ulCRC = ( ulCRC >> 1 ) ^ CRC32_POLYNOMIAL;
-        }
-        else
-        {
-            ulCRC >>= 1;
-        }
-    }
-    return ulCRC;
+    return int_to_raw(Crc32::update(0, &message[0], message.size()));
 }
@@ -27,15 +27,14 @@
 
 /* STL Headers */
 #include <vector>
-
-/* Boost Headers */
-#include <boost/numeric/ublas/vector.hpp>
-#include <boost/numeric/ublas/matrix.hpp>
-namespace blas = boost::numeric::ublas;
+#include <array>
+#include <string>
 
 /* Project Headers */
 #include "GPS.h"
 #include "ThreadSafeVariable.h"
+#include "novatel_framer.h"
+#include "novatel_logs.h"
 
 /**
  * @brief Class to send commands to, and receive data from the GPS unit.
@@ -47,6 +46,8 @@ namespace blas = boost::numeric::ublas;
  */
 class GPS::ReadSerial
 {
+    /// times parse_header and parse_log over recorded data, see novatel_parse_bench.cc
+    friend struct NovatelParseBench;
 public:
     ReadSerial();
 
@@ -60,6 +61,19 @@ public:
      */
     void readPort();
 
+    /**
+     * Takes whatever has arrived on the port when the IoReactor finds it
+     * readable and handles any complete messages.
+     */
+    void readable(uint64_t arrival_ns);
+
+    /**
+     * Restarts logging if nothing has arrived from the NovAtel in a while.
+     * Never blocks, the unlog command is sent on one call and logging is set
+     * up again on the first call RESTART_SETTLE_MS or more later.
+     */
+    void checkTimeout();
+
     std::string solStatusToString(uint32_t status);
     std::string posVelTypeToString(uint32_t type);
     enum OEM6_SOL_STATUS
@@ -555,7 +569,9 @@ private:
 
     static const uint8_t HEADER_SYNC_BYTES[];
     static const uint8_t HEADER_SYNC_BYTES_LENGTH;
-    static const uint8_t HEADER_LENGTH_BYTES;
+
+    /// one line of the LOG_NOVATEL_GPS log, see GPS_LOGFILE_HEADER
+    typedef std::array<double, 20> LogRecord;
 
     /**
      * Initialize the serial port that NovAtel is configured to run on.
@@ -580,42 +596,54 @@ private:
     /// compute the checksum for a message
     static std::vector<uint8_t> compute_checksum(const std::vector<uint8_t>& message);
 
-    /// parse the header and append the relevant field to the log
-    void parse_header(const std::vector<uint8_t>& header, std::vector<double>& log);
+    /// parse the time fields of a message header in to the log
+    void parse_header(const uint8_t* message, LogRecord& log);
 
-    /// parse the message and append the relevant fields to the log
-    void parse_log(const std::vector<uint8_t>& data, std::vector<double>& log);
+    /// update the GPS from a BESTXYZ log and fill in the rest of the log
+    void parse_log(const NovatelXYZ& xyz, LogRecord& log);
 
     /// Parses rtkxyz commands to display them
-    void parse_rtkxyz(const std::vector<uint8_t>& data);
-
+    void parse_rtkxyz(const NovatelXYZ& xyz);
 
-    ///Used by compute_checksum function
-    static unsigned long CRC32Value(int i);
+    /// acts on one complete message from the framer
+    void handleMessage(const uint8_t* message, size_t length);
 
-    static const uint32_t CRC32_POLYNOMIAL = 0xEDB88320L;
+    /// the text following the return code of a command response
+    static std::string response_text(const uint8_t* data, size_t length);
 
     /// serial port file descriptor
     int fd_ser;
 
+    /// splits the bytes read from fd_ser in to messages
+    NovatelFramer framer;
+    /// the CRC failure count last warned about
+    uint64_t reported_failures = 0;
+
     /// extract an enum field from the novatel message
-    uint parse_enum(const std::vector<uint8_t>& log, int offset = 0);
+    uint parse_enum(const uint8_t* log, int offset = 0);
     /// extract a 3 vector of floating point type (double of float) from the novatel message
     template<typename FloatingType>
-    static blas::vector<FloatingType> parse_3floats(const std::vector<uint8_t>& log, int offset = 0);
+    static Vec3 parse_3floats(const uint8_t* log, int offset = 0);
+
+    /// copy a decoded field in to a vector for the GPS setters
+    template<typename SourceType>
+    static Vec3 to_vector(const SourceType (&values)[3])
+    {
+        return Vec3(values[0], values[1], values[2]);
+    }
 
     /// rotate vectors in ecef into ned frame using the llh position parameter
-    template<typename FloatingType>
-    static blas::vector<FloatingType> ecef_to_ned(const blas::vector<FloatingType>& ecef, const blas::vector<double>& llh);
+    static Vec3 ecef_to_ned(const Vec3& ecef, const Vec3& llh);
 
     /// convert ecef position measurement into llh @note llh is in radians (easier for trig computations - must be converted to degrees for gx3)
-    static blas::vector<double> ecef_to_llh(const blas::vector<double>& ecef);
-
-    /// check whether the header is from a response message
-    static bool is_response(const std::vector<uint8_t>& header);
+    static Vec3 ecef_to_llh(const Vec3& ecef);
 
     /// stores the last time data was successfully received (for error handling)
     long last_data;
+    /// when a restart sent the unlog command, -1 unless a restart is waiting to set up logging again
+    long unlogged_at = -1;
+    /// how long a restart waits between the unlog command and setting up logging again
+    static const long RESTART_SETTLE_MS = 100;
 
     /**
      * Creates and sends a generic log signal to the NovAtel
@@ -633,28 +661,19 @@ private:
     void _genericUnlog(OEM6_LOG message);
 
     /**
-     * Reads a packet from the NovAtel. Returns false if the system was terminated
-     * before synch could happen.
+     * Reads whatever the NovAtel has sent in to the framer, restarting logging if
+     * nothing has arrived in a while. Returns false if the system was terminated.
      */
-    bool synchronize();
-
-    /// convert a raw string of bytes to a signed integer
-    template <typename ReturnType, typename IteratorType>
-    static ReturnType raw_to_int(IteratorType first, IteratorType last);
+    bool fill();
 
     /**
-     * @code
-     * uint16_t message_id = raw_to_int<uint16_t>(header.begin() + 1);
-     * @endcode
+     * A single read of whatever is waiting in to the framer, returns false
+     * if nothing was read.
      */
-    template <typename ReturnType, typename IteratorType>
-    static inline ReturnType raw_to_int(IteratorType first)
-    {
-        return raw_to_int<ReturnType>(first, first + sizeof(ReturnType));
-    }
+    bool readAvailable();
 
-    template <typename FloatingType, typename IteratorType>
-    static FloatingType raw_to_float(IteratorType first, IteratorType last);
+    /// hands every complete message in the framer to handleMessage
+    void handleMessages();
 
     /// convert an integer type (signed or unsigned) to raw
     template <typename IntegerType>
@@ -666,64 +685,16 @@ private:
 
 };
 template<typename FloatingType>
-blas::vector<FloatingType> GPS::ReadSerial::parse_3floats(const std::vector<uint8_t>& log, int offset)
+Vec3 GPS::ReadSerial::parse_3floats(const uint8_t* log, int offset)
 {
-    blas::vector<FloatingType> floats(3);
+    Vec3 floats;
     for (int i=0; i<3; i++)
-        floats[i] = raw_to_float<FloatingType>(log.begin() + offset + sizeof(FloatingType)*i,
-                                               log.begin() + offset + sizeof(FloatingType)*(i+1));
+        floats[i] = novatel_field<FloatingType>(log + offset + sizeof(FloatingType)*i);
     return floats;
 }
 
-template<typename FloatingType>
-blas::vector<FloatingType> GPS::ReadSerial::ecef_to_ned(const blas::vector<FloatingType>& ecef, const blas::vector<double>& llh)
-{
-
-    blas::matrix<double> ned_rotation(3,3);
-    ned_rotation(0,0) = -sin(llh[0])*cos(llh[1]);
-    ned_rotation(0,1) = -sin(llh[0])*sin(llh[1]);
-    ned_rotation(0,2) = cos(llh[0]);
-    ned_rotation(1,0) = -sin(llh[1]);
-    ned_rotation(1,1) = cos(llh[1]);
-    ned_rotation(1,2) = 0;
-    ned_rotation(2,0) = -cos(llh[0])*cos(llh[1]);
-    ned_rotation(2,1) = -cos(llh[0])*sin(llh[1]);
-    ned_rotation(2,2) = -sin(llh[0]);
-
-    return prod(ned_rotation, ecef);
-}
-
 
 
-template <typename ReturnType, typename IteratorType>
-ReturnType GPS::ReadSerial::raw_to_int(IteratorType first, IteratorType last)
-{
-    uint32_t data = 0; // int is largest int type from novatel
-    for (IteratorType it = last - 1; it != first - 1; --it)
-    {
-        data <<= 8;
-        data += *it;
-    }
-    return *reinterpret_cast<ReturnType*>(&data);
-
-}
-
-template <typename FloatingType, typename IteratorType>
-FloatingType GPS::ReadSerial::raw_to_float(IteratorType first, IteratorType last)
-{
-    uint64_t result = 0;
-    for (IteratorType it = last - 1; it != first - 1; --it)
-    {
-        result <<= 8;
-        result += *it;
-    }
-    if (last - first == 8)
-        return *reinterpret_cast<double*>(&result);
-    else
-        return *reinterpret_cast<float*>(&result);
-
-}
-
 template <typename IntegerType>
 std::vector<uint8_t> GPS::ReadSerial::int_to_raw(const IntegerType i)
 {
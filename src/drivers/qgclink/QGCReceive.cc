@@ -125,6 +125,7 @@ void QGCLink::QGCReceive::receive()
 				case MAVLINK_MSG_ID_UALBERTA_ACTION:
 				{
 					qgc->debug() << "Received Ualberta Action";
+					LogFile::getInstance()->triggerFlightRecorder("mavlink_action");
 					mavlink_ualberta_action_t action;
 					mavlink_msg_ualberta_action_decode(&msg, &action);
 					switch (action.action)
@@ -34,6 +34,7 @@
 #include <mavlink.h>
 
 /* STL Headers */
+#include <chrono>
 #include <vector>
 #include <exception>
 
@@ -43,20 +44,27 @@
 #include <boost/numeric/ublas/vector.hpp>
 #include <boost/numeric/ublas/matrix.hpp>
 namespace blas = boost::numeric::ublas;
-#include <boost/algorithm/string.hpp>
 
 
 #include <asio.hpp>
 
 #define NDEBUG
 
+/// console messages of each level waiting to be coalesced, more are dropped
+const size_t CONSOLE_CAPACITY = 64;
+/// different console messages waiting to be sent
+const size_t CONSOLE_PENDING = 16;
+/// how often a repeating console message is sent again with its count
+const uint64_t CONSOLE_REPEAT_MS = 1000;
+
 QGCSend::QGCSend()
     :qgc(NULL),
      servo_source(heli::NUM_AUTOPILOT_MODES),
      pilot_mode(heli::NUM_PILOT_MODES),
      filter_state(IMU::NUM_GX3_MODES),
      control_mode(heli::Num_Controller_Modes),
-     attitude_source(true)
+     attitude_source(true),
+     console_queue(CONSOLE_CAPACITY, CONSOLE_PENDING, CONSOLE_REPEAT_MS)
 {
     send_queue = new std::queue<std::vector<uint8_t> >();
 }
@@ -107,9 +115,12 @@ void QGCSend::send()
         }
 
         /* Send any queued messages to the console */
-        if (!message_queue_empty()) //only send max one message per iteration
+        uint64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                              std::chrono::steady_clock::now().time_since_epoch()).count();
+        ConsoleQueue::Message console;
+        if (console_queue.pop(now_ms, console)) //only send max one message per iteration
         {
-            send_console_message(message_queue_pop(), send_queue);
+            send_console_message(console, send_queue);
         }
 
         // Do bulk allocation of messages for drivers.
@@ -297,23 +308,15 @@ void QGCSend::send_status(std::queue<std::vector<uint8_t> >* sendq)
     sendq->push(buf);
 }
 
-std::string QGCSend::message_queue_pop()
-{
-    std::lock_guard<std::mutex> lock(message_queue_lock);
-    std::string message(message_queue.front());
-    message_queue.pop();
-    return message;
-}
-
-void QGCSend::send_console_message(const std::string& message, std::queue<std::vector<uint8_t> > *sendq)
+void QGCSend::send_console_message(const ConsoleQueue::Message& message, std::queue<std::vector<uint8_t> > *sendq)
 {
-    std::string console(message);
-    console.resize(50);
+    std::string console(ConsoleQueue::statusText(message));
+    console.resize(ConsoleQueue::TEXT_LENGTH);
 
     mavlink_message_t msg;
     std::vector<uint8_t> buf(MAVLINK_MAX_PACKET_LEN);
 
-    ::mavlink_msg_statustext_pack(qgc->getUasId(), 0, &msg, (boost::algorithm::starts_with(console, "Critical")?255:0), console.c_str());
+    ::mavlink_msg_statustext_pack(qgc->getUasId(), 0, &msg, (message.level == Debug::CRITICAL?255:0), console.c_str());
     buf.resize(mavlink_msg_to_send_buffer(&buf[0], &msg));
     sendq->push(buf);
 }
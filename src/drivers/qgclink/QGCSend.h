@@ -24,6 +24,7 @@
 #include "QGCLink.h"
 #include "heli.h"
 #include "IMU.h"
+#include "ConsoleQueue.h"
 
 /* STL Headers */
 #include <queue>
@@ -47,8 +48,13 @@ public:
     /** queue stream messages and perform actual send */
 	void send();
 
-	/// threadsafe push message to the console
-	inline void message_queue_push(const std::string& message) {std::lock_guard<std::mutex> lock(message_queue_lock); message_queue.push(message);}
+	/// queue a warning or critical message for the console, lock free from any thread
+	inline void message_queue_push(Debug::DEBUG_LEVEL level, const std::string& message) {console_queue.push(level, message);}
+
+	/// console messages dropped because too many were waiting
+	inline uint64_t console_dropped() const {return console_queue.dropped();}
+	/// console messages sent as a count on an identical one rather than on their own
+	inline uint64_t console_coalesced() const {return console_queue.coalesced();}
 
 private:
     QGCSend();
@@ -79,10 +85,10 @@ private:
 	/// send the current position and velocity measurement
 	void send_position(std::queue<std::vector<uint8_t> > *sendq);
 	/** add console message to send queue
-     * @param message - the message to send
+     * @param message - the message to send, with how many times it repeated
 	 * @param sendq send queue
 	 */
-	void send_console_message(const std::string& message, std::queue<std::vector<uint8_t> > *sendq);
+	void send_console_message(const ConsoleQueue::Message& message, std::queue<std::vector<uint8_t> > *sendq);
 
 	/** determine whether to send a particular stream
 	 * @param stream_rate requested stream rate
@@ -119,13 +125,7 @@ private:
 	/// connection for attitude source
 	boost::signals2::scoped_connection attitude_source_connection;
 
-	/// store a queue of messages
-	std::queue<std::string> message_queue;
-	/// serialize access to message_queue
-	mutable std::mutex message_queue_lock;
-	/// threadsafe empty test
-	inline bool message_queue_empty() const {std::lock_guard<std::mutex> lock(message_queue_lock); return message_queue.empty();}
-	/// threadsafe pop message
-	std::string message_queue_pop();
+	/// warnings and critical messages waiting for the console, bounded and with repeats coalesced
+	ConsoleQueue console_queue;
 };
 #endif
@@ -0,0 +1,71 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "AllocationCounter.h"
+#include "Benchmark.h"
+
+/* STL Headers */
+#include <vector>
+
+#include <mavlink.h>
+
+namespace
+{
+/**
+ * There is no MAVLink recording in recorded_data, so this builds a telemetry
+ * stream like the one the autopilot sends: a heartbeat, then attitude and
+ * raw rc channels with the values moving from one message to the next.
+ */
+std::vector<uint8_t> telemetry_stream(int rounds)
+{
+    std::vector<uint8_t> stream;
+    uint8_t buf[MAVLINK_MAX_PACKET_LEN];
+    mavlink_message_t msg;
+
+    for(int i = 0; i < rounds; i++)
+    {
+        if(i % 10 == 0)
+        {
+            mavlink_msg_heartbeat_pack(100, 200, &msg, MAV_TYPE_HELICOPTER, MAV_AUTOPILOT_GENERIC, 0, 0, 0);
+            uint16_t length = mavlink_msg_to_send_buffer(buf, &msg);
+            stream.insert(stream.end(), buf, buf + length);
+        }
+
+        mavlink_msg_attitude_pack(100, MAV_COMP_ID_IMU, &msg, i * 20, 0.01f * i, -0.02f * i, 0.5f, 0.1f, 0.2f, 0.3f);
+        uint16_t length = mavlink_msg_to_send_buffer(buf, &msg);
+        stream.insert(stream.end(), buf, buf + length);
+
+        uint16_t stick = 1100 + i % 800;
+        mavlink_msg_rc_channels_raw_pack(100, 200, &msg, 0, 0, stick, stick, 1500, 1500, 1500, 1500, 1500, 1500, 0);
+        length = mavlink_msg_to_send_buffer(buf, &msg);
+        stream.insert(stream.end(), buf, buf + length);
+    }
+
+    return stream;
+}
+}
+
+BENCHMARK(Mavlink, ParseChar)
+{
+    std::vector<uint8_t> stream = telemetry_stream(20000);
+    mavlink_message_t msg;
+    mavlink_status_t status;
+    uint64_t messages = 0;
+
+    uint64_t allocations = AllocationCounter::allocations();
+    uint64_t start = Benchmark::nowNanos();
+    for(uint8_t byte : stream)
+    {
+        if(mavlink_parse_char(MAVLINK_COMM_2, byte, &msg, &status))
+        {
+            messages++;
+        }
+    }
+    uint64_t elapsed = Benchmark::nowNanos() - start;
+    allocations = AllocationCounter::allocations() - allocations;
+
+    bench.reportPackets(messages, stream.size(), elapsed, allocations);
+}
@@ -62,10 +62,11 @@ const std::string servo_switch::LOG_INPUT_RPM = "Engine RPM";
 
 servo_switch::servo_switch()
     : Driver("Servo Switch","servo"),
-      raw_inputs(9, 0),
-      raw_outputs(9, 0),
       pilot_mode(heli::PILOT_UNKNOWN)
 {
+    raw_inputs.fill(0);
+    raw_outputs.fill(0);
+
     if(!isEnabled())
     {
         warning() << "Servo switch disabled!";
@@ -74,11 +75,19 @@ servo_switch::servo_switch()
 
     if(init_port())
     {
-        receive = std::thread(read_serial());
+        if(useReactor())
+        {
+            read_serial* reader = new read_serial();
+            watchDevice(fd_ser1, [reader](uint64_t){ reader->read_available(); });
+        }
+        else
+        {
+            receive = std::thread(read_serial());
+        }
         send = std::thread(send_serial());
         LogFile *log = LogFile::getInstance();
-        log->logHeader(LOG_INPUT_PULSE_WIDTHS, "CH1 CH2 CH3 CH4 CH5 CH6 CH7 CH8 CH9");
-        log->logHeader(LOG_OUTPUT_PULSE_WIDTHS, "CH1 CH2 CH3 CH4 CH5 CH6 CH7 CH8 CH9");
+        log_input_pulses = log->channel<PulseWidths>(LOG_INPUT_PULSE_WIDTHS);
+        log_output_pulses = log->channel<PulseWidths>(LOG_OUTPUT_PULSE_WIDTHS);
         log->logHeader(LOG_INPUT_RPM, "RPM");
     }
     else
@@ -90,17 +99,14 @@ servo_switch::servo_switch()
 void servo_switch::writeToSystemState()
 {
     SystemState *state = SystemState::getInstance();
+    SystemState::Batch batch;
 
-    auto vec = get_raw_inputs();
+    SSC::Pulses inputs = get_raw_input_array();
     std::array<uint16_t, 8> raw;
-    std::copy_n(vec.begin(), 8, raw.begin());
+    std::copy_n(inputs.begin(), 8, raw.begin());
     state->servoRawInputs.set(raw, 0);
 
-
-    state->state_lock.lock();
-    state->servo_raw_outputs = raw_outputs;
-    state->servo_pilot_mode.store(pilot_mode.load());
-    state->state_lock.unlock();
+    state->setServoOutputs(get_raw_outputs(), pilot_mode.load());
 }
 
 bool servo_switch::init_port()
@@ -134,74 +140,58 @@ void servo_switch::set_pilot_mode(heli::PILOT_MODE mode)
     }
 }
 
-std::vector<uint8_t> servo_switch::compute_checksum(uint8_t id, uint8_t count, const std::vector<uint8_t>& payload)
+/* read_serial functions */
+void servo_switch::read_serial::read_data()
 {
-    std::vector<uint8_t> checksum(2, 0);
-    checksum[0] = id + count;
-    checksum[1] = 2*id + count;
+    servo_switch* servo = servo_switch::getInstance();
 
-    for (std::vector<uint8_t>::const_iterator it = payload.begin(); it != payload.end(); ++it)
+    while(! servo->terminateRequested())
     {
-        checksum[0] += *it;
-        checksum[1] += checksum[0];
+        read_available();
     }
-    return checksum;
 }
 
-/* read_serial functions */
-void servo_switch::read_serial::read_data()
+void servo_switch::read_serial::read_available()
 {
     servo_switch* servo = servo_switch::getInstance();
 
-    int fd_ser = servo->fd_ser1;
-    std::vector<uint8_t> payload;
-    std::vector<uint8_t> checksum(2);
-    while(! servo->terminateRequested())
+    // take whatever the board has sent rather than a byte at a time
+    size_t space = 0;
+    uint8_t* dst = framer.writeSpan(space);
+    if(space == 0)
     {
-        servo->trace() << "searching for header";
-        find_next_header();
-
-        // get message id
-        uint8_t id = 0;
-        int idb = servo->readDevice(fd_ser, &id, 1);
-
-        // get message count
-        uint8_t count = 0;
-        int ctb = servo->readDevice(fd_ser, &count, 1);
-
-        // allocate space for message
-        payload.resize(count);
-        // get message payload
-        int pldb = servo->readDevice(fd_ser, &payload[0], count);
-
-        // zero checksum
-        checksum.assign(checksum.size(), 0);
-        // get checksum
-        servo->readDevice(fd_ser, &checksum[0], 2);
+        framer.reset();
+        return;
+    }
+    framer.commit(servo->readDevice(servo->fd_ser1, dst, space, 1));
 
-        servo->trace() << "ID ("<< idb <<"): " << id << " Count("<< ctb <<"): " << count << " payload("<< pldb<< "): " << count;
+    SSC::Message message;
+    while(framer.next(message))
+    {
+        parse_message(message);
+    }
 
-        if (checksum == compute_checksum(id, count, payload))
-        {
-            servo->trace() << "parsing message";
-            parse_message(id, payload);
-        }
-        else
-        {
-            servo->trace() << "bad checksum";
-        }
+    if(framer.checksumFailures() != reported_failures)
+    {
+        servo->trace() << "bad checksum";
+        reported_failures = framer.checksumFailures();
     }
 }
 
-void servo_switch::read_serial::parse_message(uint8_t id, const std::vector<uint8_t>& payload)
+void servo_switch::read_serial::parse_message(const SSC::Message& message)
 {
     servo_switch* servo = getInstance();
 
-    switch (id)
+    switch (message.id)
     {
     case STATUS:
     {
-        uint16_t status =  payload[1];
+        if (message.count < 2)
+        {
+            break;
+        }
+
+        uint16_t status =  message.payload[1];
         // shift right to get command channel state
         status = (status & 0x6) >> 1;
         /** Section 4.2.1.1 of Servo Switch/Controller Users Manual February 2, 2007
@@ -226,50 +216,39 @@ void servo_switch::read_serial::parse_message(uint8_t id, const std::vector<uint
     }
 
     case PULSE_INPUTS:
-        parse_pulse_inputs(payload);
+        parse_pulse_inputs(message);
         break;
 
     case AUXILIARY_INPUTS:
-        parse_aux_inputs(payload);
+        parse_aux_inputs(message);
         break;
 
     default:
-        servo->debug() << "Received unknown message from servo switch id: " << id;
+        servo->debug() << "Received unknown message from servo switch id: " << message.id;
     }
 }
 
-void servo_switch::read_serial::parse_pulse_inputs(const std::vector<uint8_t>& payload)
+void servo_switch::read_serial::parse_pulse_inputs(const SSC::Message& message)
 {
     servo_switch* servo = getInstance();
-    servo->debug("Parsing pulse inputs");
-    const uint16_t upper_limit = 2200;
-    const uint16_t lower_limit = 800;
-    std::vector<uint16_t> pulse_inputs(getInstance()->get_raw_inputs());  // no need for more than 9 channels
-    uint16_t pulse_width = 0;
-    for (uint32_t i=1; i<payload.size()/2 && i < pulse_inputs.size(); i++)
-    {
-        pulse_width = (static_cast<uint16_t>(payload[i*2]) << 8) + payload[i*2+1];
-        servo->debug("Got pulse input: ");
-        servo->debug() << "Input " << i << "Payload: " << pulse_width;
-        if (pulse_width > lower_limit && pulse_width < upper_limit)
-        {
-            pulse_inputs[i-1] = pulse_width;
-        }
-    }
-    // treat ch8 differently
-    pulse_inputs[7] = (static_cast<uint16_t>(payload[0]) << 8) + payload[1];
+    SSC::Pulses pulse_inputs(servo->get_raw_input_array());
+    SSC::decodePulseInputs(message, pulse_inputs);
 
-    getInstance()->set_raw_inputs(pulse_inputs);
-    LogFile *log = LogFile::getInstance();
-    log->logData(LOG_INPUT_PULSE_WIDTHS, pulse_inputs);
-    getInstance()->writeToSystemState();
+    servo->set_raw_inputs(pulse_inputs);
+    servo->log_input_pulses.log(pulse_widths(pulse_inputs));
+    servo->writeToSystemState();
 
 }
 
-void servo_switch::read_serial::parse_aux_inputs(const std::vector<uint8_t>& payload)
+void servo_switch::read_serial::parse_aux_inputs(const SSC::Message& message)
 {
     servo_switch& ss = *servo_switch::getInstance();
+    const uint8_t* payload = message.payload;
 
+    if (message.count < 4)
+    {
+        return;
+    }
 
     std::bitset<8> meas_byte (payload[2]);
     if(meas_byte.test(7))
@@ -296,26 +275,6 @@ void servo_switch::read_serial::parse_aux_inputs(const std::vector<uint8_t>& pay
 }
 
 
-void servo_switch::read_serial::find_next_header()
-{
-    servo_switch* servo = servo_switch::getInstance();
-    servo->trace() << "Finding next header";
-    bool synchronized = false;
-    int fd_ser = servo->fd_ser1;
-
-    bool found_first_byte = false;
-    uint8_t buf;
-    while (!synchronized && !servo->terminateRequested())
-    {
-        servo->readDevice(fd_ser, &buf, 1);
-        if (buf == 0x81) // first byte of header
-            found_first_byte = true;
-        else if (buf == 0xA1 && found_first_byte)
-            synchronized = true;
-        else
-            found_first_byte = false;
-    }
-}
 /* send_serial functions */
 
 void servo_switch::send_serial::operator()()
@@ -328,28 +287,15 @@ void servo_switch::send_serial::operator()()
         rl.wait();
 
         // Construct outgoing message.
-        std::vector<uint16_t> raw_outputs(servo->get_raw_outputs());
-        std::vector<uint8_t> pulse_message {0x81, 0xA1, 20};
-
-        pulse_message.push_back(raw_outputs.size() * 2);
-        for (uint32_t i = 0; i < raw_outputs.size(); i++)
-        {
-            pulse_message.push_back(static_cast<uint8_t>(raw_outputs[i] >> 8));
-            pulse_message.push_back(static_cast<uint8_t>(raw_outputs[i] & 0xFF));
-        }
-
-        std::vector<uint8_t> checksum = compute_checksum(20, raw_outputs.size() * 2,
-                                                         std::vector<uint8_t>(pulse_message.begin()+4,
-                                                                              pulse_message.end()));
-
-        pulse_message.push_back(checksum[0]);
-        pulse_message.push_back(checksum[1]);
+        SSC::Pulses raw_outputs(servo->get_raw_outputs());
+        uint8_t pulse_message[SSC::MAX_MESSAGE_LENGTH];
+        size_t length = SSC::encodePulseCommand(raw_outputs.data(), raw_outputs.size(), pulse_message);
 
         // Log our data.
-        LogFile::getInstance()->logData(LOG_OUTPUT_PULSE_WIDTHS, raw_outputs);
+        servo->log_output_pulses.log(pulse_widths(raw_outputs));
 
         // Send message to servo switch.
-        while (write(servo->fd_ser1, &pulse_message[0], pulse_message.size()) < 0)
+        while (write(servo->fd_ser1, pulse_message, length) < 0)
         {
             servo->debug("Error sending pulse output message to servo switch");
         }
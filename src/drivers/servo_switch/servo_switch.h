@@ -23,7 +23,9 @@
 
 /* STL Headers */
 #include <vector>
+#include <algorithm>
 #include <sys/types.h>
+#include <string.h>
 #include <mutex>
 #include <atomic>
 #include <thread>
@@ -32,8 +34,11 @@
 
 /* Project Headers */
 #include "Driver.h"
+#include "LogFile.h"
+#include "LogRecord.h"
 #include "heli.h"
 #include "Singleton.h"
+#include "ssc_codec.h"
 
 
 
@@ -64,13 +69,19 @@ public:
             read_data();
         }
 
+        /// a single read of whatever the board has sent, handling any complete messages
+        void read_available();
+
     private:
         void read_data();
-        void sync();
-        void parse_message(uint8_t id, const std::vector<uint8_t>& payload);
-        void parse_pulse_inputs(const std::vector<uint8_t>& payload);
-        void parse_aux_inputs(const std::vector<uint8_t>& payload);
-        void find_next_header();
+        void parse_message(const SSC::Message& message);
+        void parse_pulse_inputs(const SSC::Message& message);
+        void parse_aux_inputs(const SSC::Message& message);
+
+        /// splits the bytes read from the port in to messages
+        SSC::Framer framer;
+        /// the checksum failure count last reported
+        uint64_t reported_failures = 0;
     };
 
     class send_serial
@@ -87,7 +98,8 @@ public:
     }
     uint16_t getRaw(heli::Channel ch)
     {
-        return get_raw_inputs()[ch];
+        std::lock_guard<std::mutex> lock(raw_inputs_lock);
+        return raw_inputs[ch];
     }
     /// set the value of the servo outputs
     void setRaw(const std::vector<uint16_t>& raw_outputs)
@@ -116,6 +128,30 @@ private:
     static const std::string LOG_OUTPUT_PULSE_WIDTHS ;
     static const std::string LOG_INPUT_RPM ;
 
+#define SERVO_PULSE_FIELDS(FIELD) \
+    FIELD(uint16_t, CH1) \
+    FIELD(uint16_t, CH2) \
+    FIELD(uint16_t, CH3) \
+    FIELD(uint16_t, CH4) \
+    FIELD(uint16_t, CH5) \
+    FIELD(uint16_t, CH6) \
+    FIELD(uint16_t, CH7) \
+    FIELD(uint16_t, CH8) \
+    FIELD(uint16_t, CH9)
+    LOG_RECORD(PulseWidths, SERVO_PULSE_FIELDS);
+    static_assert(sizeof(PulseWidths) == sizeof(SSC::Pulses), "PulseWidths is a copy of SSC::Pulses");
+
+    /// the channels in a PulseWidths record
+    static PulseWidths pulse_widths(const SSC::Pulses& pulses)
+    {
+        PulseWidths widths;
+        memcpy(&widths, pulses.data(), sizeof(widths));
+        return widths;
+    }
+
+    LogRecordChannel<PulseWidths> log_input_pulses;
+    LogRecordChannel<PulseWidths> log_output_pulses;
+
 
     /// @returns true if the port was successfully set up, false otherwise
     bool init_port();
@@ -125,24 +161,28 @@ private:
     std::thread receive;
     std::thread send;
 
-    static std::vector<uint8_t> compute_checksum(uint8_t id, uint8_t count, const std::vector<uint8_t>& payload);
-
-    std::vector<uint16_t> raw_inputs;
+    /// fixed size so updating them from the read thread never allocates
+    SSC::Pulses raw_inputs;
     std::mutex raw_inputs_lock;
     inline std::vector<uint16_t> get_raw_inputs()
+    {
+        std::lock_guard<std::mutex> lock(raw_inputs_lock);
+        return std::vector<uint16_t>(raw_inputs.begin(), raw_inputs.end());
+    }
+    inline SSC::Pulses get_raw_input_array()
     {
         std::lock_guard<std::mutex> lock(raw_inputs_lock);
         return raw_inputs;
     }
-    inline void set_raw_inputs(const std::vector<uint16_t>& raw_inputs)
+    inline void set_raw_inputs(const SSC::Pulses& raw_inputs)
     {
         std::lock_guard<std::mutex> lock(raw_inputs_lock);
         this->raw_inputs = raw_inputs;
     }
 
-    std::vector<uint16_t> raw_outputs;
+    SSC::Pulses raw_outputs;
     std::mutex raw_outputs_lock;
-    inline std::vector<uint16_t> get_raw_outputs()
+    inline SSC::Pulses get_raw_outputs()
     {
         std::lock_guard<std::mutex> lock(raw_outputs_lock);
         return raw_outputs;
@@ -150,7 +190,7 @@ private:
     inline void set_raw_outputs(const std::vector<uint16_t>& raw_outputs)
     {
         std::lock_guard<std::mutex> lock(raw_outputs_lock);
-        this->raw_outputs = raw_outputs;
+        std::copy_n(raw_outputs.begin(), std::min(raw_outputs.size(), this->raw_outputs.size()), this->raw_outputs.begin());
     }
 
     std::atomic<heli::PILOT_MODE> pilot_mode;
@@ -0,0 +1,142 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#include "ssc_codec.h"
+
+/* C Headers */
+#include <string.h>
+
+namespace
+{
+const uint8_t PULSE_COMMAND = 20;
+
+/// the range a pulse input has to be in for it to be believed
+const uint16_t PULSE_LOWER_LIMIT = 800;
+const uint16_t PULSE_UPPER_LIMIT = 2200;
+}
+
+size_t SSC::encode(uint8_t id, const uint8_t* payload, uint8_t count, uint8_t* out)
+{
+    out[0] = FIRST_SYNC_BYTE;
+    out[1] = SECOND_SYNC_BYTE;
+    out[2] = id;
+    out[3] = count;
+    memmove(out + HEADER_LENGTH, payload, count);
+
+    Checksum checksum;
+    checksum.update(out + 2, count + 2);
+    out[HEADER_LENGTH + count] = checksum.first;
+    out[HEADER_LENGTH + count + 1] = checksum.second;
+
+    return HEADER_LENGTH + count + CHECKSUM_LENGTH;
+}
+
+size_t SSC::encodePulseCommand(const uint16_t* pulses, size_t channels, uint8_t* out)
+{
+    if(channels > MAX_PAYLOAD_LENGTH / 2)
+    {
+        channels = MAX_PAYLOAD_LENGTH / 2;
+    }
+
+    // build the payload in place, then fill in the header and checksum around it
+    uint8_t* payload = out + HEADER_LENGTH;
+    for(size_t i = 0; i < channels; i++)
+    {
+        payload[i * 2] = static_cast<uint8_t>(pulses[i] >> 8);
+        payload[i * 2 + 1] = static_cast<uint8_t>(pulses[i] & 0xFF);
+    }
+
+    return encode(PULSE_COMMAND, payload, channels * 2, out);
+}
+
+void SSC::decodePulseInputs(const Message& message, Pulses& inputs)
+{
+    const size_t pairs = message.count / 2;
+    for(size_t i = 1; i < pairs && i < inputs.size(); i++)
+    {
+        uint16_t pulse_width = (static_cast<uint16_t>(message.payload[i * 2]) << 8) + message.payload[i * 2 + 1];
+        if(pulse_width > PULSE_LOWER_LIMIT && pulse_width < PULSE_UPPER_LIMIT)
+        {
+            inputs[i - 1] = pulse_width;
+        }
+    }
+
+    // treat ch8 differently
+    if(message.count >= 2)
+    {
+        inputs[7] = (static_cast<uint16_t>(message.payload[0]) << 8) + message.payload[1];
+    }
+}
+
+SSC::Framer::Framer()
+    :_messages(0),
+     _checksum_failures(0)
+{
+}
+
+bool SSC::Framer::sync()
+{
+    while(_ring.size() >= 2)
+    {
+        if(_ring[0] == FIRST_SYNC_BYTE && _ring[1] == SECOND_SYNC_BYTE)
+        {
+            return true;
+        }
+
+        _ring.consume(_ring.find(FIRST_SYNC_BYTE, 1));
+    }
+
+    return false;
+}
+
+bool SSC::Framer::next(Message& message)
+{
+    while(sync())
+    {
+        if(_ring.size() < HEADER_LENGTH)
+        {
+            return false;
+        }
+
+        const size_t count = _ring[3];
+        const size_t length = HEADER_LENGTH + count;
+        if(_ring.size() < length + CHECKSUM_LENGTH)
+        {
+            return false;
+        }
+
+        // checksum the id, count and payload where they sit in the ring
+        Checksum checksum;
+        for(size_t offset = 2; offset < length;)
+        {
+            size_t span = 0;
+            const uint8_t* data = _ring.readSpan(offset, span);
+            if(span > length - offset)
+            {
+                span = length - offset;
+            }
+            checksum.update(data, span);
+            offset += span;
+        }
+
+        if(checksum.first != _ring[length] || checksum.second != _ring[length + 1])
+        {
+            _checksum_failures++;
+            _ring.consume(1);
+            continue;
+        }
+
+        message.id = _ring[2];
+        message.count = static_cast<uint8_t>(count);
+        _ring.copyOut(HEADER_LENGTH, message.payload, count);
+        _ring.consume(length + CHECKSUM_LENGTH);
+        _messages++;
+        return true;
+    }
+
+    return false;
+}
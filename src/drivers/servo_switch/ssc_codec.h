@@ -0,0 +1,162 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#ifndef SSC_CODEC_H_
+#define SSC_CODEC_H_
+
+/* STL Headers */
+#include <array>
+
+/* C Headers */
+#include <stdint.h>
+#include <stddef.h>
+
+/* Project Headers */
+#include "ByteRing.h"
+
+/**
+ * @brief Encodes and decodes messages for the Microbotics servo switch/controller (SSC).
+ *
+ * Every message is 0x81 0xA1, an id, a payload byte count, the payload and two
+ * checksum bytes (section 4.2 of the February 2, 2007 SSC Manual). The checksum
+ * is a Fletcher style running sum over the id, count and payload.
+ *
+ * Everything works on fixed size buffers, nothing here allocates.
+ */
+namespace SSC
+{
+static const uint8_t FIRST_SYNC_BYTE = 0x81;
+static const uint8_t SECOND_SYNC_BYTE = 0xA1;
+static const size_t HEADER_LENGTH = 4;
+static const size_t CHECKSUM_LENGTH = 2;
+static const size_t MAX_PAYLOAD_LENGTH = 255;
+static const size_t MAX_MESSAGE_LENGTH = HEADER_LENGTH + MAX_PAYLOAD_LENGTH + CHECKSUM_LENGTH;
+
+/// the number of channels the servo switch reads and drives
+static const size_t NUM_CHANNELS = 9;
+typedef std::array<uint16_t, NUM_CHANNELS> Pulses;
+
+/**
+ * The running checksum, starting from zero and fed the id, count and payload
+ * it gives the two checksum bytes sent at the end of a message.
+ */
+struct Checksum
+{
+    uint8_t first;
+    uint8_t second;
+
+    Checksum()
+    :first(0),
+     second(0)
+    {}
+
+    void update(const uint8_t* data, size_t length)
+    {
+        for(size_t i = 0; i < length; i++)
+        {
+            first += data[i];
+            second += first;
+        }
+    }
+
+    void update(uint8_t byte)
+    {
+        update(&byte, 1);
+    }
+};
+
+/// a decoded message, the payload is only valid up to count
+struct Message
+{
+    uint8_t id;
+    uint8_t count;
+    uint8_t payload[MAX_PAYLOAD_LENGTH];
+};
+
+/**
+ * Writes a complete message to out, which must hold at least HEADER_LENGTH +
+ * count + CHECKSUM_LENGTH bytes. Returns the number of bytes written.
+ */
+size_t encode(uint8_t id, const uint8_t* payload, uint8_t count, uint8_t* out);
+
+/**
+ * Writes a pulse command (id 20) for the given pulse widths in microseconds
+ * to out, which must hold MAX_MESSAGE_LENGTH bytes. Returns the number of bytes written.
+ */
+size_t encodePulseCommand(const uint16_t* pulses, size_t channels, uint8_t* out);
+
+/**
+ * Updates inputs from a pulse inputs message (id 13). Widths outside of the
+ * valid range keep their previous value, channel 8 is always taken as is.
+ */
+void decodePulseInputs(const Message& message, Pulses& inputs);
+
+/**
+ * @brief Splits bytes read from the servo switch in to messages.
+ *
+ * Read straight in to writeSpan() and commit() the number of bytes read, then
+ * call next() until it returns false.
+ */
+class Framer
+{
+public:
+    Framer();
+
+    /// see ByteRing::writeSpan
+    uint8_t* writeSpan(size_t& len)
+    {
+        return _ring.writeSpan(len);
+    }
+
+    /// see ByteRing::commit, negative values (failed reads) are ignored
+    void commit(int n)
+    {
+        if(n > 0)
+        {
+            _ring.commit(n);
+        }
+    }
+
+    /// copies bytes in to the framer, returns the number accepted
+    size_t write(const uint8_t* data, size_t n)
+    {
+        return _ring.write(data, n);
+    }
+
+    /// decodes the next complete message in to message, returns false if there isn't one yet
+    bool next(Message& message);
+
+    void reset()
+    {
+        _ring.clear();
+    }
+
+    /// the number of messages returned by next()
+    uint64_t messages() const
+    {
+        return _messages;
+    }
+
+    /// the number of messages thrown away because their checksum didn't match
+    uint64_t checksumFailures() const
+    {
+        return _checksum_failures;
+    }
+
+private:
+    /// holds several messages so one read can drain the port
+    ByteRing<1024> _ring;
+
+    uint64_t _messages;
+    uint64_t _checksum_failures;
+
+    /// drops bytes until the ring starts with the sync bytes, returns false if more bytes are needed
+    bool sync();
+};
+}
+
+#endif /* SSC_CODEC_H_ */
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "ssc_codec.h"
+#include "AllocationCounter.h"
+#include "Benchmark.h"
+
+/* STL Headers */
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+const uint8_t STATUS = 10;
+const uint8_t PULSE_INPUTS = 13;
+
+/**
+ * There is no servo switch recording in recorded_data yet, so this builds the
+ * stream the board sends: a pulse input message for every status message,
+ * with the sticks moving.
+ */
+std::vector<uint8_t> board_stream(int messages)
+{
+    std::vector<uint8_t> stream;
+    uint8_t out[SSC::MAX_MESSAGE_LENGTH];
+    for(int i = 0; i < messages; i++)
+    {
+        uint8_t payload[20];
+        for(int ch = 0; ch < 10; ch++)
+        {
+            uint16_t width = 1000 + (i * 7 + ch * 100) % 1000;
+            payload[ch * 2] = width >> 8;
+            payload[ch * 2 + 1] = width & 0xFF;
+        }
+
+        size_t length = (i % 2 == 0) ? SSC::encode(PULSE_INPUTS, payload, sizeof(payload), out)
+                                     : SSC::encode(STATUS, payload, 2, out);
+        stream.insert(stream.end(), out, out + length);
+    }
+    return stream;
+}
+}
+
+BENCHMARK(SSCCodec, DecodeBoardStream)
+{
+    std::vector<uint8_t> stream = board_stream(20000);
+    SSC::Framer framer;
+    SSC::Message message;
+    SSC::Pulses inputs;
+    inputs.fill(0);
+
+    uint64_t messages = 0;
+    uint64_t allocations = AllocationCounter::allocations();
+    uint64_t start = Benchmark::nowNanos();
+    for(size_t offset = 0; offset < stream.size();)
+    {
+        // a serial read hands over a few dozen bytes at a time
+        size_t space = 0;
+        uint8_t* dst = framer.writeSpan(space);
+        space = std::min<size_t>(std::min<size_t>(space, 64), stream.size() - offset);
+        std::copy(stream.begin() + offset, stream.begin() + offset + space, dst);
+        framer.commit(space);
+        offset += space;
+
+        while(framer.next(message))
+        {
+            if(message.id == PULSE_INPUTS)
+            {
+                SSC::decodePulseInputs(message, inputs);
+            }
+            messages++;
+        }
+    }
+    uint64_t elapsed = Benchmark::nowNanos() - start;
+    allocations = AllocationCounter::allocations() - allocations;
+
+    bench.reportPackets(messages, stream.size(), elapsed, allocations);
+}
+
+BENCHMARK(SSCCodec, EncodePulseCommand)
+{
+    const int COMMANDS = 100000;
+    uint16_t pulses[SSC::NUM_CHANNELS] = {1500, 1500, 1100, 1500, 1500, 1500, 1500, 1500, 1500};
+    uint8_t out[SSC::MAX_MESSAGE_LENGTH];
+    uint64_t bytes = 0;
+
+    uint64_t allocations = AllocationCounter::allocations();
+    uint64_t start = Benchmark::nowNanos();
+    for(int i = 0; i < COMMANDS; i++)
+    {
+        pulses[2] = 1100 + i % 800;
+        bytes += SSC::encodePulseCommand(pulses, SSC::NUM_CHANNELS, out);
+    }
+    uint64_t elapsed = Benchmark::nowNanos() - start;
+    allocations = AllocationCounter::allocations() - allocations;
+
+    bench.reportPackets(COMMANDS, bytes, elapsed, allocations);
+}
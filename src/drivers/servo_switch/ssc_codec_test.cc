@@ -0,0 +1,222 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "ssc_codec.h"
+#include "AllocationCounter.h"
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace
+{
+const uint8_t PULSE_INPUTS = 13;
+
+/// a pty pair, the master end plays the servo board and the slave end is the port the driver opens
+struct Loopback
+{
+    int board;
+    int port;
+
+    Loopback()
+    :board(-1),
+     port(-1)
+    {
+        board = posix_openpt(O_RDWR | O_NOCTTY);
+        if(board < 0 || grantpt(board) != 0 || unlockpt(board) != 0)
+        {
+            return;
+        }
+
+        port = open(ptsname(board), O_RDWR | O_NOCTTY);
+        if(port < 0)
+        {
+            return;
+        }
+
+        termios settings;
+        tcgetattr(port, &settings);
+        cfmakeraw(&settings);
+        tcsetattr(port, TCSANOW, &settings);
+    }
+
+    ~Loopback()
+    {
+        if(port >= 0) close(port);
+        if(board >= 0) close(board);
+    }
+
+    bool ok() const
+    {
+        return board >= 0 && port >= 0;
+    }
+};
+
+/// reads everything available on fd in to the framer, waiting up to 100ms for the first byte
+bool fill(int fd, SSC::Framer& framer)
+{
+    pollfd p = {fd, POLLIN, 0};
+    if(poll(&p, 1, 100) <= 0)
+    {
+        return false;
+    }
+
+    size_t space = 0;
+    uint8_t* dst = framer.writeSpan(space);
+    int amt = read(fd, dst, space);
+    framer.commit(amt);
+    return amt > 0;
+}
+
+std::vector<uint8_t> pulse_inputs_message(const uint16_t (&widths)[9])
+{
+    // the board sends channel 8 first, then channels 1 through 8
+    uint8_t payload[20];
+    payload[0] = widths[7] >> 8;
+    payload[1] = widths[7] & 0xFF;
+    for(int i = 0; i < 9; i++)
+    {
+        payload[2 + i * 2] = widths[i] >> 8;
+        payload[3 + i * 2] = widths[i] & 0xFF;
+    }
+
+    uint8_t out[SSC::MAX_MESSAGE_LENGTH];
+    size_t length = SSC::encode(PULSE_INPUTS, payload, sizeof(payload), out);
+    return std::vector<uint8_t>(out, out + length);
+}
+}
+
+TEST(SSCCodec, ChecksumMatchesManual)
+{
+    // section 4.2: first = id + count + sum(payload), second = 2 * id + count + running sums
+    const uint8_t payload[] = {1, 2, 3, 200};
+    uint8_t out[SSC::MAX_MESSAGE_LENGTH];
+    size_t length = SSC::encode(20, payload, sizeof(payload), out);
+
+    uint8_t first = 20 + 4, second = 2 * 20 + 4;
+    for(uint8_t b : payload)
+    {
+        first += b;
+        second += first;
+    }
+
+    ASSERT_EQ(10u, length);
+    EXPECT_EQ(first, out[8]);
+    EXPECT_EQ(second, out[9]);
+}
+
+TEST(SSCCodec, PulseCommandRoundTrip)
+{
+    const uint16_t pulses[9] = {1000, 1100, 1200, 1300, 1400, 1500, 1600, 1700, 1800};
+    uint8_t out[SSC::MAX_MESSAGE_LENGTH];
+    size_t length = SSC::encodePulseCommand(pulses, 9, out);
+
+    SSC::Framer framer;
+    SSC::Message message;
+    framer.write(out, length);
+    ASSERT_TRUE(framer.next(message));
+    EXPECT_EQ(20, message.id);
+    ASSERT_EQ(18, message.count);
+    for(int i = 0; i < 9; i++)
+    {
+        EXPECT_EQ(pulses[i], (message.payload[i * 2] << 8) | message.payload[i * 2 + 1]);
+    }
+}
+
+TEST(SSCCodec, PtyLoopback)
+{
+    Loopback loopback;
+    if(! loopback.ok())
+    {
+        return; // no ptys available
+    }
+
+    // the board sends pulse inputs, with some line noise and a corrupt message thrown in
+    const uint16_t widths[9] = {1100, 1200, 1300, 1400, 1500, 1600, 1700, 1234, 1900};
+    std::vector<uint8_t> good = pulse_inputs_message(widths);
+    std::vector<uint8_t> bad = good;
+    bad[6] ^= 0x55;
+
+    std::vector<uint8_t> stream = {0x00, 0x81, 0x00, 0xA1};
+    stream.insert(stream.end(), bad.begin(), bad.end());
+    for(int i = 0; i < 20; i++)
+    {
+        stream.insert(stream.end(), good.begin(), good.end());
+    }
+
+    // written in odd sized pieces so messages straddle reads
+    for(size_t offset = 0; offset < stream.size(); offset += 17)
+    {
+        size_t n = std::min<size_t>(17, stream.size() - offset);
+        ASSERT_EQ((ssize_t) n, write(loopback.board, &stream[offset], n));
+    }
+
+    SSC::Framer framer;
+    SSC::Message message;
+    SSC::Pulses inputs;
+    inputs.fill(0);
+    int decoded = 0;
+
+    uint64_t allocations = AllocationCounter::allocations();
+    while(decoded < 20 && fill(loopback.port, framer))
+    {
+        while(framer.next(message))
+        {
+            ASSERT_EQ(PULSE_INPUTS, message.id);
+            SSC::decodePulseInputs(message, inputs);
+            decoded++;
+        }
+    }
+    allocations = AllocationCounter::allocations() - allocations;
+
+    EXPECT_EQ(20, decoded);
+    EXPECT_EQ(1u, framer.checksumFailures());
+    EXPECT_EQ(0u, allocations);
+    // the board only reports the eight receiver channels
+    for(int i = 0; i < 8; i++)
+    {
+        EXPECT_EQ(widths[i], inputs[i]) << "channel " << i + 1;
+    }
+
+    // and the pulse command goes back the other way
+    const uint16_t pulses[9] = {1000, 1100, 1200, 1300, 1400, 1500, 1600, 1700, 1800};
+    uint8_t out[SSC::MAX_MESSAGE_LENGTH];
+    size_t length = SSC::encodePulseCommand(pulses, 9, out);
+    ASSERT_EQ((ssize_t) length, write(loopback.port, out, length));
+
+    SSC::Framer board;
+    ASSERT_TRUE(fill(loopback.board, board));
+    ASSERT_TRUE(board.next(message));
+    EXPECT_EQ(20, message.id);
+    EXPECT_EQ(0, memcmp(out + SSC::HEADER_LENGTH, message.payload, message.count));
+}
+
+TEST(SSCCodec, OutOfRangeInputsKeepLastValue)
+{
+    const uint16_t widths[9] = {1100, 100, 3000, 1400, 1500, 1600, 1700, 42, 1900};
+    std::vector<uint8_t> bytes = pulse_inputs_message(widths);
+
+    SSC::Framer framer;
+    SSC::Message message;
+    framer.write(&bytes[0], bytes.size());
+    ASSERT_TRUE(framer.next(message));
+
+    SSC::Pulses inputs;
+    inputs.fill(1500);
+    SSC::decodePulseInputs(message, inputs);
+
+    EXPECT_EQ(1100, inputs[0]);
+    EXPECT_EQ(1500, inputs[1]);
+    EXPECT_EQ(1500, inputs[2]);
+    EXPECT_EQ(42, inputs[7]);
+}
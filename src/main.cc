@@ -31,8 +31,11 @@
  */
 
 
+#include <fstream>
 #include <string>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <sys/types.h>
 #include <unistd.h>
 
@@ -42,6 +45,10 @@
 #include "SystemInformation.h"
 #include "Debug.h"
 #include "LogFile.h"
+#include "BinaryLog.h"
+#include "LogExtract.h"
+#include "Benchmark.h"
+#include "Replay.h"
 
 #include <gtest/gtest.h>
 
@@ -59,6 +66,10 @@ int main(int argc, char* argv[])
 
     printf("Usage: autopilot [-override_param=value ...]\n");
     printf("Usage: autopilot test\t(for running unittests)\n");
+    printf("Usage: autopilot bench [filter] [--json file]\t(for running benchmarks)\n");
+    printf("Usage: autopilot replay file [speed] [baud]\t(plays a recording down a pty)\n");
+    printf("Usage: autopilot logconvert file.udlog...\t(writes binary logs out as .dat text)\n");
+    printf("Usage: autopilot logextract start_s end_s out.dat file...\t(writes a time range of logs, merged by time)\n");
     printf("PID is: %d\n", getpid());
     printf("Autopilot Version: %s %s\n", __DATE__, __TIME__);
 
@@ -74,6 +85,97 @@ int main(int argc, char* argv[])
         return 0;
     }
 
+    // run benchmarks if needed.
+    if(argc >= 2 && strcmp(argv[1], "bench") == 0)
+    {
+        std::string filter, json_path;
+        for(int i = 2; i < argc; i++)
+        {
+            if(strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+            {
+                json_path = argv[++i];
+            }
+            else
+            {
+                filter = argv[i];
+            }
+        }
+
+        Benchmark::runAll(filter, json_path);
+        return 0;
+    }
+
+    // play a recording down a pty another autopilot can open as its serial port.
+    if(argc >= 3 && strcmp(argv[1], "replay") == 0)
+    {
+        double speed = argc >= 4 ? atof(argv[3]) : 1.0;
+        int baud = argc >= 5 ? atoi(argv[4]) : 115200;
+
+        ReplayRecording recording;
+        if(! recording.load(argv[2], baud))
+        {
+            printf("Could not load %s\n", argv[2]);
+            return 1;
+        }
+
+        ReplayPty pty(recording, speed);
+        if(! pty.open())
+        {
+            printf("Could not open a pty\n");
+            return 1;
+        }
+
+        printf("Replaying %zu bytes at %gx on %s\n", recording.bytes(), speed, pty.path().c_str());
+        fflush(stdout);
+        pty.start();
+        pty.wait();
+        return 0;
+    }
+
+    // turn binary logs back in to the text analysis scripts expect.
+    if(argc >= 3 && strcmp(argv[1], "logconvert") == 0)
+    {
+        int failures = 0;
+        for(int i = 2; i < argc; i++)
+        {
+            std::string written = BinaryLog::convertFile(argv[i]);
+            if(written.empty())
+            {
+                printf("Could not convert %s\n", argv[i]);
+                failures++;
+            }
+            else
+            {
+                printf("%s -> %s\n", argv[i], written.c_str());
+            }
+        }
+        return failures == 0 ? 0 : 1;
+    }
+
+    // write the records between two times, in seconds since the logs began, to one file.
+    if(argc >= 6 && strcmp(argv[1], "logextract") == 0)
+    {
+        LogExtract extract(static_cast<int64_t>(atof(argv[2]) * 1e6), static_cast<int64_t>(atof(argv[3]) * 1e6));
+        for(int i = 5; i < argc; i++)
+        {
+            if(! extract.add(argv[i]))
+            {
+                printf("Could not read %s\n", argv[i]);
+                return 1;
+            }
+        }
+
+        std::ofstream output(argv[4], std::ofstream::out | std::ofstream::binary);
+        extract.write(output);
+        if(! output)
+        {
+            printf("Could not write %s\n", argv[4]);
+            return 1;
+        }
+        printf("%s\n", argv[4]);
+        return 0;
+    }
+
     LogFile::getInstance();
 
 
@@ -0,0 +1,196 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#include "AllocationCounter.h"
+#include "Debug.h"
+
+/* STL Headers */
+#include <atomic>
+#include <exception>
+#include <new>
+#include <sstream>
+
+/* C Headers */
+#include <stdlib.h>
+#ifdef __linux__
+#include <execinfo.h>
+#endif
+
+const int NoAllocationRegion::STACK_DEPTH;
+
+namespace
+{
+// plain integers so reading them never allocates or needs a thread_local constructor
+thread_local uint64_t allocation_count = 0;
+thread_local uint64_t deallocation_count = 0;
+
+/// open NoAllocationRegions on this thread and what they've seen
+thread_local int region_depth = 0;
+thread_local uint64_t region_allocations = 0;
+thread_local NoAllocationRegion::Violation region_violation;
+/// set while taking the stack, which can allocate the first time
+thread_local bool taking_stack = false;
+
+std::atomic<NoAllocationRegion::Handler> region_handler(&NoAllocationRegion::logViolation);
+
+void region_allocated(size_t size)
+{
+    if(region_allocations++ > 0 || taking_stack)
+    {
+        return;
+    }
+
+    taking_stack = true;
+    region_violation.first_size = size;
+#ifdef __linux__
+    region_violation.stack_depth = backtrace(region_violation.stack, NoAllocationRegion::STACK_DEPTH);
+#else
+    region_violation.stack_depth = 0;
+#endif
+    taking_stack = false;
+}
+
+void* counted_malloc(size_t size)
+{
+    allocation_count++;
+    if(region_depth > 0)
+    {
+        region_allocated(size);
+    }
+    return malloc(size == 0 ? 1 : size);
+}
+
+void counted_free(void* ptr)
+{
+    if(ptr != nullptr)
+    {
+        deallocation_count++;
+        free(ptr);
+    }
+}
+}
+
+uint64_t AllocationCounter::allocations()
+{
+    return allocation_count;
+}
+
+uint64_t AllocationCounter::deallocations()
+{
+    return deallocation_count;
+}
+
+NoAllocationRegion::NoAllocationRegion(const char* name)
+{
+    if(region_depth++ == 0)
+    {
+        region_allocations = 0;
+        region_violation.region = name;
+    }
+    _start = region_allocations;
+}
+
+NoAllocationRegion::~NoAllocationRegion()
+{
+    if(--region_depth > 0 || region_allocations == 0 || std::uncaught_exception())
+    {
+        return;
+    }
+
+    Violation violation = region_violation;
+    violation.allocations = region_allocations;
+    region_handler.load()(violation);
+}
+
+uint64_t NoAllocationRegion::allocations() const
+{
+    return region_allocations - _start;
+}
+
+NoAllocationRegion::Handler NoAllocationRegion::setHandler(Handler handler)
+{
+    return region_handler.exchange(handler);
+}
+
+void NoAllocationRegion::logViolation(const Violation& violation)
+{
+    static const Logger log("NoAllocationRegion");
+    log.warning() << describe(violation);
+}
+
+std::string NoAllocationRegion::describe(const Violation& violation)
+{
+    std::ostringstream out;
+    out << violation.region << " allocated " << violation.allocations
+        << (violation.allocations == 1 ? " time" : " times")
+        << ", first " << violation.first_size << " bytes";
+
+#ifdef __linux__
+    char** symbols = backtrace_symbols(violation.stack, violation.stack_depth);
+    // the first frame is region_allocated
+    for(int i = 1; i < violation.stack_depth; i++)
+    {
+        out << "\n    ";
+        if(symbols != nullptr)
+        {
+            out << symbols[i];
+        }
+        else
+        {
+            out << violation.stack[i];
+        }
+    }
+    free(symbols);
+#endif
+
+    return out.str();
+}
+
+void* operator new(size_t size)
+{
+    void* ptr = counted_malloc(size);
+    if(ptr == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return counted_malloc(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return counted_malloc(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    counted_free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    counted_free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+    counted_free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+    counted_free(ptr);
+}
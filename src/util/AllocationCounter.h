@@ -0,0 +1,100 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#ifndef ALLOCATION_COUNTER_H_
+#define ALLOCATION_COUNTER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+/**
+ * Counts heap allocations made through the global operator new, which
+ * AllocationCounter.cc replaces for the whole autopilot.
+ *
+ * Counts are kept per thread so tests and benchmarks can measure just the
+ * code they run without the other drivers' threads getting in the way.
+ *
+ * @code
+ * uint64_t before = AllocationCounter::allocations();
+ * do_work();
+ * EXPECT_EQ(0u, AllocationCounter::allocations() - before);
+ * @endcode
+ */
+namespace AllocationCounter
+{
+/// the number of calls to operator new made by the calling thread
+uint64_t allocations();
+
+/// the number of calls to operator delete made by the calling thread
+uint64_t deallocations();
+}
+
+/**
+ * Marks code that must not allocate, like the control tick and the servo
+ * output after it. Every operator new on the thread while a region is open
+ * counts against it, and the first one is remembered with the calls that led
+ * to it.
+ *
+ * When the outermost region on a thread closes with allocations in it the
+ * handler is called, after the region is closed so it may allocate. The
+ * default one logs a warning with the stack, tests install one that fails.
+ * A region closed by an exception doesn't report, throwing allocates.
+ *
+ * @code
+ * {
+ *     NoAllocationRegion region("control tick");
+ *     (*control)(state);
+ *     helicopter->setScaled(control->get_control_effort(state));
+ * }
+ * @endcode
+ */
+class NoAllocationRegion
+{
+public:
+    /// the most calls remembered for the first allocation
+    static const int STACK_DEPTH = 16;
+
+    /// what a region that allocated reports
+    struct Violation
+    {
+        /// the outermost region's name
+        const char* region;
+        uint64_t allocations;
+        /// the size asked for by the first allocation
+        size_t first_size;
+        /// return addresses leading to the first allocation, innermost first
+        void* stack[STACK_DEPTH];
+        int stack_depth;
+    };
+
+    typedef void (*Handler)(const Violation& violation);
+
+    /// name should be a string literal, it is kept rather than copied
+    explicit NoAllocationRegion(const char* name);
+    ~NoAllocationRegion();
+
+    /// allocations on this thread since this region opened
+    uint64_t allocations() const;
+
+    /// replaces the handler for every thread, returns the old one
+    static Handler setHandler(Handler handler);
+
+    /// the handler in use when nothing else was set
+    static void logViolation(const Violation& violation);
+
+    /// the violation as text, the stack one call to a line with symbols where they can be found
+    static std::string describe(const Violation& violation);
+
+private:
+    NoAllocationRegion(const NoAllocationRegion&);
+    NoAllocationRegion& operator=(const NoAllocationRegion&);
+
+    uint64_t _start;
+};
+
+#endif /* ALLOCATION_COUNTER_H_ */
@@ -0,0 +1,132 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "AllocationCounter.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+TEST(AllocationCounter, CountsNewAndDelete)
+{
+    uint64_t allocations = AllocationCounter::allocations();
+    uint64_t deallocations = AllocationCounter::deallocations();
+
+    std::unique_ptr<int> value(new int(4));
+    EXPECT_EQ(allocations + 1, AllocationCounter::allocations());
+
+    value.reset();
+    EXPECT_EQ(deallocations + 1, AllocationCounter::deallocations());
+}
+
+TEST(AllocationCounter, CountsPerThread)
+{
+    uint64_t allocations = AllocationCounter::allocations();
+
+    std::thread other([]()
+    {
+        delete new int(2);
+    });
+    other.join();
+
+    // creating the thread allocates here, but the thread's own new does not count here
+    uint64_t after = AllocationCounter::allocations();
+    std::unique_ptr<int> value(new int(4));
+    EXPECT_EQ(after + 1, AllocationCounter::allocations());
+    EXPECT_GE(after, allocations);
+}
+
+namespace
+{
+/// new that the optimiser can't pair with its delete and remove
+int* volatile allocated;
+
+void allocateInt()
+{
+    allocated = new int(1);
+    delete allocated;
+}
+
+int reports = 0;
+NoAllocationRegion::Violation reported;
+
+void countReport(const NoAllocationRegion::Violation& violation)
+{
+    reports++;
+    reported = violation;
+}
+
+/// installs countReport for the length of a test
+class RegionReports
+{
+public:
+    RegionReports()
+    :_previous(NoAllocationRegion::setHandler(&countReport))
+    {
+        reports = 0;
+    }
+
+    ~RegionReports()
+    {
+        NoAllocationRegion::setHandler(_previous);
+    }
+
+private:
+    NoAllocationRegion::Handler _previous;
+};
+}
+
+TEST(NoAllocationRegion, QuietWhenNothingAllocates)
+{
+    RegionReports watch;
+    {
+        NoAllocationRegion region("empty");
+        int value = 4;
+        EXPECT_EQ(0u, region.allocations());
+        EXPECT_EQ(4, value);
+    }
+    EXPECT_EQ(0, reports);
+}
+
+TEST(NoAllocationRegion, ReportsOnceForTheOutermostRegion)
+{
+    RegionReports watch;
+    {
+        NoAllocationRegion outer("outer");
+        allocateInt();
+        {
+            NoAllocationRegion inner("inner");
+            allocateInt();
+            allocateInt();
+            EXPECT_EQ(2u, inner.allocations());
+        }
+        EXPECT_EQ(0, reports);
+        EXPECT_EQ(3u, outer.allocations());
+    }
+
+    ASSERT_EQ(1, reports);
+    EXPECT_STREQ("outer", reported.region);
+    EXPECT_EQ(3u, reported.allocations);
+    EXPECT_EQ(sizeof(int), reported.first_size);
+
+    std::string description(NoAllocationRegion::describe(reported));
+    EXPECT_EQ(0u, description.find("outer allocated 3 times, first 4 bytes"));
+}
+
+TEST(NoAllocationRegion, QuietWhenUnwinding)
+{
+    RegionReports watch;
+    try
+    {
+        NoAllocationRegion region("throws");
+        throw std::runtime_error("allocates");
+    }
+    catch(std::runtime_error&)
+    {
+    }
+    EXPECT_EQ(0, reports);
+}
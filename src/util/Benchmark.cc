@@ -0,0 +1,182 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#include "Benchmark.h"
+
+/* STL Headers */
+#include <fstream>
+#include <cmath>
+#include <iterator>
+#include <utility>
+
+/* C Headers */
+#include <stdio.h>
+
+namespace
+{
+typedef std::vector<std::pair<std::string, Benchmark::Function>> Registry;
+
+/// function local so registration from static initializers in other files is safe
+Registry& registry()
+{
+    static Registry benchmarks;
+    return benchmarks;
+}
+}
+
+Benchmark::Benchmark(const std::string& name)
+    :_name(name)
+{
+}
+
+bool Benchmark::add(const std::string& name, Function fn)
+{
+    registry().push_back(std::make_pair(name, fn));
+    return true;
+}
+
+int Benchmark::runAll(const std::string& filter, const std::string& json_path)
+{
+    std::vector<Benchmark> finished;
+    for(auto& entry : registry())
+    {
+        if(! filter.empty() && entry.first.find(filter) == std::string::npos)
+        {
+            continue;
+        }
+
+        printf("[ RUN      ] %s\n", entry.first.c_str());
+        Benchmark bench(entry.first);
+        entry.second(bench);
+        printf("[     DONE ] %s\n", entry.first.c_str());
+        finished.push_back(bench);
+    }
+
+    printf("%zu benchmark(s) run\n", finished.size());
+
+    if(! json_path.empty())
+    {
+        if(writeJson(json_path, finished))
+        {
+            printf("results written to %s\n", json_path.c_str());
+        }
+        else
+        {
+            printf("could not write results to %s\n", json_path.c_str());
+        }
+    }
+
+    return finished.size();
+}
+
+void Benchmark::report(const std::string& metric, double value, const std::string& units)
+{
+    printf("    %-32s %16.3f %s\n", metric.c_str(), value, units.c_str());
+    Result result = {metric, value, units};
+    _results.push_back(result);
+}
+
+void Benchmark::reportPackets(uint64_t packets, uint64_t bytes, uint64_t elapsed_ns, uint64_t allocations)
+{
+    if(packets == 0 || elapsed_ns == 0)
+    {
+        skip("nothing was parsed");
+        return;
+    }
+
+    report("packets", packets, "packets");
+    report("ns_per_packet", (double) elapsed_ns / packets, "ns/packet");
+    report("allocations_per_packet", (double) allocations / packets, "allocations/packet");
+    report("bytes_per_second", bytes / (elapsed_ns / 1e9), "B/s");
+}
+
+void Benchmark::skip(const std::string& reason)
+{
+    printf("    skipped: %s\n", reason.c_str());
+    _skipped = reason;
+}
+
+namespace
+{
+/// benchmark names, metrics and units are all plain identifiers but escape anyway
+std::string json_string(const std::string& text)
+{
+    std::string quoted = "\"";
+    for(char c : text)
+    {
+        if(c == '"' || c == '\\')
+        {
+            quoted += '\\';
+        }
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+}
+
+bool Benchmark::writeJson(const std::string& path, const std::vector<Benchmark>& benchmarks)
+{
+    std::ofstream out(path.c_str());
+    if(! out)
+    {
+        return false;
+    }
+
+    out.precision(17);
+    out << "{\n  \"version\": " << json_string(__DATE__ " " __TIME__) << ",\n  \"benchmarks\": [";
+    for(size_t i = 0; i < benchmarks.size(); i++)
+    {
+        const Benchmark& bench = benchmarks[i];
+        out << (i == 0 ? "\n" : ",\n") << "    {\"name\": " << json_string(bench._name);
+        if(! bench._skipped.empty())
+        {
+            out << ", \"skipped\": " << json_string(bench._skipped);
+        }
+
+        out << ", \"metrics\": {";
+        for(size_t j = 0; j < bench._results.size(); j++)
+        {
+            const Result& result = bench._results[j];
+            // JSON has no NaN or infinity
+            double value = std::isfinite(result.value) ? result.value : 0;
+            out << (j == 0 ? "" : ", ") << json_string(result.metric)
+                << ": {\"value\": " << value << ", \"units\": " << json_string(result.units) << "}";
+        }
+        out << "}}";
+    }
+    out << "\n  ]\n}\n";
+
+    return out.good();
+}
+
+std::string Benchmark::recordedDataPath(const std::string& file)
+{
+    const char* prefixes[] = {"recorded_data/", "../recorded_data/"};
+    for(const char* prefix : prefixes)
+    {
+        std::string path = prefix + file;
+        if(std::ifstream(path.c_str()).good())
+        {
+            return path;
+        }
+    }
+
+    return "";
+}
+
+bool Benchmark::readRecordedData(const std::string& file, std::vector<uint8_t>& data)
+{
+    std::string path = recordedDataPath(file);
+    if(path.empty())
+    {
+        return false;
+    }
+
+    std::ifstream in(path.c_str(), std::ios::binary);
+    data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return ! data.empty();
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+/* STL Headers */
+#include <string>
+#include <vector>
+#include <functional>
+#include <chrono>
+
+/* C Headers */
+#include <stdint.h>
+
+/**
+ * A small registry of benchmarks, run with `autopilot bench [filter]`.
+ *
+ * Benchmarks live next to the code they measure, like the unit tests do, and
+ * report whatever numbers make sense for them through report(). Parsers should
+ * also call reportPackets() so every parser is tracked by the same three numbers.
+ * `make bench` runs them all and saves the results as JSON in build/bench.json
+ * so one release can be compared against the next.
+ *
+ * @code
+ * BENCHMARK(GX3Framer, RecordedData)
+ * {
+ *     std::vector<uint8_t> data;
+ *     if(! Benchmark::readRecordedData("imu_data.bin", data))
+ *     {
+ *         bench.skip("no recorded data");
+ *         return;
+ *     }
+ *     ...
+ *     bench.report("packets_per_second", packets / seconds, "packets/s");
+ * }
+ * @endcode
+ */
+class Benchmark
+{
+public:
+    typedef std::function<void(Benchmark&)> Function;
+
+    /// registers a benchmark, returns true so it can be used in a static initializer
+    static bool add(const std::string& name, Function fn);
+
+    /**
+     * Runs every benchmark whose name contains filter (all of them if it is
+     * empty), returns the number that were run. If json_path isn't empty the
+     * results are also written there.
+     */
+    static int runAll(const std::string& filter, const std::string& json_path = "");
+
+    /// records a result for the running benchmark
+    void report(const std::string& metric, double value, const std::string& units);
+
+    /**
+     * Reports the standard parser numbers, ns_per_packet, allocations_per_packet
+     * and bytes_per_second, for packets packets totalling bytes bytes that took
+     * elapsed_ns and made allocations heap allocations.
+     */
+    void reportPackets(uint64_t packets, uint64_t bytes, uint64_t elapsed_ns, uint64_t allocations);
+
+    /// marks the running benchmark as skipped
+    void skip(const std::string& reason);
+
+    const std::string& name() const
+    {
+        return _name;
+    }
+
+    /// finds a file in the recorded_data directory whether running from the root or build directory
+    static std::string recordedDataPath(const std::string& file);
+
+    /// reads an entire file from recorded_data, returns false if it doesn't exist
+    static bool readRecordedData(const std::string& file, std::vector<uint8_t>& data);
+
+    /// a monotonic timestamp in nanoseconds for timing sections of a benchmark
+    static uint64_t nowNanos()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    Benchmark(const std::string& name);
+
+    struct Result
+    {
+        std::string metric;
+        double value;
+        std::string units;
+    };
+
+    /// writes every benchmark's results to path, returns false if it couldn't
+    static bool writeJson(const std::string& path, const std::vector<Benchmark>& benchmarks);
+
+    std::string _name;
+    std::vector<Result> _results;
+    std::string _skipped;
+};
+
+#define BENCHMARK_FUNCTION_NAME(group, name) group##_##name##_Benchmark
+
+/**
+ * Defines and registers a benchmark, the body receives a Benchmark& named bench.
+ */
+#define BENCHMARK(group, name) \
+    static void BENCHMARK_FUNCTION_NAME(group, name)(Benchmark& bench); \
+    static bool group##_##name##_registered __attribute__((unused)) = \
+        Benchmark::add(#group "." #name, BENCHMARK_FUNCTION_NAME(group, name)); \
+    static void BENCHMARK_FUNCTION_NAME(group, name)(Benchmark& bench)
+
+#endif /* BENCHMARK_H_ */
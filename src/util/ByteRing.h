@@ -0,0 +1,176 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#pragma once
+#ifndef BYTE_RING_H
+#define BYTE_RING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <algorithm>
+
+/** A fixed capacity ring of bytes sitting between a serial port and a framer.
+
+The owner reads straight from the port in to the free space returned by
+writeSpan() and then calls commit() with the number of bytes it got, so a
+single read() can pull in everything the port has buffered. Framers look at
+the bytes in place with operator[] and find(), and copyOut() the ones they
+want before calling consume().
+
+The ring is not threadsafe, it is meant to be owned by a single reader thread.
+
+@code
+ByteRing<4096> ring;
+size_t space = 0;
+uint8_t* dst = ring.writeSpan(space);
+ring.commit(read(fd, dst, space));
+@endcode
+**/
+template <size_t Capacity>
+class ByteRing
+{
+    static_assert(Capacity != 0 && (Capacity & (Capacity - 1)) == 0, "ByteRing capacity must be a power of two");
+
+public:
+    ByteRing()
+    :_head(0),
+     _tail(0)
+    {}
+
+    /// the number of bytes waiting to be consumed
+    size_t size() const
+    {
+        return _tail - _head;
+    }
+
+    /// the number of bytes that can still be written
+    size_t available() const
+    {
+        return Capacity - size();
+    }
+
+    bool empty() const
+    {
+        return _tail == _head;
+    }
+
+    static size_t capacity()
+    {
+        return Capacity;
+    }
+
+    /// returns the byte at offset i from the oldest byte in the ring
+    uint8_t operator[](size_t i) const
+    {
+        return _data[(_head + i) & MASK];
+    }
+
+    /** Returns a pointer to the largest contiguous free region in the ring
+    and stores its length in len, len is 0 when the ring is full.
+    **/
+    uint8_t* writeSpan(size_t& len)
+    {
+        size_t idx = _tail & MASK;
+        len = std::min(Capacity - idx, available());
+        return &_data[idx];
+    }
+
+    /// marks n bytes written in to the span returned by writeSpan() as valid
+    void commit(size_t n)
+    {
+        _tail += std::min(n, available());
+    }
+
+    /// copies up to n bytes in to the ring, returns the number copied
+    size_t write(const uint8_t* src, size_t n)
+    {
+        size_t written = 0;
+        while(written < n && available() > 0)
+        {
+            size_t len = 0;
+            uint8_t* dst = writeSpan(len);
+            len = std::min(len, n - written);
+            memcpy(dst, src + written, len);
+            commit(len);
+            written += len;
+        }
+        return written;
+    }
+
+    /// drops the n oldest bytes in the ring
+    void consume(size_t n)
+    {
+        _head += std::min(n, size());
+    }
+
+    /// copies n bytes starting at offset to dst, returns the number copied
+    size_t copyOut(size_t offset, uint8_t* dst, size_t n) const
+    {
+        if(offset >= size())
+        {
+            return 0;
+        }
+
+        n = std::min(n, size() - offset);
+        size_t idx = (_head + offset) & MASK;
+        size_t first = std::min(n, Capacity - idx);
+        memcpy(dst, &_data[idx], first);
+        memcpy(dst + first, &_data[0], n - first);
+        return n;
+    }
+
+    /** Returns a pointer to the bytes starting at offset and stores the
+    number that are contiguous in memory in len, so callers can process the
+    ring in at most two pieces without copying.
+    **/
+    const uint8_t* readSpan(size_t offset, size_t& len) const
+    {
+        if(offset >= size())
+        {
+            len = 0;
+            return _data;
+        }
+
+        size_t idx = (_head + offset) & MASK;
+        len = std::min(size() - offset, Capacity - idx);
+        return &_data[idx];
+    }
+
+    /// returns the offset of the first byte equal to value at or after from, or size() if there is none
+    size_t find(uint8_t value, size_t from = 0) const
+    {
+        while(from < size())
+        {
+            size_t idx = (_head + from) & MASK;
+            size_t len = std::min(size() - from, Capacity - idx);
+            const void* hit = memchr(&_data[idx], value, len);
+            if(hit != nullptr)
+            {
+                return from + (static_cast<const uint8_t*>(hit) - &_data[idx]);
+            }
+            from += len;
+        }
+        return size();
+    }
+
+    void clear()
+    {
+        _head = _tail = 0;
+    }
+
+private:
+    static const size_t MASK = Capacity - 1;
+
+    /// total bytes consumed, only ever grows so size() is just the difference
+    size_t _head;
+    /// total bytes committed
+    size_t _tail;
+    uint8_t _data[Capacity];
+};
+
+#endif // BYTE_RING_H
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#include "Crc32.h"
+
+namespace
+{
+/// table[k][b] is the crc of byte b followed by k zero bytes
+struct Tables
+{
+    uint32_t table[8][256];
+
+    Tables()
+    {
+        for(uint32_t b = 0; b < 256; b++)
+        {
+            uint32_t crc = b;
+            for(int bit = 0; bit < 8; bit++)
+            {
+                crc = (crc & 1) ? (crc >> 1) ^ Crc32::POLYNOMIAL : crc >> 1;
+            }
+            table[0][b] = crc;
+        }
+
+        for(uint32_t b = 0; b < 256; b++)
+        {
+            for(int k = 1; k < 8; k++)
+            {
+                table[k][b] = (table[k - 1][b] >> 8) ^ table[0][table[k - 1][b] & 0xFF];
+            }
+        }
+    }
+};
+
+const Tables& tables()
+{
+    static const Tables t;
+    return t;
+}
+}
+
+uint32_t Crc32::update(uint32_t crc, const uint8_t* data, size_t length)
+{
+    const uint32_t (&t)[8][256] = tables().table;
+
+    while(length >= 8)
+    {
+        // bytes are assembled explicitly so this works regardless of host byte order
+        uint32_t low = crc ^ (data[0] | (data[1] << 8) | (data[2] << 16) | (static_cast<uint32_t>(data[3]) << 24));
+        uint32_t high = data[4] | (data[5] << 8) | (data[6] << 16) | (static_cast<uint32_t>(data[7]) << 24);
+
+        crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24] ^
+              t[3][high & 0xFF] ^ t[2][(high >> 8) & 0xFF] ^ t[1][(high >> 16) & 0xFF] ^ t[0][high >> 24];
+
+        data += 8;
+        length -= 8;
+    }
+
+    while(length-- > 0)
+    {
+        crc = (crc >> 8) ^ t[0][(crc ^ *data++) & 0xFF];
+    }
+
+    return crc;
+}
+
+uint32_t Crc32::updateBytewise(uint32_t crc, const uint8_t* data, size_t length)
+{
+    for(size_t i = 0; i < length; i++)
+    {
+        crc ^= data[i];
+        for(int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 1) ? (crc >> 1) ^ POLYNOMIAL : crc >> 1;
+        }
+    }
+    return crc;
+}
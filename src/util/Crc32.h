@@ -0,0 +1,39 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#ifndef CRC32_H_
+#define CRC32_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Table driven CRC-32 over the reflected 0xEDB88320 polynomial, eight bytes
+ * per step (slice-by-8).
+ *
+ * No initial value or final xor is applied, so it matches the checksum the
+ * NovAtel OEM6 appends to its binary messages. Because the state is just the
+ * running crc the checksum can be built up as bytes arrive:
+ *
+ * @code
+ * uint32_t crc = 0;
+ * crc = Crc32::update(crc, first_chunk, first_length);
+ * crc = Crc32::update(crc, second_chunk, second_length);
+ * @endcode
+ */
+namespace Crc32
+{
+static const uint32_t POLYNOMIAL = 0xEDB88320;
+
+/// continues crc over length more bytes of data
+uint32_t update(uint32_t crc, const uint8_t* data, size_t length);
+
+/// the one byte at a time version update() replaces, kept to check it against
+uint32_t updateBytewise(uint32_t crc, const uint8_t* data, size_t length);
+}
+
+#endif /* CRC32_H_ */
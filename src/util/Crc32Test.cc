@@ -0,0 +1,39 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "Crc32.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+TEST(Crc32, MatchesBytewise)
+{
+    std::vector<uint8_t> data(1000);
+    for(size_t i = 0; i < data.size(); i++)
+    {
+        data[i] = static_cast<uint8_t>(i * 131 + 7);
+    }
+
+    for(size_t length = 0; length < data.size(); length += 37)
+    {
+        EXPECT_EQ(Crc32::updateBytewise(0, &data[0], length), Crc32::update(0, &data[0], length));
+    }
+}
+
+TEST(Crc32, Incremental)
+{
+    const uint8_t data[] = "123456789abcdefghijklmnop";
+    size_t length = sizeof(data) - 1;
+
+    uint32_t whole = Crc32::update(0, data, length);
+    for(size_t split = 0; split <= length; split++)
+    {
+        uint32_t crc = Crc32::update(0, data, split);
+        EXPECT_EQ(whole, Crc32::update(crc, data + split, length - split));
+    }
+
+    // the standard check value once the usual inversion is applied
+    EXPECT_EQ(0xCBF43926u, ~Crc32::update(0xFFFFFFFF, data, 9));
+}
@@ -0,0 +1,185 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#include "DurableFile.h"
+
+/* STL Headers */
+#include <algorithm>
+
+/* C Headers */
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+size_t roundUp(size_t value, size_t multiple)
+{
+    return (value + multiple - 1) / multiple * multiple;
+}
+}
+
+const size_t DurableFile::BLOCK_SIZE;
+
+DurableFile::DurableFile(const std::string& path, const Policy& policy)
+    :_path(path),
+     _policy(policy),
+     _fd(open(path.c_str(), O_CREAT | O_WRONLY | O_APPEND | O_CLOEXEC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH)),
+     _new(false),
+     _staging(std::max(BLOCK_SIZE, roundUp(policy.write_bytes, BLOCK_SIZE))),
+     _staged(0),
+     _offset(0),
+     _allocated(0),
+     _firstUncommitted(0),
+     _uncommitted(0),
+     _writes(0),
+     _syncs(0)
+{
+    if(_fd < 0)
+    {
+        return;
+    }
+
+    struct stat info;
+    if(fstat(_fd, &info) == 0)
+    {
+        _offset = info.st_size;
+        _new = (info.st_size == 0);
+    }
+    _allocated = _offset;
+}
+
+DurableFile::~DurableFile()
+{
+    if(_fd < 0)
+    {
+        return;
+    }
+
+    commit(_firstUncommitted);
+
+    if(_allocated > _offset)
+    {
+        // hand back the unused end of the last extent, the file is whole without it
+        int truncated = ftruncate(_fd, _offset);
+        (void) truncated;
+    }
+    close(_fd);
+}
+
+bool DurableFile::append(const char* data, size_t length, uint64_t now_ms)
+{
+    if(_fd < 0)
+    {
+        return false;
+    }
+
+    if(length > 0 && _uncommitted == 0)
+    {
+        _firstUncommitted = now_ms;
+    }
+
+    bool ok = true;
+    while(length > 0)
+    {
+        size_t taken = std::min(length, _staging.size() - _staged);
+        memcpy(_staging.data() + _staged, data, taken);
+        _staged += taken;
+        _uncommitted += taken;
+        data += taken;
+        length -= taken;
+
+        if(_staged == _staging.size())
+        {
+            // everything up to the last block boundary, the rest waits for more
+            size_t aligned = (_offset + _staged) / BLOCK_SIZE * BLOCK_SIZE - _offset;
+            ok = writeStaged(aligned) && ok;
+        }
+    }
+
+    bool due = _uncommitted > 0 &&
+               ((_policy.sync_ms > 0 && now_ms - _firstUncommitted >= _policy.sync_ms) ||
+                (_policy.sync_bytes > 0 && _uncommitted >= _policy.sync_bytes));
+    if(due)
+    {
+        ok = commit(now_ms) && ok;
+    }
+
+    return ok;
+}
+
+bool DurableFile::commit(uint64_t now_ms)
+{
+    if(_fd < 0)
+    {
+        return false;
+    }
+
+    if(_uncommitted == 0)
+    {
+        return true;
+    }
+
+    bool ok = writeStaged(_staged);
+    ok = (fdatasync(_fd) == 0) && ok;
+    _syncs++;
+    _uncommitted = 0;
+    _firstUncommitted = now_ms;
+    return ok;
+}
+
+bool DurableFile::writeStaged(size_t length)
+{
+    preallocate(length);
+
+    size_t done = 0;
+    bool ok = true;
+    while(done < length)
+    {
+        ssize_t written = write(_fd, _staging.data() + done, length - done);
+        _writes++;
+        if(written < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        else if(written <= 0)
+        {
+            // the bytes are gone either way, don't keep retrying them every cycle
+            ok = false;
+            break;
+        }
+        done += written;
+        _offset += written;
+    }
+
+    memmove(_staging.data(), _staging.data() + length, _staged - length);
+    _staged -= length;
+    return ok;
+}
+
+void DurableFile::preallocate(size_t length)
+{
+#ifdef __linux__
+    if(_policy.preallocate_bytes == 0 || _offset + length <= _allocated)
+    {
+        return;
+    }
+
+    uint64_t end = roundUp(_offset + length + _policy.preallocate_bytes, BLOCK_SIZE);
+    if(fallocate(_fd, FALLOC_FL_KEEP_SIZE, _allocated, end - _allocated) != 0)
+    {
+        // not every file system can, the writes still work without it
+        _policy.preallocate_bytes = 0;
+        return;
+    }
+    _allocated = end;
+#else
+    (void) length;
+#endif
+}
@@ -0,0 +1,156 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#ifndef DURABLE_FILE_H_
+#define DURABLE_FILE_H_
+
+/* STL Headers */
+#include <string>
+#include <vector>
+
+/* C Headers */
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief A file that is only ever appended to, opened once and synced to disk on a schedule.
+ *
+ * Appended bytes are staged in memory and written in whole BLOCK_SIZE blocks
+ * once Policy::write_bytes have built up, so the kernel never has to merge a
+ * partial page with what is already on disk. Space is reserved ahead of the
+ * end of the file in Policy::preallocate_bytes extents, which keeps the file
+ * in a few large pieces without changing its size.
+ *
+ * A commit writes everything staged, the partial block at the end too, and
+ * fdatasync()s the file. It happens whenever Policy::sync_ms have passed or
+ * Policy::sync_bytes have been appended since the last one, so a power cut
+ * loses at most about that much. A zero turns that trigger off.
+ *
+ * Only use a DurableFile from one thread at a time.
+ *
+ * @code
+ * DurableFile::Policy policy;
+ * DurableFile file("/logs/imu.dat", policy);
+ * if(file.isNew())
+ * {
+ *     file.append(header.data(), header.size(), now_ms);
+ * }
+ * file.append(line.data(), line.size(), now_ms);
+ * @endcode
+ */
+class DurableFile
+{
+public:
+    static const size_t BLOCK_SIZE = 4096;
+
+    struct Policy
+    {
+        /// the most that is staged before whole blocks are written out
+        size_t write_bytes;
+        /// disk space reserved past the end of the file at a time, 0 for none
+        size_t preallocate_bytes;
+        /// commit at least this often
+        uint64_t sync_ms;
+        /// commit after this much has been appended
+        size_t sync_bytes;
+
+        Policy()
+        :write_bytes(64 * 1024),
+         preallocate_bytes(1024 * 1024),
+         sync_ms(1000),
+         sync_bytes(1024 * 1024)
+        {}
+    };
+
+    /**
+     * Opens path for appending, creating it if need be. Check isOpen() to
+     * see if it worked.
+     */
+    DurableFile(const std::string& path, const Policy& policy);
+
+    /// commits and closes the file, giving back any space reserved past its end
+    ~DurableFile();
+
+    bool isOpen() const
+    {
+        return _fd >= 0;
+    }
+
+    /// true if the file was empty when it was opened
+    bool isNew() const
+    {
+        return _new;
+    }
+
+    const std::string& path() const
+    {
+        return _path;
+    }
+
+    /**
+     * Stages length bytes to go at the end of the file, writing out whole
+     * blocks and committing as the policy says. Call with no data to let
+     * a commit that is due happen. Returns false if a write failed.
+     */
+    bool append(const char* data, size_t length, uint64_t now_ms);
+
+    /// writes everything staged and syncs it, returns false if either failed
+    bool commit(uint64_t now_ms);
+
+    /// the size the file will be once everything appended is written
+    uint64_t size() const
+    {
+        return _offset + _staged;
+    }
+
+    /// write() calls made
+    uint64_t writes() const
+    {
+        return _writes;
+    }
+
+    /// fdatasync() calls made
+    uint64_t syncs() const
+    {
+        return _syncs;
+    }
+
+    /// bytes appended that a commit would lose if it failed now
+    size_t uncommitted() const
+    {
+        return _uncommitted;
+    }
+
+private:
+    DurableFile(const DurableFile&);
+    DurableFile& operator=(const DurableFile&);
+
+    /// writes the first length bytes of _staging
+    bool writeStaged(size_t length);
+
+    /// reserves the next extent once the file gets close to the end of the last one
+    void preallocate(size_t length);
+
+    std::string _path;
+    Policy _policy;
+    int _fd;
+    bool _new;
+
+    std::vector<char> _staging;
+    size_t _staged;
+    /// where the next write() goes, also the size of the file
+    uint64_t _offset;
+    uint64_t _allocated;
+
+    /// when the oldest uncommitted byte was appended
+    uint64_t _firstUncommitted;
+    size_t _uncommitted;
+    uint64_t _writes;
+    uint64_t _syncs;
+};
+
+#endif /* DURABLE_FILE_H_ */
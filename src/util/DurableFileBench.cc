@@ -0,0 +1,190 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "DurableFile.h"
+#include "Benchmark.h"
+
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+const int CHANNELS = 20;
+const int LINES_PER_SECOND = 100;
+const int WRITES_PER_SECOND = 2;
+const int SECONDS = 30;
+
+/// a line about the size of a control effort sample
+const std::string LINE = "123456789\t0.012345\t-0.543210\t1.000000\t0.250000\t-0.125000\t3.141593\t"
+                         "2.718282\t-1.414214\t0.707107\t\n";
+
+/// what the kernel counted for this process, see proc(5)
+std::map<std::string, uint64_t> processIo()
+{
+    std::map<std::string, uint64_t> counters;
+    std::ifstream io("/proc/self/io");
+    std::string name;
+    uint64_t value;
+    while(io >> name >> value)
+    {
+        counters[name.substr(0, name.size() - 1)] = value;
+    }
+    return counters;
+}
+
+std::string tempDirectory()
+{
+    char name[] = "/tmp/durable_file_bench_XXXXXX";
+    return mkdtemp(name);
+}
+
+std::string channelPath(const std::string& directory, int channel)
+{
+    return directory + "/" + std::to_string(channel) + ".dat";
+}
+
+void removeChannels(const std::string& directory)
+{
+    for(int channel = 0; channel < CHANNELS; channel++)
+    {
+        unlink(channelPath(directory, channel).c_str());
+    }
+    rmdir(directory.c_str());
+}
+
+/**
+ * SECONDS of CHANNELS logging LINES_PER_SECOND each, written out
+ * WRITES_PER_SECOND like the log writer does, without waiting in between.
+ * write(channel, data, now_ms) is whatever is being measured, the counts are
+ * per second of logging.
+ */
+void run(Benchmark& bench, std::function<void (int, const std::string&, uint64_t)> write,
+         std::function<void ()> close, uint64_t& extraSyscalls)
+{
+    std::string pending;
+    for(int i = 0; i < LINES_PER_SECOND / WRITES_PER_SECOND; i++)
+    {
+        pending += LINE;
+    }
+
+    std::map<std::string, uint64_t> before = processIo();
+    uint64_t start = Benchmark::nowNanos();
+    for(int cycle = 0; cycle < SECONDS * WRITES_PER_SECOND; cycle++)
+    {
+        for(int channel = 0; channel < CHANNELS; channel++)
+        {
+            write(channel, pending, cycle * 1000 / WRITES_PER_SECOND);
+        }
+    }
+    close();
+    uint64_t elapsed = Benchmark::nowNanos() - start;
+    std::map<std::string, uint64_t> after = processIo();
+
+    double logged = static_cast<double>(pending.size()) * CHANNELS * SECONDS * WRITES_PER_SECOND;
+    double written = after["write_bytes"] - before["write_bytes"];
+    bench.report("write_calls", (after["syscw"] - before["syscw"]) / static_cast<double>(SECONDS), "calls/s");
+    bench.report("other_calls", extraSyscalls / static_cast<double>(SECONDS), "calls/s");
+    bench.report("write_amplification", written / logged, "x");
+    bench.report("cpu_time", elapsed / 1e6 / SECONDS, "ms/s");
+}
+}
+
+// what LogfileWriter::writeThread did, reopen the file every time and never sync
+BENCHMARK(DurableFile, ReopenEveryWrite)
+{
+    std::string directory = tempDirectory();
+    uint64_t other = 0;
+
+    run(bench, [&](int channel, const std::string& data, uint64_t)
+    {
+        std::string path = channelPath(directory, channel);
+        struct stat info;
+        bool existed = stat(path.c_str(), &info) == 0;
+        std::fstream output(path.c_str(), std::fstream::out | std::fstream::app);
+        if(! existed)
+        {
+            output << "Time(micros)\theader\n";
+        }
+        output << data;
+        // stat, open, close
+        other += 3;
+    },
+    []{}, other);
+
+    // until the kernel writes back dirty pages, vm.dirty_expire_centisecs
+    bench.report("data_loss_window", 30, "s");
+    removeChannels(directory);
+}
+
+// the obvious fix, keep the file open and sync after every write
+BENCHMARK(DurableFile, SyncEveryWrite)
+{
+    std::string directory = tempDirectory();
+    std::vector<int> files;
+    uint64_t other = 0;
+    for(int channel = 0; channel < CHANNELS; channel++)
+    {
+        std::string path = channelPath(directory, channel);
+        files.push_back(open(path.c_str(), O_CREAT | O_WRONLY | O_APPEND, S_IRUSR | S_IWUSR));
+    }
+
+    run(bench, [&](int channel, const std::string& data, uint64_t)
+    {
+        if(write(files[channel], data.data(), data.size()) > 0)
+        {
+            fdatasync(files[channel]);
+            other++;
+        }
+    },
+    [&]
+    {
+        for(int fd : files)
+        {
+            ::close(fd);
+        }
+    }, other);
+
+    bench.report("data_loss_window", 1000 / WRITES_PER_SECOND, "ms");
+    removeChannels(directory);
+}
+
+BENCHMARK(DurableFile, GroupCommit)
+{
+    std::string directory = tempDirectory();
+    std::vector<std::unique_ptr<DurableFile> > files;
+    DurableFile::Policy policy;
+    for(int channel = 0; channel < CHANNELS; channel++)
+    {
+        std::string path = channelPath(directory, channel);
+        files.push_back(std::unique_ptr<DurableFile>(new DurableFile(path, policy)));
+    }
+
+    uint64_t other = 0;
+    run(bench, [&](int channel, const std::string& data, uint64_t now_ms)
+    {
+        files[channel]->append(data.data(), data.size(), now_ms);
+    },
+    [&]
+    {
+        for(std::unique_ptr<DurableFile>& file : files)
+        {
+            other += file->syncs();
+        }
+        files.clear();
+    }, other);
+
+    bench.report("data_loss_window", policy.sync_ms + 1000 / WRITES_PER_SECOND, "ms");
+    removeChannels(directory);
+}
@@ -0,0 +1,158 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "DurableFile.h"
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+/// a temporary file name that is removed at the end of the test
+struct TempPath
+{
+    std::string path;
+
+    TempPath()
+    {
+        char name[] = "/tmp/durable_file_XXXXXX";
+        int fd = mkstemp(name);
+        close(fd);
+        unlink(name);
+        path = name;
+    }
+
+    ~TempPath()
+    {
+        unlink(path.c_str());
+    }
+
+    std::string contents() const
+    {
+        std::ifstream file(path.c_str(), std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    off_t size() const
+    {
+        struct stat info;
+        return stat(path.c_str(), &info) == 0 ? info.st_size : -1;
+    }
+};
+
+/// a policy that only commits when asked to
+DurableFile::Policy manual()
+{
+    DurableFile::Policy policy;
+    policy.write_bytes = 2 * DurableFile::BLOCK_SIZE;
+    policy.sync_ms = 0;
+    policy.sync_bytes = 0;
+    return policy;
+}
+}
+
+TEST(DurableFile, StagesUntilWholeBlocksCanBeWritten)
+{
+    TempPath temp;
+    DurableFile file(temp.path, manual());
+    ASSERT_TRUE(file.isOpen());
+    EXPECT_TRUE(file.isNew());
+
+    std::string line(100, 'x');
+    for(int i = 0; i < 90; i++)
+    {
+        ASSERT_TRUE(file.append(line.data(), line.size(), 0));
+    }
+
+    // 9000 bytes fill the two blocks of staging once, and only those go out
+    EXPECT_EQ(1u, file.writes());
+    EXPECT_EQ(static_cast<off_t>(2 * DurableFile::BLOCK_SIZE), temp.size());
+    EXPECT_EQ(0u, file.syncs());
+    EXPECT_EQ(9000u, file.uncommitted());
+
+    ASSERT_TRUE(file.commit(0));
+    EXPECT_EQ(1u, file.syncs());
+    EXPECT_EQ(0u, file.uncommitted());
+    EXPECT_EQ(9000, temp.size());
+}
+
+TEST(DurableFile, WritesEndOnBlockBoundariesAfterACommit)
+{
+    TempPath temp;
+    DurableFile file(temp.path, manual());
+
+    std::string odd(1000, 'a');
+    file.append(odd.data(), odd.size(), 0);
+    file.commit(0);
+
+    std::string more(3 * DurableFile::BLOCK_SIZE, 'b');
+    file.append(more.data(), more.size(), 0);
+
+    EXPECT_EQ(0, temp.size() % static_cast<off_t>(DurableFile::BLOCK_SIZE));
+    file.commit(0);
+    EXPECT_EQ(odd + more, temp.contents());
+}
+
+TEST(DurableFile, CommitsAfterSyncMs)
+{
+    TempPath temp;
+    DurableFile::Policy policy = manual();
+    policy.sync_ms = 500;
+    DurableFile file(temp.path, policy);
+
+    file.append("first\n", 6, 1000);
+    file.append("second\n", 7, 1400);
+    EXPECT_EQ(0u, file.syncs());
+    EXPECT_EQ(0, temp.size());
+
+    // the wait is from the oldest uncommitted byte, not the newest
+    file.append(nullptr, 0, 1500);
+    EXPECT_EQ(1u, file.syncs());
+    EXPECT_EQ("first\nsecond\n", temp.contents());
+
+    // nothing new, nothing to sync
+    file.append(nullptr, 0, 5000);
+    EXPECT_EQ(1u, file.syncs());
+}
+
+TEST(DurableFile, CommitsAfterSyncBytes)
+{
+    TempPath temp;
+    DurableFile::Policy policy = manual();
+    policy.sync_bytes = 1000;
+    DurableFile file(temp.path, policy);
+
+    std::string line(400, 'y');
+    file.append(line.data(), line.size(), 0);
+    file.append(line.data(), line.size(), 0);
+    EXPECT_EQ(0u, file.syncs());
+    file.append(line.data(), line.size(), 0);
+    EXPECT_EQ(1u, file.syncs());
+    EXPECT_EQ(1200, temp.size());
+}
+
+TEST(DurableFile, ReopeningAppends)
+{
+    TempPath temp;
+    {
+        DurableFile file(temp.path, DurableFile::Policy());
+        file.append("header\n", 7, 0);
+    }
+
+    DurableFile file(temp.path, DurableFile::Policy());
+    EXPECT_FALSE(file.isNew());
+    file.append("line\n", 5, 0);
+    file.commit(0);
+
+    // the space reserved ahead of the first file's end was given back
+    EXPECT_EQ("header\nline\n", temp.contents());
+}
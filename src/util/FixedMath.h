@@ -0,0 +1,365 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#pragma once
+#ifndef FIXED_MATH_H
+#define FIXED_MATH_H
+
+#include <cmath>
+#include <ostream>
+#include <stddef.h>
+
+/** A vector of N doubles held by value.
+
+The navigation and control code works in two and three dimensions, and a
+boost::numeric::ublas::vector<double> of that size is a heap allocation every
+time one is made, copied or returned. These are plain arrays, so they cost
+nothing to pass around and the operations below are short loops the compiler
+unrolls.
+
+Elements are reached with [] or () like a ublas vector, and begin(), end(),
+size() and value_type let one be logged through a LogChannel or saturated
+with Control::saturate.
+
+@code
+Vec3 error(imu->get_ned_position() - reference);
+Vec2 roll_pitch(error.head<2>());
+double distance = error.norm();
+@endcode
+**/
+template <size_t N>
+class Vector
+{
+public:
+    typedef double value_type;
+    typedef double* iterator;
+    typedef const double* const_iterator;
+
+    /// all zeros
+    Vector()
+    {
+        fill(0);
+    }
+
+    Vector(double x, double y)
+    {
+        static_assert(N == 2, "two values make a Vector<2>");
+        _values[0] = x;
+        _values[1] = y;
+    }
+
+    Vector(double x, double y, double z)
+    {
+        static_assert(N == 3, "three values make a Vector<3>");
+        _values[0] = x;
+        _values[1] = y;
+        _values[2] = z;
+    }
+
+    /// the first N values of any container with begin() and end(), zeros after its end
+    template <class Container>
+    static Vector from(const Container& container)
+    {
+        Vector result;
+        size_t i = 0;
+        for(typename Container::const_iterator it = container.begin(); it != container.end() && i < N; ++it)
+        {
+            result._values[i++] = *it;
+        }
+        return result;
+    }
+
+    static size_t size()
+    {
+        return N;
+    }
+
+    double& operator[](size_t i) { return _values[i]; }
+    double operator[](size_t i) const { return _values[i]; }
+    double& operator()(size_t i) { return _values[i]; }
+    double operator()(size_t i) const { return _values[i]; }
+
+    iterator begin() { return _values; }
+    iterator end() { return _values + N; }
+    const_iterator begin() const { return _values; }
+    const_iterator end() const { return _values + N; }
+
+    void fill(double value)
+    {
+        for(size_t i = 0; i < N; i++)
+        {
+            _values[i] = value;
+        }
+    }
+
+    /// the first M values, e.g. roll and pitch out of the euler angles
+    template <size_t M>
+    Vector<M> head() const
+    {
+        static_assert(M <= N, "head can't be longer than the vector");
+        Vector<M> result;
+        for(size_t i = 0; i < M; i++)
+        {
+            result[i] = _values[i];
+        }
+        return result;
+    }
+
+    /// this vector with zeros added to make it M long
+    template <size_t M>
+    Vector<M> extend() const
+    {
+        static_assert(M >= N, "extend can't make the vector shorter");
+        Vector<M> result;
+        for(size_t i = 0; i < N; i++)
+        {
+            result[i] = _values[i];
+        }
+        return result;
+    }
+
+    double dot(const Vector& other) const
+    {
+        double sum = 0;
+        for(size_t i = 0; i < N; i++)
+        {
+            sum += _values[i] * other._values[i];
+        }
+        return sum;
+    }
+
+    /// the euclidean length
+    double norm() const
+    {
+        return std::sqrt(dot(*this));
+    }
+
+    Vector& operator+=(const Vector& other)
+    {
+        for(size_t i = 0; i < N; i++)
+        {
+            _values[i] += other._values[i];
+        }
+        return *this;
+    }
+
+    Vector& operator-=(const Vector& other)
+    {
+        for(size_t i = 0; i < N; i++)
+        {
+            _values[i] -= other._values[i];
+        }
+        return *this;
+    }
+
+    Vector& operator*=(double scale)
+    {
+        for(size_t i = 0; i < N; i++)
+        {
+            _values[i] *= scale;
+        }
+        return *this;
+    }
+
+    Vector& operator/=(double scale)
+    {
+        for(size_t i = 0; i < N; i++)
+        {
+            _values[i] /= scale;
+        }
+        return *this;
+    }
+
+private:
+    double _values[N];
+};
+
+typedef Vector<2> Vec2;
+typedef Vector<3> Vec3;
+
+template <size_t N>
+inline Vector<N> operator+(Vector<N> a, const Vector<N>& b)
+{
+    return a += b;
+}
+
+template <size_t N>
+inline Vector<N> operator-(Vector<N> a, const Vector<N>& b)
+{
+    return a -= b;
+}
+
+template <size_t N>
+inline Vector<N> operator-(Vector<N> a)
+{
+    return a *= -1;
+}
+
+template <size_t N>
+inline Vector<N> operator*(Vector<N> a, double scale)
+{
+    return a *= scale;
+}
+
+template <size_t N>
+inline Vector<N> operator*(double scale, Vector<N> a)
+{
+    return a *= scale;
+}
+
+template <size_t N>
+inline Vector<N> operator/(Vector<N> a, double scale)
+{
+    return a /= scale;
+}
+
+template <size_t N>
+inline bool operator==(const Vector<N>& a, const Vector<N>& b)
+{
+    for(size_t i = 0; i < N; i++)
+    {
+        if(a[i] != b[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <size_t N>
+inline bool operator!=(const Vector<N>& a, const Vector<N>& b)
+{
+    return !(a == b);
+}
+
+/// written the way ublas writes its vectors, "[3](1,2,3)", so the logs read the same
+template <size_t N>
+std::ostream& operator<<(std::ostream& out, const Vector<N>& vector)
+{
+    out << '[' << N << "](";
+    for(size_t i = 0; i < N; i++)
+    {
+        if(i > 0)
+        {
+            out << ',';
+        }
+        out << vector[i];
+    }
+    return out << ')';
+}
+
+/** A 3x3 matrix of doubles held by value, for rotations between the body and
+navigation frames.
+**/
+class Mat3
+{
+public:
+    /// all zeros
+    Mat3()
+    {
+        for(size_t r = 0; r < 3; r++)
+        {
+            for(size_t c = 0; c < 3; c++)
+            {
+                _values[r][c] = 0;
+            }
+        }
+    }
+
+    static Mat3 identity()
+    {
+        Mat3 result;
+        result(0, 0) = 1;
+        result(1, 1) = 1;
+        result(2, 2) = 1;
+        return result;
+    }
+
+    /// the rotation by angle radians about the z axis
+    static Mat3 rotationZ(double angle)
+    {
+        Mat3 result;
+        result(0, 0) = std::cos(angle);
+        result(0, 1) = -std::sin(angle);
+        result(1, 0) = std::sin(angle);
+        result(1, 1) = std::cos(angle);
+        result(2, 2) = 1;
+        return result;
+    }
+
+    double& operator()(size_t row, size_t column) { return _values[row][column]; }
+    double operator()(size_t row, size_t column) const { return _values[row][column]; }
+
+    Mat3 transpose() const
+    {
+        Mat3 result;
+        for(size_t r = 0; r < 3; r++)
+        {
+            for(size_t c = 0; c < 3; c++)
+            {
+                result._values[c][r] = _values[r][c];
+            }
+        }
+        return result;
+    }
+
+    Vec3 operator*(const Vec3& vector) const
+    {
+        Vec3 result;
+        for(size_t r = 0; r < 3; r++)
+        {
+            result[r] = _values[r][0] * vector[0] + _values[r][1] * vector[1] + _values[r][2] * vector[2];
+        }
+        return result;
+    }
+
+    Mat3 operator*(const Mat3& other) const
+    {
+        Mat3 result;
+        for(size_t r = 0; r < 3; r++)
+        {
+            for(size_t c = 0; c < 3; c++)
+            {
+                result._values[r][c] = _values[r][0] * other._values[0][c]
+                                     + _values[r][1] * other._values[1][c]
+                                     + _values[r][2] * other._values[2][c];
+            }
+        }
+        return result;
+    }
+
+    bool operator==(const Mat3& other) const
+    {
+        for(size_t r = 0; r < 3; r++)
+        {
+            for(size_t c = 0; c < 3; c++)
+            {
+                if(_values[r][c] != other._values[r][c])
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+private:
+    double _values[3][3];
+};
+
+/// written the way ublas writes its matrices, "[3,3]((1,0,0),(0,1,0),(0,0,1))"
+inline std::ostream& operator<<(std::ostream& out, const Mat3& matrix)
+{
+    out << "[3,3](";
+    for(size_t r = 0; r < 3; r++)
+    {
+        out << (r > 0 ? ",(" : "(") << matrix(r, 0) << ',' << matrix(r, 1) << ',' << matrix(r, 2) << ')';
+    }
+    return out << ')';
+}
+
+#endif
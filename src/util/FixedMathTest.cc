@@ -0,0 +1,72 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "FixedMath.h"
+#include "AllocationCounter.h"
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <vector>
+
+TEST(FixedMath, VectorArithmetic)
+{
+    Vec3 a(1, 2, 3);
+    Vec3 b(4, 5, 6);
+
+    EXPECT_EQ(Vec3(5, 7, 9), a + b);
+    EXPECT_EQ(Vec3(-3, -3, -3), a - b);
+    EXPECT_EQ(Vec3(2, 4, 6), 2 * a);
+    EXPECT_EQ(Vec3(0.5, 1, 1.5), a / 2);
+    EXPECT_EQ(Vec3(-1, -2, -3), -a);
+    EXPECT_EQ(32, a.dot(b));
+    EXPECT_DOUBLE_EQ(5, Vec2(3, 4).norm());
+
+    EXPECT_EQ(Vec2(1, 2), a.head<2>());
+    EXPECT_EQ(Vec3(1, 2, 0), Vec2(1, 2).extend<3>());
+    EXPECT_EQ(Vec3(7, 8, 0), Vec3::from(std::vector<double>{7, 8}));
+    EXPECT_EQ(Vec2(7, 8), Vec2::from(std::vector<double>{7, 8, 9}));
+}
+
+TEST(FixedMath, RotationsMatchTheirDefinitions)
+{
+    const double heading = 0.7;
+    Mat3 rz(Mat3::rotationZ(heading));
+
+    // body x axis ends up pointing along the heading
+    Vec3 forward(rz * Vec3(1, 0, 0));
+    EXPECT_DOUBLE_EQ(std::cos(heading), forward[0]);
+    EXPECT_DOUBLE_EQ(std::sin(heading), forward[1]);
+    EXPECT_DOUBLE_EQ(0, forward[2]);
+
+    // a rotation's transpose undoes it
+    Mat3 back(rz.transpose() * rz);
+    for(size_t r = 0; r < 3; r++)
+    {
+        for(size_t c = 0; c < 3; c++)
+        {
+            EXPECT_NEAR(Mat3::identity()(r, c), back(r, c), 1e-15);
+        }
+    }
+}
+
+TEST(FixedMath, PrintsLikeUblas)
+{
+    std::ostringstream out;
+    out << Vec3(1, 2.5, -3) << ' ' << Mat3::identity();
+    EXPECT_EQ("[3](1,2.5,-3) [3,3]((1,0,0),(0,1,0),(0,0,1))", out.str());
+}
+
+TEST(FixedMath, NeverAllocates)
+{
+    uint64_t before = AllocationCounter::allocations();
+
+    Mat3 rotation(Mat3::rotationZ(0.3) * Mat3::rotationZ(0.2));
+    Vec3 error(rotation.transpose() * (Vec3(1, 2, 3) - Vec3(3, 2, 1)));
+    Vec2 effort(error.head<2>() * 0.5);
+
+    EXPECT_EQ(0u, AllocationCounter::allocations() - before);
+    EXPECT_NE(0, effort.norm());
+}
@@ -0,0 +1,196 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#include "IoReactor.h"
+
+/* STL Headers */
+#include <chrono>
+
+/* C Headers */
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace
+{
+const int MAX_EVENTS = 16;
+const uint64_t TICK_NS = IoReactor::TICK_MS * 1000000ull;
+}
+
+IoReactor::IoReactor(size_t threads)
+    :_epoll_fd(epoll_create1(EPOLL_CLOEXEC)),
+     _stop_fd(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)),
+     _stop(false),
+     _next_tick_ns(now_ns() + TICK_NS),
+     _wakeups(0),
+     _dispatches(0)
+{
+    // level triggered and never re-armed, so once written every thread sees it
+    epoll_event stop_event = {};
+    stop_event.events = EPOLLIN;
+    stop_event.data.ptr = nullptr;
+    epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _stop_fd, &stop_event);
+
+    for(size_t i = 0; i < threads; i++)
+    {
+        _threads.push_back(std::thread(&IoReactor::run, this));
+    }
+}
+
+IoReactor::~IoReactor()
+{
+    _stop = true;
+    uint64_t one = 1;
+    if(write(_stop_fd, &one, sizeof(one)) != sizeof(one))
+    {
+        // the threads will still notice _stop on their next tick
+    }
+
+    for(std::thread& thread : _threads)
+    {
+        thread.join();
+    }
+
+    close(_stop_fd);
+    close(_epoll_fd);
+}
+
+uint64_t IoReactor::now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool IoReactor::add(int fd, ReadableCallback readable, TickCallback tick)
+{
+    std::lock_guard<std::mutex> lock(_registrations_lock);
+
+    _registrations.emplace_back();
+    Registration* registration = &_registrations.back();
+    registration->fd = fd;
+    registration->active = true;
+    registration->readable = readable;
+    registration->tick = tick;
+
+    // one shot so a second reactor thread can't be woken for bytes the first is still reading
+    epoll_event event = {};
+    event.events = EPOLLIN | EPOLLONESHOT;
+    event.data.ptr = registration;
+    if(epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0)
+    {
+        _registrations.pop_back();
+        return false;
+    }
+
+    return true;
+}
+
+void IoReactor::remove(int fd)
+{
+    std::lock_guard<std::mutex> lock(_registrations_lock);
+
+    for(Registration& registration : _registrations)
+    {
+        if(registration.fd != fd || ! registration.active)
+        {
+            continue;
+        }
+
+        epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+
+        // waits out a callback already running on another thread
+        std::lock_guard<std::mutex> callback_lock(registration.lock);
+        registration.active = false;
+        registration.readable = nullptr;
+        registration.tick = nullptr;
+    }
+}
+
+bool IoReactor::rearm(Registration* registration)
+{
+    epoll_event event = {};
+    event.events = EPOLLIN | EPOLLONESHOT;
+    event.data.ptr = registration;
+    return epoll_ctl(_epoll_fd, EPOLL_CTL_MOD, registration->fd, &event) == 0;
+}
+
+void IoReactor::dispatch(Registration* registration, uint32_t events, uint64_t arrival_ns)
+{
+    std::lock_guard<std::mutex> lock(registration->lock);
+
+    if(! registration->active)
+    {
+        return;
+    }
+
+    registration->readable(arrival_ns);
+    _dispatches++;
+
+    // a hung up port would wake us forever, leave it for the driver's tick to notice.
+    // if the fd was removed meanwhile this fails harmlessly.
+    if(! (events & (EPOLLHUP | EPOLLERR)))
+    {
+        rearm(registration);
+    }
+}
+
+void IoReactor::tick()
+{
+    uint64_t now = now_ns();
+    uint64_t next = _next_tick_ns.load();
+    if(now < next || ! _next_tick_ns.compare_exchange_strong(next, now + TICK_NS))
+    {
+        return;
+    }
+
+    // ticks run without _registrations_lock so a slow one can't hold up add() and remove().
+    // registrations are never freed while the reactor runs, so the pointers stay good.
+    std::vector<Registration*> ticking;
+    {
+        std::lock_guard<std::mutex> lock(_registrations_lock);
+        for(Registration& registration : _registrations)
+        {
+            if(registration.active && registration.tick)
+            {
+                ticking.push_back(&registration);
+            }
+        }
+    }
+
+    for(Registration* registration : ticking)
+    {
+        // a tick is skipped rather than waiting on a busy callback, remove() may also have won the lock
+        std::unique_lock<std::mutex> callback_lock(registration->lock, std::try_to_lock);
+        if(callback_lock.owns_lock() && registration->active && registration->tick)
+        {
+            registration->tick();
+        }
+    }
+}
+
+void IoReactor::run()
+{
+    epoll_event events[MAX_EVENTS];
+
+    while(! _stop)
+    {
+        int count = epoll_wait(_epoll_fd, events, MAX_EVENTS, TICK_MS);
+        uint64_t arrival_ns = now_ns();
+        _wakeups++;
+
+        for(int i = 0; i < count; i++)
+        {
+            Registration* registration = static_cast<Registration*>(events[i].data.ptr);
+            if(registration != nullptr)
+            {
+                dispatch(registration, events[i].events, arrival_ns);
+            }
+        }
+
+        tick();
+    }
+}
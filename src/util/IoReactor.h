@@ -0,0 +1,135 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#ifndef IO_REACTOR_H_
+#define IO_REACTOR_H_
+
+/* STL Headers */
+#include <atomic>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* C Headers */
+#include <stdint.h>
+#include <stddef.h>
+
+/* Project Headers */
+#include "Singleton.h"
+
+/**
+ * @brief Services many file descriptors from one or two epoll threads.
+ *
+ * Rather than every serial driver parking its own thread in a blocking read,
+ * a driver registers its port with a callback that reads what is waiting
+ * (usually straight in to a framer) and handles any complete messages. The
+ * callback is given the steady_clock time the reactor woke for the bytes so
+ * drivers can timestamp arrivals without a clock call of their own.
+ *
+ * Callbacks for one fd never run concurrently, even with more than one
+ * reactor thread, so a driver's framer needs no locking. Callbacks should
+ * not block; the fd is readable when they are called so a single read()
+ * will return straight away. Callbacks may add() other fds but must not
+ * remove() their own.
+ *
+ * If the fd hangs up or errors the readable callback is run one last time
+ * and the fd is no longer watched until it is removed and added again.
+ *
+ * An optional tick callback is run about every TICK_MS for watchdog style
+ * checks such as restarting a sensor that has gone quiet.
+ *
+ * @code
+ * IoReactor::getInstance(1)->add(fd, [this](uint64_t arrival_ns){
+ *     framer.commit(read(fd, framer.writeSpan(space), space));
+ *     ...
+ * });
+ * @endcode
+ */
+class IoReactor : public Singleton<IoReactor>
+{
+public:
+    /// called when the fd has data waiting, with the steady_clock time in nanoseconds the reactor woke
+    typedef std::function<void (uint64_t arrival_ns)> ReadableCallback;
+
+    /// called about every TICK_MS while the fd is registered
+    typedef std::function<void ()> TickCallback;
+
+    static const int TICK_MS = 100;
+
+    /// starts the given number of epoll threads
+    explicit IoReactor(size_t threads);
+    ~IoReactor();
+
+    /**
+     * Starts watching fd, returns false if epoll would not take it.
+     * An fd can only be registered once at a time.
+     */
+    bool add(int fd, ReadableCallback readable, TickCallback tick = nullptr);
+
+    /**
+     * Stops watching fd. Once this returns no callback for fd is running or
+     * will be run again.
+     */
+    void remove(int fd);
+
+    /// the number of times a reactor thread returned from epoll_wait
+    uint64_t wakeups() const
+    {
+        return _wakeups.load();
+    }
+
+    /// the number of readable callbacks run
+    uint64_t dispatches() const
+    {
+        return _dispatches.load();
+    }
+
+    /// the number of epoll threads
+    size_t threads() const
+    {
+        return _threads.size();
+    }
+
+    /// the clock arrival times are measured with
+    static uint64_t now_ns();
+
+private:
+    struct Registration
+    {
+        int fd;
+        bool active;
+        ReadableCallback readable;
+        TickCallback tick;
+        /// held while either callback runs so they never overlap
+        std::mutex lock;
+    };
+
+    void run();
+    void dispatch(Registration* registration, uint32_t events, uint64_t arrival_ns);
+    void tick();
+    bool rearm(Registration* registration);
+
+    int _epoll_fd;
+    /// an eventfd written to wake the threads when stopping
+    int _stop_fd;
+    std::atomic_bool _stop;
+
+    /// never shrinks while the reactor runs, an event can still be in flight for a removed fd
+    std::list<Registration> _registrations;
+    std::mutex _registrations_lock;
+    /// claimed by whichever thread notices it has passed
+    std::atomic<uint64_t> _next_tick_ns;
+
+    std::atomic<uint64_t> _wakeups;
+    std::atomic<uint64_t> _dispatches;
+
+    std::vector<std::thread> _threads;
+};
+
+#endif /* IO_REACTOR_H_ */
@@ -0,0 +1,166 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "IoReactor.h"
+#include "LatencyHistogram.h"
+#include "Benchmark.h"
+
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+namespace
+{
+const int PORTS = 6;
+const int MESSAGES = 500;
+
+/// context switches for the whole process, the counters perf sched reports per task
+struct ContextSwitches
+{
+    long voluntary;
+    long involuntary;
+
+    static ContextSwitches now()
+    {
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        ContextSwitches switches = {usage.ru_nvcsw, usage.ru_nivcsw};
+        return switches;
+    }
+};
+
+/**
+ * Every 2ms writes a timestamp down each of PORTS pipes, like a handful of sensors
+ * streaming at 500Hz, and measures how long the readers take to see each one.
+ * start_readers is handed the read ends and a function that reads and records one
+ * timestamp, returning false once the pipe is closed.
+ */
+template <class StartReaders, class StopReaders>
+void run(Benchmark& bench, StartReaders start_readers, StopReaders stop_readers)
+{
+    int read_fds[PORTS], write_fds[PORTS];
+    for(int i = 0; i < PORTS; i++)
+    {
+        int fds[2];
+        if(pipe(fds) != 0)
+        {
+            bench.skip("could not create pipes");
+            return;
+        }
+        read_fds[i] = fds[0];
+        write_fds[i] = fds[1];
+    }
+
+    LatencyHistogram latency;
+    std::mutex latency_lock;
+    auto received = [&](int fd)
+    {
+        uint64_t sent;
+        if(read(fd, &sent, sizeof(sent)) != sizeof(sent))
+        {
+            return false;
+        }
+
+        uint64_t now = Benchmark::nowNanos();
+        std::lock_guard<std::mutex> lock(latency_lock);
+        latency.record(now - sent);
+        return true;
+    };
+
+    size_t threads = start_readers(read_fds, received);
+    ContextSwitches before = ContextSwitches::now();
+
+    for(int n = 0; n < MESSAGES; n++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        for(int i = 0; i < PORTS; i++)
+        {
+            uint64_t sent = Benchmark::nowNanos();
+            if(write(write_fds[i], &sent, sizeof(sent)) != sizeof(sent))
+            {
+                bench.skip("short write");
+            }
+        }
+    }
+
+    // let the last messages drain before counting
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ContextSwitches after = ContextSwitches::now();
+    double messages = static_cast<double>(MESSAGES) * PORTS;
+
+    // closing the write ends wakes any blocked readers
+    for(int i = 0; i < PORTS; i++)
+    {
+        close(write_fds[i]);
+    }
+    stop_readers(read_fds);
+    for(int i = 0; i < PORTS; i++)
+    {
+        close(read_fds[i]);
+    }
+
+    bench.report("reader_threads", threads, "threads");
+    bench.report("voluntary_switches", (after.voluntary - before.voluntary) / messages, "switches/msg");
+    bench.report("involuntary_switches", (after.involuntary - before.involuntary) / messages, "switches/msg");
+    bench.report("latency_p50", latency.percentile(0.5) / 1000.0, "us");
+    bench.report("latency_p99", latency.percentile(0.99) / 1000.0, "us");
+    bench.report("latency_max", latency.max() / 1000.0, "us");
+}
+}
+
+BENCHMARK(IoReactor, ThreadPerPort)
+{
+    std::vector<std::thread> readers;
+
+    run(bench, [&](int* fds, std::function<bool (int)> received)
+    {
+        for(int i = 0; i < PORTS; i++)
+        {
+            int fd = fds[i];
+            readers.push_back(std::thread([fd, received]
+            {
+                // what Driver::readDevice does today, a blocking read per thread
+                while(received(fd))
+                {
+                }
+            }));
+        }
+        return readers.size();
+    },
+    [&](int*)
+    {
+        for(std::thread& reader : readers)
+        {
+            reader.join();
+        }
+    });
+}
+
+BENCHMARK(IoReactor, Reactor)
+{
+    IoReactor reactor(1);
+
+    run(bench, [&](int* fds, std::function<bool (int)> received)
+    {
+        for(int i = 0; i < PORTS; i++)
+        {
+            int fd = fds[i];
+            reactor.add(fd, [fd, received](uint64_t){ received(fd); });
+        }
+        return reactor.threads();
+    },
+    [&](int* fds)
+    {
+        for(int i = 0; i < PORTS; i++)
+        {
+            reactor.remove(fds[i]);
+        }
+    });
+}
@@ -0,0 +1,184 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "IoReactor.h"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <unistd.h>
+
+namespace
+{
+/// a pipe that closes itself
+struct Pipe
+{
+    int read_fd;
+    int write_fd;
+
+    Pipe()
+    {
+        int fds[2];
+        EXPECT_EQ(0, pipe(fds));
+        read_fd = fds[0];
+        write_fd = fds[1];
+    }
+
+    ~Pipe()
+    {
+        close(read_fd);
+        close(write_fd);
+    }
+};
+
+/// spins until condition is true or a second has passed
+template <class Condition>
+bool eventually(Condition condition)
+{
+    for(int i = 0; i < 1000 && ! condition(); i++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return condition();
+}
+}
+
+TEST(IoReactor, ReadsWhatArrives)
+{
+    IoReactor reactor(1);
+    Pipe pipe;
+    std::atomic<int> received(0);
+    std::atomic<uint64_t> arrival(0);
+
+    uint64_t before = IoReactor::now_ns();
+    ASSERT_TRUE(reactor.add(pipe.read_fd, [&](uint64_t arrival_ns)
+    {
+        char buf[64];
+        received += read(pipe.read_fd, buf, sizeof(buf));
+        arrival = arrival_ns;
+    }));
+
+    ASSERT_EQ(5, write(pipe.write_fd, "hello", 5));
+    EXPECT_TRUE(eventually([&]{ return received == 5; }));
+    EXPECT_GE(arrival.load(), before);
+    EXPECT_LE(arrival.load(), IoReactor::now_ns());
+}
+
+TEST(IoReactor, RemoveStopsCallbacks)
+{
+    IoReactor reactor(1);
+    Pipe pipe;
+    std::atomic<int> calls(0);
+
+    ASSERT_TRUE(reactor.add(pipe.read_fd, [&](uint64_t)
+    {
+        char buf[64];
+        if(read(pipe.read_fd, buf, sizeof(buf)) > 0)
+        {
+            calls++;
+        }
+    }));
+
+    ASSERT_EQ(1, write(pipe.write_fd, "a", 1));
+    ASSERT_TRUE(eventually([&]{ return calls == 1; }));
+
+    reactor.remove(pipe.read_fd);
+    ASSERT_EQ(1, write(pipe.write_fd, "b", 1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(1, calls.load());
+}
+
+TEST(IoReactor, CallbacksForOneFdNeverOverlap)
+{
+    IoReactor reactor(2);
+    Pipe pipes[4];
+    std::atomic<int> inside[4];
+    std::atomic<int> overlaps(0);
+    std::atomic<int> received(0);
+
+    for(int i = 0; i < 4; i++)
+    {
+        inside[i] = 0;
+        int fd = pipes[i].read_fd;
+        std::atomic<int>* flag = &inside[i];
+        ASSERT_TRUE(reactor.add(fd, [&, fd, flag](uint64_t)
+        {
+            if(flag->fetch_add(1) != 0)
+            {
+                overlaps++;
+            }
+            char buf;
+            received += read(fd, &buf, 1);
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+            flag->fetch_sub(1);
+        }));
+    }
+
+    const int per_pipe = 200;
+    for(int n = 0; n < per_pipe; n++)
+    {
+        for(Pipe& pipe : pipes)
+        {
+            ASSERT_EQ(1, write(pipe.write_fd, "x", 1));
+        }
+    }
+
+    EXPECT_TRUE(eventually([&]{ return received == 4 * per_pipe; }));
+    EXPECT_EQ(0, overlaps.load());
+    EXPECT_EQ(2u, reactor.threads());
+}
+
+TEST(IoReactor, TicksWhileIdle)
+{
+    IoReactor reactor(1);
+    Pipe pipe;
+    std::atomic<int> ticks(0);
+
+    ASSERT_TRUE(reactor.add(pipe.read_fd, [](uint64_t){}, [&]{ ticks++; }));
+    EXPECT_TRUE(eventually([&]{ return ticks >= 2; }));
+}
+
+TEST(IoReactor, SlowTickDoesNotHoldUpAdd)
+{
+    IoReactor reactor(1);
+    Pipe slow, other;
+    std::atomic_bool ticking(false);
+
+    ASSERT_TRUE(reactor.add(slow.read_fd, [](uint64_t){}, [&]
+    {
+        if(! ticking.exchange(true))
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        }
+    }));
+    ASSERT_TRUE(eventually([&]{ return ticking.load(); }));
+
+    uint64_t before = IoReactor::now_ns();
+    ASSERT_TRUE(reactor.add(other.read_fd, [](uint64_t){}));
+    EXPECT_LT(IoReactor::now_ns() - before, 100000000u);
+
+    reactor.remove(other.read_fd);
+}
+
+TEST(IoReactor, HangupIsNotRetried)
+{
+    IoReactor reactor(1);
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+    std::atomic<int> calls(0);
+
+    ASSERT_TRUE(reactor.add(fds[0], [&](uint64_t){ calls++; }));
+    close(fds[1]);
+
+    ASSERT_TRUE(eventually([&]{ return calls >= 1; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(1, calls.load());
+
+    reactor.remove(fds[0]);
+    close(fds[0]);
+}
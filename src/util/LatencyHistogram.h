@@ -0,0 +1,133 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#pragma once
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+/** A fixed size histogram of durations in nanoseconds.
+
+Buckets are logarithmic with eight linear steps per power of two, so any
+value is reported to within 12.5% and recording never allocates. It is not
+threadsafe, each thread that measures something should keep its own.
+
+@code
+LatencyHistogram latency;
+latency.record(end_ns - start_ns);
+uint64_t p99 = latency.percentile(0.99);
+@endcode
+**/
+class LatencyHistogram
+{
+public:
+    LatencyHistogram()
+    {
+        reset();
+    }
+
+    void record(uint64_t ns)
+    {
+        _buckets[bucket(ns)]++;
+        _count++;
+        _sum += ns;
+        if(ns > _max)
+        {
+            _max = ns;
+        }
+    }
+
+    /// the number of values recorded
+    uint64_t count() const
+    {
+        return _count;
+    }
+
+    uint64_t max() const
+    {
+        return _max;
+    }
+
+    uint64_t mean() const
+    {
+        return _count == 0 ? 0 : _sum / _count;
+    }
+
+    /// the upper bound of the bucket holding fraction p (0 to 1) of recorded values
+    uint64_t percentile(double p) const
+    {
+        if(_count == 0)
+        {
+            return 0;
+        }
+
+        uint64_t target = static_cast<uint64_t>(p * _count);
+        if(target >= _count)
+        {
+            target = _count - 1;
+        }
+
+        uint64_t seen = 0;
+        for(size_t i = 0; i < NUM_BUCKETS; i++)
+        {
+            seen += _buckets[i];
+            if(seen > target)
+            {
+                uint64_t upper = upper_bound(i);
+                return upper < _max ? upper : _max;
+            }
+        }
+        return _max;
+    }
+
+    void reset()
+    {
+        memset(_buckets, 0, sizeof(_buckets));
+        _count = 0;
+        _sum = 0;
+        _max = 0;
+    }
+
+private:
+    static const size_t SUB_BUCKET_BITS = 3;
+    static const size_t SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static const size_t NUM_BUCKETS = 64 * SUB_BUCKETS;
+
+    static size_t bucket(uint64_t ns)
+    {
+        if(ns < SUB_BUCKETS)
+        {
+            return ns;
+        }
+
+        size_t msb = 63 - __builtin_clzll(ns);
+        size_t sub = (ns >> (msb - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+        return (msb - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + sub;
+    }
+
+    static uint64_t upper_bound(size_t bucket)
+    {
+        if(bucket < SUB_BUCKETS)
+        {
+            return bucket;
+        }
+
+        size_t shift = bucket / SUB_BUCKETS - 1;
+        uint64_t sub = bucket % SUB_BUCKETS;
+        return ((SUB_BUCKETS + sub + 1) << shift) - 1;
+    }
+
+    uint32_t _buckets[NUM_BUCKETS];
+    uint64_t _count;
+    uint64_t _sum;
+    uint64_t _max;
+};
+
+#endif // LATENCY_HISTOGRAM_H
@@ -0,0 +1,34 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "LatencyHistogram.h"
+#include <gtest/gtest.h>
+
+TEST(LatencyHistogram, Empty)
+{
+    LatencyHistogram h;
+    EXPECT_EQ(0u, h.count());
+    EXPECT_EQ(0u, h.percentile(0.5));
+}
+
+TEST(LatencyHistogram, PercentilesWithinBucketError)
+{
+    LatencyHistogram h;
+    for(uint64_t i = 1; i <= 1000; i++)
+    {
+        h.record(i * 1000);
+    }
+
+    EXPECT_EQ(1000u, h.count());
+    EXPECT_EQ(1000000u, h.max());
+    EXPECT_EQ(500500u, h.mean());
+    EXPECT_NEAR(500000, h.percentile(0.5), 500000 / 8);
+    EXPECT_NEAR(990000, h.percentile(0.99), 990000 / 8);
+    EXPECT_EQ(1000000u, h.percentile(1.0));
+
+    h.reset();
+    EXPECT_EQ(0u, h.count());
+}
@@ -0,0 +1,177 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#pragma once
+#ifndef MPSC_RING_H
+#define MPSC_RING_H
+
+#include <atomic>
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+
+/** A fixed capacity lock-free queue from any number of producer threads to
+exactly one consumer thread.
+
+Each slot carries a sequence number (Vyukov's bounded queue), a producer
+claims a slot with one compare and swap on the tail and publishes it by
+bumping the slot's sequence, so producers never wait on each other or on the
+consumer and never allocate. A full queue makes push() return false.
+
+Values are filled and consumed in place, so T can be a large record without
+being copied twice.
+
+@code
+MpscRing<Record> queue(1024);
+
+// any thread
+queue.push([&](Record& slot){ slot.length = ...; });
+
+// the consumer
+while(queue.pop([&](Record& slot){ write(slot); }))
+{
+}
+@endcode
+**/
+template <class T>
+class MpscRing
+{
+public:
+    /// capacity is rounded up to a power of two
+    explicit MpscRing(size_t capacity)
+    :_capacity(roundUp(capacity)),
+     _mask(_capacity - 1),
+     _cells(new Cell[_capacity]),
+     _head(0),
+     _tail(0)
+    {
+        for(size_t i = 0; i < _capacity; i++)
+        {
+            _cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Claims a slot and calls fill(T&) to write it, returns false without
+     * calling fill if the queue is full. Safe from any thread.
+     */
+    template <class Fill>
+    bool push(Fill fill)
+    {
+        size_t position = _tail.value.load(std::memory_order_relaxed);
+        Cell* cell;
+
+        while(true)
+        {
+            cell = &_cells[position & _mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+            if(difference == 0)
+            {
+                if(_tail.value.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if(difference < 0)
+            {
+                // the consumer hasn't freed this slot from the last time around
+                return false;
+            }
+            else
+            {
+                position = _tail.value.load(std::memory_order_relaxed);
+            }
+        }
+
+        fill(cell->value);
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool push(const T& value)
+    {
+        return push([&value](T& slot){ slot = value; });
+    }
+
+    /**
+     * Calls consume(T&) on the oldest value and frees its slot, returns false
+     * if nothing is ready. Only call from the consumer thread.
+     */
+    template <class Consume>
+    bool pop(Consume consume)
+    {
+        size_t position = _head.value.load(std::memory_order_relaxed);
+        Cell* cell = &_cells[position & _mask];
+        if(cell->sequence.load(std::memory_order_acquire) != position + 1)
+        {
+            // empty, or the next producer hasn't finished filling its slot
+            return false;
+        }
+
+        consume(cell->value);
+        cell->sequence.store(position + _capacity, std::memory_order_release);
+        _head.value.store(position + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool pop(T& value)
+    {
+        return pop([&value](T& slot){ value = slot; });
+    }
+
+    /// slots claimed but not yet consumed, a snapshot that may already be stale
+    size_t size() const
+    {
+        return _tail.value.load(std::memory_order_relaxed) - _head.value.load(std::memory_order_relaxed);
+    }
+
+    size_t capacity() const
+    {
+        return _capacity;
+    }
+
+private:
+    MpscRing(const MpscRing&);
+    MpscRing& operator=(const MpscRing&);
+
+    static size_t roundUp(size_t capacity)
+    {
+        size_t rounded = 2;
+        while(rounded < capacity)
+        {
+            rounded <<= 1;
+        }
+        return rounded;
+    }
+
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    /// a position padded out to its own cache line so producers and the consumer don't fight over it
+    struct PaddedIndex
+    {
+        std::atomic<size_t> value;
+        char pad[64 - sizeof(std::atomic<size_t>)];
+
+        PaddedIndex(size_t v) : value(v) {}
+    };
+
+    const size_t _capacity;
+    const size_t _mask;
+    std::unique_ptr<Cell[]> _cells;
+    /// consumer position
+    PaddedIndex _head;
+    /// producer position
+    PaddedIndex _tail;
+};
+
+#endif // MPSC_RING_H
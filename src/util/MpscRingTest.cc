@@ -0,0 +1,100 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "MpscRing.h"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+TEST(MpscRing, FullAndEmpty)
+{
+    MpscRing<int> ring(3);
+    int value;
+
+    EXPECT_EQ(4u, ring.capacity());
+    EXPECT_FALSE(ring.pop(value));
+
+    for(int i = 0; i < 4; i++)
+    {
+        EXPECT_TRUE(ring.push(i));
+    }
+    EXPECT_FALSE(ring.push(4));
+    EXPECT_EQ(4u, ring.size());
+
+    for(int i = 0; i < 4; i++)
+    {
+        ASSERT_TRUE(ring.pop(value));
+        EXPECT_EQ(i, value);
+    }
+    EXPECT_EQ(0u, ring.size());
+
+    // wraps around
+    EXPECT_TRUE(ring.push(5));
+    ASSERT_TRUE(ring.pop(value));
+    EXPECT_EQ(5, value);
+}
+
+TEST(MpscRing, FillsInPlace)
+{
+    struct Record
+    {
+        int length;
+        char data[32];
+    };
+
+    MpscRing<Record> ring(8);
+    EXPECT_TRUE(ring.push([](Record& slot){ slot.length = 2; slot.data[0] = 'h'; slot.data[1] = 'i'; }));
+
+    std::string seen;
+    EXPECT_TRUE(ring.pop([&](Record& slot){ seen.assign(slot.data, slot.length); }));
+    EXPECT_EQ("hi", seen);
+}
+
+TEST(MpscRing, ManyProducersKeepTheirOwnOrder)
+{
+    const uint32_t producers = 4;
+    const uint32_t count = 100000;
+    MpscRing<uint32_t> ring(64);
+
+    std::vector<std::thread> threads;
+    for(uint32_t p = 0; p < producers; p++)
+    {
+        threads.push_back(std::thread([&ring, p, count]()
+        {
+            for(uint32_t i = 0; i < count; i++)
+            {
+                while(! ring.push(p << 24 | i))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }));
+    }
+
+    std::vector<uint32_t> next(producers, 0);
+    uint32_t received = 0, value;
+    while(received < producers * count)
+    {
+        if(ring.pop(value))
+        {
+            uint32_t p = value >> 24;
+            ASSERT_LT(p, producers);
+            ASSERT_EQ(next[p], value & 0xFFFFFF);
+            next[p]++;
+            received++;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    for(std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    EXPECT_EQ(0u, ring.size());
+}
@@ -0,0 +1,151 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#include "NumberFormat.h"
+
+/* STL Headers */
+#include <algorithm>
+
+/* C Headers */
+#include <math.h>
+#include <stdio.h>
+
+namespace
+{
+/// "00" to "99", so digits come out two at a time
+const char DIGIT_PAIRS[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+/// the most digits after the point the fast path handles
+const int FAST_PRECISION = 9;
+
+const double POWERS_OF_TEN[FAST_PRECISION + 1] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9};
+
+/**
+ * The fast path's whole part must fit in a uint64_t, and scaling the
+ * fraction is off by at most 1e9 * 2^-53, about 1.1e-7 of the last digit.
+ * Further than TIE_MARGIN from a half, rounding goes the same way it would
+ * for the exact value.
+ */
+const double FAST_LIMIT = 1e18;
+const double TIE_MARGIN = 1e-6;
+
+/// writes exactly digits digits of value, zero padded, ending just before end
+void writeDigits(char* end, uint64_t value, int digits)
+{
+    for(; digits >= 2; digits -= 2)
+    {
+        end -= 2;
+        memcpy(end, DIGIT_PAIRS + 2 * (value % 100), 2);
+        value /= 100;
+    }
+    if(digits == 1)
+    {
+        *--end = '0' + value % 10;
+    }
+}
+
+int countDigits(uint64_t value)
+{
+    int digits = 1;
+    for(; value >= 10; value /= 10)
+    {
+        digits++;
+    }
+    return digits;
+}
+}
+
+size_t NumberFormat::formatUnsigned(char* out, uint64_t value)
+{
+    int digits = countDigits(value);
+    writeDigits(out + digits, value, digits);
+    return digits;
+}
+
+size_t NumberFormat::formatInteger(char* out, int64_t value)
+{
+    if(value < 0)
+    {
+        *out = '-';
+        // negated as unsigned so INT64_MIN works
+        return 1 + formatUnsigned(out + 1, 0 - static_cast<uint64_t>(value));
+    }
+    return formatUnsigned(out, value);
+}
+
+size_t NumberFormat::formatFixedPrintf(char* out, double value, int precision)
+{
+    precision = std::max(0, std::min(MAX_PRECISION, precision));
+    int length = snprintf(out, MAX_LENGTH, "%.*f", precision, value);
+    return std::max(0, std::min(length, static_cast<int>(MAX_LENGTH) - 1));
+}
+
+size_t NumberFormat::formatFixed(char* out, double value, int precision)
+{
+    precision = std::max(0, std::min(MAX_PRECISION, precision));
+    double magnitude = fabs(value);
+    if(! (magnitude < FAST_LIMIT) || precision > FAST_PRECISION)
+    {
+        return formatFixedPrintf(out, value, precision);
+    }
+
+    // both exact, the fraction has no more bits than magnitude
+    double whole = floor(magnitude);
+    double scaled = (magnitude - whole) * POWERS_OF_TEN[precision];
+    double digits = floor(scaled);
+    double remainder = scaled - digits;
+    if(fabs(remainder - 0.5) < TIE_MARGIN)
+    {
+        return formatFixedPrintf(out, value, precision);
+    }
+
+    uint64_t integer = static_cast<uint64_t>(whole);
+    uint64_t fraction = static_cast<uint64_t>(digits) + (remainder > 0.5 ? 1 : 0);
+    if(fraction >= static_cast<uint64_t>(POWERS_OF_TEN[precision]))
+    {
+        fraction = 0;
+        integer++;
+    }
+
+    // printf keeps the sign of values that round to zero, and of -0.0
+    char* start = out;
+    if(signbit(value))
+    {
+        *out++ = '-';
+    }
+    out += formatUnsigned(out, integer);
+    if(precision > 0)
+    {
+        *out++ = '.';
+        writeDigits(out + precision, fraction, precision);
+        out += precision;
+    }
+    return out - start;
+}
+
+const size_t TextLine::CAPACITY;
+
+void TextLine::grow(size_t length)
+{
+    _capacity = std::max(length, 2 * _capacity);
+    if(_data == _stack)
+    {
+        _heap.assign(_stack, _length);
+    }
+    _heap.resize(_capacity);
+    _data = &_heap[0];
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#ifndef NUMBER_FORMAT_H_
+#define NUMBER_FORMAT_H_
+
+/* STL Headers */
+#include <string>
+#include <type_traits>
+
+/* C Headers */
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+/**
+ * Number to text for the .dat logs, written straight in to a caller's
+ * buffer with no streams, locale or temporary strings.
+ *
+ * Integers come out as std::to_string writes them. Floating point is fixed
+ * precision like printf's %f, so at DEFAULT_PRECISION it is exactly what
+ * std::to_string wrote before. Values too large for 64 bit digits, or so
+ * close to halfway between two outputs that the fast path can't be sure
+ * which way to round, fall back to snprintf.
+ *
+ * @code
+ * char text[NumberFormat::MAX_LENGTH];
+ * size_t length = NumberFormat::format(text, 3.14159, 3);   // "3.142"
+ * @endcode
+ */
+namespace NumberFormat
+{
+/// the most characters one formatted number takes
+static const size_t MAX_LENGTH = 350;
+/// digits after the point std::to_string writes
+static const int DEFAULT_PRECISION = 6;
+/// more digits than a double holds, larger precisions are clamped to it
+static const int MAX_PRECISION = 17;
+
+/// writes value to out, returns the characters written
+size_t formatInteger(char* out, int64_t value);
+size_t formatUnsigned(char* out, uint64_t value);
+
+/// writes value with precision digits after the point, clamped to 0 to MAX_PRECISION
+size_t formatFixed(char* out, double value, int precision);
+
+/// the fixed point text of value through snprintf, what formatFixed() must match
+size_t formatFixedPrintf(char* out, double value, int precision);
+
+inline size_t format(char* out, double value, int precision)
+{
+    return formatFixed(out, value, precision);
+}
+
+inline size_t format(char* out, float value, int precision)
+{
+    return formatFixed(out, value, precision);
+}
+
+template<typename T>
+typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value, size_t>::type
+format(char* out, T value, int)
+{
+    return formatInteger(out, value);
+}
+
+template<typename T>
+typename std::enable_if<std::is_integral<T>::value && ! std::is_signed<T>::value, size_t>::type
+format(char* out, T value, int)
+{
+    return formatUnsigned(out, value);
+}
+
+/// appends value to out, going through a buffer on the stack
+template<typename T>
+void append(std::string& out, T value, int precision)
+{
+    char text[MAX_LENGTH];
+    out.append(text, format(text, value, precision));
+}
+}
+
+/**
+ * A line of a log built in place: on the stack while it fits in CAPACITY,
+ * moving to the heap only for the rare line that doesn't.
+ */
+class TextLine
+{
+public:
+    static const size_t CAPACITY = 1024;
+
+    TextLine()
+    :_data(_stack),
+     _length(0),
+     _capacity(CAPACITY)
+    {}
+
+    /// appends value, formatted by NumberFormat::format
+    template<typename T>
+    void appendNumber(T value, int precision)
+    {
+        _length += NumberFormat::format(reserve(NumberFormat::MAX_LENGTH), value, precision);
+    }
+
+    void append(char c)
+    {
+        *reserve(1) = c;
+        _length++;
+    }
+
+    void append(const char* data, size_t length)
+    {
+        memcpy(reserve(length), data, length);
+        _length += length;
+    }
+
+    const char* data() const
+    {
+        return _data;
+    }
+
+    size_t size() const
+    {
+        return _length;
+    }
+
+private:
+    TextLine(const TextLine&);
+    TextLine& operator=(const TextLine&);
+
+    /// room for length more characters, returns where they go
+    char* reserve(size_t length)
+    {
+        if(_length + length > _capacity)
+        {
+            grow(_length + length);
+        }
+        return _data + _length;
+    }
+
+    void grow(size_t length);
+
+    char _stack[CAPACITY];
+    std::string _heap;
+    char* _data;
+    size_t _length;
+    size_t _capacity;
+};
+
+#endif /* NUMBER_FORMAT_H_ */
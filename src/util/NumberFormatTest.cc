@@ -0,0 +1,115 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "NumberFormat.h"
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <random>
+#include <string>
+
+#include <math.h>
+
+namespace
+{
+template<typename T>
+std::string format(T value, int precision = NumberFormat::DEFAULT_PRECISION)
+{
+    std::string out;
+    NumberFormat::append(out, value, precision);
+    return out;
+}
+
+std::string printfFixed(double value, int precision)
+{
+    char text[NumberFormat::MAX_LENGTH];
+    return std::string(text, NumberFormat::formatFixedPrintf(text, value, precision));
+}
+}
+
+TEST(NumberFormat, IntegersMatchToString)
+{
+    EXPECT_EQ("0", format(0));
+    EXPECT_EQ("-7", format(-7));
+    EXPECT_EQ("1500", format(static_cast<uint16_t>(1500)));
+    EXPECT_EQ("-128", format(static_cast<int8_t>(-128)));
+    EXPECT_EQ("1", format(true));
+    EXPECT_EQ(std::to_string(std::numeric_limits<int64_t>::min()), format(std::numeric_limits<int64_t>::min()));
+    EXPECT_EQ(std::to_string(std::numeric_limits<int64_t>::max()), format(std::numeric_limits<int64_t>::max()));
+    EXPECT_EQ(std::to_string(std::numeric_limits<uint64_t>::max()), format(std::numeric_limits<uint64_t>::max()));
+
+    for(int64_t value = 1; value < 1000000000000000000ll; value *= 7)
+    {
+        EXPECT_EQ(std::to_string(value), format(value));
+        EXPECT_EQ(std::to_string(-value), format(-value));
+    }
+}
+
+TEST(NumberFormat, DefaultPrecisionMatchesToString)
+{
+    const double values[] = {0.0, -0.0, 1.0, -1.0, 0.5, 0.0000005, -0.0000004, 0.9999996, 123.4567895,
+                             3.141592653589793, 1e15, -2.5e17, 1e18, 1e300, -1e-300,
+                             INFINITY, -INFINITY, NAN};
+    for(double value : values)
+    {
+        EXPECT_EQ(std::to_string(value), format(value)) << value;
+    }
+    EXPECT_EQ(std::to_string(0.1f), format(0.1f));
+
+    std::mt19937_64 random(42);
+    std::uniform_real_distribution<double> small(-10.0, 10.0);
+    std::uniform_real_distribution<double> exponent(-8.0, 17.0);
+    for(int i = 0; i < 200000; i++)
+    {
+        double value = small(random);
+        ASSERT_EQ(std::to_string(value), format(value)) << value;
+
+        value = small(random) * pow(10.0, exponent(random));
+        ASSERT_EQ(std::to_string(value), format(value)) << value;
+    }
+}
+
+TEST(NumberFormat, OtherPrecisionsMatchPrintf)
+{
+    std::mt19937_64 random(7);
+    std::uniform_real_distribution<double> values(-1000.0, 1000.0);
+    for(int precision = 0; precision <= NumberFormat::MAX_PRECISION; precision++)
+    {
+        for(int i = 0; i < 20000; i++)
+        {
+            double value = values(random);
+            ASSERT_EQ(printfFixed(value, precision), format(value, precision)) << value << " " << precision;
+        }
+    }
+
+    // exact ties go to even like printf
+    EXPECT_EQ("2", format(2.5, 0));
+    EXPECT_EQ("4", format(3.5, 0));
+    EXPECT_EQ("0.12", format(0.125, 2));
+    EXPECT_EQ("10.0", format(9.96, 1));
+    EXPECT_EQ("-0", format(-0.2, 0));
+
+    // out of range precisions are clamped
+    EXPECT_EQ("3", format(3.14, -2));
+    EXPECT_EQ(printfFixed(0.1, 17), format(0.1, 40));
+}
+
+TEST(TextLine, GrowsPastTheStack)
+{
+    TextLine line;
+    std::string expected;
+    for(int i = 0; i < 1000; i++)
+    {
+        line.appendNumber(i * 0.25, 2);
+        line.append('\t');
+        expected += format(i * 0.25, 2) + "\t";
+    }
+    line.append("end\n", 4);
+    expected += "end\n";
+
+    EXPECT_GT(line.size(), TextLine::CAPACITY);
+    EXPECT_EQ(expected, std::string(line.data(), line.size()));
+}
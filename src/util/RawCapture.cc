@@ -0,0 +1,283 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#include "RawCapture.h"
+
+/* STL Headers */
+#include <algorithm>
+#include <chrono>
+#include <list>
+#include <thread>
+
+/* C Headers */
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+/* Project Headers */
+#include "Wakeup.h"
+
+const char RawCapture::MAGIC[8] = {'U', 'D', 'C', 'A', 'P', '0', '0', '1'};
+
+namespace
+{
+/// how often staged reads are written out when nothing is filling up
+const std::chrono::milliseconds FLUSH_PERIOD(100);
+
+/**
+ * The one thread that writes every capture out.
+ */
+class CaptureFlusher
+{
+public:
+    static CaptureFlusher& instance()
+    {
+        // never destroyed, its thread runs until the process exits
+        static CaptureFlusher* flusher = new CaptureFlusher();
+        return *flusher;
+    }
+
+    void add(RawCapture* capture)
+    {
+        std::lock_guard<std::mutex> lock(_captures_lock);
+        _captures.push_back(capture);
+
+        if(! _started)
+        {
+            _started = true;
+            std::thread(&CaptureFlusher::run, this).detach();
+        }
+    }
+
+    /// once this returns the flusher will not touch capture again
+    void remove(RawCapture* capture)
+    {
+        std::lock_guard<std::mutex> lock(_captures_lock);
+        _captures.remove(capture);
+    }
+
+    /// asks for a flush sooner than the next period
+    void nudge()
+    {
+        _wakeup.notify();
+    }
+
+private:
+    CaptureFlusher()
+    :_started(false)
+    {}
+
+    void run()
+    {
+        while(true)
+        {
+            _wakeup.wait(FLUSH_PERIOD);
+
+            std::lock_guard<std::mutex> lock(_captures_lock);
+            for(RawCapture* capture : _captures)
+            {
+                capture->flush();
+            }
+        }
+    }
+
+    std::list<RawCapture*> _captures;
+    std::mutex _captures_lock;
+    bool _started;
+    Wakeup _wakeup;
+};
+
+void put_le(uint8_t* out, uint64_t value, size_t bytes)
+{
+    for(size_t i = 0; i < bytes; i++)
+    {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+/**
+ * Opens a capture at path to append to. A file that doesn't start with MAGIC
+ * is renamed to path.old first, records appended to it would be unreadable.
+ * Returns -1 on failure.
+ */
+int open_capture(const std::string& path)
+{
+    const int flags = O_CREAT | O_RDWR | O_APPEND | O_CLOEXEC;
+    const mode_t mode = S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH;
+    int fd = open(path.c_str(), flags, mode);
+    struct stat info;
+    if(fd < 0 || fstat(fd, &info) != 0)
+    {
+        if(fd >= 0)
+        {
+            close(fd);
+        }
+        return -1;
+    }
+
+    if(info.st_size > 0)
+    {
+        uint8_t magic[RawCapture::MAGIC_LENGTH];
+        if(pread(fd, magic, sizeof(magic), 0) == static_cast<ssize_t>(sizeof(magic)) &&
+           RawCapture::isCapture(magic, sizeof(magic)))
+        {
+            return fd;
+        }
+
+        close(fd);
+        if(rename(path.c_str(), (path + ".old").c_str()) != 0 ||
+           (fd = open(path.c_str(), flags, mode)) < 0)
+        {
+            return -1;
+        }
+    }
+
+    if(write(fd, RawCapture::MAGIC, RawCapture::MAGIC_LENGTH) != static_cast<ssize_t>(RawCapture::MAGIC_LENGTH))
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+uint64_t get_le(const uint8_t* in, size_t bytes)
+{
+    uint64_t value = 0;
+    for(size_t i = 0; i < bytes; i++)
+    {
+        value |= static_cast<uint64_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+}
+
+RawCapture::RawCapture(const std::string& path)
+    :_fd(open_capture(path)),
+     _head(0),
+     _tail(0),
+     _dropped_bytes(0)
+{
+    if(_fd < 0)
+    {
+        return;
+    }
+
+    CaptureFlusher::instance().add(this);
+}
+
+RawCapture::~RawCapture()
+{
+    if(_fd < 0)
+    {
+        return;
+    }
+
+    CaptureFlusher::instance().remove(this);
+    flush();
+    close(_fd);
+}
+
+uint64_t RawCapture::now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void RawCapture::stage(size_t position, const void* data, size_t length)
+{
+    size_t start = position & MASK;
+    size_t first = std::min(length, STAGING_SIZE - start);
+    memcpy(_staging + start, data, first);
+    memcpy(_staging, static_cast<const uint8_t*>(data) + first, length - first);
+}
+
+void RawCapture::record(uint64_t timestamp_ns, const void* data, size_t length)
+{
+    if(_fd < 0 || length == 0)
+    {
+        return;
+    }
+
+    size_t tail = _tail.value.load(std::memory_order_relaxed);
+    size_t used = tail - _head.value.load(std::memory_order_acquire);
+    size_t needed = RECORD_HEADER_LENGTH + length;
+    if(needed > STAGING_SIZE - used)
+    {
+        _dropped_bytes += length;
+        CaptureFlusher::instance().nudge();
+        return;
+    }
+
+    uint8_t header[RECORD_HEADER_LENGTH];
+    put_le(header, timestamp_ns, 8);
+    put_le(header + 8, length, 4);
+    stage(tail, header, RECORD_HEADER_LENGTH);
+    stage(tail + RECORD_HEADER_LENGTH, data, length);
+    _tail.value.store(tail + needed, std::memory_order_release);
+
+    // past half full, don't wait for the next period
+    if(used < STAGING_SIZE / 2 && used + needed >= STAGING_SIZE / 2)
+    {
+        CaptureFlusher::instance().nudge();
+    }
+}
+
+size_t RawCapture::flush()
+{
+    std::lock_guard<std::mutex> lock(_flush_lock);
+    size_t head = _head.value.load(std::memory_order_relaxed);
+    size_t tail = _tail.value.load(std::memory_order_acquire);
+    if(head == tail || _fd < 0)
+    {
+        return 0;
+    }
+
+    // everything staged in one call, two pieces if it wraps around the end of the buffer
+    size_t start = head & MASK;
+    size_t length = tail - head;
+    size_t first = std::min(length, STAGING_SIZE - start);
+    iovec pieces[2] = {{_staging + start, first}, {_staging, length - first}};
+
+    ssize_t written = writev(_fd, pieces, length == first ? 1 : 2);
+    if(written < 0)
+    {
+        // the records are gone, count them so the loss shows up somewhere
+        _dropped_bytes += length;
+        written = length;
+    }
+
+    _head.value.store(head + written, std::memory_order_release);
+    return written;
+}
+
+bool RawCapture::isCapture(const uint8_t* data, size_t size)
+{
+    return size >= MAGIC_LENGTH && memcmp(data, MAGIC, MAGIC_LENGTH) == 0;
+}
+
+bool RawCapture::nextRecord(const uint8_t* data, size_t size, size_t& offset, Record& record)
+{
+    if(offset + RECORD_HEADER_LENGTH > size)
+    {
+        return false;
+    }
+
+    uint32_t length = get_le(data + offset + 8, 4);
+    if(offset + RECORD_HEADER_LENGTH + length > size)
+    {
+        return false;
+    }
+
+    record.timestamp_ns = get_le(data + offset, 8);
+    record.length = length;
+    record.data = data + offset + RECORD_HEADER_LENGTH;
+    offset += RECORD_HEADER_LENGTH + length;
+    return true;
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#ifndef RAW_CAPTURE_H_
+#define RAW_CAPTURE_H_
+
+/* STL Headers */
+#include <atomic>
+#include <mutex>
+#include <string>
+
+/* C Headers */
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief Saves the raw bytes a driver reads, timestamped, without slowing the driver down.
+ *
+ * record() copies each read in to a lock-free staging buffer and returns, a
+ * background thread shared by every capture drains the buffers with one
+ * writev() per file. If the disk falls far enough behind that a read won't
+ * fit it is dropped and counted rather than blocking the sensor thread.
+ *
+ * The file starts with the eight bytes of MAGIC, then each read is a record of
+ *
+ *     uint64_t timestamp_ns   steady_clock time the read returned
+ *     uint32_t length
+ *     uint8_t  data[length]
+ *
+ * in little endian order, so a replay can reproduce the original timing.
+ * Use nextRecord() to walk a capture.
+ *
+ * record() must only be called from one thread at a time.
+ */
+class RawCapture
+{
+public:
+    static const char MAGIC[8];
+    static const size_t MAGIC_LENGTH = sizeof(MAGIC);
+    static const size_t RECORD_HEADER_LENGTH = 12;
+    /// bytes staged per capture, about a second of every sensor on board
+    static const size_t STAGING_SIZE = 1 << 16;
+
+    /// one read from a capture file, data points in to the buffer passed to nextRecord()
+    struct Record
+    {
+        uint64_t timestamp_ns;
+        uint32_t length;
+        const uint8_t* data;
+    };
+
+    /**
+     * Opens path for appending, writing MAGIC if the file is new. A file that
+     * doesn't start with MAGIC, such as raw bytes saved before reads were
+     * timestamped, is renamed to path.old (replacing any earlier one) and a
+     * new capture started. Check isOpen() to see if it worked.
+     */
+    explicit RawCapture(const std::string& path);
+
+    /// writes out anything still staged and closes the file
+    ~RawCapture();
+
+    bool isOpen() const
+    {
+        return _fd >= 0;
+    }
+
+    /**
+     * Stages a read to be written, never blocks or allocates.
+     */
+    void record(uint64_t timestamp_ns, const void* data, size_t length);
+
+    /**
+     * Writes everything staged so far, returns the number of bytes written.
+     * Called by the background thread, but safe to call from anywhere.
+     */
+    size_t flush();
+
+    /// bytes of data (not counting record headers) dropped because staging was full or the write failed
+    uint64_t droppedBytes() const
+    {
+        return _dropped_bytes.load();
+    }
+
+    /// the clock timestamps are measured with
+    static uint64_t now_ns();
+
+    /// true if data starts with MAGIC
+    static bool isCapture(const uint8_t* data, size_t size);
+
+    /**
+     * Decodes the record at offset, moving offset to the next one. Start
+     * offset at MAGIC_LENGTH. Returns false at the end of the data or if the
+     * last record was cut short.
+     */
+    static bool nextRecord(const uint8_t* data, size_t size, size_t& offset, Record& record);
+
+private:
+    RawCapture(const RawCapture&);
+    RawCapture& operator=(const RawCapture&);
+
+    static const size_t MASK = STAGING_SIZE - 1;
+
+    /// copies length bytes in to staging starting at the unmasked position
+    void stage(size_t position, const void* data, size_t length);
+
+    /// a position padded out to its own cache line so the reader and flusher don't fight over it
+    struct PaddedIndex
+    {
+        std::atomic<size_t> value;
+        char pad[64 - sizeof(std::atomic<size_t>)];
+
+        PaddedIndex(size_t v) : value(v) {}
+    };
+
+    int _fd;
+    /// flusher position
+    PaddedIndex _head;
+    /// reader position
+    PaddedIndex _tail;
+    std::atomic<uint64_t> _dropped_bytes;
+    /// only one flush() moves _head at a time
+    std::mutex _flush_lock;
+    uint8_t _staging[STAGING_SIZE];
+};
+
+#endif /* RAW_CAPTURE_H_ */
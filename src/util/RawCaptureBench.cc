@@ -0,0 +1,105 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "RawCapture.h"
+#include "LatencyHistogram.h"
+#include "Benchmark.h"
+
+#include <thread>
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+namespace
+{
+const int READS = 20000;
+
+std::string temp_path()
+{
+    char name[] = "/tmp/raw_capture_bench_XXXXXX";
+    close(mkstemp(name));
+    unlink(name);
+    return name;
+}
+
+/**
+ * Times the call made after every read, spread out a little like a serial
+ * port would be so the background writer gets to run.
+ */
+template <class Save>
+void run(Benchmark& bench, size_t read_size, Save save)
+{
+    uint8_t buf[256] = {0};
+    LatencyHistogram latency;
+
+    for(int i = 0; i < READS; i++)
+    {
+        uint64_t start = Benchmark::nowNanos();
+        save(buf, read_size);
+        latency.record(Benchmark::nowNanos() - start);
+
+        if(i % 100 == 99)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+
+    bench.report("mean", latency.mean(), "ns/read");
+    bench.report("p99", latency.percentile(0.99), "ns/read");
+    bench.report("max", latency.max() / 1000.0, "us");
+}
+
+/// what readDevice did before, a write() on the reading thread
+void synchronous(Benchmark& bench, size_t read_size)
+{
+    std::string path = temp_path();
+    int fd = open(path.c_str(), O_CREAT | O_WRONLY | O_APPEND, S_IRUSR | S_IWUSR);
+    run(bench, read_size, [fd](const uint8_t* data, size_t length)
+    {
+        if(write(fd, data, length) < 0)
+        {
+            return;
+        }
+    });
+    close(fd);
+    unlink(path.c_str());
+}
+
+void staged(Benchmark& bench, size_t read_size)
+{
+    std::string path = temp_path();
+    {
+        RawCapture capture(path);
+        run(bench, read_size, [&capture](const uint8_t* data, size_t length)
+        {
+            capture.record(RawCapture::now_ns(), data, length);
+        });
+        bench.report("dropped", capture.droppedBytes(), "bytes");
+    }
+    unlink(path.c_str());
+}
+}
+
+BENCHMARK(RawCapture, WriteOneByte)
+{
+    synchronous(bench, 1);
+}
+
+BENCHMARK(RawCapture, StagedOneByte)
+{
+    staged(bench, 1);
+}
+
+BENCHMARK(RawCapture, Write64Bytes)
+{
+    synchronous(bench, 64);
+}
+
+BENCHMARK(RawCapture, Staged64Bytes)
+{
+    staged(bench, 64);
+}
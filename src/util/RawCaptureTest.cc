@@ -0,0 +1,176 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "RawCapture.h"
+#include "AllocationCounter.h"
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+namespace
+{
+/// a temporary file name that is removed at the end of the test
+struct TempPath
+{
+    std::string path;
+
+    TempPath()
+    {
+        char name[] = "/tmp/raw_capture_XXXXXX";
+        int fd = mkstemp(name);
+        close(fd);
+        unlink(name);
+        path = name;
+    }
+
+    ~TempPath()
+    {
+        unlink(path.c_str());
+    }
+
+    std::vector<uint8_t> contents() const
+    {
+        std::ifstream file(path.c_str(), std::ios::binary);
+        return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+};
+}
+
+TEST(RawCapture, RecordsAreFramedWithTimestamps)
+{
+    TempPath temp;
+    {
+        RawCapture capture(temp.path);
+        ASSERT_TRUE(capture.isOpen());
+        capture.record(100, "abc", 3);
+        capture.record(250, "x", 1);
+        capture.record(251, "ignored", 0);
+    }
+
+    std::vector<uint8_t> data = temp.contents();
+    ASSERT_TRUE(RawCapture::isCapture(&data[0], data.size()));
+
+    size_t offset = RawCapture::MAGIC_LENGTH;
+    RawCapture::Record record;
+    ASSERT_TRUE(RawCapture::nextRecord(&data[0], data.size(), offset, record));
+    EXPECT_EQ(100u, record.timestamp_ns);
+    ASSERT_EQ(3u, record.length);
+    EXPECT_EQ(0, memcmp("abc", record.data, 3));
+
+    ASSERT_TRUE(RawCapture::nextRecord(&data[0], data.size(), offset, record));
+    EXPECT_EQ(250u, record.timestamp_ns);
+    ASSERT_EQ(1u, record.length);
+    EXPECT_EQ('x', record.data[0]);
+
+    EXPECT_FALSE(RawCapture::nextRecord(&data[0], data.size(), offset, record));
+    EXPECT_EQ(data.size(), offset);
+}
+
+TEST(RawCapture, AppendsWithoutRepeatingMagic)
+{
+    TempPath temp;
+    {
+        RawCapture capture(temp.path);
+        capture.record(1, "a", 1);
+    }
+    {
+        RawCapture capture(temp.path);
+        capture.record(2, "b", 1);
+    }
+
+    std::vector<uint8_t> data = temp.contents();
+    size_t offset = RawCapture::MAGIC_LENGTH;
+    RawCapture::Record record;
+    int records = 0;
+    while(RawCapture::nextRecord(&data[0], data.size(), offset, record))
+    {
+        records++;
+        EXPECT_EQ(records, (int) record.timestamp_ns);
+    }
+    EXPECT_EQ(2, records);
+}
+
+TEST(RawCapture, WrapsAndDropsWithoutBlocking)
+{
+    TempPath temp;
+    RawCapture capture(temp.path);
+    std::vector<uint8_t> chunk(1000);
+    for(size_t i = 0; i < chunk.size(); i++)
+    {
+        chunk[i] = i & 0xFF;
+    }
+
+    // more than the staging buffer holds before anything is flushed, and no allocations doing it
+    const int chunks = 2 * RawCapture::STAGING_SIZE / chunk.size();
+    uint64_t allocations = AllocationCounter::allocations();
+    for(int i = 0; i < chunks; i++)
+    {
+        capture.record(i, &chunk[0], chunk.size());
+        if(i % 50 == 49)
+        {
+            capture.flush();
+        }
+    }
+    EXPECT_EQ(0u, AllocationCounter::allocations() - allocations);
+    capture.flush();
+
+    std::vector<uint8_t> data = temp.contents();
+    size_t offset = RawCapture::MAGIC_LENGTH;
+    RawCapture::Record record;
+    uint64_t saved = 0;
+    uint64_t last_timestamp = 0;
+    while(RawCapture::nextRecord(&data[0], data.size(), offset, record))
+    {
+        ASSERT_EQ(chunk.size(), record.length);
+        EXPECT_EQ(0, memcmp(&chunk[0], record.data, chunk.size()));
+        EXPECT_TRUE(saved == 0 || record.timestamp_ns > last_timestamp);
+        last_timestamp = record.timestamp_ns;
+        saved += record.length;
+    }
+
+    EXPECT_EQ(data.size(), offset);
+    EXPECT_EQ(chunks * chunk.size(), saved + capture.droppedBytes());
+}
+
+TEST(RawCapture, MovesAsideAFileThatIsNotACapture)
+{
+    TempPath temp;
+    std::string old = temp.path + ".old";
+    {
+        std::ofstream plain(temp.path.c_str(), std::ios::binary);
+        plain << "raw bytes saved before captures";
+    }
+    {
+        RawCapture capture(temp.path);
+        ASSERT_TRUE(capture.isOpen());
+        capture.record(1, "a", 1);
+    }
+
+    std::vector<uint8_t> data = temp.contents();
+    ASSERT_TRUE(RawCapture::isCapture(&data[0], data.size()));
+    size_t offset = RawCapture::MAGIC_LENGTH;
+    RawCapture::Record record;
+    ASSERT_TRUE(RawCapture::nextRecord(&data[0], data.size(), offset, record));
+    EXPECT_EQ(1u, record.timestamp_ns);
+    EXPECT_EQ(data.size(), offset);
+
+    std::ifstream moved(old.c_str());
+    std::string contents((std::istreambuf_iterator<char>(moved)), std::istreambuf_iterator<char>());
+    EXPECT_EQ("raw bytes saved before captures", contents);
+    unlink(old.c_str());
+}
+
+TEST(RawCapture, BadPathIsNotOpen)
+{
+    RawCapture capture("/nonexistent/directory/capture.bin");
+    EXPECT_FALSE(capture.isOpen());
+    capture.record(0, "a", 1);
+}
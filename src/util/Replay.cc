@@ -0,0 +1,293 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#include "Replay.h"
+
+/* STL Headers */
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+
+/* C Headers */
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+/* Project Headers */
+#include "RawCapture.h"
+
+namespace
+{
+/// the longest a replay sleeps before checking whether it should stop
+const uint64_t MAX_SLEEP_NS = 100000000;
+
+uint64_t now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+}
+
+/* ReplayRecording */
+bool ReplayRecording::load(const std::string& path, int baud, size_t chunk_size)
+{
+    std::ifstream file(path.c_str(), std::ios::binary);
+    if(! file)
+    {
+        return false;
+    }
+
+    return loadBytes(std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()),
+                     baud, chunk_size);
+}
+
+bool ReplayRecording::loadBytes(const std::vector<uint8_t>& bytes, int baud, size_t chunk_size)
+{
+    _data = bytes;
+    _chunks.clear();
+    _timestamped = RawCapture::isCapture(_data.data(), _data.size());
+
+    if(_timestamped)
+    {
+        size_t offset = RawCapture::MAGIC_LENGTH;
+        RawCapture::Record record;
+        uint64_t first_ns = 0;
+        while(RawCapture::nextRecord(_data.data(), _data.size(), offset, record))
+        {
+            if(_chunks.empty())
+            {
+                first_ns = record.timestamp_ns;
+            }
+            else if(static_cast<int64_t>(record.timestamp_ns - first_ns - _chunks.back().offset_ns) < 0)
+            {
+                // captures appended across restarts go back in time, carry on from the last read
+                first_ns = record.timestamp_ns - _chunks.back().offset_ns;
+            }
+
+            Chunk chunk = {record.timestamp_ns - first_ns, record.data, record.length};
+            _chunks.push_back(chunk);
+        }
+
+        return ! _chunks.empty();
+    }
+
+    if(baud <= 0 || chunk_size == 0)
+    {
+        return false;
+    }
+
+    // 8N1 framing puts ten bits on the wire for every byte
+    const double ns_per_byte = 1e10 / baud;
+    for(size_t start = 0; start < _data.size(); start += chunk_size)
+    {
+        Chunk chunk = {static_cast<uint64_t>(start * ns_per_byte),
+                       _data.data() + start,
+                       static_cast<uint32_t>(std::min(chunk_size, _data.size() - start))};
+        _chunks.push_back(chunk);
+    }
+
+    return ! _chunks.empty();
+}
+
+size_t ReplayRecording::bytes() const
+{
+    size_t total = 0;
+    for(const Chunk& chunk : _chunks)
+    {
+        total += chunk.length;
+    }
+    return total;
+}
+
+/* ReplayClock */
+ReplayClock::ReplayClock(double speed)
+    :_speed(speed),
+     _started(false),
+     _start_ns(0)
+{
+}
+
+void ReplayClock::start()
+{
+    _started = true;
+    _start_ns = now_ns();
+}
+
+bool ReplayClock::waitUntil(uint64_t offset_ns, const std::atomic_bool* stop)
+{
+    if(_speed <= 0)
+    {
+        return stop == nullptr || ! stop->load();
+    }
+
+    if(! _started)
+    {
+        start();
+    }
+
+    const uint64_t due = _start_ns + static_cast<uint64_t>(offset_ns / _speed);
+    while(true)
+    {
+        if(stop != nullptr && stop->load())
+        {
+            return false;
+        }
+
+        uint64_t now = now_ns();
+        if(now >= due)
+        {
+            return true;
+        }
+
+        std::this_thread::sleep_for(std::chrono::nanoseconds(std::min(due - now, MAX_SLEEP_NS)));
+    }
+}
+
+/* ReplayInjector */
+ReplayInjector::ReplayInjector(const ReplayRecording& recording, double speed)
+    :_recording(recording),
+     _clock(speed),
+     _chunk(0),
+     _offset(0)
+{
+}
+
+int ReplayInjector::read(void* buf, int n)
+{
+    if(finished() || n <= 0)
+    {
+        return 0;
+    }
+
+    const ReplayRecording::Chunk& chunk = _recording[_chunk];
+    if(_offset == 0)
+    {
+        _clock.waitUntil(chunk.offset_ns);
+    }
+
+    size_t amount = std::min(static_cast<size_t>(n), chunk.length - _offset);
+    memcpy(buf, chunk.data + _offset, amount);
+    _offset += amount;
+
+    if(_offset == chunk.length)
+    {
+        _chunk++;
+        _offset = 0;
+    }
+
+    return amount;
+}
+
+/* ReplayPty */
+ReplayPty::ReplayPty(const ReplayRecording& recording, double speed)
+    :_recording(recording),
+     _clock(speed),
+     _master(-1),
+     _slave(-1),
+     _stop(false),
+     _finished(false)
+{
+}
+
+ReplayPty::~ReplayPty()
+{
+    _stop = true;
+    if(_thread.joinable())
+    {
+        _thread.join();
+    }
+
+    if(_slave >= 0)
+    {
+        close(_slave);
+    }
+
+    if(_master >= 0)
+    {
+        close(_master);
+    }
+}
+
+bool ReplayPty::open()
+{
+    _master = posix_openpt(O_RDWR | O_NOCTTY);
+    if(_master < 0 || grantpt(_master) != 0 || unlockpt(_master) != 0)
+    {
+        return false;
+    }
+
+    _path = ptsname(_master);
+    _slave = ::open(_path.c_str(), O_RDWR | O_NOCTTY);
+    if(_slave < 0)
+    {
+        return false;
+    }
+
+    // no line discipline between the recording and the driver
+    termios settings;
+    tcgetattr(_slave, &settings);
+    cfmakeraw(&settings);
+    tcsetattr(_slave, TCSANOW, &settings);
+    return true;
+}
+
+void ReplayPty::start()
+{
+    _thread = std::thread(&ReplayPty::play, this);
+}
+
+void ReplayPty::wait()
+{
+    if(_thread.joinable())
+    {
+        _thread.join();
+    }
+}
+
+void ReplayPty::drain()
+{
+    uint8_t discard[256];
+    pollfd p = {_master, POLLIN, 0};
+    while(poll(&p, 1, 0) > 0 && (p.revents & POLLIN) && ::read(_master, discard, sizeof(discard)) > 0)
+    {
+    }
+}
+
+void ReplayPty::play()
+{
+    for(size_t i = 0; i < _recording.chunks() && _clock.waitUntil(_recording[i].offset_ns, &_stop); i++)
+    {
+        drain();
+
+        const ReplayRecording::Chunk& chunk = _recording[i];
+        size_t written = 0;
+        while(written < chunk.length && ! _stop)
+        {
+            // wait for the driver to make room rather than blocking where _stop can't be seen
+            pollfd p = {_master, POLLOUT, 0};
+            if(poll(&p, 1, 100) <= 0)
+            {
+                drain();
+                continue;
+            }
+
+            ssize_t amount = ::write(_master, chunk.data + written, chunk.length - written);
+            if(amount < 0)
+            {
+                _stop = true;
+                break;
+            }
+            written += amount;
+        }
+    }
+
+    _finished = true;
+}
@@ -0,0 +1,199 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#ifndef REPLAY_H_
+#define REPLAY_H_
+
+/* STL Headers */
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* C Headers */
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief A sensor recording loaded in to memory as the reads it was captured in.
+ *
+ * Captures saved through read_save_path (see RawCapture) keep the size and
+ * time of every read. Plain byte recordings like recorded_data/imu_data.bin
+ * have no timing, so they are cut in to chunk_size pieces spaced as far apart
+ * as they would arrive over a serial port at baud.
+ */
+class ReplayRecording
+{
+public:
+    /// one read, offset_ns is measured from the first read in the recording
+    struct Chunk
+    {
+        uint64_t offset_ns;
+        const uint8_t* data;
+        uint32_t length;
+    };
+
+    /**
+     * Reads path in to memory, returns false if it can't be read or is empty.
+     */
+    bool load(const std::string& path, int baud = 115200, size_t chunk_size = 64);
+
+    /// loads bytes already in memory the same way load() treats a file
+    bool loadBytes(const std::vector<uint8_t>& bytes, int baud = 115200, size_t chunk_size = 64);
+
+    size_t chunks() const
+    {
+        return _chunks.size();
+    }
+
+    const Chunk& operator[](size_t index) const
+    {
+        return _chunks[index];
+    }
+
+    /// the total number of bytes read
+    size_t bytes() const;
+
+    /// the time from the first read to the last
+    uint64_t duration_ns() const
+    {
+        return _chunks.empty() ? 0 : _chunks.back().offset_ns;
+    }
+
+    /// true if the recording carried its own timestamps
+    bool timestamped() const
+    {
+        return _timestamped;
+    }
+
+private:
+    std::vector<uint8_t> _data;
+    std::vector<Chunk> _chunks;
+    bool _timestamped = false;
+};
+
+/**
+ * @brief Decides when each read of a recording is due.
+ *
+ * A speed of 1 plays back in real time, 10 ten times faster and 0 (or
+ * anything not positive) as fast as possible, which doubles as a
+ * throughput benchmark for whatever is consuming the bytes.
+ */
+class ReplayClock
+{
+public:
+    explicit ReplayClock(double speed);
+
+    /// starts the playback clock, called automatically on the first waitUntil()
+    void start();
+
+    /**
+     * Sleeps until a read recorded offset_ns in to the recording is due,
+     * giving up early if stop is set. Returns false if it gave up.
+     */
+    bool waitUntil(uint64_t offset_ns, const std::atomic_bool* stop = nullptr);
+
+    double speed() const
+    {
+        return _speed;
+    }
+
+private:
+    double _speed;
+    bool _started;
+    uint64_t _start_ns;
+};
+
+/**
+ * @brief Hands a recording out one read at a time in place of a serial port.
+ *
+ * Driver::readDevice uses this when replay_path is set, every read the driver
+ * makes gets the next recorded read (or what is left of it if the driver's
+ * buffer is smaller), so the framers and parsers see exactly the bytes and
+ * boundaries they saw in flight.
+ *
+ * read() must only be called from one thread.
+ */
+class ReplayInjector
+{
+public:
+    ReplayInjector(const ReplayRecording& recording, double speed);
+
+    /**
+     * Waits until the next read is due then copies up to n bytes of it to buf.
+     * Returns 0 once the recording has finished.
+     */
+    int read(void* buf, int n);
+
+    bool finished() const
+    {
+        return _chunk >= _recording.chunks();
+    }
+
+private:
+    const ReplayRecording& _recording;
+    ReplayClock _clock;
+    size_t _chunk;
+    /// bytes of the current chunk already handed out
+    size_t _offset;
+};
+
+/**
+ * @brief Plays a recording down a pseudo terminal so drivers can open it like the real port.
+ *
+ * Point a driver's serial_port at path() and start() the replay. Anything
+ * the driver writes back, like configuration commands, is read and thrown
+ * away so the driver never blocks on a full pty.
+ */
+class ReplayPty
+{
+public:
+    ReplayPty(const ReplayRecording& recording, double speed);
+
+    /// stops playback and closes the pty
+    ~ReplayPty();
+
+    /// creates the pty, returns false if the system has none to give
+    bool open();
+
+    /// the device to open in place of the serial port
+    const std::string& path() const
+    {
+        return _path;
+    }
+
+    /// plays the recording from a thread of its own
+    void start();
+
+    /// waits for the recording to finish playing
+    void wait();
+
+    bool finished() const
+    {
+        return _finished;
+    }
+
+private:
+    ReplayPty(const ReplayPty&);
+    ReplayPty& operator=(const ReplayPty&);
+
+    void play();
+    /// throws away anything the driver has written
+    void drain();
+
+    const ReplayRecording& _recording;
+    ReplayClock _clock;
+    int _master;
+    /// held open so the pty survives the driver closing and reopening the port
+    int _slave;
+    std::string _path;
+    std::thread _thread;
+    std::atomic_bool _stop;
+    std::atomic_bool _finished;
+};
+
+#endif /* REPLAY_H_ */
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "Replay.h"
+#include "Benchmark.h"
+#include "gx3_framer.h"
+#include "novatel_framer.h"
+
+/*
+ * Max speed replays of the recordings through the framers, by way of the
+ * same ReplayInjector reads Driver::readDevice makes during a replay.
+ */
+
+BENCHMARK(Replay, GX3MaxSpeed)
+{
+    ReplayRecording recording;
+    if(! recording.load(Benchmark::recordedDataPath("imu_data.bin"), 115200, 256))
+    {
+        bench.skip("no recorded data");
+        return;
+    }
+
+    ReplayInjector injector(recording, 0);
+    GX3Framer framer;
+    uint8_t packet[GX3Framer::MAX_PACKET_LENGTH];
+    uint64_t packets = 0;
+
+    uint64_t start = Benchmark::nowNanos();
+    while(! injector.finished())
+    {
+        size_t space = 0;
+        uint8_t* dst = framer.writeSpan(space);
+        if(space == 0)
+        {
+            framer.reset();
+            continue;
+        }
+        framer.commit(injector.read(dst, space));
+        while(framer.next(packet) > 0)
+        {
+            packets++;
+        }
+    }
+    double seconds = (Benchmark::nowNanos() - start) / 1e9;
+
+    bench.report("packets", packets, "packets");
+    bench.report("throughput", recording.bytes() / seconds / 1e6, "MB/s");
+    bench.report("speedup", recording.duration_ns() / 1e9 / seconds, "x real time");
+}
+
+BENCHMARK(Replay, NovatelMaxSpeed)
+{
+    ReplayRecording recording;
+    if(! recording.load(Benchmark::recordedDataPath("novatel_gps_data.bin"), 38400, 256))
+    {
+        bench.skip("no recorded data");
+        return;
+    }
+
+    ReplayInjector injector(recording, 0);
+    NovatelFramer framer;
+    uint8_t message[NovatelFramer::MAX_MESSAGE_LENGTH];
+    uint64_t messages = 0;
+
+    uint64_t start = Benchmark::nowNanos();
+    while(! injector.finished())
+    {
+        size_t space = 0;
+        uint8_t* dst = framer.writeSpan(space);
+        if(space == 0)
+        {
+            framer.reset();
+            continue;
+        }
+        framer.commit(injector.read(dst, space));
+        while(framer.next(message) > 0)
+        {
+            messages++;
+        }
+    }
+    double seconds = (Benchmark::nowNanos() - start) / 1e9;
+
+    bench.report("messages", messages, "messages");
+    bench.report("throughput", recording.bytes() / seconds / 1e6, "MB/s");
+    bench.report("speedup", recording.duration_ns() / 1e9 / seconds, "x real time");
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "Replay.h"
+#include "RawCapture.h"
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+namespace
+{
+std::vector<uint8_t> counting_bytes(size_t count)
+{
+    std::vector<uint8_t> bytes(count);
+    for(size_t i = 0; i < count; i++)
+    {
+        bytes[i] = i & 0xFF;
+    }
+    return bytes;
+}
+
+/// a capture file in /tmp holding the given reads 10ms apart
+std::string write_capture(const std::vector<std::string>& reads)
+{
+    char name[] = "/tmp/replay_test_XXXXXX";
+    close(mkstemp(name));
+    unlink(name);
+
+    RawCapture capture(name);
+    uint64_t timestamp = 5000000000ull;
+    for(const std::string& read : reads)
+    {
+        capture.record(timestamp, read.data(), read.size());
+        timestamp += 10000000;
+    }
+    return name;
+}
+}
+
+TEST(Replay, PlainBytesArePacedByBaud)
+{
+    ReplayRecording recording;
+    ASSERT_TRUE(recording.loadBytes(counting_bytes(1000), 10000, 100));
+
+    EXPECT_FALSE(recording.timestamped());
+    ASSERT_EQ(10u, recording.chunks());
+    EXPECT_EQ(1000u, recording.bytes());
+    // 10000 baud is 1000 bytes a second, so each 100 byte chunk is 100ms after the last
+    EXPECT_EQ(0u, recording[0].offset_ns);
+    EXPECT_EQ(100000000u, recording[1].offset_ns);
+    EXPECT_EQ(900000000u, recording.duration_ns());
+}
+
+TEST(Replay, CapturesKeepTheirReads)
+{
+    std::string path = write_capture({"abc", "d", "efgh"});
+    ReplayRecording recording;
+    ASSERT_TRUE(recording.load(path));
+    unlink(path.c_str());
+
+    EXPECT_TRUE(recording.timestamped());
+    ASSERT_EQ(3u, recording.chunks());
+    EXPECT_EQ(0u, recording[0].offset_ns);
+    EXPECT_EQ(10000000u, recording[1].offset_ns);
+    EXPECT_EQ(20000000u, recording[2].offset_ns);
+    EXPECT_EQ(4u, recording[2].length);
+}
+
+TEST(Replay, InjectorSplitsReadsForSmallBuffers)
+{
+    std::string path = write_capture({"abcdef", "gh"});
+    ReplayRecording recording;
+    ASSERT_TRUE(recording.load(path));
+    unlink(path.c_str());
+
+    ReplayInjector injector(recording, 0);
+    char buf[4];
+    ASSERT_EQ(4, injector.read(buf, 4));
+    EXPECT_EQ(0, memcmp("abcd", buf, 4));
+    ASSERT_EQ(2, injector.read(buf, 4));
+    EXPECT_EQ(0, memcmp("ef", buf, 2));
+    ASSERT_EQ(2, injector.read(buf, 4));
+    EXPECT_EQ(0, memcmp("gh", buf, 2));
+    EXPECT_TRUE(injector.finished());
+    EXPECT_EQ(0, injector.read(buf, 4));
+}
+
+TEST(Replay, SpeedScalesPlayback)
+{
+    // a second of recording at 20x should take about 50ms
+    ReplayRecording recording;
+    ASSERT_TRUE(recording.loadBytes(counting_bytes(1000), 10000, 100));
+
+    ReplayInjector injector(recording, 20);
+    uint8_t buf[100];
+    auto start = std::chrono::steady_clock::now();
+    while(injector.read(buf, sizeof(buf)) > 0)
+    {
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+    EXPECT_GE(elapsed, 40);
+    EXPECT_LT(elapsed, 500);
+}
+
+TEST(Replay, PtyDeliversEveryByte)
+{
+    std::vector<uint8_t> bytes = counting_bytes(5000);
+    ReplayRecording recording;
+    ASSERT_TRUE(recording.loadBytes(bytes, 115200, 64));
+
+    ReplayPty pty(recording, 0);
+    if(! pty.open())
+    {
+        return; // no ptys available
+    }
+
+    int port = open(pty.path().c_str(), O_RDWR | O_NOCTTY);
+    ASSERT_GE(port, 0);
+    pty.start();
+
+    // anything the driver writes is thrown away rather than getting in the way
+    ASSERT_EQ(4, write(port, "init", 4));
+
+    std::vector<uint8_t> received;
+    uint8_t buf[512];
+    pollfd p = {port, POLLIN, 0};
+    while(received.size() < bytes.size() && poll(&p, 1, 1000) > 0)
+    {
+        ssize_t amount = read(port, buf, sizeof(buf));
+        ASSERT_GT(amount, 0);
+        received.insert(received.end(), buf, buf + amount);
+    }
+
+    pty.wait();
+    close(port);
+    EXPECT_TRUE(pty.finished());
+    EXPECT_EQ(bytes, received);
+}
@@ -0,0 +1,216 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#pragma once
+#ifndef SEQ_LOCK_H
+#define SEQ_LOCK_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <thread>
+#include <type_traits>
+
+/** A value of T any number of threads can update and read whole, without
+readers ever taking a lock or holding up a writer.
+
+A writer makes the sequence odd with one compare and swap, which also keeps
+other writers out, changes the value in place and makes the sequence even
+again. A reader copies the value between two loads of the sequence and tries
+again if a write was in the middle of it, so a read never sees half of one
+update and half of another. Writes are a few hundred nanoseconds, so a read
+hardly ever has to go around twice.
+
+The value is kept as atomic words so copying it while it is being written is
+well defined. T must be safe to copy with memcpy: numbers, arrays and plain
+structs of them. A writer that only changes part of T can say which bytes,
+and only the words holding them are copied in and out while it holds the
+sequence.
+
+Waiting readers and writers spin a little, then yield between tries, so a
+writer that is preempted half way through doesn't have others burn its CPU.
+
+@code
+SeqLock<State> state;
+
+// any writer
+state.write([&](State& s){ s.roll = roll; s.rollRate = rate; });
+
+// any reader, roll and rollRate are from the same write
+State now = state.read();
+
+// a writer of one field
+state.write(offsetof(State, roll), sizeof(float), [&](State& s){ s.roll = roll; });
+@endcode
+**/
+template <class T>
+class SeqLock
+{
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock copies T with memcpy");
+
+public:
+    /// tries a waiting reader or writer makes before it starts yielding between them
+    static const unsigned SPINS = 64;
+
+    explicit SeqLock(const T& initial = T())
+    :_sequence(0)
+    {
+        store(initial);
+    }
+
+    /**
+     * Calls update(T&) on a copy of the value and publishes the result.
+     * Writers take turns, update should be quick and must not write here again.
+     */
+    template <class Update>
+    void write(Update update)
+    {
+        write(0, sizeof(T), update);
+    }
+
+    /**
+     * Like write(update), but only the length bytes from offset are copied in
+     * for update and published. The rest of the T update is given is
+     * undefined, and update must not change it.
+     */
+    template <class Update>
+    void write(size_t offset, size_t length, Update update)
+    {
+        uint64_t sequence = _sequence.load(std::memory_order_relaxed);
+        for(unsigned attempts = 1; ; attempts++)
+        {
+            if((sequence & 1) == 0 &&
+               _sequence.compare_exchange_weak(sequence, sequence + 1, std::memory_order_acquire,
+                                               std::memory_order_relaxed))
+            {
+                break;
+            }
+            backOff(attempts);
+            sequence = _sequence.load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+
+        // the only writer now, so the words can't change under this copy
+        size_t first = offset / sizeof(uint64_t);
+        size_t last = (offset + length + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type value;
+        copyOut(first, last, &value);
+        update(*reinterpret_cast<T*>(&value));
+        copyIn(first, last, &value);
+
+        _sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    /// the value as of the last write to finish
+    T read() const
+    {
+        T value;
+        read(value);
+        return value;
+    }
+
+    /// copies the value in to out, returns how many times it had to try
+    unsigned read(T& out) const
+    {
+        uint64_t writes;
+        return read(out, writes);
+    }
+
+    /// copies the value in to out and how many writes came before it in to writes
+    unsigned read(T& out, uint64_t& writes) const
+    {
+        uint64_t words[WORDS];
+        for(unsigned attempts = 1; ; attempts++)
+        {
+            uint64_t before = _sequence.load(std::memory_order_acquire);
+            if((before & 1) == 0)
+            {
+                for(size_t i = 0; i < WORDS; i++)
+                {
+                    words[i] = _words[i].load(std::memory_order_relaxed);
+                }
+                std::atomic_thread_fence(std::memory_order_acquire);
+
+                if(_sequence.load(std::memory_order_relaxed) == before)
+                {
+                    memcpy(&out, words, sizeof(T));
+                    writes = before / 2;
+                    return attempts;
+                }
+            }
+            backOff(attempts);
+        }
+    }
+
+    /// writes finished so far
+    uint64_t writes() const
+    {
+        return _sequence.load(std::memory_order_acquire) / 2;
+    }
+
+private:
+    SeqLock(const SeqLock&);
+    SeqLock& operator=(const SeqLock&);
+
+    static const size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    /// spins for the first SPINS attempts, then lets the thread holding things up run
+    static void backOff(unsigned attempts)
+    {
+        if(attempts >= SPINS)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    /// copies words [first, last) in to the same place in value
+    void copyOut(size_t first, size_t last, void* value) const
+    {
+        for(size_t i = first; i < last; i++)
+        {
+            uint64_t word = _words[i].load(std::memory_order_relaxed);
+            memcpy(static_cast<char*>(value) + i * sizeof(uint64_t), &word, bytesOf(i));
+        }
+    }
+
+    /// stores words [first, last) from the same place in value
+    void copyIn(size_t first, size_t last, const void* value)
+    {
+        for(size_t i = first; i < last; i++)
+        {
+            // the padding past the end of T stays 0
+            uint64_t word = 0;
+            memcpy(&word, static_cast<const char*>(value) + i * sizeof(uint64_t), bytesOf(i));
+            _words[i].store(word, std::memory_order_relaxed);
+        }
+    }
+
+    /// how much of T word i holds, all of it but for a last partial word
+    static size_t bytesOf(size_t i)
+    {
+        return i + 1 < WORDS ? sizeof(uint64_t) : sizeof(T) - i * sizeof(uint64_t);
+    }
+
+    void store(const T& value)
+    {
+        uint64_t words[WORDS] = {};
+        memcpy(words, &value, sizeof(T));
+        for(size_t i = 0; i < WORDS; i++)
+        {
+            _words[i].store(words[i], std::memory_order_relaxed);
+        }
+    }
+
+    std::atomic<uint64_t> _sequence;
+    std::atomic<uint64_t> _words[WORDS];
+};
+
+template <class T>
+const unsigned SeqLock<T>::SPINS;
+
+#endif // SEQ_LOCK_H
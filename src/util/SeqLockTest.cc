@@ -0,0 +1,189 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "SeqLock.h"
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <stddef.h>
+
+namespace
+{
+/// every word the same in a whole write, an odd size so the last word is partly padding
+struct Sample
+{
+    uint32_t sequence;
+    double values[6];
+    uint16_t check;
+};
+
+Sample sample(uint32_t sequence)
+{
+    Sample s;
+    s.sequence = sequence;
+    for(double& value : s.values)
+    {
+        value = sequence;
+    }
+    s.check = static_cast<uint16_t>(sequence);
+    return s;
+}
+
+bool whole(const Sample& s)
+{
+    for(double value : s.values)
+    {
+        if(value != s.sequence)
+        {
+            return false;
+        }
+    }
+    return s.check == static_cast<uint16_t>(s.sequence);
+}
+}
+
+TEST(SeqLock, ReadsTheLastWrite)
+{
+    SeqLock<Sample> lock(sample(7));
+    EXPECT_EQ(7u, lock.read().sequence);
+    EXPECT_EQ(0u, lock.writes());
+
+    lock.write([](Sample& s){ s.values[2] = 3.5; });
+    Sample read = lock.read();
+    EXPECT_EQ(7u, read.sequence);
+    EXPECT_EQ(3.5, read.values[2]);
+    EXPECT_EQ(7.0, read.values[3]);
+    EXPECT_EQ(1u, lock.writes());
+
+    Sample out;
+    EXPECT_EQ(1u, lock.read(out));
+    EXPECT_EQ(3.5, out.values[2]);
+}
+
+TEST(SeqLock, ReadersNeverSeeHalfAWrite)
+{
+    SeqLock<Sample> lock(sample(0));
+    std::atomic<bool> done(false);
+    const uint32_t per_writer = 50000;
+
+    std::vector<std::thread> writers;
+    for(int w = 0; w < 2; w++)
+    {
+        writers.push_back(std::thread([&lock, w, per_writer]()
+        {
+            for(uint32_t i = 0; i < per_writer; i++)
+            {
+                lock.write([&](Sample& s){ s = sample(i * 2 + w); });
+            }
+        }));
+    }
+
+    uint64_t reads = 0, torn = 0;
+    std::thread reader([&]()
+    {
+        while(! done.load())
+        {
+            if(! whole(lock.read()))
+            {
+                torn++;
+            }
+            reads++;
+        }
+    });
+
+    for(std::thread& writer : writers)
+    {
+        writer.join();
+    }
+    done = true;
+    reader.join();
+
+    EXPECT_EQ(0u, torn);
+    EXPECT_LT(0u, reads);
+    EXPECT_EQ(2 * per_writer, lock.writes());
+}
+
+TEST(SeqLock, WritersTakeTurns)
+{
+    SeqLock<std::array<uint64_t, 3> > lock;
+    const int per_writer = 20000;
+
+    std::vector<std::thread> writers;
+    for(int w = 0; w < 4; w++)
+    {
+        writers.push_back(std::thread([&lock, per_writer]()
+        {
+            for(int i = 0; i < per_writer; i++)
+            {
+                // read, modify, write only adds up if no other writer gets in between
+                lock.write([](std::array<uint64_t, 3>& counts)
+                {
+                    for(uint64_t& count : counts)
+                    {
+                        count++;
+                    }
+                });
+            }
+        }));
+    }
+    for(std::thread& writer : writers)
+    {
+        writer.join();
+    }
+
+    std::array<uint64_t, 3> counts = lock.read();
+    for(uint64_t count : counts)
+    {
+        EXPECT_EQ(4u * per_writer, count);
+    }
+}
+
+TEST(SeqLock, WritesOnlyTheBytesGiven)
+{
+    SeqLock<Sample> lock(sample(7));
+
+    lock.write(offsetof(Sample, check), sizeof(uint16_t), [](Sample& s){ s.check = 99; });
+    Sample read = lock.read();
+    EXPECT_EQ(99u, read.check);
+    EXPECT_EQ(7u, read.sequence);
+    EXPECT_EQ(7.0, read.values[0]);
+    EXPECT_EQ(7.0, read.values[5]);
+    EXPECT_EQ(1u, lock.writes());
+}
+
+TEST(SeqLock, ReaderWaitsOutASlowWriter)
+{
+    SeqLock<Sample> lock(sample(1));
+    std::atomic<bool> writing(false);
+
+    std::thread writer([&]()
+    {
+        lock.write([&](Sample& s)
+        {
+            writing = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            s = sample(2);
+        });
+    });
+
+    while(! writing.load())
+    {
+        std::this_thread::yield();
+    }
+
+    // spins, then yields until the writer is done rather than never giving up the CPU
+    Sample out;
+    uint64_t writes;
+    EXPECT_LT(SeqLock<Sample>::SPINS, lock.read(out, writes));
+    EXPECT_EQ(2u, out.sequence);
+    EXPECT_EQ(1u, writes);
+    writer.join();
+}
@@ -31,18 +31,24 @@ template <class T>
 class Singleton
 {
 public:
+  /**
+   * Returns the instance, constructing it from args on the first call.
+   *
+   * Once constructed this is one acquire load with no lock, it is called per
+   * packet and per log line. Only the first callers take the lock, so two
+   * threads racing to construct still get the same instance.
+   */
   template <typename... Args>
   static
   T* getInstance(Args... args)
   {
-    std::lock_guard<std::mutex> lock(instance_lock_);
-
-    if (instance_.load() == nullptr)
+    T* instance = instance_.load(std::memory_order_acquire);
+    if (instance != nullptr)
       {
-        instance_ = new T(std::forward<Args>(args)...);
+        return instance;
       }
 
-    return instance_;
+    return construct(std::forward<Args>(args)...);
   }
 
   /**
@@ -51,24 +57,41 @@ public:
    */
   template <typename... Args>
   static
-  T* getInstanceIfConstructed(Args... args)
+  T* getInstanceIfConstructed(Args...)
   {
-      if(instance_.load() == nullptr)
-      {
-          return nullptr;
-      }
-
-      return getInstance(std::forward<Args>(args)...);
+      return instance_.load(std::memory_order_acquire);
   }
 
+  /**
+   * Deletes the instance so the next getInstance makes a new one. Nothing else
+   * may be using the instance, callers holding the old pointer aren't told.
+   */
   static
   void destroyInstance()
   {
-    delete instance_.load();
-    instance_.store(nullptr);
+    std::lock_guard<std::mutex> lock(instance_lock_);
+    delete instance_.load(std::memory_order_relaxed);
+    instance_.store(nullptr, std::memory_order_release);
   }
 
 private:
+  /// the slow path, taken until the instance exists
+  template <typename... Args>
+  static
+  T* construct(Args... args)
+  {
+    std::lock_guard<std::mutex> lock(instance_lock_);
+
+    T* instance = instance_.load(std::memory_order_relaxed);
+    if (instance == nullptr)
+      {
+        instance = new T(std::forward<Args>(args)...);
+        instance_.store(instance, std::memory_order_release);
+      }
+
+    return instance;
+  }
+
     static std::atomic<T*> instance_;
     static std::mutex instance_lock_;
 };
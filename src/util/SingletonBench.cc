@@ -0,0 +1,110 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "Singleton.h"
+#include "Benchmark.h"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+const int THREADS = 4;
+const int CALLS = 1000000;
+
+class BenchSingleton : public Singleton<BenchSingleton>
+{
+    friend class Singleton<BenchSingleton>;
+
+public:
+    std::atomic<uint64_t> uses;
+
+private:
+    BenchSingleton()
+    :uses(0){}
+};
+
+/// the way getInstance used to work, locking on every call
+class LockedSingleton
+{
+public:
+    static LockedSingleton* getInstance()
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        if(_instance == nullptr)
+        {
+            _instance = new LockedSingleton();
+        }
+        return _instance;
+    }
+
+    std::atomic<uint64_t> uses;
+
+private:
+    LockedSingleton()
+    :uses(0){}
+
+    static LockedSingleton* _instance;
+    static std::mutex _lock;
+};
+
+LockedSingleton* LockedSingleton::_instance = nullptr;
+std::mutex LockedSingleton::_lock;
+
+/**
+ * Has THREADS threads each call getInstance CALLS times at once, like the IMU
+ * and GPS readers and the logger do, and reports the cost of one call.
+ */
+template <class T>
+void run(Benchmark& bench)
+{
+    T::getInstance();
+    std::atomic<int> ready(0);
+    std::vector<std::thread> threads;
+
+    uint64_t start = Benchmark::nowNanos();
+    for(int t = 0; t < THREADS; t++)
+    {
+        threads.push_back(std::thread([&ready]()
+        {
+            ready++;
+            while(ready.load() < THREADS)
+            {
+                std::this_thread::yield();
+            }
+
+            uint64_t found = 0;
+            for(int i = 0; i < CALLS; i++)
+            {
+                found += T::getInstance() != nullptr;
+            }
+            T::getInstance()->uses += found;
+        }));
+    }
+    for(std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    uint64_t elapsed = Benchmark::nowNanos() - start;
+
+    bench.report("ns_per_call", elapsed / static_cast<double>(THREADS * CALLS), "ns/call");
+    bench.report("calls", T::getInstance()->uses.load(), "calls");
+}
+}
+
+// getInstance after construction, four threads at once
+BENCHMARK(Singleton, Contended)
+{
+    run<BenchSingleton>(bench);
+}
+
+// the same with the lock taken on every call, for comparison
+BENCHMARK(Singleton, ContendedLocked)
+{
+    run<LockedSingleton>(bench);
+}
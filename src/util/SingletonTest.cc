@@ -9,6 +9,11 @@
 #include "Singleton.h"
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
 class SingletonTestClass : public Singleton<SingletonTestClass>
 {
     friend class Singleton<SingletonTestClass>;
@@ -50,3 +55,45 @@ TEST(Singleton, Instance_if_constructed_equal)
     EXPECT_EQ(a, b);
 }
 
+
+namespace
+{
+std::atomic<int> constructions(0);
+
+class SlowSingleton : public Singleton<SlowSingleton>
+{
+    friend class Singleton<SlowSingleton>;
+
+    private:
+        SlowSingleton()
+        {
+            constructions++;
+            // widen the window for a second thread to try constructing too
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+};
+}
+
+TEST(Singleton, Racing_Threads_Share_One_Instance)
+{
+    SlowSingleton* seen[4];
+    std::vector<std::thread> threads;
+    for(int i = 0; i < 4; i++)
+    {
+        threads.push_back(std::thread([&seen, i]()
+        {
+            seen[i] = SlowSingleton::getInstance();
+        }));
+    }
+    for(std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(1, constructions.load());
+    for(int i = 1; i < 4; i++)
+    {
+        EXPECT_EQ(seen[0], seen[i]);
+    }
+    EXPECT_EQ(seen[0], SlowSingleton::getInstanceIfConstructed());
+}
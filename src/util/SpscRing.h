@@ -0,0 +1,109 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#pragma once
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <stddef.h>
+
+/** A fixed capacity lock-free queue between exactly one producer thread and
+exactly one consumer thread.
+
+push() may only be called from the producer and pop() only from the consumer,
+neither ever blocks or allocates. T should be something cheap to copy, like an
+index in to a buffer pool.
+
+@code
+SpscRing<uint16_t, 64> queue;
+queue.push(3);          // producer thread
+
+uint16_t index;
+while(queue.pop(index)) // consumer thread
+{
+    ...
+}
+@endcode
+**/
+template <class T, size_t Capacity>
+class SpscRing
+{
+    static_assert(Capacity != 0 && (Capacity & (Capacity - 1)) == 0, "SpscRing capacity must be a power of two");
+
+public:
+    SpscRing()
+    :_head(0),
+     _tail(0)
+    {}
+
+    /// adds value to the queue, returns false if the queue is full
+    bool push(const T& value)
+    {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        if(tail - _head.load(std::memory_order_acquire) == Capacity)
+        {
+            return false;
+        }
+
+        _data[tail & MASK] = value;
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// removes the oldest value in to value, returns false if the queue is empty
+    bool pop(T& value)
+    {
+        size_t head = _head.load(std::memory_order_relaxed);
+        if(head == _tail.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        value = _data[head & MASK];
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// only exact when called from the producer or consumer while the other is idle
+    size_t size() const
+    {
+        return _tail.load(std::memory_order_acquire) - _head.load(std::memory_order_acquire);
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    static size_t capacity()
+    {
+        return Capacity;
+    }
+
+private:
+    static const size_t MASK = Capacity - 1;
+
+    /// a position padded out to its own cache line so the two threads don't fight over it
+    struct PaddedIndex
+    {
+        std::atomic<size_t> value;
+        char pad[64 - sizeof(std::atomic<size_t>)];
+
+        PaddedIndex(size_t v) : value(v) {}
+        size_t load(std::memory_order order) const { return value.load(order); }
+        void store(size_t v, std::memory_order order) { value.store(v, order); }
+    };
+
+    /// consumer position
+    PaddedIndex _head;
+    /// producer position
+    PaddedIndex _tail;
+    T _data[Capacity];
+};
+
+#endif // SPSC_RING_H
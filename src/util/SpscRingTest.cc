@@ -0,0 +1,66 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "SpscRing.h"
+#include <gtest/gtest.h>
+#include <thread>
+
+TEST(SpscRing, FullAndEmpty)
+{
+    SpscRing<int, 4> ring;
+    int value;
+
+    EXPECT_TRUE(ring.empty());
+    EXPECT_FALSE(ring.pop(value));
+
+    for(int i = 0; i < 4; i++)
+    {
+        EXPECT_TRUE(ring.push(i));
+    }
+    EXPECT_FALSE(ring.push(4));
+    EXPECT_EQ(4u, ring.size());
+
+    for(int i = 0; i < 4; i++)
+    {
+        ASSERT_TRUE(ring.pop(value));
+        EXPECT_EQ(i, value);
+    }
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(SpscRing, TwoThreadsKeepOrder)
+{
+    SpscRing<uint32_t, 64> ring;
+    const uint32_t count = 200000;
+
+    std::thread producer([&ring, count]()
+    {
+        for(uint32_t i = 0; i < count; i++)
+        {
+            while(! ring.push(i))
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint32_t expected = 0, value;
+    while(expected < count)
+    {
+        if(ring.pop(value))
+        {
+            ASSERT_EQ(expected, value);
+            expected++;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    producer.join();
+    EXPECT_TRUE(ring.empty());
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+
+#pragma once
+#ifndef WAKEUP_H
+#define WAKEUP_H
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+/** Lets a consumer thread sleep until a producer has queued something for it.
+
+The producer calls notify() after pushing on to a lock-free queue, it only
+touches the mutex when the consumer is actually asleep so the common case is
+two atomic operations. The consumer drains its queues, then calls wait() which
+returns straight away if anything was posted since the last wait().
+
+@code
+// producer
+queue.push(index);
+wakeup.notify();
+
+// consumer
+while(running)
+{
+    while(queue.pop(index)) { ... }
+    wakeup.wait(std::chrono::milliseconds(100));
+}
+@endcode
+**/
+class Wakeup
+{
+public:
+    Wakeup()
+    :_pending(false),
+     _waiting(false)
+    {}
+
+    /// wakes the consumer, or makes its next wait() return immediately
+    void notify()
+    {
+        _pending.store(true);
+        if(_waiting.load())
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            _cv.notify_one();
+        }
+    }
+
+    /**
+     * Blocks until notify() is called or timeout passes, returns true if it
+     * was notified. Timeouts give the caller a chance to check for termination.
+     */
+    template <class Rep, class Period>
+    bool wait(const std::chrono::duration<Rep, Period>& timeout)
+    {
+        if(_pending.exchange(false))
+        {
+            return true;
+        }
+
+        std::unique_lock<std::mutex> lock(_lock);
+        _waiting.store(true);
+        // _pending is checked after _waiting is published, so a notify() racing with us is never lost
+        _cv.wait_for(lock, timeout, [this]{ return _pending.load(); });
+        _waiting.store(false);
+        return _pending.exchange(false);
+    }
+
+private:
+    std::atomic_bool _pending;
+    std::atomic_bool _waiting;
+    std::mutex _lock;
+    std::condition_variable _cv;
+};
+
+#endif // WAKEUP_H
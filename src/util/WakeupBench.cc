@@ -0,0 +1,73 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "Wakeup.h"
+#include "SpscRing.h"
+#include "LatencyHistogram.h"
+#include "Benchmark.h"
+
+#include <thread>
+#include <atomic>
+
+namespace
+{
+const int MESSAGES = 500;
+
+/**
+ * Posts a timestamp every 2 ms, like the GX3 at 500Hz, and measures how long the
+ * consumer takes to pick each one up with the given wait strategy.
+ */
+template <class WaitFn>
+void run(Benchmark& bench, WaitFn wait, Wakeup& wakeup)
+{
+    SpscRing<uint64_t, 1024> queue;
+    std::atomic_bool done(false);
+    LatencyHistogram latency;
+    uint64_t wakeups = 0;
+
+    std::thread producer([&]()
+    {
+        for(int i = 0; i < MESSAGES; i++)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            queue.push(Benchmark::nowNanos());
+            wakeup.notify();
+        }
+        done = true;
+    });
+
+    uint64_t start = Benchmark::nowNanos();
+    uint64_t sent;
+    while(! done || ! queue.empty())
+    {
+        while(queue.pop(sent))
+        {
+            latency.record(Benchmark::nowNanos() - sent);
+        }
+        wait();
+        wakeups++;
+    }
+    double seconds = (Benchmark::nowNanos() - start) / 1e9;
+    producer.join();
+
+    bench.report("latency_p50", latency.percentile(0.5) / 1000.0, "us");
+    bench.report("latency_p99", latency.percentile(0.99) / 1000.0, "us");
+    bench.report("latency_max", latency.max() / 1000.0, "us");
+    bench.report("consumer_wakeups", wakeups / seconds, "wakeups/s");
+}
+}
+
+BENCHMARK(Wakeup, Polling5ms)
+{
+    Wakeup unused;
+    run(bench, []{ std::this_thread::sleep_for(std::chrono::milliseconds(5)); }, unused);
+}
+
+BENCHMARK(Wakeup, Notify)
+{
+    Wakeup wakeup;
+    run(bench, [&wakeup]{ wakeup.wait(std::chrono::milliseconds(100)); }, wakeup);
+}
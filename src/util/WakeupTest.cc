@@ -0,0 +1,54 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "Wakeup.h"
+#include "SpscRing.h"
+#include <gtest/gtest.h>
+#include <thread>
+
+TEST(Wakeup, PendingNotifyReturnsImmediately)
+{
+    Wakeup wakeup;
+    wakeup.notify();
+    EXPECT_TRUE(wakeup.wait(std::chrono::seconds(10)));
+    EXPECT_FALSE(wakeup.wait(std::chrono::milliseconds(1)));
+}
+
+TEST(Wakeup, NoLostWakeups)
+{
+    SpscRing<uint32_t, 16> queue;
+    Wakeup wakeup;
+    const uint32_t count = 20000;
+
+    std::thread producer([&]()
+    {
+        for(uint32_t i = 0; i < count; i++)
+        {
+            while(! queue.push(i))
+            {
+                std::this_thread::yield();
+            }
+            wakeup.notify();
+        }
+    });
+
+    // a lost notify would leave the consumer asleep with items queued until the timeout
+    uint32_t received = 0, value, timeouts = 0;
+    while(received < count)
+    {
+        while(queue.pop(value))
+        {
+            received++;
+        }
+        if(received < count && ! wakeup.wait(std::chrono::seconds(1)))
+        {
+            timeouts++;
+        }
+    }
+
+    producer.join();
+    EXPECT_EQ(0u, timeouts);
+}
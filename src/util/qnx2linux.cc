@@ -10,19 +10,115 @@
 #include "qnx2linux.h"
 #include <termios.h>
 #include <unistd.h>
-#include <thread>
+#include <poll.h>
+#include <time.h>
 #include "Debug.h"
+#include <atomic>
 #include <cstdint>
 #include <errno.h>
-#include <chrono>
-#include <cstring>
-#include <cassert>
 
 Logger qnx2LinuxLogger("QNX2Linux");
 
 void handleReadErrno();
 
+namespace
+{
+const uint64_t TENTH_NS = 100000000ull;
+
+/// fds at or past this are set up on every call rather than remembered
+const int MAX_PREPARED_FDS = 1024;
+std::atomic<bool> preparedPorts[MAX_PREPARED_FDS];
+
+uint64_t now_ns()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000000ull + now.tv_nsec;
+}
+
+/**
+ * Takes a terminal out of canonical mode so ppoll() reports single bytes and
+ * a read() after it never blocks. Non terminals are left alone.
+ */
+void preparePort(int fd)
+{
+    if(fd >= 0 && fd < MAX_PREPARED_FDS && preparedPorts[fd].load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    struct termios settings;
+    if(tcgetattr(fd, &settings) == 0 &&
+       ((settings.c_lflag & ICANON) || settings.c_cc[VMIN] > 1 || settings.c_cc[VTIME] != 0))
+    {
+        settings.c_lflag &= ~ICANON; /* Set non-canonical mode */
+        settings.c_cc[VTIME] = 0;
+        settings.c_cc[VMIN] = 1;
+        tcsetattr(fd, TCSANOW, &settings);
+    }
+
+    if(fd >= 0 && fd < MAX_PREPARED_FDS)
+    {
+        preparedPorts[fd].store(true, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * Waits for fd to be readable, hang up or error until deadline_ns, 0 waits
+ * forever. Returns the poll events seen, 0 if the deadline passed first.
+ */
+short waitReadable(int fd, uint64_t deadline_ns)
+{
+    struct pollfd request = {fd, POLLIN, 0};
 
+    while(true)
+    {
+        timespec wait;
+        timespec* timeout = nullptr;
+        if(deadline_ns != 0)
+        {
+            uint64_t now = now_ns();
+            uint64_t left = deadline_ns > now ? deadline_ns - now : 0;
+            wait.tv_sec = left / 1000000000ull;
+            wait.tv_nsec = left % 1000000000ull;
+            timeout = &wait;
+        }
+
+        int ready = ppoll(&request, 1, timeout, nullptr);
+        if(ready > 0)
+        {
+            return request.revents;
+        }
+
+        if(ready == 0)
+        {
+            return 0;
+        }
+
+        if(errno != EINTR)
+        {
+            // let read() report it
+            return POLLERR;
+        }
+    }
+}
+
+/// the earlier of two deadlines where 0 is never
+uint64_t earliest(uint64_t a, uint64_t b)
+{
+    if(a == 0)
+    {
+        return b;
+    }
+
+    if(b == 0)
+    {
+        return a;
+    }
+
+    return a < b ? a : b;
+}
+}
 
 int QNX2Linux::readcond(int fd, void * buf, int n, int min, int time, int timeout)
 {
@@ -32,60 +128,70 @@ int QNX2Linux::readcond(int fd, void * buf, int n, int min, int time, int timeou
         return 0;
     }
 
-    //debug() << "readcond " << n << std::hex << buf;
-    struct termios orig;
-    struct termios modified;
-
-    tcgetattr(fd, &orig);
-    modified = orig;
-    modified.c_lflag &= ~ICANON; /* Set non-canonical mode */
-    modified.c_cc[VTIME] = time;
-    modified.c_cc[VMIN] = min;
-    tcsetattr(fd, TCSANOW, &modified);
+    preparePort(fd);
 
-    uint8_t buffer[n];
+    uint8_t* buffer = static_cast<uint8_t*>(buf);
+    uint64_t start = now_ns();
+    uint64_t overall_deadline = timeout > 0 ? start + timeout * TENTH_NS : 0;
+    // with no minimum the gap timer runs from the call, otherwise from the last byte
+    uint64_t gap_deadline = (min == 0 && time > 0) ? start + time * TENTH_NS : 0;
+    bool poll_only = (min == 0 && time == 0 && timeout == 0);
 
     int totalBytesRead = 0;
-    if(timeout == 0)
-    {
-        totalBytesRead = read(fd, buffer, n);
-    }
-    else
+    while(totalBytesRead < n)
     {
-        for(int i = 0; i < timeout; i++)
+        if(min > 0 && totalBytesRead >= min)
         {
-            assert(totalBytesRead < n);
+            break;
+        }
+
+        uint64_t deadline = earliest(overall_deadline, gap_deadline);
+        if(poll_only)
+        {
+            deadline = start;
+        }
 
-            int bytesRead = read(fd, &buffer[totalBytesRead], n - totalBytesRead);
+        if(waitReadable(fd, deadline) == 0)
+        {
+            break;
+        }
 
-            if(bytesRead < 0)
+        int bytesRead = read(fd, &buffer[totalBytesRead], n - totalBytesRead);
+        if(bytesRead < 0)
+        {
+            if(errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)
             {
-                bytesRead = 0;
-                handleReadErrno();
                 continue;
             }
-            totalBytesRead += bytesRead;
 
-            // if we've read enough, stop
-            if(totalBytesRead == n)
-            {
-                break;
-            }
+            handleReadErrno();
+            return totalBytesRead > 0 ? totalBytesRead : -1;
+        }
 
-            // QNX specification says this is 1/10th of a second.
-            std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) );
+        if(bytesRead == 0)
+        {
+            // hung up, waiting longer won't bring anything
+            break;
+        }
+
+        totalBytesRead += bytesRead;
+        if(time > 0)
+        {
+            gap_deadline = now_ns() + time * TENTH_NS;
         }
-    }
 
-    memcpy(buf, buffer, n);
+        if(poll_only)
+        {
+            break;
+        }
+    }
 
-    tcsetattr(fd, TCSANOW, &orig); // return to the original state.
     return totalBytesRead;
 }
 
 int QNX2Linux::readUntilMin(int fd, void* buf, int n, int min)
 {
-    uint8_t buffer[n];
+    uint8_t* buffer = static_cast<uint8_t*>(buf);
     int totalBytesRead = 0;
 
     while(totalBytesRead < min)
@@ -94,26 +200,40 @@ int QNX2Linux::readUntilMin(int fd, void* buf, int n, int min)
 
         if(bytesRead < 0)
         {
-            bytesRead = 0;
-            handleReadErrno();
+            if(errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+            {
+                handleReadErrno();
+                return totalBytesRead > 0 ? totalBytesRead : -1;
+            }
+
+            waitReadable(fd, 0);
             continue;
         }
 
-        totalBytesRead += bytesRead;
-
-        // if we've read enough, stop
-        if(totalBytesRead >= min)
+        if(bytesRead == 0)
         {
-            break;
+            // nothing waiting on a port with VMIN of 0, or the other end hung up
+            if(waitReadable(fd, 0) & POLLHUP)
+            {
+                break;
+            }
+            continue;
         }
 
-        std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) );
+        totalBytesRead += bytesRead;
     }
 
-    memcpy(buf, buffer, totalBytesRead);
     return totalBytesRead;
 }
 
+void QNX2Linux::resetPort(int fd)
+{
+    if(fd >= 0 && fd < MAX_PREPARED_FDS)
+    {
+        preparedPorts[fd].store(false, std::memory_order_relaxed);
+    }
+}
+
 void handleReadErrno()
 {
     if(errno == EAGAIN || errno == EWOULDBLOCK)
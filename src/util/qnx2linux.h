@@ -19,12 +19,22 @@ namespace QNX2Linux
  * An alternate to the read() system call, that provides a timeout and amount
  * of time to read.
  *
+ * Returns as soon as min bytes have been read, taking anything else already
+ * waiting up to n. Otherwise returns what it has once time tenths of a second
+ * pass without a new byte (counted from the call if min is 0), or timeout
+ * tenths of a second pass in total. A time or timeout of 0 means no limit of
+ * that kind, and all three 0 reads only what is already waiting.
+ *
+ * The first call for an fd takes it out of canonical mode, after that reads
+ * wait in ppoll() and leave the port settings alone.
+ *
  * @param fd - the file to read from
  * @param buf - the buffer to read in to
  * @param n - the number of bytes possible to read
  * @param min - the minimum number of bytes to read
  * @param time - in tenths of a second to wait for data
  * @param timeout - in tenths of a second to time out multiple reades
+ * @return the number of bytes read, or -1 if nothing was read because of an error
  */
 int readcond(int fd, void * buf, int n, int min, int time, int timeout);
 
@@ -33,6 +43,12 @@ int readcond(int fd, void * buf, int n, int min, int time, int timeout);
  */
 int readUntilMin(int fd, void * buf, int n, int min);
 
+/**
+ * Forgets that readcond() has set up fd, call after reopening a port or
+ * changing its terminal settings.
+ */
+void resetPort(int fd);
+
 #endif
 }
 
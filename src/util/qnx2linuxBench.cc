@@ -0,0 +1,170 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "qnx2linux.h"
+#include "LatencyHistogram.h"
+#include "Benchmark.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace
+{
+const int PACKETS = 100;
+const size_t PACKET_SIZE = 32;
+
+/**
+ * readcond as it was, setting VMIN and VTIME around every read and sleeping
+ * a tenth of a second between partial reads.
+ */
+int termios_readcond(int fd, void * buf, int n, int min, int time, int timeout)
+{
+    struct termios orig;
+    struct termios modified;
+
+    tcgetattr(fd, &orig);
+    modified = orig;
+    modified.c_lflag &= ~ICANON;
+    modified.c_cc[VTIME] = time;
+    modified.c_cc[VMIN] = min;
+    tcsetattr(fd, TCSANOW, &modified);
+
+    uint8_t buffer[n];
+
+    int totalBytesRead = 0;
+    for(int i = 0; i < timeout; i++)
+    {
+        int bytesRead = read(fd, &buffer[totalBytesRead], n - totalBytesRead);
+        if(bytesRead < 0)
+        {
+            continue;
+        }
+        totalBytesRead += bytesRead;
+
+        if(totalBytesRead == n)
+        {
+            break;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    memcpy(buf, buffer, n);
+
+    tcsetattr(fd, TCSANOW, &orig);
+    return totalBytesRead;
+}
+
+/**
+ * Every 5ms a sensor on the master end of a pty writes a packet stamped with
+ * the time it was sent, the reader calls readcond with n and min like the
+ * drivers do and measures how long each packet took to come out.
+ */
+template <class Readcond>
+void run(Benchmark& bench, Readcond readcond, int n, int min)
+{
+    int sensor = posix_openpt(O_RDWR | O_NOCTTY);
+    if(sensor < 0 || grantpt(sensor) != 0 || unlockpt(sensor) != 0)
+    {
+        bench.skip("no pty available");
+        return;
+    }
+
+    int port = open(ptsname(sensor), O_RDWR | O_NOCTTY);
+    termios settings;
+    tcgetattr(port, &settings);
+    cfmakeraw(&settings);
+    tcsetattr(port, TCSANOW, &settings);
+    QNX2Linux::resetPort(port);
+
+    // keeps sending until the reader has enough, the old readcond blocks on a quiet port
+    std::atomic_bool done(false);
+    std::thread writer([sensor, &done]
+    {
+        while(! done)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            uint8_t packet[PACKET_SIZE] = {};
+            uint64_t sent = Benchmark::nowNanos();
+            memcpy(packet, &sent, sizeof(sent));
+            if(write(sensor, packet, PACKET_SIZE) != static_cast<ssize_t>(PACKET_SIZE))
+            {
+                return;
+            }
+        }
+    });
+
+    LatencyHistogram latency;
+    uint8_t pending[1024];
+    size_t pending_size = 0;
+    int received = 0;
+    int reads = 0;
+    uint64_t give_up = Benchmark::nowNanos() + 5000000000ull;
+
+    while(received < PACKETS && Benchmark::nowNanos() < give_up)
+    {
+        int amt = readcond(port, pending + pending_size, n, min, 10, 10);
+        uint64_t now = Benchmark::nowNanos();
+        reads++;
+        if(amt <= 0)
+        {
+            continue;
+        }
+
+        pending_size += amt;
+        size_t used = 0;
+        for(; pending_size - used >= PACKET_SIZE; used += PACKET_SIZE)
+        {
+            uint64_t sent;
+            memcpy(&sent, pending + used, sizeof(sent));
+            latency.record(now - sent);
+            received++;
+        }
+        memmove(pending, pending + used, pending_size - used);
+        pending_size -= used;
+    }
+
+    done = true;
+    writer.join();
+    close(port);
+    close(sensor);
+
+    bench.report("packets", received, "packets");
+    bench.report("reads_per_packet", reads / static_cast<double>(received), "reads/packet");
+    bench.report("latency_p50", latency.percentile(0.5) / 1000.0, "us");
+    bench.report("latency_p99", latency.percentile(0.99) / 1000.0, "us");
+    bench.report("latency_max", latency.max() / 1000.0, "us");
+}
+}
+
+// how the drivers read, anything up to a buffer as soon as one byte is there
+BENCHMARK(Readcond, TermiosAnyBytes)
+{
+    run(bench, termios_readcond, 256, 1);
+}
+
+BENCHMARK(Readcond, PollAnyBytes)
+{
+    run(bench, QNX2Linux::readcond, 256, 1);
+}
+
+// one whole packet per call
+BENCHMARK(Readcond, TermiosWholePacket)
+{
+    run(bench, termios_readcond, PACKET_SIZE, PACKET_SIZE);
+}
+
+BENCHMARK(Readcond, PollWholePacket)
+{
+    run(bench, QNX2Linux::readcond, PACKET_SIZE, PACKET_SIZE);
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright 2014 Joseph Lewis <joseph@josephlewis.net>
+ *
+ * This file is part of University of Denver Autopilot.
+ * Dual licensed under the GPL v 3 and the Apache 2.0 License
+ */
+#include "qnx2linux.h"
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+namespace
+{
+/// a pty pair left in its default canonical mode, the master end plays the sensor
+struct Pty
+{
+    int sensor;
+    int port;
+
+    Pty()
+    :sensor(-1),
+     port(-1)
+    {
+        sensor = posix_openpt(O_RDWR | O_NOCTTY);
+        if(sensor < 0 || grantpt(sensor) != 0 || unlockpt(sensor) != 0)
+        {
+            return;
+        }
+
+        port = open(ptsname(sensor), O_RDWR | O_NOCTTY);
+        QNX2Linux::resetPort(port);
+    }
+
+    ~Pty()
+    {
+        if(port >= 0) close(port);
+        if(sensor >= 0) close(sensor);
+    }
+
+    bool ok() const
+    {
+        return sensor >= 0 && port >= 0;
+    }
+};
+
+int64_t elapsed_ms(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+}
+}
+
+TEST(QNX2Linux, ReadcondReturnsOnceMinArrives)
+{
+    Pty pty;
+    ASSERT_TRUE(pty.ok());
+
+    // no newline, a canonical port would hold on to these
+    ASSERT_EQ(4, write(pty.sensor, "wxyz", 4));
+
+    char buf[64];
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(4, QNX2Linux::readcond(pty.port, buf, sizeof(buf), 4, 10, 10));
+    EXPECT_LT(elapsed_ms(start), 50);
+    EXPECT_EQ('z', buf[3]);
+}
+
+TEST(QNX2Linux, ReadcondGivesUpAfterTheGap)
+{
+    Pty pty;
+    ASSERT_TRUE(pty.ok());
+    ASSERT_EQ(2, write(pty.sensor, "ab", 2));
+
+    char buf[64];
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(2, QNX2Linux::readcond(pty.port, buf, sizeof(buf), 4, 1, 10));
+
+    int64_t waited = elapsed_ms(start);
+    EXPECT_GE(waited, 90);
+    EXPECT_LT(waited, 500);
+}
+
+TEST(QNX2Linux, ReadcondTimesOutWithNothing)
+{
+    Pty pty;
+    ASSERT_TRUE(pty.ok());
+
+    char buf[64];
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(0, QNX2Linux::readcond(pty.port, buf, sizeof(buf), 1, 0, 1));
+    EXPECT_GE(elapsed_ms(start), 90);
+
+    // all zero only takes what is already there
+    start = std::chrono::steady_clock::now();
+    EXPECT_EQ(0, QNX2Linux::readcond(pty.port, buf, sizeof(buf), 0, 0, 0));
+    EXPECT_LT(elapsed_ms(start), 50);
+}
+
+TEST(QNX2Linux, ReadUntilMinWaitsForTheRest)
+{
+    Pty pty;
+    ASSERT_TRUE(pty.ok());
+
+    // readUntilMin expects the port already set up
+    char buf[64];
+    EXPECT_EQ(0, QNX2Linux::readcond(pty.port, buf, sizeof(buf), 0, 0, 0));
+
+    std::thread sensor([&]
+    {
+        EXPECT_EQ(3, write(pty.sensor, "abc", 3));
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        EXPECT_EQ(3, write(pty.sensor, "def", 3));
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(6, QNX2Linux::readUntilMin(pty.port, buf, sizeof(buf), 6));
+    EXPECT_LT(elapsed_ms(start), 90);
+    EXPECT_EQ('f', buf[5]);
+    sensor.join();
+}